@@ -0,0 +1,462 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/assets/GameConfigLoader.h>
+#include <engine/Engine.h>
+#include <engine/helpers/Arguments.h>
+#include <engine/physics/Physics.h>
+#include <engine/structs/Actor.h>
+#include <engine/structs/ActorDefinition.h>
+#include <engine/structs/ActorIoQueue.h>
+#include <engine/structs/ActorPool.h>
+#include <engine/structs/Atom.h>
+#include <engine/structs/GlobalState.h>
+#include <engine/structs/KVList.h>
+#include <engine/structs/List.h>
+#include <engine/structs/Map.h>
+#include <engine/structs/MapArena.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/Timing.h>
+#include <joltc/Math/Quat.h>
+#include <joltc/Math/Transform.h>
+#include <SDL3/SDL_atomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+/// How many named actors the actor I/O benchmark creates, unless overridden with --actors
+#define DEFAULT_ACTOR_IO_BENCHMARK_ACTORS 10000
+/// How many ticks the actor I/O benchmark runs for, unless overridden with --iterations
+#define DEFAULT_ACTOR_IO_BENCHMARK_TICKS 100
+/// How many actors the actor pool benchmark spawns per round, unless overridden with --actors
+#define DEFAULT_ACTOR_POOL_BENCHMARK_ACTORS 100000
+/// How many rounds the actor pool benchmark runs, unless overridden with --iterations
+#define DEFAULT_ACTOR_POOL_BENCHMARK_ROUNDS 10
+
+#define BENCHMARK_ACTOR_NAME "actor_io_benchmark"
+#define BENCHMARK_OUTPUT "benchmark_fire"
+#define BENCHMARK_INPUT "benchmark_receive"
+
+/// The most ticks the linear scan baseline runs for, since it is quadratic in the actor count
+#define MAX_LINEAR_SCAN_TICKS 5
+
+/// The number of inputs received since the benchmark started
+static size_t inputsReceived = 0;
+
+static ActorOutputId benchmarkFireOutput;
+
+static void BenchmarkActorInit(Actor * /*this*/, const KvList /*params*/, Transform * /*transform*/) {}
+
+static void BenchmarkActorReceiveHandler(Actor * /*this*/, const Actor * /*sender*/, const Param * /*param*/)
+{
+	inputsReceived++;
+}
+
+static ActorDefinition benchmarkActorDefinition = {
+	.Update = DefaultActorUpdate,
+	.OnPlayerContactAdded = DefaultActorOnPlayerContactAdded,
+	.OnPlayerContactPersisted = DefaultActorOnPlayerContactPersisted,
+	.OnPlayerContactRemoved = DefaultActorOnPlayerContactRemoved,
+	.RenderUi = DefaultActorRenderUi,
+	.Interact = DefaultActorInteract,
+	.Destroy = DefaultActorDestroy,
+	.Init = BenchmarkActorInit,
+};
+
+static Atom GetBenchmarkActorName(const size_t nameIndex)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "benchmark_%zu", nameIndex);
+	return Intern(name);
+}
+
+/**
+ * Find the actors with a name by comparing it against every name, like named actors were looked up before they were
+ * indexed
+ */
+static size_t FindActorsLinear(const char *name, const char *const *names, Actor *const *actors, const size_t count)
+{
+	List found;
+	ListInit(found, LIST_POINTER);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (strcmp(names[i], name) == 0)
+		{
+			ListAdd(found, actors[i]);
+		}
+	}
+	const size_t foundCount = found.length;
+	ListFree(found);
+	return foundCount;
+}
+
+static void LogBenchmarkTime(const char *name, const uint64_t timeNs, const size_t ticks, const size_t operations)
+{
+	LogInfo("  %-22s %10.3f ms/tick %10.1f ns/op\n",
+			name,
+			(double)timeNs / (double)ticks / 1000000.0,
+			(double)timeNs / (double)(ticks * operations));
+}
+
+/**
+ * Fill a scratch map with named actors that each fire an output at the next name every tick, and log how long the
+ * outputs and the name lookups behind them take. Actors are named in pairs, so every output has two targets.
+ * @param actorCount The number of actors
+ * @param ticks The number of ticks to run
+ * @return Whether the benchmark ran
+ */
+static bool BenchmarkActorIo(const size_t actorCount, const size_t ticks)
+{
+	if (actorCount < 2 || ticks == 0)
+	{
+		LogError("The actor I/O benchmark needs at least 2 actors and 1 tick\n");
+		return false;
+	}
+	RegisterDefaultActorInputs(&benchmarkActorDefinition);
+	benchmarkFireOutput = RegisterActorOutput(&benchmarkActorDefinition, BENCHMARK_OUTPUT);
+	RegisterActorInput(&benchmarkActorDefinition, BENCHMARK_INPUT, BenchmarkActorReceiveHandler);
+	RegisterActor(BENCHMARK_ACTOR_NAME, &benchmarkActorDefinition);
+
+	Map *map = CreateMap();
+	GetState()->map = map;
+
+	const size_t nameCount = actorCount / 2;
+	Actor **actors = malloc(sizeof(Actor *) * actorCount);
+	CheckAlloc(actors);
+	const char **names = malloc(sizeof(char *) * actorCount);
+	CheckAlloc(names);
+	for (size_t i = 0; i < actorCount; i++)
+	{
+		Transform transform = {.rotation = JPH_Quat_Identity};
+		Actor *actor = CreateActor(&transform, BENCHMARK_ACTOR_NAME, NULL, NULL);
+		ActorConnection *connection = MapArenaAllocFreeable(NULL, sizeof(ActorConnection));
+		connection->sourceActorOutput = Intern(BENCHMARK_OUTPUT);
+		connection->targetActorInput = Intern(BENCHMARK_INPUT);
+		connection->targetActorName = GetBenchmarkActorName(((i / 2) + 1) % nameCount);
+		connection->outParamOverride.type = PARAM_TYPE_NONE;
+		ListAdd(actor->ioConnections, connection);
+		InvalidateActorOutputLinks(actor);
+
+		names[i] = AtomString(GetBenchmarkActorName((i / 2) % nameCount));
+		NameActor(actor, names[i], map);
+		AddActorToMap(actor, map);
+		actors[i] = actor;
+	}
+
+	uint64_t start = GetTimeNs();
+	for (size_t i = 0; i < actorCount; i++)
+	{
+		LinkActorOutputs(actors[i], map);
+	}
+	const uint64_t linkTime = GetTimeNs() - start;
+
+	inputsReceived = 0;
+	const int relinksBefore = SDL_GetAtomicInt(&map->ioRelinkCount);
+	uint64_t fireTime = 0;
+	uint64_t dispatchTime = 0;
+	for (size_t tick = 0; tick < ticks; tick++)
+	{
+		start = GetTimeNs();
+		for (size_t i = 0; i < actorCount; i++)
+		{
+			ActorFireOutputId(actors[i], benchmarkFireOutput, PARAM_NONE);
+		}
+		const uint64_t dispatchStart = GetTimeNs();
+		fireTime += dispatchStart - start;
+		DispatchActorInputs(map, SIZE_MAX);
+		dispatchTime += GetTimeNs() - dispatchStart;
+	}
+	const int relinks = SDL_GetAtomicInt(&map->ioRelinkCount) - relinksBefore;
+
+	size_t indexedFound = 0;
+	start = GetTimeNs();
+	for (size_t tick = 0; tick < ticks; tick++)
+	{
+		for (size_t i = 0; i < actorCount; i++)
+		{
+			const ActorConnection *connection = ListGetPointer(actors[i]->ioConnections, 0);
+			NamedActorIterator iterator;
+			IterateActorsByName(AtomString(connection->targetActorName), map, &iterator);
+			while (NextActorByName(&iterator) != NULL)
+			{
+				indexedFound++;
+			}
+		}
+	}
+	const uint64_t indexedTime = GetTimeNs() - start;
+
+	const size_t linearTicks = ticks < MAX_LINEAR_SCAN_TICKS ? ticks : MAX_LINEAR_SCAN_TICKS;
+	size_t linearFound = 0;
+	start = GetTimeNs();
+	for (size_t tick = 0; tick < linearTicks; tick++)
+	{
+		for (size_t i = 0; i < actorCount; i++)
+		{
+			const ActorConnection *connection = ListGetPointer(actors[i]->ioConnections, 0);
+			linearFound += FindActorsLinear(AtomString(connection->targetActorName), names, actors, actorCount);
+		}
+	}
+	const uint64_t linearTime = GetTimeNs() - start;
+
+	LogInfo("Actor I/O benchmark (%zu actor(s) in %zu name(s), %zu tick(s), %zu input(s) received):\n",
+			actorCount,
+			nameCount,
+			ticks,
+			inputsReceived);
+	LogBenchmarkTime("Link outputs", linkTime, 1, actorCount);
+	LogBenchmarkTime("Fire outputs", fireTime, ticks, actorCount);
+	LogBenchmarkTime("Dispatch inputs", dispatchTime, ticks, actorCount);
+	LogBenchmarkTime("Indexed lookup", indexedTime, ticks, actorCount);
+	LogBenchmarkTime("Linear scan lookup", linearTime, linearTicks, actorCount);
+	if (relinks > 0)
+	{
+		LogWarning("Actors rebuilt their output links %d time(s) while firing, which should not happen\n", relinks);
+	}
+	if (indexedFound / ticks != linearFound / linearTicks)
+	{
+		LogWarning("The indexed lookup found %zu actor(s) per tick, but the linear scan found %zu\n",
+				   indexedFound / ticks,
+				   linearFound / linearTicks);
+	}
+
+	free(names);
+	free(actors);
+	GetState()->map = NULL;
+	DestroyMap(map);
+	return true;
+}
+
+#define POOL_BENCHMARK_ACTOR_NAME "actor_pool_benchmark"
+
+/// The most actors the list removal baseline runs with, since it is quadratic in the actor count
+#define MAX_LIST_REMOVAL_ACTORS 10000
+
+typedef struct PoolBenchmarkActorData
+{
+	Transform transform;
+	size_t spawnIndex;
+} PoolBenchmarkActorData;
+
+static size_t actorsSpawned = 0;
+
+static void PoolBenchmarkActorInit(Actor *this, const KvList /*params*/, Transform *transform)
+{
+	PoolBenchmarkActorData *data = ActorAllocExtraData(this, sizeof(PoolBenchmarkActorData));
+	data->transform = *transform;
+	data->spawnIndex = actorsSpawned;
+	actorsSpawned++;
+}
+
+static ActorDefinition poolBenchmarkActorDefinition = {
+	.Update = DefaultActorUpdate,
+	.OnPlayerContactAdded = DefaultActorOnPlayerContactAdded,
+	.OnPlayerContactPersisted = DefaultActorOnPlayerContactPersisted,
+	.OnPlayerContactRemoved = DefaultActorOnPlayerContactRemoved,
+	.RenderUi = DefaultActorRenderUi,
+	.Interact = DefaultActorInteract,
+	.Destroy = DefaultActorDestroy,
+	.Init = PoolBenchmarkActorInit,
+};
+
+/**
+ * Get the most memory the process has had resident, in KiB, or 0 if the platform can't tell
+ */
+static size_t GetPeakResidentKiB(void)
+{
+#ifdef __linux__
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+		return (size_t)usage.ru_maxrss;
+	}
+#endif
+	return 0;
+}
+
+/**
+ * Shuffle handles with a fixed seed, so that actors are removed from all over the actor list like they are in a game
+ */
+static void ShuffleHandles(ActorHandle *handles, const size_t count, uint64_t *seed)
+{
+	for (size_t i = count; i > 1; i--)
+	{
+		*seed ^= *seed << 13;
+		*seed ^= *seed >> 7;
+		*seed ^= *seed << 17;
+		const size_t j = *seed % i;
+		const ActorHandle handle = handles[i - 1];
+		handles[i - 1] = handles[j];
+		handles[j] = handle;
+	}
+}
+
+/**
+ * Remove handles from a list with a find and an ordered remove each, like actors were removed from their map before
+ * removing one moved the last actor into its place
+ */
+static uint64_t TimeListRemoval(ActorHandle *handles, const size_t count, uint64_t *seed)
+{
+	List list;
+	ListInit(list, LIST_UINT64);
+	for (size_t i = 0; i < count; i++)
+	{
+		ListAdd(list, handles[i]);
+	}
+	ShuffleHandles(handles, count, seed);
+	const uint64_t start = GetTimeNs();
+	for (size_t i = 0; i < count; i++)
+	{
+		ListRemoveAt(list, ListFind(list, handles[i]));
+	}
+	const uint64_t time = GetTimeNs() - start;
+	ListFree(list);
+	return time;
+}
+
+static void LogBenchmarkThroughput(const char *name, const uint64_t timeNs, const size_t operations)
+{
+	LogInfo("  %-22s %12.0f actors/s %10.1f ns/actor\n",
+			name,
+			(double)operations / ((double)timeNs / 1000000000.0),
+			(double)timeNs / (double)operations);
+}
+
+/**
+ * Spawn actors into a scratch map and remove them in a shuffled order, round after round, and log the spawn and removal
+ * throughput, the peak RSS of the process, and whether every handle to a removed actor was caught as stale
+ * @param actorCount The number of actors to spawn each round
+ * @param rounds The number of rounds to run
+ * @return Whether the benchmark ran
+ */
+static bool BenchmarkActorPool(const size_t actorCount, const size_t rounds)
+{
+	if (actorCount == 0 || actorCount > MAX_POOLED_ACTORS || rounds == 0)
+	{
+		LogError("The actor pool benchmark needs 1 to %u actors and at least 1 round\n", MAX_POOLED_ACTORS);
+		return false;
+	}
+	RegisterDefaultActorInputs(&poolBenchmarkActorDefinition);
+	RegisterActor(POOL_BENCHMARK_ACTOR_NAME, &poolBenchmarkActorDefinition);
+
+	Map *map = CreateMap();
+	GetState()->map = map;
+	const size_t residentBefore = GetPeakResidentKiB();
+
+	ActorHandle *handles = malloc(sizeof(ActorHandle) * actorCount);
+	CheckAlloc(handles);
+	uint64_t seed = 0x9e3779b97f4a7c15;
+	uint64_t spawnTime = 0;
+	uint64_t removeTime = 0;
+	size_t staleHandles = 0;
+	for (size_t round = 0; round < rounds; round++)
+	{
+		uint64_t start = GetTimeNs();
+		for (size_t i = 0; i < actorCount; i++)
+		{
+			Transform transform = {.rotation = JPH_Quat_Identity};
+			Actor *actor = CreateActor(&transform, POOL_BENCHMARK_ACTOR_NAME, NULL, NULL);
+			AddActorToMap(actor, map);
+			handles[i] = actor->handle;
+		}
+		spawnTime += GetTimeNs() - start;
+
+		ShuffleHandles(handles, actorCount, &seed);
+		start = GetTimeNs();
+		for (size_t i = 0; i < actorCount; i++)
+		{
+			RemoveActor(GetActorFromHandle(handles[i]));
+		}
+		removeTime += GetTimeNs() - start;
+
+		// Every slot was reused or freed, so every handle from this round must be stale now
+		for (size_t i = 0; i < actorCount; i++)
+		{
+			staleHandles += GetActorFromHandle(handles[i]) == NULL ? 1 : 0;
+		}
+	}
+
+	const size_t baselineCount = actorCount < MAX_LIST_REMOVAL_ACTORS ? actorCount : MAX_LIST_REMOVAL_ACTORS;
+	const uint64_t listRemovalTime = TimeListRemoval(handles, baselineCount, &seed);
+
+	ActorPoolStats stats;
+	GetActorPoolStats(&stats);
+	const size_t residentAfter = GetPeakResidentKiB();
+
+	LogInfo("Actor pool benchmark (%zu actor(s), %zu round(s)):\n", actorCount, rounds);
+	LogBenchmarkThroughput("Spawn", spawnTime, actorCount * rounds);
+	LogBenchmarkThroughput("Remove", removeTime, actorCount * rounds);
+	LogBenchmarkThroughput("List removal baseline", listRemovalTime, baselineCount);
+	LogInfo("  Pool: %zu peak actor(s) in %zu slab(s), %zu KiB reserved\n",
+			stats.peakActors,
+			stats.slabCount,
+			stats.bytesReserved / 1024);
+	if (residentAfter != 0)
+	{
+		LogInfo("  Peak RSS: %zu KiB (%zu KiB before spawning)\n", residentAfter, residentBefore);
+	} else
+	{
+		LogInfo("  Peak RSS: not available on this platform\n");
+	}
+	LogInfo("  Stale handles caught: %zu/%zu\n", staleHandles, actorCount * rounds);
+	if (staleHandles != actorCount * rounds)
+	{
+		LogWarning("%zu handle(s) still resolved after their actor was removed\n", actorCount * rounds - staleHandles);
+	}
+	if (map->actors.length != 0)
+	{
+		LogWarning("%zu actor(s) were left in the map after removing every actor\n", map->actors.length);
+	}
+
+	free(handles);
+	GetState()->map = NULL;
+	DestroyMap(map);
+	return true;
+}
+
+static void RegisterNoGameActors() {}
+
+int main(const int argc, const char *argv[])
+{
+	ExecPathInit(argc, argv);
+	InitArguments(argc, argv);
+	LoadGameConfig(GetCliArgStr("--game", "assets/game"));
+	InitTimers();
+
+	PhysicsInitGlobal(GetState());
+	InitState();
+	// Only the engine's actors, the benchmarks register their own
+	RegisterActors(RegisterNoGameActors);
+
+	// One benchmark per process, so that the peak RSS of the pool benchmark only includes the pool
+	const char *benchmark = GetCliArgStr("--benchmark", "io");
+	bool success = false;
+	if (strcmp(benchmark, "io") == 0)
+	{
+		const int actors = GetCliArgInt("--actors", DEFAULT_ACTOR_IO_BENCHMARK_ACTORS);
+		const int ticks = GetCliArgInt("--iterations", DEFAULT_ACTOR_IO_BENCHMARK_TICKS);
+		success = BenchmarkActorIo(actors > 0 ? (size_t)actors : 0, ticks > 0 ? (size_t)ticks : 0);
+	} else if (strcmp(benchmark, "pool") == 0)
+	{
+		const int actors = GetCliArgInt("--actors", DEFAULT_ACTOR_POOL_BENCHMARK_ACTORS);
+		const int rounds = GetCliArgInt("--iterations", DEFAULT_ACTOR_POOL_BENCHMARK_ROUNDS);
+		success = BenchmarkActorPool(actors > 0 ? (size_t)actors : 0, rounds > 0 ? (size_t)rounds : 0);
+	} else
+	{
+		LogError("Unknown benchmark \"%s\", expected io or pool\n", benchmark);
+	}
+
+	DestroyActorDefinitions();
+	DestroyActorPool();
+	PhysicsDestroyGlobal(GetState());
+	DestroyGameConfig();
+	DestroyAtoms();
+	return success ? 0 : 1;
+}
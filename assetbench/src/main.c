@@ -0,0 +1,347 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/assets/AssetIndex.h>
+#include <engine/assets/AssetReader.h>
+#include <engine/assets/DataReader.h>
+#include <engine/assets/FontLoader.h>
+#include <engine/assets/GameConfigLoader.h>
+#include <engine/assets/MapLoader.h>
+#include <engine/assets/MapMaterialLoader.h>
+#include <engine/assets/ModelLoader.h>
+#include <engine/assets/TextureLoader.h>
+#include <engine/Engine.h>
+#include <engine/helpers/Arguments.h>
+#include <engine/structs/Asset.h>
+#include <engine/structs/KVList.h>
+#include <engine/structs/List.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/threads/WorkerPool.h>
+#include <engine/subsystem/Timing.h>
+#include <joltc/joltc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// How many times every asset is loaded in each pass, unless overridden with --iterations
+#define DEFAULT_ITERATIONS 5
+
+/// Stored as the duration of a load that failed
+#define LOAD_FAILED UINT64_MAX
+
+typedef bool (*AssetBenchLoadFunction)(const char *relPath);
+
+typedef struct AssetBenchType AssetBenchType;
+typedef struct BenchAsset BenchAsset;
+typedef struct BenchPass BenchPass;
+
+struct AssetBenchType
+{
+	/// The file extension of this asset type, including the dot
+	const char *extension;
+	/// Load, parse and free an asset of this type
+	AssetBenchLoadFunction Load;
+};
+
+struct BenchAsset
+{
+	/// The asset path, relative to the asset paths
+	char *path;
+	const AssetBenchType *type;
+	/// The decompressed size of the asset
+	size_t size;
+};
+
+struct BenchPass
+{
+	const List *assets;
+	/// The time each load took in nanoseconds, indexed by iteration * asset count + asset index
+	uint64_t *durations;
+	/// The iteration that is currently running
+	size_t iteration;
+};
+
+static bool LoadBenchTexture(const char *relPath)
+{
+	Asset *asset = LoadAsset(relPath, false, false);
+	Image image;
+	const bool success = LoadImageFromAsset(asset, &image);
+	if (success)
+	{
+		free(image.pixelDataBuffer);
+	}
+	FreeAsset(asset);
+	return success;
+}
+
+static bool LoadBenchModel(const char *relPath)
+{
+	ModelDefinition *model = LoadModelInternal(relPath);
+	FreeModel(model);
+	return model != NULL;
+}
+
+static bool LoadBenchMapMaterial(const char *relPath)
+{
+	MapMaterial *material = LoadMapMaterialInternal(relPath);
+	FreeMapMaterial(material);
+	return material != NULL;
+}
+
+static bool LoadBenchFont(const char *relPath)
+{
+	Font *font = LoadFontInternal(relPath);
+	FreeFont(font);
+	return font != NULL;
+}
+
+static bool LoadBenchKvList(const char *relPath)
+{
+	Asset *asset = LoadAsset(relPath, false, false);
+	if (asset == NULL || asset->type != ASSET_TYPE_KV_LIST)
+	{
+		FreeAsset(asset);
+		return false;
+	}
+	DataReader *reader = CreateDataReaderFromAsset(asset);
+	KvList list;
+	ReadKvList(reader, list);
+	KvListDestroy(list);
+	DestroyDataReader(reader);
+	FreeAsset(asset);
+	return true;
+}
+
+static bool LoadBenchMap(const char *relPath)
+{
+	Asset *asset = LoadAsset(relPath, false, false);
+	if (asset == NULL || asset->type != ASSET_TYPE_MAP)
+	{
+		FreeAsset(asset);
+		return false;
+	}
+	return ParseMapHeadless(asset);
+}
+
+static const AssetBenchType assetTypes[] = {
+	{".gtex", LoadBenchTexture},
+	{".gmdl", LoadBenchModel},
+	{".gmtl", LoadBenchMapMaterial},
+	{".gfon", LoadBenchFont},
+	{".gkvl", LoadBenchKvList},
+	{".gmap", LoadBenchMap},
+};
+#define ASSET_TYPE_COUNT (sizeof(assetTypes) / sizeof(*assetTypes))
+
+/**
+ * Find every asset of a supported type, and load each of them once to warm up the disk and material caches
+ * @param assets A @c LIST_POINTER list to append the found @c BenchAsset structs to
+ */
+static void FindBenchAssets(List *assets)
+{
+	for (size_t i = 0; i < ASSET_TYPE_COUNT; i++)
+	{
+		const AssetBenchType *type = &assetTypes[i];
+		List names;
+		ListInit(names, LIST_POINTER);
+		EnumerateIndexedAssets("", type->extension, true, &names);
+		for (size_t j = 0; j < names.length; j++)
+		{
+			char *name = ListGetPointer(names, j);
+			BenchAsset *asset = malloc(sizeof(BenchAsset));
+			CheckAlloc(asset);
+			asset->path = malloc(strlen(name) + strlen(type->extension) + 1);
+			CheckAlloc(asset->path);
+			sprintf(asset->path, "%s%s", name, type->extension);
+			asset->type = type;
+
+			Asset *assetData = LoadAsset(asset->path, false, false);
+			asset->size = assetData ? assetData->size : 0;
+			FreeAsset(assetData);
+			if (assetData == NULL || !type->Load(asset->path))
+			{
+				LogWarning("Skipping asset %s, since it failed to load\n", asset->path);
+				free(asset->path);
+				free(asset);
+				continue;
+			}
+			ListAdd(*assets, asset);
+		}
+		ListAndContentsFree(names);
+	}
+}
+
+static void RunBenchLoad(const size_t index, void *userData)
+{
+	const BenchPass *pass = userData;
+	const BenchAsset *asset = ListGetPointer(*pass->assets, index);
+	const uint64_t start = GetTimeNs();
+	const bool success = asset->type->Load(asset->path);
+	pass->durations[(pass->iteration * pass->assets->length) + index] = success ? GetTimeNs() - start : LOAD_FAILED;
+}
+
+static int CompareDurations(const void *a, const void *b)
+{
+	const uint64_t durationA = *(const uint64_t *)a;
+	const uint64_t durationB = *(const uint64_t *)b;
+	return (durationA > durationB) - (durationA < durationB);
+}
+
+/**
+ * Get a percentile from a sorted array of durations, in milliseconds
+ */
+static double GetPercentile(const uint64_t *sortedDurations, const size_t count, const size_t percentile)
+{
+	return (double)sortedDurations[((count - 1) * percentile) / 100] / 1000000.0;
+}
+
+/**
+ * Log the throughput of a pass and the load latency of each asset type
+ */
+static void LogBenchPass(const char *name, const BenchPass *pass, const size_t iterations, const uint64_t passTime)
+{
+	const List *assets = pass->assets;
+	uint64_t *typeDurations = malloc(sizeof(uint64_t) * assets->length * iterations);
+	CheckAlloc(typeDurations);
+	size_t totalBytes = 0;
+	size_t failures = 0;
+
+	LogInfo("%s: %zu asset(s) x %zu iteration(s) in %.3f ms\n",
+			name,
+			assets->length,
+			iterations,
+			(double)passTime / 1000000.0);
+	LogInfo("  %-6s %6s %10s %10s %10s %10s %10s\n", "type", "count", "MB", "p50 ms", "p90 ms", "p99 ms", "max ms");
+	for (size_t i = 0; i < ASSET_TYPE_COUNT; i++)
+	{
+		size_t count = 0;
+		size_t bytes = 0;
+		for (size_t j = 0; j < assets->length; j++)
+		{
+			const BenchAsset *asset = ListGetPointer(*assets, j);
+			if (asset->type != &assetTypes[i])
+			{
+				continue;
+			}
+			for (size_t k = 0; k < iterations; k++)
+			{
+				const uint64_t duration = pass->durations[(k * assets->length) + j];
+				if (duration == LOAD_FAILED)
+				{
+					failures++;
+					continue;
+				}
+				typeDurations[count] = duration;
+				count++;
+				bytes += asset->size;
+			}
+		}
+		totalBytes += bytes;
+		if (count == 0)
+		{
+			continue;
+		}
+		qsort(typeDurations, count, sizeof(uint64_t), CompareDurations);
+		LogInfo("  %-6s %6zu %10.2f %10.3f %10.3f %10.3f %10.3f\n",
+				assetTypes[i].extension,
+				count / iterations,
+				(double)bytes / iterations / (1024.0 * 1024.0),
+				GetPercentile(typeDurations, count, 50),
+				GetPercentile(typeDurations, count, 90),
+				GetPercentile(typeDurations, count, 99),
+				(double)typeDurations[count - 1] / 1000000.0);
+	}
+	LogInfo("  Throughput: %.1f MB/s (decompressed)\n",
+			passTime ? ((double)totalBytes / (1024.0 * 1024.0)) / ((double)passTime / 1000000000.0) : 0.0);
+	if (failures > 0)
+	{
+		LogWarning("  %zu load(s) failed\n", failures);
+	}
+	free(typeDurations);
+}
+
+/**
+ * Load every asset a number of times and log the results
+ * @param multiThreaded Whether to spread the loads over the worker pool
+ */
+static void RunBenchPass(const List *assets, const size_t iterations, const bool multiThreaded)
+{
+	BenchPass pass = {
+		.assets = assets,
+		.durations = malloc(sizeof(uint64_t) * assets->length * iterations),
+	};
+	CheckAlloc(pass.durations);
+
+	const uint64_t start = GetTimeNs();
+	for (pass.iteration = 0; pass.iteration < iterations; pass.iteration++)
+	{
+		if (multiThreaded)
+		{
+			ParallelFor(assets->length, RunBenchLoad, &pass);
+		} else
+		{
+			for (size_t i = 0; i < assets->length; i++)
+			{
+				RunBenchLoad(i, &pass);
+			}
+		}
+	}
+	const uint64_t passTime = GetTimeNs() - start;
+
+	char name[64];
+	if (multiThreaded)
+	{
+		snprintf(name, sizeof(name), "Multi-threaded (%zu threads)", GetWorkerPoolThreadCount());
+	} else
+	{
+		snprintf(name, sizeof(name), "Single-threaded");
+	}
+	LogBenchPass(name, &pass, iterations, passTime);
+	free(pass.durations);
+}
+
+int main(const int argc, const char *argv[])
+{
+	ExecPathInit(argc, argv);
+	InitArguments(argc, argv);
+	LoadGameConfig(GetCliArgStr("--game", "assets/game"));
+	InitTimers();
+
+	JPH_Init();
+	WorkerPoolInit();
+	AssetCacheInit();
+
+	const int iterations = GetCliArgInt("--iterations", DEFAULT_ITERATIONS);
+
+	List assets;
+	ListInit(assets, LIST_POINTER);
+	FindBenchAssets(&assets);
+	if (assets.length == 0)
+	{
+		LogError("No assets were found in %s\n", gameConfig.gameTitle);
+	} else
+	{
+		LogInfo("Benchmarking %zu asset(s) from %s\n", assets.length, gameConfig.gameTitle);
+		RunBenchPass(&assets, iterations > 0 ? (size_t)iterations : 1, false);
+		RunBenchPass(&assets, iterations > 0 ? (size_t)iterations : 1, true);
+	}
+
+	for (size_t i = 0; i < assets.length; i++)
+	{
+		const BenchAsset *asset = ListGetPointer(assets, i);
+		free(asset->path);
+	}
+	const bool foundAssets = assets.length > 0;
+	ListAndContentsFree(assets);
+
+	DestroyAssetCache();
+	DestroyGameConfig();
+	WorkerPoolDestroy();
+	JPH_Shutdown();
+	return foundAssets ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/assets/AssetReader.h>
+#include <engine/assets/PackFile.h>
+#include <engine/Engine.h>
+#include <engine/helpers/Arguments.h>
+#include <engine/structs/Atom.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/threads/WorkerPool.h>
+#include <joltc/joltc.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+static void PrintUsage(void)
+{
+	LogInfo("Usage:\n");
+	LogInfo("  assettool --pack=<directory> --output=<file.gpak>\n");
+	LogInfo("    Pack every file in a directory into a pack file, which is loaded when placed in an asset path\n");
+	LogInfo("  assettool --repack=<asset> [--output=<asset>]\n");
+	LogInfo("    Re-compress an asset with the current asset format, upgrading maps to the newest map format.\n");
+	LogInfo("    The asset is replaced if no output is given.\n");
+}
+
+/**
+ * Run @c RepackAssetFile, with the parts of the engine a map upgrade needs to build its collision
+ */
+static bool RepackAsset(const char *input, const char *output)
+{
+	JPH_Init();
+	WorkerPoolInit();
+	const bool success = RepackAssetFile(input, output);
+	WorkerPoolDestroy();
+	JPH_Shutdown();
+	DestroyAtoms();
+	return success;
+}
+
+int main(const int argc, const char *argv[])
+{
+	ExecPathInit(argc, argv);
+	InitArguments(argc, argv);
+
+	const char *output = GetCliArgStr("--output", NULL);
+	const char *packDirectory = GetCliArgStr("--pack", NULL);
+	const char *repackAsset = GetCliArgStr("--repack", NULL);
+	if (packDirectory != NULL && output != NULL)
+	{
+		if (!WritePackFile(packDirectory, output))
+		{
+			LogError("Failed to pack %s into %s\n", packDirectory, output);
+			return 1;
+		}
+		LogInfo("Packed %s into %s\n", packDirectory, output);
+		return 0;
+	}
+	if (repackAsset != NULL)
+	{
+		if (output == NULL)
+		{
+			output = repackAsset;
+		}
+		if (!RepackAsset(repackAsset, output))
+		{
+			LogError("Failed to repack %s\n", repackAsset);
+			return 1;
+		}
+		LogInfo("Repacked %s into %s\n", repackAsset, output);
+		return 0;
+	}
+
+	PrintUsage();
+	return 1;
+}
@@ -0,0 +1,16 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_MAPCHUNK_H
+#define GAME_MAPCHUNK_H
+
+#include <engine/structs/ActorDefinition.h>
+
+extern ActorDefinition mapChunkActorDefinition;
+
+#define MAP_CHUNK_ACTOR_NAME "map_chunk"
+
+void RegisterMapChunkActor();
+
+#endif //GAME_MAPCHUNK_H
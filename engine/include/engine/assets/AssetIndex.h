@@ -0,0 +1,61 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_ASSETINDEX_H
+#define GAME_ASSETINDEX_H
+
+#include <engine/assets/GameConfigLoader.h>
+#include <engine/structs/List.h>
+#include <stdbool.h>
+
+/**
+ * Scan every asset path (loose files and mounted packs) into the asset index.
+ * Mounted packs must already be mounted.
+ */
+void InitAssetIndex();
+
+/**
+ * Free the asset index
+ */
+void DestroyAssetIndex();
+
+/**
+ * Bring the asset index up to date with the current asset paths.
+ * Only asset paths that were added since the last scan are scanned, removed ones are dropped without touching the disk.
+ * Does nothing if the index has not been initialized.
+ */
+void RefreshAssetIndex();
+
+/**
+ * Add files that appeared in an asset path after it was scanned to the asset index
+ * @param root The directory of the asset path the files are in
+ * @param relPath The file relative to root, or a directory to add every file in it and its subfolders
+ * @note This must be called from the main thread.
+ */
+void AddPathToAssetIndex(const char *root, const char *relPath);
+
+/**
+ * Look up which asset path an asset should be loaded from
+ * @param relPath The path of the asset, relative to the asset paths
+ * @param isCodeAsset Whether to only consider asset paths with @c ASSET_PATH_ALLOW_CODE_EXECUTION
+ * @param assetPath Where to store the highest priority asset path containing the asset
+ * @param packed Where to store whether the asset is in one of that asset path's packs
+ * @return Whether the asset is in the index
+ * @note This is safe to call from any thread.
+ */
+bool FindIndexedAsset(const char *relPath, bool isCodeAsset, const AssetPath **assetPath, bool *packed);
+
+/**
+ * Get the names of all indexed assets in a folder, across all asset paths
+ * @param folder The folder to enumerate, relative to the asset paths, or an empty string for the root
+ * @param extension Only list assets with this extension
+ * @param recursive Whether to also list the assets in the folder's subfolders
+ * @param output A @c LIST_POINTER list to append the asset names to, relative to the folder and without the extension.
+ *				 These must be freed.
+ */
+void EnumerateIndexedAssets(const char *folder, const char *extension, bool recursive, List *output);
+
+void DPrintAssetIndex();
+
+#endif //GAME_ASSETINDEX_H
@@ -0,0 +1,73 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_ASSETMANIFEST_H
+#define GAME_ASSETMANIFEST_H
+
+#include <engine/assets/AsyncAssetLoader.h>
+#include <engine/structs/List.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ASSET_MANIFEST_EXTENSION ".gmanifest"
+#define MANIFEST(assetName) ("map/" assetName ASSET_MANIFEST_EXTENSION)
+
+/// The maximum length of the asset path of a map manifest
+#define MAX_MANIFEST_PATH_LENGTH 256
+
+/// How long to keep recording the assets a map uses after it has finished loading
+#define DEFAULT_MANIFEST_RECORD_SECONDS 30
+
+/**
+ * Set up the manifest recorder
+ */
+void InitAssetManifestRecorder();
+
+/**
+ * Finish any recording that is still running and free the manifest recorder
+ */
+void DestroyAssetManifestRecorder();
+
+/**
+ * Start recording the assets loaded for a map, finishing any previous recording.
+ * Nothing is recorded if the map already has a manifest, unless @c --record-manifests was passed.
+ * @param mapName The name of the map that is being loaded
+ */
+void StartMapManifestRecording(const char *mapName);
+
+/**
+ * Start the play time window of the current recording, once the map has finished loading.
+ * The recording is finished @c --manifest-record-seconds (@c DEFAULT_MANIFEST_RECORD_SECONDS by default) later.
+ */
+void StartMapManifestPlayWindow();
+
+/**
+ * Finish the current recording once its play time window is over. Called once per frame by the engine.
+ */
+void UpdateMapManifestRecording();
+
+/**
+ * Stop recording and write the manifest next to the map file. Maps that are in a pack are not written.
+ */
+void FinishMapManifestRecording();
+
+/**
+ * Add an asset to the current recording
+ * @param relPath The asset that was loaded
+ * @param isCodeAsset Whether the asset is considered code. Code assets are never recorded.
+ * @note This is safe to call from any thread.
+ */
+void RecordManifestAsset(const char *relPath, bool isCodeAsset);
+
+/**
+ * Start prefetching every asset in a map's manifest on the asset loader threads
+ * @param mapName The name of the map
+ * @param callback Called once for every prefetched asset. The asset stays in the cache once the callback returns.
+ * @param userData Passed to the callback
+ * @param tickets A @c LIST_UINT32 list to append the ticket of each prefetch to
+ * @return The number of prefetches that were started
+ */
+size_t PrefetchMapManifest(const char *mapName, AssetLoadCallback callback, void *userData, List *tickets);
+
+#endif //GAME_ASSETMANIFEST_H
@@ -12,9 +12,15 @@
 #include <stddef.h>
 #include <stdio.h>
 
-#define ASSET_FORMAT_VERSION 2
+#define ASSET_FORMAT_VERSION 3
+/// The previous asset format version, which stores the payload as a single gzip stream. This can still be read.
+#define ASSET_FORMAT_VERSION_SINGLE_STREAM 2
 #define ASSET_FORMAT_MAGIC 0x454D4147
 #define ASSET_HEADER_SIZE (sizeof(uint32_t) + (sizeof(uint8_t) * 3) + (sizeof(size_t) * 2))
+/// The default size of the independently compressed chunks of a version 3 asset, before compression
+#define ASSET_CHUNK_SIZE (256 * 1024)
+/// The size of the chunk table header of a version 3 asset (chunk size and chunk count)
+#define ASSET_CHUNK_TABLE_HEADER_SIZE (sizeof(uint32_t) * 2)
 
 /**
  * Prints an error and returns NULL if there are not enough bytes remaining to read
@@ -54,7 +60,7 @@ void DestroyAssetCache();
 
 /**
  * Get a list of all assets of a certain type that are in a folder, across all asset paths
- * @param folder The folder to recursively enumerate the assets of
+ * @param folder The folder to enumerate the assets of, not including its subfolders
  * @param output Where to store the list of assets
  * @param extension Asset file extension to search for
  */
@@ -73,23 +79,114 @@ Asset *LoadAssetFromFile(FILE *file);
  * @param cache Whether the asset should be cached
  * @param isCodeAsset Whether the asset is considered code, when true it will not search asset paths without @c ASSET_PATH_ALLOW_CODE_EXECUTION set
  * @return Decompressed asset, including header
- * @warning If the asset is not cached, you will have to pass it to @c FreeAsset. Otherwise,
- * it is kept around until program exit and automatically freed.
+ * @warning If the asset is not cached, you will have to pass it to @c FreeAsset. Otherwise, it is owned by the cache
+ * and may be evicted by any later cached load once the cache is over budget. Use @c LoadAssetPinned to keep a cached
+ * asset around for longer than the current frame.
+ * @note This is safe to call from any thread. See @c LoadAssetAsync to load without blocking.
  */
 Asset *LoadAsset(const char *relPath, bool cache, bool isCodeAsset);
 
 /**
- * Remove an asset from the cache
- * @param relPath The asset to decompress
- * @note Any pointers to this asset will become invalid.
+ * Load an asset into the cache and pin it, so that it will not be evicted until it is unpinned
+ * @param relPath The asset to load
+ * @param isCodeAsset Whether the asset is considered code, see @c LoadAsset
+ * @return The cached asset, or NULL on failure
+ * @note Every successful call must be matched with a call to @c UnpinAsset
+ */
+Asset *LoadAssetPinned(const char *relPath, bool isCodeAsset);
+
+/**
+ * Load an asset into the cache ahead of time, so that the first real load of it does not have to touch the disk.
+ * Unlike other cached assets, a prefetched asset is handed over to the first uncached @c LoadAsset of it instead of
+ * being loaded again.
+ * @param relPath The asset to load
+ * @param isCodeAsset Whether the asset is considered code, see @c LoadAsset
+ * @return The cached asset, pinned like @c LoadAssetPinned, or NULL on failure
+ */
+Asset *PrefetchAsset(const char *relPath, bool isCodeAsset);
+
+/**
+ * Unpin an asset pinned by @c LoadAssetPinned, allowing it to be evicted again
+ * @param asset The asset returned by @c LoadAssetPinned or @c PrefetchAsset, which is freed here if it was removed
+ *				from the cache while pinned
+ */
+void UnpinAsset(const Asset *asset);
+
+/**
+ * Set the number of bytes the primary asset cache may hold, evicting assets if it is now over budget
+ * @param budget The budget in bytes, or 0 for no limit
+ */
+void SetAssetCacheBudget(size_t budget);
+
+/**
+ * Read the raw (still compressed) file of an asset, from either a loose file or a pack
+ * @param relPath The asset to read
+ * @param isCodeAsset Whether the asset is considered code, see @c LoadAsset
+ * @param size Where to store the size of the file
+ * @return The file data, which must be freed, or NULL on failure
+ */
+uint8_t *LoadAssetFileData(const char *relPath, bool isCodeAsset, size_t *size);
+
+/**
+ * Check whether an asset exists in any asset path, without loading it
+ * @param relPath The asset to look for
+ * @param isCodeAsset Whether the asset is considered code, see @c LoadAsset
+ */
+bool AssetExists(const char *relPath, bool isCodeAsset);
+
+/**
+ * Get the path of the loose file an asset would be loaded from
+ * @param relPath The asset to look for
+ * @return The full path of the file, which must be freed, or NULL if the asset does not exist or is in a pack
+ */
+char *GetLooseAssetPath(const char *relPath);
+
+/**
+ * Check whether an asset path ends with a file extension
+ * @param relPath The asset path to check
+ * @param extension The extension, including the dot
+ */
+bool HasAssetExtension(const char *relPath, const char *extension);
+
+/**
+ * Remove an asset from the cache. A pinned asset stays valid until it is unpinned, while the next load of it reads the
+ * asset again.
+ * @param relPath The asset to remove
+ * @note Any pointers to this asset that are not pinned will become invalid.
  */
 void RemoveAssetFromCache(const char *relPath);
 
+/**
+ * Reload a single asset after it changed on disk. Textures, models and map materials are updated in place and
+ * uploaded again, anything else is dropped from the asset cache so that it is read again the next time it is loaded.
+ * This is safe to call while a map is loaded, but only from the main thread.
+ * @param relPath The asset that changed
+ */
+void ReloadAsset(const char *relPath);
+
 /**
  * Hot reload all cached assets. Do not call while a map is loaded.
  */
 void HotReloadAssets();
 
+/**
+ * Decompress an asset file that is already in memory, in any supported asset format version
+ * @param assetData The asset file, including the header
+ * @param fileSize The size of the asset file
+ * @param dest The asset to decompress into
+ * @return Whether the asset was decompressed
+ */
+bool DecompressAssetData(const uint8_t *assetData, size_t fileSize, Asset *dest);
+
+/**
+ * Re-compress an asset file with the current asset format version. Maps are also upgraded to the newest map format.
+ * @param inputPath The asset file to read
+ * @param outputPath The asset file to write. This may be the same as inputPath.
+ * @return Whether the asset was repacked
+ * @note This is what the assettool --repack command runs.
+ */
+bool RepackAssetFile(const char *inputPath, const char *outputPath);
+
 void DPrintAssetReader();
 
 #define TEXTURE(assetName) ("texture/" assetName ".gtex")
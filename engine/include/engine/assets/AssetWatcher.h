@@ -0,0 +1,28 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_ASSETWATCHER_H
+#define GAME_ASSETWATCHER_H
+
+/// The size of the buffer inotify events are read into. Events that don't fit are read on the next pass.
+#define ASSET_WATCHER_BUFFER_SIZE 4096
+
+/**
+ * Start watching the loose files of every asset path for changes if @c --watch-assets was passed.
+ * Only supported on Linux, since it uses inotify.
+ */
+void InitAssetWatcher();
+
+/**
+ * Reload every asset that was written since the last call, with @c ReloadAsset.
+ * Must be called on the main thread.
+ */
+void PollAssetWatcher();
+
+/**
+ * Stop watching the asset paths
+ */
+void DestroyAssetWatcher();
+
+#endif //GAME_ASSETWATCHER_H
@@ -0,0 +1,86 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_ASYNCASSETLOADER_H
+#define GAME_ASYNCASSETLOADER_H
+
+#include <engine/structs/Asset.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Maximum number of I/O worker threads used for asynchronous asset loads
+#define MAX_ASSET_LOADER_THREADS 4
+
+/// A ticket that is never returned by @c LoadAssetAsync
+#define ASSET_LOAD_TICKET_INVALID 0
+
+typedef uint32_t AssetLoadTicket;
+
+typedef enum AssetLoadFlags AssetLoadFlags;
+
+enum AssetLoadFlags
+{
+	ASSET_LOAD_NONE = 0,
+	/// Insert the loaded asset into the asset cache, see @c LoadAsset
+	ASSET_LOAD_CACHE = 1 << 0,
+	/// The asset is considered code, see @c LoadAsset
+	ASSET_LOAD_CODE = 1 << 1,
+	/// Load the asset with @c PrefetchAsset, implies @c ASSET_LOAD_CACHE
+	ASSET_LOAD_PREFETCH = 1 << 2,
+};
+
+/**
+ * Called on the main thread once an asynchronous asset load has finished
+ * @param ticket The ticket returned by @c LoadAssetAsync
+ * @param asset The loaded asset, or NULL on failure. If the load was not cached, the callback owns the asset and must
+ *				pass it to @c FreeAsset. Cached assets are only pinned until the callback returns.
+ * @param userData The user data passed to @c LoadAssetAsync
+ */
+typedef void (*AssetLoadCallback)(AssetLoadTicket ticket, Asset *asset, void *userData);
+
+/**
+ * Start the asset loader worker threads
+ */
+void InitAsyncAssetLoader();
+
+/**
+ * Cancel all loads and stop the asset loader worker threads
+ */
+void DestroyAsyncAssetLoader();
+
+/**
+ * Load an asset on an I/O worker thread
+ * @param relPath The asset to load
+ * @param flags Flags controlling how the asset is loaded
+ * @param callback The function to call on the main thread once the load has finished
+ * @param userData Passed to the callback
+ * @return A ticket that can be used to cancel the load
+ * @note The callback is always invoked from @c ProcessAssetLoadCallbacks, even if the asset was already cached.
+ */
+AssetLoadTicket LoadAssetAsync(const char *relPath, AssetLoadFlags flags, AssetLoadCallback callback, void *userData);
+
+/**
+ * Cancel an asynchronous asset load. Its callback will not be called.
+ * @param ticket The ticket of the load to cancel. Tickets that have already completed are ignored.
+ */
+void CancelAssetLoad(AssetLoadTicket ticket);
+
+/**
+ * Cancel all asynchronous asset loads and wait for any in-flight loads to finish. No callbacks will be called.
+ */
+void CancelAllAssetLoads();
+
+/**
+ * Invoke the callbacks of all finished asynchronous asset loads. Called once per frame by the engine.
+ */
+void ProcessAssetLoadCallbacks();
+
+/**
+ * Get the number of asynchronous asset loads that have not had their callback invoked yet
+ */
+size_t GetPendingAssetLoadCount();
+
+void DPrintAsyncAssetLoader();
+
+#endif //GAME_ASYNCASSETLOADER_H
@@ -0,0 +1,82 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_COOKEDASSETCACHE_H
+#define GAME_COOKEDASSETCACHE_H
+
+#include <engine/structs/Asset.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define COOKED_ASSET_MAGIC 0x444B4347 // "GCKD" in ASCII
+#define COOKED_ASSET_VERSION 1
+#define COOKED_ASSET_EXTENSION ".gcooked"
+
+/// The payload of a cooked asset starts at a multiple of this, so that it is page aligned when mapped
+#define COOKED_ASSET_PAYLOAD_ALIGNMENT 4096
+/// Assets smaller than this are not worth a separate file, decompressing them is about as fast as opening one
+#define COOKED_ASSET_MIN_SIZE (64 * 1024)
+/// The asset type stored for entries written with @c StoreCookedData, which are not assets
+#define COOKED_DATA_TYPE 0xFF
+/// The maximum number of bytes waiting to be written to the cache before new assets are skipped
+#define COOKED_ASSET_MAX_PENDING_BYTES (256 * 1024 * 1024)
+
+/**
+ * Find the cooked asset cache directory and start the background writer thread.
+ * Does nothing if the cache is disabled with @c --no-asset-cache.
+ */
+void InitCookedAssetCache();
+
+/**
+ * Stop the background writer thread. Cooked assets that have not been written yet are dropped.
+ */
+void DestroyCookedAssetCache();
+
+/**
+ * Load an already decompressed asset from the cooked asset cache
+ * @param sourcePath The loose asset file or pack the asset was found in
+ * @param relPath The path of the asset, relative to its asset path
+ * @param asset Where to store the asset
+ * @return Whether the asset was found in the cache and passed its integrity checks
+ * @note This is safe to call from any thread.
+ */
+bool LoadCookedAsset(const char *sourcePath, const char *relPath, Asset *asset);
+
+/**
+ * Queue a decompressed asset to be written to the cooked asset cache in the background
+ * @param sourcePath The loose asset file or pack the asset was found in
+ * @param relPath The path of the asset, relative to its asset path
+ * @param asset The decompressed asset. It is copied, so it may be freed right away.
+ * @note This is safe to call from any thread.
+ */
+void StoreCookedAsset(const char *sourcePath, const char *relPath, const Asset *asset);
+
+/**
+ * Check whether the cooked asset cache is in use, so that data that is only computed to be stored can be skipped
+ */
+bool IsCookedAssetCacheEnabled();
+
+/**
+ * Load data that was stored with @c StoreCookedData
+ * @param key The key the data was stored with
+ * @param size Where to store the size of the data
+ * @return The data (must be freed), or NULL if it was not found or failed its integrity checks
+ * @note This is safe to call from any thread.
+ */
+uint8_t *LoadCookedData(const char *key, size_t *size);
+
+/**
+ * Queue data that is expensive to compute to be written to the cooked asset cache in the background
+ * @param key Identifies the data. This must change whenever the data would, for example by including a hash of the
+ *			  input the data was computed from.
+ * @param data The data. It is copied, so it may be freed right away.
+ * @param size The size of the data
+ * @note This is safe to call from any thread.
+ */
+void StoreCookedData(const char *key, const uint8_t *data, size_t size);
+
+void DPrintCookedAssetCache();
+
+#endif //GAME_COOKEDASSETCACHE_H
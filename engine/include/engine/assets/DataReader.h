@@ -67,6 +67,43 @@ void ReadBuffer(DataReader *reader, size_t readSize, void *dest);
  */
 char *ReadStringSafe(DataReader *reader, size_t *outLength);
 
+/**
+ * Reads a length and string from the given data at the given offset without copying it
+ * @param reader The DataReader to read from
+ * @param outLength Where to write the length of the string read, including the null terminator
+ * @return A pointer into the reader's buffer, which is only valid as long as the buffer is, or NULL if the string is
+ *		   out of bounds or not null terminated
+ */
+const char *ReadStringView(DataReader *reader, size_t *outLength);
+
+/**
+ * Get a pointer to an array of elements in the reader's buffer and seek past it, without copying it
+ * @param reader The DataReader to read from
+ * @param elementSize The size of a single element
+ * @param count The number of elements
+ * @return A pointer into the reader's buffer, which is only valid as long as the buffer is
+ * @note The returned pointer is not guaranteed to be aligned for the element type, use memcpy or
+ *		 @c ReadStructArray if that matters
+ */
+const void *ReadSpan(DataReader *reader, size_t elementSize, size_t count);
+
+/**
+ * Reads an array of floats with a single bounds check
+ * @param reader The DataReader to read from
+ * @param count The number of floats to read
+ * @param dest The buffer to write the floats into, which must hold at least @c count floats
+ */
+void ReadFloatArray(DataReader *reader, size_t count, float *dest);
+
+/**
+ * Reads an array of tightly packed structs with a single bounds check
+ * @param reader The DataReader to read from
+ * @param elementSize The size of a single struct, which must match the size of the struct in the data
+ * @param count The number of structs to read
+ * @param dest The buffer to write the structs into
+ */
+void ReadStructArray(DataReader *reader, size_t elementSize, size_t count, void *dest);
+
 /**
  * Seek ahead in a DataReader without performing any reads
  * @param reader The DataReader to seek
@@ -79,6 +116,11 @@ void Seek(DataReader *reader, size_t bytes);
  */
 size_t DataReaderGetOffset(const DataReader *reader);
 
+/**
+ * Get the number of bytes left to read in a DataReader
+ */
+size_t DataReaderGetRemaining(const DataReader *reader);
+
 /**
  * Calculate a 16-bit checksum of a given data buffer
  * @param buffer The data to checksum
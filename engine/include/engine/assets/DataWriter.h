@@ -51,6 +51,22 @@ void WriteBuffer(DataWriter *writer, const void *buffer, size_t elementSize, siz
  */
 void WriteString(DataWriter *writer, const char *string);
 
+/**
+ * Write a complete asset file (header and compressed payload) in the current asset format version
+ * @param writer The DataWriter to write to
+ * @param type The type of the asset
+ * @param typeVersion The version of the asset type
+ * @param data The decompressed asset data
+ * @param size The size of the decompressed asset data
+ * @param chunkSize The size of each independently compressed chunk before compression, usually @c ASSET_CHUNK_SIZE
+ */
+void WriteCompressedAsset(DataWriter *writer,
+						  uint8_t type,
+						  uint8_t typeVersion,
+						  const uint8_t *data,
+						  size_t size,
+						  uint32_t chunkSize);
+
 #define DeclareWriteFunction(T, name) void name(DataWriter *writer, const T data)
 
 DeclareWriteFunction(int8_t, WriteInt8);
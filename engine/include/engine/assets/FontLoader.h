@@ -47,6 +47,14 @@ struct Font
 	float charEndUVs[255];
 };
 
+/**
+ * Load a font from an asset, without caching it
+ * @param asset The asset to load the font from
+ * @return The loaded font, or a fallback font if it failed
+ * @note This pointer is not tracked and must be freed with @c FreeFont. The font texture is still cached.
+ */
+Font *LoadFontInternal(const char *asset);
+
 /**
  * Load a font from an asset
  * @param asset The asset to load the font from
@@ -55,6 +63,11 @@ struct Font
  */
 Font *LoadFont(const char *asset);
 
+/**
+ * Free a font loaded with @c LoadFontInternal
+ */
+void FreeFont(Font *font);
+
 void DestroyFontLoader();
 
 void DPrintFontLoader();
@@ -7,6 +7,12 @@
 
 #include <engine/structs/List.h>
 #include <stddef.h>
+#include <stdint.h>
+
+/// The default size of the primary asset cache, in MiB
+#define DEFAULT_ASSET_CACHE_BUDGET_MB 256
+/// The default for @c GameConfig.actorIoChainDepthLimit
+#define DEFAULT_ACTOR_IO_CHAIN_DEPTH_LIMIT 64
 
 typedef struct GameConfig GameConfig;
 
@@ -56,6 +62,14 @@ struct GameConfig
 
 	/// The map to load for the menu background
 	const char *backgroundMap;
+
+	/// The number of bytes the primary asset cache may hold before it starts evicting assets, or 0 for no limit
+	size_t assetCacheBudget;
+
+	/// The most undelayed inputs a chain of actor outputs may pass through in one tick before the rest of the chain is
+	/// dropped, or 0 for no limit. This is a depth limit rather than cycle detection, so it also cuts off long chains
+	/// that never repeat.
+	uint32_t actorIoChainDepthLimit;
 };
 
 /// The loaded game config
@@ -9,6 +9,37 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+/// Maps that are a single stream, with each section following the previous one
+#define MAP_ASSET_VERSION_V1 1
+/// Maps that start with a section table, so that sections can be read in parallel or skipped
+#define MAP_ASSET_VERSION_SECTIONED 2
+/// Sectioned maps that store their collision as indexed triangles instead of a triangle soup
+#define MAP_ASSET_VERSION_INDEXED_COLLISION 3
+
+typedef enum MapSectionId MapSectionId;
+
+/**
+ * The sections of a map, in the order they are stored in a version 1 map.
+ * A sectioned map starts with a @c uint32_t section count, followed by a table entry for each section of
+ * @c {uint32_t id, uint32_t crc32, size_t offset, size_t size} with the offset from the start of the map.
+ * Each section has the same contents as in a version 1 map, except for the collision of a version 3 map.
+ * Each collision sub-shape of a version 1 or 2 map is a @c size_t triangle count followed by 9 floats per triangle.
+ * In a version 3 map it is a @c size_t vertex count followed by 3 floats per vertex, and then a @c size_t triangle
+ * count followed by 3 @c uint32_t vertex indices per triangle.
+ */
+enum MapSectionId
+{
+	/// The sky and Discord rich presence info
+	MAP_SECTION_INFO,
+	MAP_SECTION_ACTORS,
+	/// The geometry and material of each model
+	MAP_SECTION_MODELS,
+	MAP_SECTION_COLLISION,
+	MAP_SECTION_LIGHTMAP,
+	MAP_SECTION_LIGHTS,
+	MAP_SECTION_COUNT,
+};
+
 /**
  * Load a map asset
  * @param map The map to load into
@@ -17,4 +48,59 @@
  */
 bool LoadMap(Map *map, Asset *mapData);
 
+/**
+ * Load a map asset into a map that is not the current map, doing as much of the work as possible.
+ * The collision shapes and physics bodies are built, but actors are only read and nothing is uploaded to the GPU.
+ * @param map The map to load into, from @c CreateMap
+ * @param mapData The asset to load from, which is freed on success
+ * @return Whether the map was loaded sucessfully. If this is false, @c map can only be passed to @c DestroyMap
+ * @note This is safe to call from any thread, as long as nothing else uses @c map at the same time.
+ */
+bool LoadMapDetached(Map *map, Asset *mapData);
+
+/**
+ * Finish loading a map that was loaded with @c LoadMapDetached by creating its actors and uploading it to the GPU.
+ * Must be called on the main thread once the map has been made the current map with @c ChangeMap.
+ * @param map The map to finish
+ */
+void FinishDetachedMapLoad(Map *map);
+
+/**
+ * Parse a map asset and build its collision shapes, without creating actors, physics bodies or GPU resources.
+ * The geometry and lightmap are skipped, since a headless map is never drawn.
+ * Everything that was parsed is freed again, so this is only useful for measuring map load times.
+ * @param mapData The asset to parse, which is freed on success
+ * @return Whether the map was parsed sucessfully
+ * @note This is safe to call from any thread.
+ */
+bool ParseMapHeadless(Asset *mapData);
+
+/**
+ * Load a map asset as a chunk of another map, doing as much of the work as possible.
+ * The collision shapes are built, but physics bodies and actors are only created once the chunk is attached.
+ * @param chunk The chunk to load into, from @c CreateMapChunk
+ * @param mapData The asset to load from, which is freed on success
+ * @return Whether the chunk was loaded sucessfully. If this is false, @c chunk can only be passed to @c DestroyMapChunk
+ * @note This is safe to call from any thread, as long as nothing else uses @c chunk at the same time.
+ */
+bool LoadMapChunk(Map *chunk, Asset *mapData);
+
+/**
+ * Attach a chunk loaded with @c LoadMapChunk to a map, creating its physics bodies in the map's physics system and its
+ * actors in the map's actor list. Players in the chunk are ignored, since the map already has one.
+ * Must be called on the main thread while the physics thread is not running.
+ * @param map The map to attach the chunk to
+ * @param chunk The chunk to attach, which must be destroyed with @c DestroyMapChunk before @c map is destroyed
+ * @note The chunk's geometry is not uploaded to the GPU by this.
+ */
+void AttachMapChunk(Map *map, Map *chunk);
+
+/**
+ * Convert a map asset to the newest version in place, building indexed collision from triangle soups.
+ * Maps that are already the newest version are left alone.
+ * @param mapData The asset to convert
+ * @return Whether the map is now the newest version
+ */
+bool UpgradeMapAsset(Asset *mapData);
+
 #endif //GAME_MAPLOADER_H
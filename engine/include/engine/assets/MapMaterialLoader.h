@@ -36,6 +36,14 @@ struct MapMaterial
 	SoundClass soundClass;
 };
 
+/**
+ * Load a map material from an asset, without caching it
+ * @param path The asset path
+ * @return The map material, or NULL on error
+ * @note This pointer is not tracked and must be freed with @c FreeMapMaterial.
+ */
+MapMaterial *LoadMapMaterialInternal(const char *path);
+
 /**
  * Load a map material from an asset
  * @param path The asset path
@@ -43,6 +51,19 @@ struct MapMaterial
  */
 MapMaterial *LoadMapMaterial(const char *path);
 
+/**
+ * Read a map material from disk again, updating the loaded material in place
+ * @param path The material asset that changed
+ * @return The reloaded material, or NULL if the material was not loaded or failed to load
+ * @note The material's shader is kept, since changing it requires the map to be uploaded again.
+ */
+MapMaterial *ReloadMapMaterial(const char *path);
+
+/**
+ * Free a map material loaded with @c LoadMapMaterialInternal
+ */
+void FreeMapMaterial(MapMaterial *material);
+
 void DestroyMapMaterialLoader();
 
 #endif //GAME_MAPMATERIALLOADER_H
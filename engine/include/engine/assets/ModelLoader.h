@@ -5,15 +5,20 @@
 #ifndef MODELLOADER_H
 #define MODELLOADER_H
 
+#include <engine/structs/Atom.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/Vector2.h>
 #include <joltc/joltc.h>
 #include <joltc/Math/Vector3.h>
 #include <joltc/Physics/Collision/Shape/Shape.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
-#define MODEL_ASSET_VERSION 1
+/// Models with an indexed static collider
+#define MODEL_ASSET_VERSION 2
+/// Models whose static collider is stored as a triangle soup of 9 floats per triangle, which can still be loaded
+#define MODEL_ASSET_VERSION_TRIANGLE_SOUP 1
 
 /// The maximum number of models that can be loaded in any one execution of the game
 #define MAX_MODELS 128
@@ -105,6 +110,8 @@ struct ModelDefinition
 	uint32_t id;
 	/// The asset name of this model
 	char *name;
+	/// The interned asset name of this model, which the model cache is searched by
+	Atom nameAtom;
 
 	/// The total number of materials in the model, across all skins
 	uint32_t materialCount;
@@ -152,8 +159,15 @@ struct ModelStaticCollider
 {
 	/// The number of triangles in this mesh
 	size_t numTriangles;
-	/// The triangles in this mesh
+	/// The triangles in this mesh, for meshes stored as a triangle soup, or NULL if the mesh is indexed
 	JPH_Triangle *tris;
+
+	/// The number of vertices in an indexed mesh
+	size_t numVertices;
+	/// The vertices of an indexed mesh, or NULL if the mesh is a triangle soup
+	Vector3 *vertices;
+	/// The triangles of an indexed mesh as indices into @c vertices, or NULL if the mesh is a triangle soup
+	JPH_IndexedTriangle *indexedTris;
 };
 
 /**
@@ -175,6 +189,15 @@ ModelDefinition *LoadModelInternal(const char *asset);
  */
 ModelDefinition *LoadModel(const char *asset);
 
+/**
+ * Read a model from disk again, replacing the contents of the loaded model in place
+ * @param asset The model asset that changed
+ * @return The reloaded model, or NULL if the model was not loaded or could not be reloaded
+ * @note The model still has to be uploaded to the GPU again, see @c QueueModelReload.
+ * @warning Nothing else may use the model while it is reloaded.
+ */
+ModelDefinition *ReloadModel(const char *asset);
+
 /**
  * Fetch a cached model from an ID
  * @param id The model ID to fetch
@@ -208,6 +231,29 @@ JPH_Shape *CreateDynamicModelShape(size_t numHulls, const ModelConvexHull *hulls
  */
 JPH_Shape *CreateStaticModelShape(const ModelStaticCollider *staticCollider);
 
+/**
+ * Check that every triangle of an indexed static collider only uses vertices that exist
+ * @param triangleData The triangles as 3 @c uint32_t vertex indices each, as stored in the asset
+ * @param numTriangles The number of triangles
+ * @param numVertices The number of vertices
+ * @return Whether every index is in range
+ */
+bool CheckStaticColliderIndices(const uint8_t *triangleData, size_t numTriangles, size_t numVertices);
+
+/**
+ * Create a static model collider shape from the collision data of a model or map asset
+ * @param vertexData The vertices as 3 floats each, or NULL if the triangles are a triangle soup
+ * @param numVertices The number of vertices
+ * @param triangleData The triangles as 3 @c uint32_t vertex indices each, or as 9 floats each for a triangle soup
+ * @param numTriangles The number of triangles
+ * @return The @c JPH_Shape
+ * @note The data does not have to be aligned. Indices must have been checked with @c CheckStaticColliderIndices.
+ */
+JPH_Shape *CreateStaticModelShapeFromData(const uint8_t *vertexData,
+										  size_t numVertices,
+										  const uint8_t *triangleData,
+										  size_t numTriangles);
+
 void DPrintModelLoader();
 
 #endif //MODELLOADER_H
@@ -0,0 +1,65 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_PACKFILE_H
+#define GAME_PACKFILE_H
+
+#include <engine/assets/GameConfigLoader.h>
+#include <engine/structs/List.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PACK_FILE_MAGIC 0x4B415047 // "GPAK" in ASCII
+#define PACK_FILE_VERSION 1
+#define PACK_FILE_EXTENSION ".gpak"
+
+/**
+ * Mount every pack file found in the root of every asset path.
+ * Packs in the same asset path are searched in reverse name order, so "b.gpak" overrides "a.gpak".
+ */
+void MountAssetPacks();
+
+/**
+ * Unmount all mounted pack files
+ * @warning Any pointers returned by @c FindPackedAsset will become invalid!
+ */
+void UnmountAssetPacks();
+
+/**
+ * Look up an asset in the packs mounted for an asset path
+ * @param assetPath The asset path to search the packs of
+ * @param relPath The path of the asset, relative to the asset path
+ * @param data Where to store a pointer to the packed asset file
+ * @param size Where to store the size of the packed asset file
+ * @param packPath Where to store the path of the pack the asset was found in, or NULL. Valid until the pack is unmounted.
+ * @return Whether the asset was found
+ * @note This does not touch the filesystem, the returned data points directly into the mapped pack.
+ */
+bool FindPackedAsset(const AssetPath *assetPath,
+					 const char *relPath,
+					 const uint8_t **data,
+					 size_t *size,
+					 const char **packPath);
+
+/**
+ * Get the paths of all packed assets for an asset path
+ * @param assetPath The asset path to list the packs of
+ * @param output A @c LIST_POINTER list to append the asset paths to, relative to the asset path. These point into the
+ *				 mapped pack and must not be freed.
+ */
+void ListPackedAssets(const AssetPath *assetPath, List *output);
+
+/**
+ * Pack every file in a directory (recursively) into a pack file
+ * @param directory The directory to pack. Paths in the pack will be relative to this.
+ * @param outputPath The pack file to write
+ * @return Whether the pack file was successfully written
+ * @note This is what the assettool --pack command runs.
+ */
+bool WritePackFile(const char *directory, const char *outputPath);
+
+void DPrintPackFiles();
+
+#endif //GAME_PACKFILE_H
@@ -6,6 +6,7 @@
 #define TEXTURELOADER_H
 
 #include <engine/assets/AssetReader.h>
+#include <engine/structs/Atom.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -52,8 +53,15 @@ struct Image
 
 	/// The name of the image
 	char *name;
+	/// The interned name of the image, which the texture cache is sorted by. Set by @c RegisterImage.
+	Atom nameAtom;
 	/// The pixel data of the image
 	uint8_t *pixelData;
+	/// The allocation that owns the pixel data, which pixelData may point into
+	void *pixelDataBuffer;
+	/// The newer version of the image read by @c ReloadImage, which is swapped in by @c ApplyImageReload once the
+	/// renderer takes its upload. Set to NULL by @c RegisterImage.
+	Image *pendingReload;
 };
 
 /**
@@ -62,7 +70,14 @@ struct Image
  */
 void GenFallbackImage(Image *src);
 
-bool LoadImageFromAsset(const Asset *asset, Image *image);
+/**
+ * Load an image from a texture asset
+ * @param asset The asset to load the image from. On success, the image takes ownership of the asset's data buffer and
+ *				the pixel data points directly into it, so the asset must not be cached.
+ * @param image The image to populate
+ * @return Whether the image was loaded
+ */
+bool LoadImageFromAsset(Asset *asset, Image *image);
 
 /**
  * Load an image from disk, falling back to a cached version if possible
@@ -71,6 +86,27 @@ bool LoadImageFromAsset(const Asset *asset, Image *image);
  */
 Image *LoadImage(const char *asset);
 
+/**
+ * Read a texture from disk again into the pending reload of the loaded image. The current pixels are left alone, since
+ * the renderer may still be about to upload them.
+ * @param asset The texture asset that changed
+ * @return The reloaded image, or NULL if the texture was not loaded or failed to load
+ * @note The image still has to be uploaded to the GPU again, see @c QueueTextureReload.
+ */
+Image *ReloadImage(const char *asset);
+
+/**
+ * Replace the pixels of an image with its pending reload, which the renderer does right before uploading it again
+ * @param image The image
+ * @return Whether the image had a pending reload
+ */
+bool ApplyImageReload(Image *image);
+
+/**
+ * Apply the pending reload of every loaded image, for when the renderer uploads every texture again
+ */
+void ApplyAllImageReloads();
+
 /**
  * Get the missing texture
  */
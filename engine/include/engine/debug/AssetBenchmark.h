@@ -0,0 +1,19 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef ASSETBENCHMARK_H
+#define ASSETBENCHMARK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Compare single-stream (version 2) and chunked (version 3) decompression of an asset and log the results
+ * @param relPath The asset to benchmark, in any supported format version
+ * @param iterations How many times to decompress each version
+ * @return Whether the benchmark ran
+ */
+bool BenchmarkAssetCompression(const char *relPath, size_t iterations);
+
+#endif //ASSETBENCHMARK_H
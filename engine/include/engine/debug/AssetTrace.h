@@ -0,0 +1,68 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef ASSETTRACE_H
+#define ASSETTRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// The number of slowest assets shown in the asset trace debug entry
+#define ASSET_TRACE_TOP_COUNT 10
+
+typedef enum AssetTracePhase
+{
+	/// Finding and opening the asset file or pack entry
+	ASSET_TRACE_OPEN,
+	/// Reading the asset file into memory (or loading it from the cooked asset cache)
+	ASSET_TRACE_READ,
+	/// Decompressing the asset
+	ASSET_TRACE_INFLATE,
+	/// Turning the decompressed asset into engine structures
+	ASSET_TRACE_PARSE,
+	/// Uploading the loaded asset to the GPU
+	ASSET_TRACE_UPLOAD,
+	ASSET_TRACE_PHASE_COUNT,
+} AssetTracePhase;
+
+/**
+ * Start recording asset load events if @c --asset-trace=<file> was passed.
+ * The report is written as JSON if the file name ends in ".json", and as CSV otherwise.
+ */
+void InitAssetTrace();
+
+/**
+ * Write the asset trace report and free all recorded events.
+ * Must be called after the asset loader threads have stopped.
+ */
+void DestroyAssetTrace();
+
+/**
+ * Start timing an asset load phase
+ * @return The start time to pass to @c AssetTraceEnd, or 0 if tracing is disabled
+ */
+uint64_t AssetTraceBegin();
+
+/**
+ * Record an asset load phase
+ * @param asset The name of the asset
+ * @param phase The phase that was timed
+ * @param startTime The value returned by @c AssetTraceBegin
+ * @param bytes The number of bytes that were processed during the phase
+ * @note This is safe to call from any thread.
+ */
+void AssetTraceEnd(const char *asset, AssetTracePhase phase, uint64_t startTime, size_t bytes);
+
+/**
+ * Log the time spent in each phase since a point in time, and the slowest assets in that window
+ * @param since The time to start from, from @c GetTimeNs
+ */
+void LogAssetTraceSummary(uint64_t since);
+
+/**
+ * Show the assets that took the longest to load
+ */
+void DPrintAssetTrace();
+
+#endif //ASSETTRACE_H
@@ -0,0 +1,69 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_MAPLOADPROFILER_H
+#define GAME_MAPLOADPROFILER_H
+
+#include <engine/structs/MapArena.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// The maximum length of a map load stage name, including the terminator
+#define MAP_LOAD_STAGE_NAME_LENGTH 64
+
+typedef struct MapLoadStageTimer MapLoadStageTimer;
+
+/**
+ * The state of a map load stage that is being timed
+ */
+struct MapLoadStageTimer
+{
+	/// When the stage started, from @c GetTimeNs, or 0 if no map load is being profiled
+	uint64_t startTime;
+	/// The arena the stage allocates from, or NULL if its allocations are not counted
+	const MapArena *arena;
+	/// The allocation count of @c arena when the stage started
+	size_t startAllocations;
+	/// The number of bytes allocated from @c arena when the stage started
+	size_t startBytes;
+};
+
+/**
+ * Set up the map load profiler
+ */
+void InitMapLoadProfiler();
+
+/**
+ * Start profiling a map load if @c --profile-map-load was passed, discarding the stages of the previous one
+ * @param mapName The name of the map that is being loaded
+ */
+void BeginMapLoadProfile(const char *mapName);
+
+/**
+ * Stop profiling the current map load and log its stages as a table
+ */
+void FinishMapLoadProfile();
+
+/**
+ * Start timing a map load stage
+ * @param arena The arena of the map that is being loaded, or NULL if the stage's allocations should not be counted.
+ *				Pass NULL for stages that run while other threads allocate from the same arena.
+ * @return The timer to pass to @c EndMapLoadStage
+ */
+MapLoadStageTimer StartMapLoadStage(const MapArena *arena);
+
+/**
+ * Record a map load stage. Stages with the same name are added together.
+ * @param stage The name of the stage
+ * @param timer The value returned by @c StartMapLoadStage
+ * @note This is safe to call from any thread.
+ */
+void EndMapLoadStage(const char *stage, const MapLoadStageTimer *timer);
+
+/**
+ * Free the map load profiler
+ */
+void DestroyMapLoadProfiler();
+
+#endif //GAME_MAPLOADPROFILER_H
@@ -6,6 +6,8 @@
 #define GAME_RENDERINGHELPERS_H
 
 #include <cglm/types.h>
+#include <engine/assets/ModelLoader.h>
+#include <engine/assets/TextureLoader.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/Map.h>
@@ -49,6 +51,14 @@ enum RendererQueuedAction
 	QUEUED_ACTION_CLEAR_ALL_MODELS = 1 << 2,
 	QUEUED_ACTION_RELOAD_ALL_ASSETS = 1 << 3,
 	QUEUED_ACTION_TOGGLE_VSYNC = 1 << 4,
+	/// Upload the textures passed to @c QueueTextureReload again
+	QUEUED_ACTION_RELOAD_TEXTURES = 1 << 5,
+	/// Upload the models passed to @c QueueModelReload again
+	QUEUED_ACTION_RELOAD_MODELS = 1 << 6,
+	/// Look up the textures of the current map's materials again
+	QUEUED_ACTION_UPDATE_MAP_MATERIALS = 1 << 7,
+	/// Upload the geometry and lightmap of the current map and its resident chunks again
+	QUEUED_ACTION_RELOAD_MAP_GEOMETRY = 1 << 8,
 };
 
 extern RendererQueuedAction rendererQueuedActions;
@@ -195,9 +205,23 @@ float X_TO_NDC(float x);
  */
 float Y_TO_NDC(float y);
 
+/**
+ * Upload a texture that was reloaded with @c ReloadImage again at the start of the next frame, replacing its slot in
+ * the texture array
+ * @param image The reloaded image
+ */
+void QueueTextureReload(const Image *image);
+
+/**
+ * Upload a model that was reloaded with @c ReloadModel again at the start of the next frame
+ * @param model The reloaded model
+ */
+void QueueModelReload(const ModelDefinition *model);
+
 /**
  * Load the map models from a map
- * @param map The map to load from
+ * @param map The map to load from. Its geometry is freed afterwards, unless it has chunks that need it to be uploaded
+ *			  again when they are streamed in.
  */
 void LoadMapModels(Map *map);
 
@@ -5,6 +5,8 @@
 #ifndef GAME_VULKAN_H
 #define GAME_VULKAN_H
 
+#include <engine/assets/ModelLoader.h>
+#include <engine/assets/TextureLoader.h>
 #include <engine/graphics/Drawing.h>
 #include <engine/graphics/RenderingHelpers.h> // NOLINT(*-include-cleaner)
 #include <engine/structs/Camera.h>
@@ -54,6 +56,10 @@ void VK_Cleanup();
 
 bool VK_LoadMap(const Map *map);
 
+void VK_QueueTextureReload(const Image *image);
+
+void VK_QueueModelReload(const ModelDefinition *model);
+
 bool VK_UpdateViewportSize();
 
 void VK_Minimize();
@@ -6,6 +6,7 @@
 #define GAME_VULKANACTORS_H
 
 #include <engine/structs/List.h>
+#include <stdint.h>
 #include <vulkan/vulkan_core.h>
 
 void InitActorLoadingVariables();
@@ -14,4 +15,10 @@ VkResult LoadActors(const LockingList *actors);
 
 VkResult UpdateActors();
 
+/**
+ * Forget that a model's LODs are loaded, so that they are uploaded again the next time an actor uses the model
+ * @param modelId The ID of the model
+ */
+void UnloadModelLods(uint32_t modelId);
+
 #endif //GAME_VULKANACTORS_H
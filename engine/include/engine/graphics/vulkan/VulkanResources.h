@@ -12,4 +12,11 @@ VkResult ResizeDebugDrawBuffers();
 
 bool LoadTexture(const Image *image);
 
+/**
+ * Upload a texture again after its image was reloaded, keeping its slot in the texture array
+ * @param image The reloaded image
+ * @return Whether the texture was uploaded, or true if it was never uploaded in the first place
+ */
+bool ReloadTexture(const Image *image);
+
 #endif //VULKANRESOURCES_H
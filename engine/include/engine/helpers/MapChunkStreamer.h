@@ -0,0 +1,53 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_MAPCHUNKSTREAMER_H
+#define GAME_MAPCHUNKSTREAMER_H
+
+#include <engine/structs/List.h>
+#include <engine/structs/Map.h>
+#include <joltc/Math/Vector3.h>
+
+/// How close the camera has to be to a chunk for it to be loaded, unless the map_chunk sets "load_radius"
+#define DEFAULT_MAP_CHUNK_LOAD_RADIUS 128.0f
+/// How much further than its load radius the camera has to be from a chunk for it to be unloaded, unless the map_chunk
+/// sets "unload_margin". This keeps chunks from being loaded and unloaded over and over at the edge of their radius.
+#define DEFAULT_MAP_CHUNK_UNLOAD_MARGIN 32.0f
+/// The maximum number of chunks that are read or built at once
+#define MAX_MAP_CHUNK_LOADS 2
+
+/**
+ * Add a chunk to a map, to be streamed in and out by @c UpdateMapChunks.
+ * Registering a chunk that the map already has does nothing.
+ * @param map The map the chunk belongs to
+ * @param chunkMapName The name of the map asset the chunk is loaded from
+ * @param position The position the distance to the chunk is measured from
+ * @param loadRadius How close the camera has to be for the chunk to be loaded
+ * @param unloadRadius How far the camera has to be for the chunk to be unloaded, which should be above @c loadRadius
+ */
+void RegisterMapChunk(Map *map, const char *chunkMapName, const Vector3 *position, float loadRadius, float unloadRadius);
+
+/**
+ * Start loading chunks the camera is close to, attach chunks that finished loading, and unload chunks the camera is far
+ * from. Called once per frame by the engine.
+ * @param map The current map
+ */
+void UpdateMapChunks(Map *map);
+
+/**
+ * Get every chunk of a map that is attached to it
+ * @param map The map
+ * @param chunkMaps A @c LIST_POINTER list to append the @c Map of each resident chunk to
+ */
+void GetResidentMapChunks(const Map *map, List *chunkMaps);
+
+/**
+ * Unload every chunk of a map, waiting for the ones that are still being built
+ * @param map The map, which the physics thread and LOD thread must not be using
+ */
+void DestroyMapChunks(Map *map);
+
+void DPrintMapChunks();
+
+#endif //GAME_MAPCHUNKSTREAMER_H
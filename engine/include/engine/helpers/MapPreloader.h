@@ -0,0 +1,73 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_MAPPRELOADER_H
+#define GAME_MAPPRELOADER_H
+
+#include <engine/structs/Map.h>
+
+/// The maximum number of maps that can be preloaded at once. Preloads that failed or are waiting for room in the budget
+/// don't count toward it.
+#define MAX_MAP_PRELOADS 4
+/// How much memory preloaded maps may use in MiB, unless overridden with --map-preload-budget (0 disables preloading)
+#define DEFAULT_MAP_PRELOAD_BUDGET_MB 256
+/// How close the player has to be to a trigger_map for its map to be preloaded, unless it sets "preload_radius"
+#define DEFAULT_MAP_PRELOAD_RADIUS 64.0f
+
+typedef enum MapPreloadStatus
+{
+	/// The map is not being preloaded
+	MAP_PRELOAD_NONE,
+	/// The map is still being read or built
+	MAP_PRELOAD_LOADING,
+	/// The map can be taken with @c TakePreloadedMap
+	MAP_PRELOAD_READY,
+} MapPreloadStatus;
+
+/**
+ * Set up the map preloader
+ */
+void InitMapPreloader();
+
+/**
+ * Discard every preloaded map and free the map preloader
+ */
+void DestroyMapPreloader();
+
+/**
+ * Ask for a map to be preloaded, or keep an existing preload from being discarded.
+ * The preload itself is started by @c UpdateMapPreloads.
+ * @param mapName The name of the map
+ * @note This is safe to call from any thread.
+ */
+void RequestMapPreload(const char *mapName);
+
+/**
+ * Start requested preloads and pick up finished ones. Called once per frame by the engine.
+ */
+void UpdateMapPreloads();
+
+/**
+ * Check how far along the preload of a map is
+ * @param mapName The name of the map
+ */
+MapPreloadStatus GetMapPreloadStatus(const char *mapName);
+
+/**
+ * Take a preloaded map out of the preloader
+ * @param mapName The name of the map
+ * @return The map, which must be finished with @c FinishDetachedMapLoad once it is the current map, or NULL if the map
+ *		   is not done preloading
+ */
+Map *TakePreloadedMap(const char *mapName);
+
+/**
+ * Discard every preload, waiting for the ones that are still being built
+ * @param keepMapName The name of a map whose preload should be kept, or NULL to discard all of them
+ */
+void DiscardMapPreloads(const char *keepMapName);
+
+void DPrintMapPreloader();
+
+#endif //GAME_MAPPRELOADER_H
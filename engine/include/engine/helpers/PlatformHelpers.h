@@ -7,6 +7,7 @@
 
 #include <SDL3/SDL_video.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
  * Attempt to set Win32 DWM window attributes (dark mode, square corners)
@@ -48,4 +49,20 @@ bool RedirectFd(int originalFd, int *pipeFds, int *originalFdCopy);
  */
 void RestoreFd(int modifiedFd, int *pipeFds, int originalFd);
 
+/**
+ * Map a file into memory for reading
+ * @param path The file to map
+ * @param size Where to store the size of the mapping in bytes
+ * @return The base of the read-only mapping, or NULL on failure
+ * @note Empty files cannot be mapped and will fail
+ */
+const void *MapFileReadOnly(const char *path, size_t *size);
+
+/**
+ * Unmap a file previously mapped with @c MapFileReadOnly
+ * @param data The base of the mapping
+ * @param size The size of the mapping in bytes
+ */
+void UnmapFile(const void *data, size_t size);
+
 #endif //PLATFORMHELPERS_H
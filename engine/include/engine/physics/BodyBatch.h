@@ -0,0 +1,52 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_BODYBATCH_H
+#define GAME_BODYBATCH_H
+
+#include <joltc/enums.h>
+#include <joltc/Physics/Body/BodyCreationSettings.h>
+#include <joltc/Physics/Body/BodyID.h>
+#include <joltc/Physics/Body/BodyInterface.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/**
+	 * Start batching the bodies created with @c CreateAndAddBody on this thread, so that they are all added to the
+	 * broadphase at once by @c EndBodyBatch. Adding bodies one at a time degrades the broadphase tree and takes a lock
+	 * for each body.
+	 * Batches may be nested, in which case the bodies are added when the outermost batch ends.
+	 * @param bodyInterface The body interface to batch. Bodies created through any other body interface are added
+	 *						right away.
+	 * @warning Bodies in a batch must not be removed before the batch ends.
+	 */
+	void BeginBodyBatch(JPH_BodyInterface *bodyInterface);
+
+	/**
+	 * End a batch started with @c BeginBodyBatch, adding all of its bodies to the broadphase at once
+	 * @return The number of bodies that were added, which is 0 for nested batches
+	 * @note This does not optimize the broadphase, since that is too slow to do every tick.
+	 */
+	size_t EndBodyBatch();
+
+	/**
+	 * Create a body and add it to the physics system, or to the current batch if this thread has one open.
+	 * Use this instead of @c JPH_BodyInterface_CreateAndAddBody.
+	 * @param bodyInterface The body interface to create the body with
+	 * @param settings The creation settings of the body
+	 * @param activation Whether to activate the body once it is added
+	 * @return The ID of the body, which can be used right away even if the body is batched
+	 */
+	JPH_BodyID CreateAndAddBody(JPH_BodyInterface *bodyInterface,
+								const JPH_BodyCreationSettings *settings,
+								JPH_Activation activation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //GAME_BODYBATCH_H
@@ -0,0 +1,46 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_COOKEDSHAPES_H
+#define GAME_COOKEDSHAPES_H
+
+#include <joltc/Physics/Collision/Shape/Shape.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/// Bump this when the way shapes are built from their source data changes, so that stale cooked shapes are rebuilt
+#define COOKED_SHAPES_VERSION 1
+
+/**
+ * Restore shapes from the cooked asset cache instead of building them
+ * @param kind What the shapes are built as, so that the same source data built in different ways is kept apart
+ * @param sourceData The data the shapes are built from, which is hashed to find them
+ * @param sourceSize The size of @c sourceData
+ * @param shapes Where to store the restored shapes. Shapes that were NULL when they were stored are NULL again.
+ * @param shapeCount The number of shapes, which must match the number that was stored
+ * @return Whether the shapes were restored. If not, @c shapes is left untouched and the shapes should be built.
+ * @note This is safe to call from any thread.
+ */
+bool LoadCookedShapes(const char *kind,
+					  const void *sourceData,
+					  size_t sourceSize,
+					  JPH_Shape **shapes,
+					  size_t shapeCount);
+
+/**
+ * Store shapes in the cooked asset cache, so that they can be restored with @c LoadCookedShapes next time
+ * @param kind What the shapes are built as
+ * @param sourceData The data the shapes were built from
+ * @param sourceSize The size of @c sourceData
+ * @param shapes The shapes, any of which may be NULL
+ * @param shapeCount The number of shapes
+ * @note This is safe to call from any thread, as long as the shapes are not modified at the same time.
+ */
+void StoreCookedShapes(const char *kind,
+					   const void *sourceData,
+					   size_t sourceSize,
+					   JPH_Shape *const *shapes,
+					   size_t shapeCount);
+
+#endif //GAME_COOKEDSHAPES_H
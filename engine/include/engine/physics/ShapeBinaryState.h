@@ -0,0 +1,40 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_SHAPEBINARYSTATE_H
+#define GAME_SHAPEBINARYSTATE_H
+
+#include <joltc/Physics/Collision/Shape/Shape.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/**
+	 * Serialize shapes and all of their children with Jolt's binary state
+	 * @param shapes The shapes to save, any of which may be NULL. Children shared between shapes are only saved once.
+	 * @param shapeCount The number of shapes
+	 * @param size Where to store the size of the returned data
+	 * @return The serialized shapes (must be freed), or NULL if there was not enough memory
+	 */
+	uint8_t *SaveShapesBinaryState(JPH_Shape *const *shapes, size_t shapeCount, size_t *size);
+
+	/**
+	 * Restore shapes that were serialized with @c SaveShapesBinaryState
+	 * @param data The serialized shapes
+	 * @param size The size of @c data
+	 * @param shapes Where to store the restored shapes, which must be destroyed with @c JPH_Shape_Destroy
+	 * @param shapeCount The number of shapes, which must match the number that was saved
+	 * @return Whether every shape was restored. Data from another version of Jolt is rejected.
+	 */
+	bool RestoreShapesBinaryState(const uint8_t *data, size_t size, JPH_Shape **shapes, size_t shapeCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //GAME_SHAPEBINARYSTATE_H
@@ -7,10 +7,13 @@
 
 #include <engine/assets/ModelLoader.h>
 #include <engine/structs/ActorDefinition.h>
+#include <engine/structs/ActorPool.h>
 #include <engine/structs/ActorWall.h>
+#include <engine/structs/Atom.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/List.h>
+#include <engine/structs/MapArena.h>
 #include <joltc/Math/Transform.h>
 #include <joltc/Physics/Body/BodyID.h>
 #include <joltc/Physics/Body/BodyInterface.h>
@@ -20,12 +23,18 @@
 
 typedef struct Actor Actor;
 typedef struct ActorConnection ActorConnection;
+typedef struct ActorOutputLink ActorOutputLink;
 
 #define ACTOR_INPUT_KILL "kill"
 
 #define ACTOR_OUTPUT_SPAWNED "spawned"
 #define ACTOR_OUTPUT_KILLED "killed"
 
+/// The ID of @c ACTOR_OUTPUT_SPAWNED, which every actor has
+#define ACTOR_OUTPUT_SPAWNED_ID 0
+/// The ID of @c ACTOR_OUTPUT_KILLED, which every actor has
+#define ACTOR_OUTPUT_KILLED_ID 1
+
 enum ActorFlags
 {
 	ACTOR_FLAG_CAN_PUSH_PLAYER = 1 << 0,
@@ -39,21 +48,44 @@ enum ActorFlags
 struct ActorConnection
 {
 	/// The name of the input on the target actor
-	char *targetActorInput;
+	Atom targetActorInput;
 	/// The name of the output on the source actor
-	char *sourceActorOutput;
+	Atom sourceActorOutput;
 	/// The name of the actor firing the output
-	char *targetActorName;
+	Atom targetActorName;
 	/// The param to send to the input
 	Param outParamOverride;
 	/// The number of times this output will fire before it is removed. 0 means unlimited.
 	size_t numRefires;
+	/// The ID of @c sourceActorOutput on the source actor, resolved when the actor's outputs are linked
+	ActorOutputId outputId;
+	/// Set once the connection has run out of refires. It is removed once the output finishes firing.
+	bool spent;
+};
+
+/**
+ * An I/O connection resolved to one of the actors it targets, so that firing an output needs no lookups
+ */
+struct ActorOutputLink
+{
+	/// The connection the link was resolved from
+	ActorConnection *connection;
+	/// The actor the input is sent to, or NULL if no actor has the connection's target name
+	Actor *target;
+	/// The handler of the input on the target, or NULL if there is no target or it does not have the input
+	ActorInputHandlerFunction handler;
+	/// Whether this is the last link of its connection, which is where the connection's refires are counted
+	bool lastOfConnection;
 };
 
 struct Actor
 {
 	/// A unique ID used to represent this actor
 	uint64_t id;
+	/// A handle to this actor, which can be kept instead of a pointer to find out whether the actor was freed
+	ActorHandle handle;
+	/// The index of this actor in its map's actor list, or SIZE_MAX if it is not in one
+	size_t mapIndex;
 
 	/// The actor's definition
 	const ActorDefinition *definition;
@@ -89,9 +121,23 @@ struct Actor
 
 	/// List of I/O connections
 	LockingList ioConnections;
-
-	/// Extra data for the actor
+	/// The I/O connections resolved to their targets, grouped by output ID, or NULL if there are none
+	ActorOutputLink *outputLinks;
+	/// The index in @c outputLinks of the first link of each output, followed by the number of links
+	size_t *outputLinkStarts;
+	/// The @c ioLinkGeneration of the map when @c outputLinks was built, or -1 if it has to be rebuilt
+	int outputLinkGeneration;
+	/// Set once the actor is removed from its map. Actors removed by an input are kept until every input has been sent.
+	bool removed;
+
+	/// Extra data for the actor, from @c ActorAllocExtraData
 	void *extraData;
+
+	/// The arena of the map this actor was loaded with, or NULL if it was spawned after the map loaded
+	MapArena *arena;
+
+	/// The name of the actor, or @c ATOM_NONE if it has no name
+	Atom name;
 };
 
 /**
@@ -104,6 +150,22 @@ struct Actor
  */
 Actor *CreateActor(Transform *transform, const char *actorType, KvList params, JPH_BodyInterface *bodyInterface);
 
+/**
+ * Create an Actor whose memory, other than the actor itself and its extra data, comes from a map arena while the map is
+ * loading
+ * @param transform Actor position
+ * @param actorType Actor type
+ * @param params Parameters for the actor, can be NULL
+ * @param bodyInterface The Joly body interface within which to create the actor's rigid body
+ * @param arena The arena of the map the actor is being loaded into, or NULL to use the heap
+ * @return Initialized Actor struct
+ */
+Actor *CreateActorInArena(Transform *transform,
+						  const char *actorType,
+						  KvList params,
+						  JPH_BodyInterface *bodyInterface,
+						  MapArena *arena);
+
 /**
  * Destroy an Actor
  * @param actor actor to destroy
@@ -124,15 +186,75 @@ void ActorTriggerInput(const Actor *sender, Actor *receiver, const char *input,
  * @param sender The actor sending the signal
  * @param output The signal to send
  * @param defaultParam The default parameter to send with the signal
+ * @note This looks the output up by name, so prefer @c ActorFireOutputId.
  */
 void ActorFireOutput(Actor *sender, const char *output, Param defaultParam);
 
+/**
+ * Fire signal from an actor
+ * @param sender The actor sending the signal
+ * @param output The ID of the output, from @c RegisterActorOutput
+ * @param defaultParam The default parameter to send with the signal
+ * @note The inputs are queued, and sent by @c DispatchActorInputs at the end of the current physics tick.
+ */
+void ActorFireOutputId(Actor *sender, ActorOutputId output, Param defaultParam);
+
+/**
+ * Fire signal from an actor after a delay
+ * @param sender The actor sending the signal
+ * @param output The ID of the output, from @c RegisterActorOutput
+ * @param defaultParam The default parameter to send with the signal
+ * @param delayTicks The number of physics ticks to wait before the inputs are sent
+ */
+void ActorFireOutputIdDelayed(Actor *sender, ActorOutputId output, Param defaultParam, uint32_t delayTicks);
+
+/**
+ * Make an actor rebuild its output links the next time it fires an output.
+ * This must be called after changing the actor's @c ioConnections.
+ * @param actor The actor
+ */
+void InvalidateActorOutputLinks(Actor *actor);
+
 /**
  * Destroy an actor connection
- * @param connection The connection to destroy
+ * @param connection The connection to destroy, which must have been allocated with @c MapArenaAllocFreeable
  */
 void DestroyActorConnection(ActorConnection *connection);
 
+/**
+ * Allocate the zeroed extra data of an actor from the pool of its class, and set it as the actor's @c extraData
+ * @param this The actor the extra data belongs to
+ * @param size The size of the extra data, which must be the same for every actor of the class
+ * @return The extra data, which is freed with the actor
+ * @warning This will crash the engine on allocation failure. It does *not* return NULL.
+ */
+void *ActorAllocExtraData(Actor *this, size_t size);
+
+/**
+ * Allocate zeroed memory that belongs to an actor, such as its wall.
+ * While the actor's map is loading this comes from the map's arena, otherwise it comes from the heap.
+ * @param this The actor the memory belongs to
+ * @param size The number of bytes to allocate
+ * @return The allocated memory, which must be freed with @c ActorFree
+ * @warning This will crash the engine on allocation failure. It does *not* return NULL.
+ */
+void *ActorAlloc(const Actor *this, size_t size);
+
+/**
+ * Copy a string into memory that belongs to an actor
+ * @param this The actor the string belongs to
+ * @param string The string to copy
+ * @return The copy of the string, which must be freed with @c ActorFree
+ */
+char *ActorStrdup(const Actor *this, const char *string);
+
+/**
+ * Free memory that belongs to an actor. Memory from the map arena is left for the arena to release.
+ * @param this The actor the memory belongs to
+ * @param pointer The memory to free, which may be NULL
+ */
+void ActorFree(const Actor *this, void *pointer);
+
 /**
  * Create an empty body for an actor which does not need collision, but does need a position in the world
  * @param this The actor to create the body for
@@ -5,16 +5,26 @@
 #ifndef GAME_ACTORDEFINITIONS_H
 #define GAME_ACTORDEFINITIONS_H
 
+#include <engine/structs/Atom.h>
 #include <engine/structs/Dict.h>
 #include <engine/structs/KVList.h>
 #include <joltc/Math/Transform.h>
 #include <joltc/Physics/Body/BodyID.h>
 #include <m-core.h>
+#include <stddef.h>
+#include <stdint.h>
 
 typedef struct Actor Actor;
+typedef struct ActorBlockPool ActorBlockPool;
 
 typedef struct ActorDefinition ActorDefinition;
 
+/// The index of an output within the outputs of an actor definition, from @c RegisterActorOutput
+typedef size_t ActorOutputId;
+
+/// An output that the actor definition does not have
+#define ACTOR_OUTPUT_INVALID SIZE_MAX
+
 typedef void (*ActorInitFunction)(Actor *this, const KvList params, Transform *transform);
 
 typedef void (*ActorUpdateFunction)(Actor *this, double delta);
@@ -37,9 +47,11 @@ typedef void (*ActorRegisterFunction)(void);
 
 typedef void (*RegisterGameActorsFunction)(void);
 
-DEFINE_DICT(ActorInputHandlerFunctionDict, const char *, M_CSTR_OPLIST, ActorInputHandlerFunction, M_PTR_OPLIST);
+DEFINE_DICT(ActorInputHandlerFunctionDict, Atom, ATOM_OPLIST, ActorInputHandlerFunction, M_PTR_OPLIST);
 
-DEFINE_DICT(ActorDefinitionDict, const char *, M_CSTR_OPLIST, ActorDefinition *, M_PTR_OPLIST);
+DEFINE_DICT(ActorOutputIdDict, Atom, ATOM_OPLIST, ActorOutputId, M_POD_OPLIST);
+
+DEFINE_DICT(ActorDefinitionDict, Atom, ATOM_OPLIST, ActorDefinition *, M_PTR_OPLIST);
 
 struct ActorDefinition
 {
@@ -57,6 +69,11 @@ struct ActorDefinition
 	/// The list of input handlers
 	ActorInputHandlerFunctionDict inputHandlers;
 
+	/// The ID of each output the actor can fire, by name
+	ActorOutputIdDict outputIds;
+	/// The number of outputs the actor can fire
+	size_t outputCount;
+
 	ActorInteractFunction Interact;
 
 	/// The function to call to initialize the actor
@@ -67,6 +84,9 @@ struct ActorDefinition
 
 	/// The class name of this actor definition
 	const char *className;
+
+	/// The pool the extra data of every actor of this class comes from, created when the class is registered
+	ActorBlockPool *extraDataPool;
 };
 
 /**
@@ -92,8 +112,17 @@ void RegisterActorInput(ActorDefinition *definition, const char *name, ActorInpu
 void UnregisterActorInput(ActorDefinition *definition, const char *name);
 
 /**
- * Register default actor inputs
+ * Register an output that an actor can fire
+ * @param definition The actor definition to modify
+ * @param name The name of the output, which map connections refer to it by
+ * @return The ID of the output, to pass to @c ActorFireOutputId
+ */
+ActorOutputId RegisterActorOutput(ActorDefinition *definition, const char *name);
+
+/**
+ * Register default actor inputs and outputs
  * @param definition The definition to modify
+ * @note This must be called before any other input or output is registered.
  */
 void RegisterDefaultActorInputs(ActorDefinition *definition);
 
@@ -112,10 +141,18 @@ const ActorDefinition *GetActorDefinition(const char *actorType);
 /**
  * Get an input handler for an actor definition
  * @param definition The actor definition
- * @param input The signal name
- * @return The signal handler function
+ * @param input The atom of the signal name
+ * @return The signal handler function, or NULL if the definition does not have the input
+ */
+ActorInputHandlerFunction GetActorInputHandler(const ActorDefinition *definition, Atom input);
+
+/**
+ * Get the ID of an output of an actor definition
+ * @param definition The actor definition
+ * @param output The atom of the output name
+ * @return The ID of the output, or @c ACTOR_OUTPUT_INVALID if the definition does not have it
  */
-ActorInputHandlerFunction GetActorInputHandler(const ActorDefinition *definition, const char *input);
+ActorOutputId GetActorOutputId(const ActorDefinition *definition, Atom output);
 
 /**
  * Destroy actor registrations
@@ -0,0 +1,128 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_ACTORIOQUEUE_H
+#define GAME_ACTORIOQUEUE_H
+
+#include <engine/structs/ActorDefinition.h>
+#include <engine/structs/ActorPool.h>
+#include <engine/structs/KVList.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_thread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// The number of events the queue makes room for the first time an input is queued
+#define ACTOR_IO_QUEUE_INITIAL_CAPACITY 256
+/// The most inputs dispatched per physics tick. The rest wait for the next tick, so that huge cascades can't stall one.
+#define ACTOR_IO_EVENTS_PER_TICK 4096
+
+typedef struct Actor Actor;
+typedef struct Map Map;
+typedef struct ActorIoEvent ActorIoEvent;
+typedef struct ActorIoQueue ActorIoQueue;
+
+/**
+ * An input that was sent by an output and is waiting to be dispatched
+ */
+struct ActorIoEvent
+{
+	/// The actor that fired the output, which is sent as NULL if it has been freed since
+	ActorHandle sender;
+	/// The actor the input is sent to, which is skipped if it has been freed since
+	ActorHandle target;
+	/// The handler of the input on the target
+	ActorInputHandlerFunction handler;
+	/// The param to send to the input. Strings point to their interned copy, arrays and KV lists are owned by the event.
+	Param param;
+	/// The physics tick the input is due on
+	uint64_t fireTick;
+	/// The order the input was queued in, so that delayed inputs due on the same tick keep their order
+	uint64_t sequence;
+	/// How many undelayed inputs led up to this one
+	uint32_t chainDepth;
+};
+
+/**
+ * The inputs sent by the outputs of a map's actors, which are dispatched by @c DispatchActorInputs once per physics
+ * tick instead of recursively from wherever the output was fired.
+ * A zeroed queue is a valid empty queue.
+ */
+struct ActorIoQueue
+{
+	/// A ring buffer of the inputs that are due, oldest first
+	ActorIoEvent *events;
+	size_t capacity;
+	/// The index in @c events of the oldest input
+	size_t head;
+	size_t count;
+
+	/// A binary min heap of the inputs that were sent with a delay and are not due yet, by fire tick
+	ActorIoEvent *delayedEvents;
+	size_t delayedCapacity;
+	size_t delayedCount;
+
+	/// The next @c sequence to hand out
+	uint64_t nextSequence;
+
+	/// Held while the queue is used, since outputs can be fired from the physics thread's contact callbacks
+	SDL_SpinLock lock;
+	/// The thread that is dispatching inputs, or 0 if none is. Only inputs it queues are part of a chain.
+	SDL_ThreadID dispatchThread;
+	/// The chain depth of the input that is being dispatched
+	uint32_t dispatchChainDepth;
+
+	/// The number of inputs dispatched on the last tick
+	size_t dispatchedLastTick;
+	/// The number of inputs that were dropped for making a chain deeper than the chain depth limit
+	size_t chainDepthDrops;
+	/// The number of ticks that left inputs for the next tick because they ran out of budget
+	size_t overBudgetTicks;
+};
+
+/**
+ * Queue an input to be sent by @c DispatchActorInputs
+ * @param queue The queue of the map the actors are in
+ * @param sender The actor that fired the output
+ * @param target The actor to send the input to
+ * @param handler The handler of the input on the target
+ * @param param The param to send, which is copied
+ * @param tick The current physics tick of the map
+ * @param delayTicks The number of physics ticks to wait before sending the input, or 0 to send it this tick
+ * @return Whether the input was queued. Undelayed inputs that make a chain deeper than
+ *		   @c GameConfig.actorIoChainDepthLimit are dropped, which stops cycles but also cuts off long acyclic chains.
+ * @note This is safe to call from any thread. It only allocates when the queue has to grow, which is done without the
+ *		 queue locked, or when the param is an array or KV list.
+ */
+bool QueueActorInput(ActorIoQueue *queue,
+					 const Actor *sender,
+					 Actor *target,
+					 ActorInputHandlerFunction handler,
+					 const Param *param,
+					 uint64_t tick,
+					 uint32_t delayTicks);
+
+/**
+ * Send the inputs of a map that are due, including the ones queued while doing so, until the budget runs out
+ * @param map The map whose inputs to send
+ * @param budget The most inputs to send. Inputs that don't fit are sent first on the next call.
+ * @return The number of inputs sent
+ * @note Actors removed by an input are kept until every input has been sent.
+ */
+size_t DispatchActorInputs(Map *map, size_t budget);
+
+/**
+ * Get the number of inputs waiting in a queue, including delayed ones
+ * @param queue The queue
+ */
+size_t GetQueuedActorInputCount(ActorIoQueue *queue);
+
+/**
+ * Free the memory of a queue and the params of the inputs left in it, and reset it to an empty queue
+ * @param queue The queue to destroy
+ */
+void DestroyActorIoQueue(ActorIoQueue *queue);
+
+#endif //GAME_ACTORIOQUEUE_H
@@ -0,0 +1,137 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_ACTORPOOL_H
+#define GAME_ACTORPOOL_H
+
+#include <SDL3/SDL_atomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A reference to a pooled actor that can be checked for whether the actor still exists.
+ * The low @c ACTOR_HANDLE_INDEX_BITS bits are the actor's slot in the pool, and the high 32 bits are the generation of
+ * the slot, which changes every time an actor in the slot is freed.
+ */
+typedef uint64_t ActorHandle;
+
+/// A handle that never refers to an actor
+#define ACTOR_HANDLE_NONE 0
+
+/// The number of bits of a handle that hold the slot index
+#define ACTOR_HANDLE_INDEX_BITS 32
+/// The last generation a slot can have. A slot whose actor is freed at this generation is retired instead of wrapping
+/// around, so that a stale handle can never look valid again.
+#define ACTOR_HANDLE_MAX_GENERATION UINT32_MAX
+/// The most actors that can exist at once
+#define MAX_POOLED_ACTORS (1u << 20)
+
+/// The number of actors in each slab of the pool. Slabs are never moved, so actor pointers stay valid.
+#define ACTOR_POOL_SLAB_SIZE 1024
+
+/// The size of each slab of an @c ActorBlockPool, including the slab header
+#define ACTOR_BLOCK_POOL_SLAB_BYTES (16 * 1024)
+
+typedef struct Actor Actor;
+typedef struct ActorBlockPool ActorBlockPool;
+typedef struct ActorBlockSlab ActorBlockSlab;
+typedef struct ActorPoolStats ActorPoolStats;
+
+/**
+ * A pool of fixed size blocks, used for the extra data of every actor of one class.
+ * A zeroed pool is a valid empty pool, which takes its block size from the first allocation.
+ */
+struct ActorBlockPool
+{
+	/// The size of each block, rounded up to keep every block aligned
+	size_t blockSize;
+	/// The slabs the blocks are carved from, newest first
+	ActorBlockSlab *slabs;
+	/// The blocks that were freed, linked through their first bytes
+	void *freeBlocks;
+	/// Held while allocating or freeing, since map chunks create actors on their own threads
+	SDL_SpinLock lock;
+
+	/// The number of blocks carved from each slab
+	size_t blocksPerSlab;
+	/// The number of blocks handed out and not freed
+	size_t blocksInUse;
+};
+
+struct ActorPoolStats
+{
+	/// The number of actors that exist
+	size_t liveActors;
+	/// The most actors that existed at once
+	size_t peakActors;
+	/// The number of slabs the pool allocated
+	size_t slabCount;
+	/// The number of bytes the pool allocated for slabs
+	size_t bytesReserved;
+	/// The number of slots that ran out of generations and will never be used again
+	size_t retiredSlots;
+	/// The number of times a handle was resolved after its actor was freed
+	size_t staleHandleLookups;
+};
+
+/**
+ * Take a zeroed actor from the pool
+ * @return The actor, whose @c handle is set
+ * @note This is safe to call from any thread.
+ * @warning This will crash the engine on allocation failure or if @c MAX_POOLED_ACTORS actors exist. It does *not*
+ *			return NULL.
+ */
+Actor *AllocPooledActor(void);
+
+/**
+ * Return an actor to the pool, which makes every handle to it stale.
+ * Freed slots are reused oldest first, so that a slot goes through as few generations as possible.
+ * @param actor The actor, which must have come from @c AllocPooledActor
+ */
+void ReleasePooledActor(Actor *actor);
+
+/**
+ * Get the actor a handle refers to
+ * @param handle The handle
+ * @return The actor, or NULL if the handle is @c ACTOR_HANDLE_NONE or the actor has been freed
+ * @note This is safe to call from any thread, but the actor may be freed by another thread once it returns.
+ */
+Actor *GetActorFromHandle(ActorHandle handle);
+
+/**
+ * Get the usage of the actor pool
+ * @param stats The stats to fill in
+ */
+void GetActorPoolStats(ActorPoolStats *stats);
+
+/**
+ * Free every slab of the actor pool, which should only be done once every actor has been freed
+ */
+void DestroyActorPool(void);
+
+/**
+ * Take a zeroed block from a block pool
+ * @param pool The pool
+ * @param size The number of bytes needed, which must not be more than the size of the pool's first allocation
+ * @return The block, which must be freed with @c ReleaseActorBlock
+ * @note This is safe to call from any thread.
+ * @warning This will crash the engine on allocation failure. It does *not* return NULL.
+ */
+void *AllocActorBlock(ActorBlockPool *pool, size_t size);
+
+/**
+ * Return a block to its pool
+ * @param pool The pool the block came from
+ * @param block The block, which may be NULL
+ */
+void ReleaseActorBlock(ActorBlockPool *pool, void *block);
+
+/**
+ * Free every slab of a block pool and reset it to an empty pool, which should only be done once every block has been
+ * freed
+ * @param pool The pool to destroy
+ */
+void DestroyActorBlockPool(ActorBlockPool *pool);
+
+#endif //GAME_ACTORPOOL_H
@@ -0,0 +1,85 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_ATOM_H
+#define GAME_ATOM_H
+
+#include <m-core.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// The most strings that can be interned, including @c ATOM_NONE. The atom table grows as strings are interned, this
+/// only bounds how far.
+#define MAX_ATOMS (1u << 26)
+
+/// The atom of no string. Every other atom is above this, so zeroed atoms are empty.
+#define ATOM_NONE 0
+
+/**
+ * An interned string. Two atoms are equal exactly when their strings are, so they can be compared and hashed as
+ * integers. Atoms stay valid until @c DestroyAtoms.
+ */
+typedef uint32_t Atom;
+
+/// An M*LIB oplist for using atoms as dict keys, hashed with their precomputed hash
+#define ATOM_OPLIST \
+	(INIT(M_INIT_DEFAULT), \
+	 INIT_SET(M_SET_DEFAULT), \
+	 SET(M_SET_DEFAULT), \
+	 CLEAR(M_NOTHING_DEFAULT), \
+	 HASH(AtomHash), \
+	 EQUAL(M_EQUAL_DEFAULT), \
+	 CMP(M_CMP_DEFAULT), \
+	 TYPE(Atom))
+
+/**
+ * Get the atom of a string, adding it to the atom table if it is not there yet
+ * @param string The string, or NULL
+ * @return The atom of the string, or @c ATOM_NONE if it is NULL or @c MAX_ATOMS strings have been interned
+ * @note This is safe to call from any thread. Strings that are already interned are found without locking.
+ */
+Atom Intern(const char *string);
+
+/**
+ * Get the atom of a string that may not be null terminated
+ * @param string The characters of the string
+ * @param length The number of characters, not including any null terminator
+ * @return The atom of the string, or @c ATOM_NONE if @c MAX_ATOMS strings have been interned
+ */
+Atom InternLength(const char *string, size_t length);
+
+/**
+ * Get the atom of a string without interning it
+ * @param string The string
+ * @return The atom of the string, or @c ATOM_NONE if it has never been interned
+ * @note This never locks. A string that has never been interned can't be a key of anything keyed on atoms, so callers
+ *		 looking something up by name can treat @c ATOM_NONE as not found.
+ */
+Atom FindAtom(const char *string);
+
+/**
+ * Get the string of an atom
+ * @param atom The atom
+ * @return The interned string, or NULL for @c ATOM_NONE
+ */
+const char *AtomString(Atom atom);
+
+/**
+ * Get the precomputed hash of an atom's string
+ * @param atom The atom
+ * @return The hash
+ */
+uint32_t AtomHash(Atom atom);
+
+/**
+ * Get the number of interned strings
+ */
+size_t GetAtomCount();
+
+/**
+ * Free every interned string. Every atom is invalid afterward.
+ */
+void DestroyAtoms();
+
+#endif //GAME_ATOM_H
@@ -5,6 +5,8 @@
 #ifndef GLOBALSTATE_H
 #define GLOBALSTATE_H
 
+#include <engine/assets/AsyncAssetLoader.h>
+#include <engine/structs/Asset.h>
 #include <engine/structs/Camera.h>
 #include <engine/structs/GameState.h>
 #include <engine/structs/Item.h>
@@ -150,4 +152,30 @@ void DestroyGlobalState();
  */
 bool ChangeMapByName(const char *name);
 
+/**
+ * Change the map to an already loaded map asset
+ * @param name Map name to change to
+ * @param mapAsset The uncached map asset, such as one loaded with @c LoadMapAssetAsync. This takes ownership of it.
+ * @warning Don't use this from MainState, use @c LoadingSelectStateSet instead to avoid potential crashes
+ */
+bool ChangeMapFromAsset(const char *name, Asset *mapAsset);
+
+/**
+ * Change the map to a map that was loaded in the background, and finish loading it
+ * @param name Map name to change to
+ * @param map The map, such as one from @c TakePreloadedMap. This takes ownership of it.
+ * @return Whether the map was changed, which is false if @c map is NULL
+ * @warning Don't use this from MainState, use @c LoadingSelectStateSet instead to avoid potential crashes
+ */
+bool ChangeMapFromPreload(const char *name, Map *map);
+
+/**
+ * Start loading the asset of a map by name on the asset loader threads
+ * @param name The name of the map to load
+ * @param callback Called on the main thread with the (uncached) map asset
+ * @param userData Passed to the callback
+ * @return The ticket of the load, or @c ASSET_LOAD_TICKET_INVALID if the name is invalid
+ */
+AssetLoadTicket LoadMapAssetAsync(const char *name, AssetLoadCallback callback, void *userData);
+
 #endif //GLOBALSTATE_H
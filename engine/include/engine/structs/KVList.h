@@ -7,6 +7,7 @@
 
 #include <engine/assets/DataReader.h>
 #include <engine/assets/DataWriter.h>
+#include <engine/structs/Atom.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/Dict.h>
 #include <engine/structs/Vector2.h>
@@ -118,7 +119,8 @@ void FreeParam(Param *param);
 #pragma endregion
 
 // TODO find a way to not leak this into anyone who includes this
-DEFINE_DICT(KvList, const char *, STR_OPLIST, Param, PARAM_OPLIST);
+// Keyed on atoms, so that keys aren't copied for every list and lookups hash an integer
+DEFINE_DICT(KvList, Atom, ATOM_OPLIST, Param, PARAM_OPLIST);
 
 /**
  * Creates a key-value list.
@@ -7,15 +7,24 @@
 
 #include <engine/assets/MapMaterialLoader.h>
 #include <engine/structs/Actor.h>
+#include <engine/structs/ActorIoQueue.h>
+#include <engine/structs/Atom.h>
 #include <engine/structs/Camera.h>
 #include <engine/structs/Color.h>
+#include <engine/structs/Dict.h>
+#include <engine/structs/KVList.h>
 #include <engine/structs/Light.h>
 #include <engine/structs/List.h>
+#include <engine/structs/MapArena.h>
 #include <engine/structs/Player.h>
 #include <engine/structs/Vector2.h>
 #include <engine/structs/Viewmodel.h>
 #include <joltc/joltc.h>
+#include <joltc/Math/Transform.h>
 #include <joltc/Math/Vector3.h>
+#include <joltc/Physics/Collision/Shape/Shape.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_mutex.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -24,6 +33,12 @@ typedef struct Map Map;
 typedef struct MapVertex MapVertex;
 typedef struct MapModel MapModel;
 typedef struct MapTransition MapTransition;
+typedef struct MapPendingActor MapPendingActor;
+typedef struct NamedActorSet NamedActorSet;
+typedef struct NamedActorIterator NamedActorIterator;
+
+/// How many actors can share a name before the actors of that name need an allocation of their own
+#define NAMED_ACTOR_INLINE_CAPACITY 4
 
 typedef enum MapChangeFlags MapChangeFlags;
 
@@ -66,6 +81,47 @@ struct MapTransition
 	Vector3 relativeAngles;
 };
 
+/**
+ * An actor that was read by a detached map load, to be created once the map is swapped in
+ */
+struct MapPendingActor
+{
+	Atom actorClass;
+	Transform transform;
+	KvList params;
+	LockingList ioConnections;
+};
+
+/**
+ * The actors that share a name, in the order they were named
+ */
+struct NamedActorSet
+{
+	/// The name, which is also the key of the set in @c NamedActorIndex
+	Atom name;
+	size_t count;
+	/// The first @c NAMED_ACTOR_INLINE_CAPACITY actors
+	Actor *inlineActors[NAMED_ACTOR_INLINE_CAPACITY];
+	/// The actors after the inline ones, or NULL if they all fit inline
+	Actor **overflowActors;
+	size_t overflowCapacity;
+};
+
+DEFINE_DICT(NamedActorIndex, Atom, ATOM_OPLIST, NamedActorSet, M_POD_OPLIST);
+
+/**
+ * Walks over the actors with a given name without allocating, from @c IterateActorsByName
+ */
+struct NamedActorIterator
+{
+	const Map *map;
+	Atom name;
+	/// The index of the next actor in the name's @c NamedActorSet
+	size_t next;
+	/// The actor returned last, used to notice it being removed or renamed by the caller
+	const Actor *previous;
+};
+
 struct Map
 {
 	char *mapName;
@@ -74,7 +130,8 @@ struct Map
 	/// The display name this map uses for Discord RPC
 	char *discordRpcName;
 
-	/// The list of actors in the map
+	/// The list of actors in the map, in no particular order since removing an actor moves the last one into its place.
+	/// A chunk instead holds the handles of the actors it added to the map it is attached to, in a @c LIST_UINT64.
 	LockingList actors;
 
 	/// Ths number of map models in this map
@@ -106,10 +163,20 @@ struct Map
 	/// The player object
 	Player player;
 
-	/// The map of named actors in the map (key portion)
-	LockingList namedActorNames;
-	/// The map of named actors in the map (value portion)
-	List namedActorPointers;
+	/// The named actors in the map, by name
+	NamedActorIndex namedActors;
+	/// Held while @c namedActors is used, since outputs can be fired from the physics thread
+	SDL_Mutex *namedActorsMutex;
+	/// Bumped whenever an actor is named or unnamed, which makes every actor rebuild its output links
+	SDL_AtomicInt ioLinkGeneration;
+	/// The number of times the output links of an actor have been built, for profiling
+	SDL_AtomicInt ioRelinkCount;
+	/// The inputs sent by outputs that have not been dispatched yet
+	ActorIoQueue ioQueue;
+	/// Nonzero while the inputs in @c ioQueue are being dispatched
+	SDL_AtomicInt ioDispatchDepth;
+	/// Actors removed while inputs were being dispatched, which are freed once the dispatch finishes
+	LockingList removedActors;
 
 	/// A pointer to the I/O proxy actor, if it exists
 	Actor *ioProxy;
@@ -132,6 +199,24 @@ struct Map
 	Light *pointLights;
 
 	MapTransition *transition;
+
+	/// Actors read by @c LoadMapDetached that have not been created yet
+	List pendingActors;
+	/// The material name of each model, if the map was loaded by @c LoadMapDetached and not finished yet
+	char **pendingMaterialNames;
+
+	/// The number of collision shapes read by @c LoadMapChunk that have no body yet
+	size_t pendingCollisionCount;
+	/// The collision shapes read by @c LoadMapChunk, which get a body once the chunk is attached
+	JPH_Shape **pendingCollisionShapes;
+	/// The position of the body of each shape in @c pendingCollisionShapes
+	Vector3 *pendingCollisionPositions;
+
+	/// The chunks this map streams in and out, owned by the map chunk streamer
+	List chunks;
+
+	/// Holds the data read from the map file and the actors created while loading, all freed with the map
+	MapArena arena;
 };
 
 /**
@@ -140,6 +225,13 @@ struct Map
  */
 Map *CreateMap(void);
 
+/**
+ * Create an empty map to load a chunk into.
+ * Chunks share the physics system and player of the map they are attached to, so they have neither of their own.
+ * @return Blank chunk map
+ */
+Map *CreateMapChunk(void);
+
 /**
  * Free data from a map that is only used when first loading it
  * @param map The map to free data from
@@ -152,6 +244,14 @@ void FreeLoadTimeMapData(Map *map);
  */
 void DestroyMap(Map *map);
 
+/**
+ * Remove a chunk from the map it is attached to and destroy it
+ * @param map The map the chunk is attached to, or NULL if it was never attached
+ * @param chunk The chunk to destroy
+ * @note The physics thread and LOD thread must not be running while a chunk that is attached is destroyed.
+ */
+void DestroyMapChunk(Map *map, Map *chunk);
+
 /**
  * Add an actor to the map
  * @param actor Actor to add
@@ -159,6 +259,13 @@ void DestroyMap(Map *map);
  */
 void AddActor(Actor *actor);
 
+/**
+ * Add an actor to a map's actor list
+ * @param actor The actor to add, which must not be in an actor list already
+ * @param map The map to add the actor to
+ */
+void AddActorToMap(Actor *actor, Map *map);
+
 /**
  * Remove an actor from the map
  * @param actor Actor to remove
@@ -167,20 +274,26 @@ void AddActor(Actor *actor);
 void RemoveActor(Actor *actor);
 
 /**
- * Assign a name to an actor
+ * Assign a name to an actor, replacing the name it had before
  * @param actor The actor to name
  * @param name The name to assign
  * @param map The map within which the actor resides
  */
 void NameActor(Actor *actor, const char *name, Map *map);
 
+/**
+ * Remove the name of an actor, if it has one
+ * @param actor The actor to unname
+ * @param map The map within which the actor resides
+ */
+void UnnameActor(Actor *actor, Map *map);
+
 /**
  * Get a single actor by name
  * @param name The name of the actor
  * @param map The map to search in
  * @return The actor with the given name, or NULL if not found
- * @note This is slow. Use sparingly.
- * @note If there are multiple actors with the same name, whichever one was loaded first will be returned
+ * @note If there are multiple actors with the same name, whichever one was named first will be returned
  */
 Actor *GetActorByName(const char *name, const Map *map);
 
@@ -188,11 +301,51 @@ Actor *GetActorByName(const char *name, const Map *map);
  * Get all actors with a given name
  * @param name The name of the actors
  * @param map The map to search in
- * @param actors The list of actors with the given name.
- * @note This is extra slow. Use even more sparingly.
+ * @param actors The list of actors with the given name, which must be freed by the caller
+ * @note This allocates a list, so prefer @c IterateActorsByName.
  */
 void GetActorsByName(const char *name, const Map *map, List *actors);
 
+/**
+ * Start walking over the actors with a given name
+ * @param name The name of the actors
+ * @param map The map to search in
+ * @param iterator The iterator to pass to @c NextActorByName
+ */
+void IterateActorsByName(const char *name, const Map *map, NamedActorIterator *iterator);
+
+/**
+ * Get the next actor with the iterator's name
+ * @param iterator The iterator from @c IterateActorsByName
+ * @return The next actor, or NULL once every actor has been returned
+ * @note The actor that was returned last may be removed or renamed before the next call, such as by an input handler.
+ */
+Actor *NextActorByName(NamedActorIterator *iterator);
+
+/**
+ * Resolve the I/O connections of an actor to the actors they target, and the input handlers of those actors
+ * @param actor The actor whose connections to link
+ * @param map The map within which the actor resides
+ * @note This is done automatically when the actor fires an output after actors were named or unnamed.
+ */
+void LinkActorOutputs(Actor *actor, Map *map);
+
+/**
+ * Link the outputs of actors that were just loaded into a map.
+ * Debug builds also report connections from outputs the actor does not have, to names no actor has, or to inputs the
+ * target does not have.
+ * @param map The map the actors were loaded into
+ * @param firstActor The index in the map's actor list of the first actor that was loaded, which every actor after it
+ *					 was loaded along with
+ */
+void LinkLoadedActorOutputs(Map *map, size_t firstActor);
+
+/**
+ * Free the actors that were removed while inputs were being dispatched
+ * @param map The map the actors were removed from
+ */
+void FreeRemovedActors(Map *map);
+
 /**
  * Renders a map from a given camera, including actor UI and physics debug.
  * @param map The map to render
@@ -0,0 +1,110 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef GAME_MAPARENA_H
+#define GAME_MAPARENA_H
+
+#include <SDL3/SDL_atomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/// The size of each block the arena allocates from, including the block header
+#define MAP_ARENA_BLOCK_SIZE (64 * 1024)
+
+/// Allocations larger than this get a block of their own, so they don't waste the rest of the current block
+#define MAP_ARENA_LARGE_ALLOCATION (MAP_ARENA_BLOCK_SIZE / 4)
+
+typedef struct MapArena MapArena;
+typedef struct MapArenaBlock MapArenaBlock;
+
+/**
+ * A bump allocator for data that lives exactly as long as a map.
+ * Memory from the arena is never freed on its own, it is all released at once when the arena is destroyed.
+ * A zeroed arena is a valid empty arena.
+ */
+struct MapArena
+{
+	/// The block that is currently being allocated from, followed by every older block
+	MapArenaBlock *blocks;
+	/// Whether the map has finished loading. Sealed arenas are read only, so they can be shared between threads.
+	bool sealed;
+	/// Held while allocating, since the sections of a map may be parsed on several threads at once
+	SDL_SpinLock lock;
+
+	/// The number of allocations made from the arena
+	size_t allocationCount;
+	/// The number of bytes handed out by the arena, including alignment padding
+	size_t bytesAllocated;
+	/// The number of bytes allocated from the heap for blocks
+	size_t bytesReserved;
+	/// The number of blocks in the arena
+	size_t blockCount;
+};
+
+/**
+ * Allocate memory from an arena
+ * @param arena The arena to allocate from, which must not be sealed
+ * @param size The number of bytes to allocate
+ * @return The allocated memory, which is not zeroed
+ * @warning This will crash the engine on allocation failure. It does *not* return NULL.
+ */
+void *MapArenaAlloc(MapArena *arena, size_t size);
+
+/**
+ * Allocate zeroed memory for an array from an arena
+ * @param arena The arena to allocate from, which must not be sealed
+ * @param count The number of elements
+ * @param size The size of each element
+ * @return The zeroed memory
+ */
+void *MapArenaCalloc(MapArena *arena, size_t count, size_t size);
+
+/**
+ * Copy a string into an arena
+ * @param arena The arena to allocate from, which must not be sealed
+ * @param string The string to copy
+ * @return The copy of the string
+ */
+char *MapArenaStrdup(MapArena *arena, const char *string);
+
+/**
+ * Allocate zeroed memory that can be freed on its own with @c MapArenaFree.
+ * It comes from the arena while the arena is not sealed and from the heap otherwise, which is recorded in front of the
+ * allocation.
+ * @param arena The arena to allocate from, or NULL to use the heap
+ * @param size The number of bytes to allocate
+ * @return The zeroed memory
+ * @warning This will crash the engine on allocation failure. It does *not* return NULL.
+ */
+void *MapArenaAllocFreeable(MapArena *arena, size_t size);
+
+/**
+ * Copy a string into memory that can be freed on its own with @c MapArenaFree, see @c MapArenaAllocFreeable
+ * @param arena The arena to allocate from, or NULL to use the heap
+ * @param string The string to copy
+ * @return The copy of the string
+ */
+char *MapArenaStrdupFreeable(MapArena *arena, const char *string);
+
+/**
+ * Free memory from @c MapArenaAllocFreeable or @c MapArenaStrdupFreeable. Memory from an arena is left for the arena to
+ * release, anything else is passed to @c free.
+ * @param pointer The memory to free, which may be NULL
+ */
+void MapArenaFree(void *pointer);
+
+/**
+ * Stop allocating from an arena once the map has finished loading.
+ * Anything allocated with @c MapArenaAllocFreeable after this goes to the heap, so that gameplay can't grow the arena
+ * forever.
+ */
+void MapArenaSeal(MapArena *arena);
+
+/**
+ * Free every block of an arena and reset it to an empty arena
+ * @param arena The arena to destroy
+ */
+void MapArenaDestroy(MapArena *arena);
+
+#endif //GAME_MAPARENA_H
@@ -0,0 +1,45 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <stddef.h>
+
+/// Maximum number of threads in the worker pool, not counting the calling thread
+#define MAX_WORKER_POOL_THREADS 15
+
+/**
+ * A function run by @c ParallelFor for each index
+ * @param index The index to process
+ * @param userData The user data passed to @c ParallelFor
+ */
+typedef void (*ParallelForFunction)(size_t index, void *userData);
+
+/**
+ * Start the worker pool threads
+ */
+void WorkerPoolInit();
+
+/**
+ * Stop the worker pool threads. Must not be called while a @c ParallelFor is running.
+ */
+void WorkerPoolDestroy();
+
+/**
+ * Run a function for every index in [0, count) across the worker pool, and wait for all of them to finish
+ * @param count The number of indices
+ * @param function The function to run for each index
+ * @param userData Passed to the function
+ * @note The calling thread also runs indices, so this is safe to call from any thread, including from inside another
+ *		 @c ParallelFor. If the pool is not running, everything runs on the calling thread.
+ */
+void ParallelFor(size_t count, ParallelForFunction function, void *userData);
+
+/**
+ * Get the number of threads that can run @c ParallelFor work, including the calling thread
+ */
+size_t GetWorkerPoolThreadCount();
+
+#endif //WORKERPOOL_H
@@ -3,22 +3,32 @@
 //
 
 #include <engine/assets/AddonLoader.h>
+#include <engine/assets/AssetManifest.h>
 #include <engine/assets/AssetReader.h>
+#include <engine/assets/AssetWatcher.h>
+#include <engine/assets/AsyncAssetLoader.h>
 #include <engine/assets/GameConfigLoader.h>
 #include <engine/Commit.h>
+#include <engine/debug/AssetBenchmark.h>
+#include <engine/debug/AssetTrace.h>
 #include <engine/debug/DebugEntryManager.h>
 #include <engine/debug/DPrint.h>
 #include <engine/debug/DPrintConsole.h>
 #include <engine/debug/FrameBenchmark.h>
 #include <engine/debug/FrameGrapher.h>
+#include <engine/debug/MapLoadProfiler.h>
 #include <engine/Engine.h>
 #include <engine/graphics/Drawing.h>
 #include <engine/graphics/RenderingHelpers.h>
 #include <engine/helpers/Arguments.h>
+#include <engine/helpers/MapChunkStreamer.h>
+#include <engine/helpers/MapPreloader.h>
 #include <engine/helpers/MathEx.h>
 #include <engine/helpers/PlatformHelpers.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/ActorDefinition.h>
+#include <engine/structs/ActorPool.h>
+#include <engine/structs/Atom.h>
 #include <engine/structs/ControlOptions.h>
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/InputAction.h>
@@ -32,6 +42,7 @@
 #include <engine/subsystem/TextInputSystem.h>
 #include <engine/subsystem/threads/LodThread.h>
 #include <engine/subsystem/threads/PhysicsThread.h>
+#include <engine/subsystem/threads/WorkerPool.h>
 #include <engine/subsystem/Timing.h>
 #include <SDL3/SDL_error.h>
 #include <SDL3/SDL_events.h>
@@ -273,10 +284,22 @@ void InitEngine(const EngineInitializationInfo initInfo)
 	InitAddonLoader();
 
 	InitTimers();
+	InitAssetTrace();
+	InitMapLoadProfiler();
 
 	PhysicsInitGlobal(GetState());
 
+	WorkerPoolInit();
 	AssetCacheInit();
+	InitAsyncAssetLoader();
+	InitMapPreloader();
+	InitAssetWatcher();
+
+	if (HasCliArg("--bench-asset-compression"))
+	{
+		BenchmarkAssetCompression(GetCliArgStr("--bench-asset-compression", MAP("megatest")),
+								  GetCliArgInt("--bench-iterations", 100));
+	}
 
 	InitSDL();
 
@@ -285,6 +308,7 @@ void InitEngine(const EngineInitializationInfo initInfo)
 	RegisterActors(initInfo.RegisterGameActors);
 
 	InitState();
+
 	PhysicsThreadInit();
 
 	if (!RenderPreInit())
@@ -325,6 +349,13 @@ void EngineIteration()
 	{
 		HandleEvent();
 	}
+	ProcessAssetLoadCallbacks();
+	UpdateMapPreloads();
+	if (GetState()->map != NULL)
+	{
+		UpdateMapChunks(GetState()->map);
+	}
+	UpdateMapManifestRecording();
 	GlobalState *state = GetState();
 
 	const double delta = lastFrameTime / TARGET_FPS_NS_D;
@@ -428,9 +459,13 @@ void DestroyEngine()
 	DiscordDestroy();
 	PhysicsThreadTerminate();
 	LodThreadDestroy();
+	DestroyMapPreloader();
+	DestroyAsyncAssetLoader();
 	DestroyFrameGrapher();
 	InputDestroy();
 	DestroyGlobalState();
+	DestroyActorDefinitions();
+	DestroyActorPool(); // Every map must be gone by now
 	DestroySoundSystem();
 	DestroyControls();
 	DestroyDebugEntryManager();
@@ -439,9 +474,14 @@ void DestroyEngine()
 	SDL_DestroyWindow(GetGameWindow());
 	LogDebug("Cleaning up icon...\n");
 	SDL_DestroySurface(windowIcon);
+	DestroyAssetTrace();
+	DestroyMapLoadProfiler();
+	DestroyAssetWatcher();
 	DestroyAssetCache(); // Free all assets
 	DestroyAddonLoader();
 	DestroyGameConfig();
+	WorkerPoolDestroy();
+	DestroyAtoms(); // Every KvList and cache that keys on atoms must be gone by now
 	// Need to clean up logging system before cleaning SDL as logging uses and SDL thread
 	// Logs beyond this point will not be written to the log file, but will still print to stdout
 	LogDestroy();
@@ -9,11 +9,9 @@
 #include <engine/structs/Camera.h>
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/Math/Transform.h>
 #include <joltc/Physics/Body/BodyInterface.h>
 #include <stdbool.h>
-#include <stdlib.h>
 #include <string.h>
 
 typedef struct CameraData
@@ -23,8 +21,7 @@ typedef struct CameraData
 
 static void CameraInit(Actor *this, const KvList params, Transform *transform)
 {
-	this->extraData = calloc(1, sizeof(CameraData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(CameraData));
 	CameraData *data = this->extraData;
 	memcpy(&data->camera.transform, transform, sizeof(Transform));
 	data->camera.fov = (float)KvGetInt(params, "fov", 90);
@@ -8,15 +8,15 @@
 #include <engine/structs/ActorDefinition.h>
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
-#include <engine/subsystem/Error.h>
 #include <engine/subsystem/Logging.h>
 #include <joltc/Math/Quat.h>
 #include <joltc/Math/RVec3.h>
 #include <joltc/Math/Transform.h>
 #include <joltc/Math/Vector3.h>
-#include <stdlib.h>
 #include <string.h>
 
+static ActorOutputId usedOutput;
+
 typedef struct EntranceData
 {
 	char *entranceName;
@@ -45,7 +45,7 @@ static void EntranceUpdate(Actor *this, double /*delta*/)
 			JPH_RVec3_Add(&data->xfm.position, &transition->relativePosition, &finalXfm.position);
 
 			SetPlayerTransform(&GetState()->map->player, &finalXfm);
-			ActorFireOutput(this, ENTRANCE_OUTPUT_USED, PARAM_NONE);
+			ActorFireOutputId(this, usedOutput, PARAM_NONE);
 		}
 	}
 }
@@ -53,17 +53,16 @@ static void EntranceUpdate(Actor *this, double /*delta*/)
 static void EntranceInit(Actor *this, const KvList params, Transform *transform)
 {
 	ActorCreateEmptyBody(this, transform);
-	this->extraData = malloc(sizeof(EntranceData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(EntranceData));
 	EntranceData *data = this->extraData;
-	data->entranceName = strdup(KvGetString(params, "name", ""));
+	data->entranceName = ActorStrdup(this, KvGetString(params, "name", ""));
 	memcpy(&data->xfm, transform, sizeof(Transform));
 }
 
 static void EntranceDestroy(Actor *this)
 {
 	const EntranceData *data = this->extraData;
-	free(data->entranceName);
+	ActorFree(this, data->entranceName);
 }
 
 ActorDefinition entranceActorDefinition = {
@@ -80,5 +79,6 @@ ActorDefinition entranceActorDefinition = {
 void RegisterEntrance()
 {
 	RegisterDefaultActorInputs(&entranceActorDefinition);
+	usedOutput = RegisterActorOutput(&entranceActorDefinition, ENTRANCE_OUTPUT_USED);
 	RegisterActor(ENTRANCE_ACTOR_NAME, &entranceActorDefinition);
 }
@@ -11,11 +11,13 @@
 #include <joltc/Math/Transform.h>
 #include <stddef.h>
 
+static ActorOutputId firstTickOutput;
+
 static void IoProxyUpdate(Actor *this, double /*delta*/)
 {
 	if (GetState()->map->physicsTick == 0)
 	{
-		ActorFireOutput(this, IO_PROXY_OUTPUT_FIRST_TICK, PARAM_NONE);
+		ActorFireOutputId(this, firstTickOutput, PARAM_NONE);
 	}
 }
 
@@ -44,6 +46,7 @@ ActorDefinition ioProxyActorDefinition = {
 void RegisterIoProxy()
 {
 	RegisterDefaultActorInputs(&ioProxyActorDefinition);
+	firstTickOutput = RegisterActorOutput(&ioProxyActorDefinition, IO_PROXY_OUTPUT_FIRST_TICK);
 	UnregisterActorInput(&ioProxyActorDefinition, ACTOR_INPUT_KILL);
 	RegisterActor(IO_PROXY_ACTOR_NAME, &ioProxyActorDefinition);
 }
@@ -0,0 +1,44 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/actor/MapChunk.h>
+#include <engine/helpers/MapChunkStreamer.h>
+#include <engine/structs/Actor.h>
+#include <engine/structs/ActorDefinition.h>
+#include <engine/structs/GlobalState.h>
+#include <engine/structs/KVList.h>
+#include <engine/subsystem/Logging.h>
+#include <joltc/Math/Transform.h>
+#include <stddef.h>
+
+static void MapChunkInit(Actor * /*this*/, const KvList params, Transform *transform)
+{
+	const char *chunkMapName = KvGetString(params, "map_name", "");
+	if (chunkMapName[0] == '\0')
+	{
+		LogError("map_chunk actor has no map_name, so it cannot be streamed in\n");
+		return;
+	}
+	const float loadRadius = KvGetFloat(params, "load_radius", DEFAULT_MAP_CHUNK_LOAD_RADIUS);
+	const float unloadMargin = KvGetFloat(params, "unload_margin", DEFAULT_MAP_CHUNK_UNLOAD_MARGIN);
+	RegisterMapChunk(GetState()->map, chunkMapName, &transform->position, loadRadius, loadRadius + unloadMargin);
+}
+
+ActorDefinition mapChunkActorDefinition = {
+	.Update = DefaultActorUpdate,
+	.OnPlayerContactAdded = DefaultActorOnPlayerContactAdded,
+	.OnPlayerContactPersisted = DefaultActorOnPlayerContactPersisted,
+	.OnPlayerContactRemoved = DefaultActorOnPlayerContactRemoved,
+	.RenderUi = DefaultActorRenderUi,
+	.Interact = DefaultActorInteract,
+	.Destroy = DefaultActorDestroy,
+	.Init = MapChunkInit,
+};
+
+void RegisterMapChunkActor()
+{
+	RegisterDefaultActorInputs(&mapChunkActorDefinition);
+	UnregisterActorInput(&mapChunkActorDefinition, ACTOR_INPUT_KILL);
+	RegisterActor(MAP_CHUNK_ACTOR_NAME, &mapChunkActorDefinition);
+}
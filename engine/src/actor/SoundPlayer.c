@@ -6,16 +6,12 @@
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
 #include <engine/structs/KVList.h>
-#include <engine/subsystem/Error.h>
 #include <engine/subsystem/SoundSystem.h>
 #include <joltc/Math/RVec3.h>
 #include <joltc/Math/Transform.h>
 #include <joltc/Physics/Body/BodyInterface.h>
 #include <stdbool.h>
 #include <stddef.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
 
 typedef struct SoundPlayerData
 {
@@ -43,7 +39,7 @@ static void SoundPlayerDestroy(Actor *this)
 	{
 		StopSound(data->effect);
 	}
-	free(data->asset);
+	ActorFree(this, data->asset);
 }
 
 static void SoundPlayerPlayHandler(Actor *this, const Actor * /*sender*/, const Param * /*param*/)
@@ -85,19 +81,16 @@ static void SoundPlayerStopHandler(Actor *this, const Actor * /*sender*/, const
 
 static void SoundPlayerInit(Actor *this, const KvList params, Transform *transform)
 {
-	SoundPlayerData *data = calloc(1, sizeof(SoundPlayerData));
-	CheckAlloc(data);
+	SoundPlayerData *data = ActorAllocExtraData(this, sizeof(SoundPlayerData));
 	data->effect = NULL;
 	const char *soundAsset = KvGetString(params, "sound", "sfx/click");
-	data->asset = malloc(strlen(soundAsset) + 1);
-	sprintf(data->asset, "%s", soundAsset);
+	data->asset = ActorStrdup(this, soundAsset);
 	data->loops = KvGetInt(params, "loops", 0);
 	data->volume = KvGetFloat(params, "volume", 1);
 	data->preload = KvGetBool(params, "preload", false);
 	data->category = KvGetByte(params, "category", SOUND_CATEGORY_SFX);
 	data->positional = KvGetBool(params, "positional", false);
 	ActorCreateEmptyBody(this, transform);
-	this->extraData = data;
 }
 
 ActorDefinition soundPlayerActorDefinition = {
@@ -3,12 +3,12 @@
 //
 
 #include <engine/actor/Trigger.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Map.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/constants.h>
 #include <joltc/enums.h>
 #include <joltc/joltc.h>
@@ -19,7 +19,10 @@
 #include <joltc/Physics/Body/BodyInterface.h>
 #include <joltc/Physics/Collision/Shape/Shape.h>
 #include <stdbool.h>
-#include <stdlib.h>
+
+static ActorOutputId triggeredOutput;
+static ActorOutputId enteredOutput;
+static ActorOutputId exitedOutput;
 
 typedef struct TriggerData
 {
@@ -41,16 +44,14 @@ static inline void CreateTriggerSensor(Actor *this, const Transform *transform)
 																						   OBJECT_LAYER_SENSOR,
 																						   this);
 	JPH_BodyCreationSettings_SetIsSensor(bodyCreationSettings, true);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_Shape_Destroy(shape);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
 
 static void TriggerForceTriggerHandler(Actor *this, const Actor * /*sender*/, const Param * /*param*/)
 {
-	ActorFireOutput(this, TRIGGER_OUTPUT_TRIGGERED, PARAM_NONE);
+	ActorFireOutputId(this, triggeredOutput, PARAM_NONE);
 }
 
 static void TriggerEnableHandler(Actor *this, const Actor * /*sender*/, const Param * /*param*/)
@@ -70,8 +71,8 @@ static void TriggerOnPlayerContactAdded(Actor *this, JPH_BodyID /*bodyId*/)
 	const TriggerData *data = this->extraData;
 	if (data->enabled)
 	{
-		ActorFireOutput(this, TRIGGER_OUTPUT_ENTERED, PARAM_NONE);
-		ActorFireOutput(this, TRIGGER_OUTPUT_TRIGGERED, PARAM_NONE);
+		ActorFireOutputId(this, enteredOutput, PARAM_NONE);
+		ActorFireOutputId(this, triggeredOutput, PARAM_NONE);
 	}
 }
 
@@ -80,7 +81,7 @@ static void TriggerOnPlayerContactPersisted(Actor *this, JPH_BodyID /*bodyId*/)
 	const TriggerData *data = this->extraData;
 	if (!data->oneShot && data->enabled)
 	{
-		ActorFireOutput(this, TRIGGER_OUTPUT_TRIGGERED, PARAM_NONE);
+		ActorFireOutputId(this, triggeredOutput, PARAM_NONE);
 	}
 }
 
@@ -89,7 +90,7 @@ static void TriggerOnPlayerContactRemoved(Actor *this, JPH_BodyID /*bodyId*/)
 	const TriggerData *data = this->extraData;
 	if (data->enabled)
 	{
-		ActorFireOutput(this, TRIGGER_OUTPUT_EXITED, PARAM_NONE);
+		ActorFireOutputId(this, exitedOutput, PARAM_NONE);
 		if (data->oneShot)
 		{
 			RemoveActor(this);
@@ -99,8 +100,7 @@ static void TriggerOnPlayerContactRemoved(Actor *this, JPH_BodyID /*bodyId*/)
 
 static void TriggerInit(Actor *this, const KvList params, Transform *transform)
 {
-	this->extraData = malloc(sizeof(TriggerData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(TriggerData));
 	TriggerData *data = this->extraData;
 	data->width = KvGetFloat(params, "width", 16.0f);
 	data->height = KvGetFloat(params, "height", 16.0f);
@@ -124,6 +124,9 @@ ActorDefinition triggerActorDefinition = {
 void RegisterTrigger()
 {
 	RegisterDefaultActorInputs(&triggerActorDefinition);
+	triggeredOutput = RegisterActorOutput(&triggerActorDefinition, TRIGGER_OUTPUT_TRIGGERED);
+	enteredOutput = RegisterActorOutput(&triggerActorDefinition, TRIGGER_OUTPUT_ENTERED);
+	exitedOutput = RegisterActorOutput(&triggerActorDefinition, TRIGGER_OUTPUT_EXITED);
 	RegisterActorInput(&triggerActorDefinition, TRIGGER_INPUT_FORCE_TRIGGER, TriggerForceTriggerHandler);
 	RegisterActorInput(&triggerActorDefinition, TRIGGER_INPUT_ENABLE, TriggerEnableHandler);
 	RegisterActorInput(&triggerActorDefinition, TRIGGER_INPUT_DISABLE, TriggerDisableHandler);
@@ -4,6 +4,8 @@
 
 #include <engine/actor/TriggerMap.h>
 #include <engine/gameState/LoadingState.h>
+#include <engine/helpers/MapPreloader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -35,6 +37,8 @@ typedef struct TriggerMapData
 	char *mapName;
 	char *entranceName;
 	Transform xfm;
+	/// How close the player has to be for the map to be preloaded, or 0 to never preload it
+	float preloadRadius;
 } TriggerMapData;
 
 static inline void CreateTriggerMapSensor(Actor *this, const Transform *transform)
@@ -48,9 +52,7 @@ static inline void CreateTriggerMapSensor(Actor *this, const Transform *transfor
 																						   OBJECT_LAYER_SENSOR,
 																						   this);
 	JPH_BodyCreationSettings_SetIsSensor(bodyCreationSettings, true);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_Shape_Destroy(shape);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
@@ -92,6 +94,23 @@ static void TriggerDisableHandler(Actor *this, const Actor * /*sender*/, const P
 	data->enabled = false;
 }
 
+static void TriggerMapUpdate(Actor *this, double /*delta*/)
+{
+	const TriggerMapData *data = this->extraData;
+	if (!data->enabled || data->preloadRadius <= 0 || data->mapName[0] == '\0')
+	{
+		return;
+	}
+	const Vector3 *playerPosition = &GetState()->map->player.transform.position;
+	const float x = playerPosition->x - data->xfm.position.x;
+	const float y = playerPosition->y - data->xfm.position.y;
+	const float z = playerPosition->z - data->xfm.position.z;
+	if ((x * x) + (y * y) + (z * z) <= data->preloadRadius * data->preloadRadius)
+	{
+		RequestMapPreload(data->mapName);
+	}
+}
+
 static void TriggerMapOnPlayerContactPersisted(Actor *this, JPH_BodyID /*bodyId*/)
 {
 	const TriggerMapData *data = this->extraData;
@@ -103,15 +122,15 @@ static void TriggerMapOnPlayerContactPersisted(Actor *this, JPH_BodyID /*bodyId*
 
 static void TriggerMapInit(Actor *this, const KvList params, Transform *transform)
 {
-	this->extraData = malloc(sizeof(TriggerMapData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(TriggerMapData));
 	TriggerMapData *data = this->extraData;
 	data->width = KvGetFloat(params, "width", 16.0f);
 	data->height = KvGetFloat(params, "height", 16.0f);
 	data->depth = KvGetFloat(params, "depth", 16.0f);
 	data->enabled = KvGetBool(params, "start_enabled", true);
-	data->mapName = strdup(KvGetString(params, "map_name", ""));
-	data->entranceName = strdup(KvGetString(params, "entrance_name", ""));
+	data->mapName = ActorStrdup(this, KvGetString(params, "map_name", ""));
+	data->entranceName = ActorStrdup(this, KvGetString(params, "entrance_name", ""));
+	data->preloadRadius = KvGetFloat(params, "preload_radius", DEFAULT_MAP_PRELOAD_RADIUS);
 	memcpy(&data->xfm, transform, sizeof(Transform));
 
 	CreateTriggerMapSensor(this, transform);
@@ -120,12 +139,12 @@ static void TriggerMapInit(Actor *this, const KvList params, Transform *transfor
 static void TriggerMapDestroy(Actor *this)
 {
 	const TriggerMapData *data = this->extraData;
-	free(data->mapName);
-	free(data->entranceName);
+	ActorFree(this, data->mapName);
+	ActorFree(this, data->entranceName);
 }
 
 ActorDefinition triggerMapActorDefinition = {
-	.Update = DefaultActorUpdate,
+	.Update = TriggerMapUpdate,
 	.OnPlayerContactAdded = DefaultActorOnPlayerContactAdded,
 	.OnPlayerContactPersisted = TriggerMapOnPlayerContactPersisted,
 	.OnPlayerContactRemoved = DefaultActorOnPlayerContactRemoved,
@@ -11,14 +11,12 @@
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Map.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/Math/Quat.h>
 #include <joltc/Math/Transform.h>
 #include <joltc/Math/Vector3.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <stdlib.h>
 
 static Actor *interpolatingActor = NULL;
 
@@ -38,8 +36,7 @@ typedef struct GlobalFogData
 
 static void GlobalFogInit(Actor *this, const KvList params, Transform *transform)
 {
-	this->extraData = calloc(1, sizeof(GlobalFogData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(GlobalFogData));
 	GlobalFogData *data = this->extraData;
 	Vector3 euler;
 	JPH_Quat_GetEulerAngles(&transform->rotation, &euler);
@@ -11,12 +11,10 @@
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Map.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/Math/Transform.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <stdlib.h>
 
 static Actor *interpolatingActor = NULL;
 
@@ -32,8 +30,7 @@ typedef struct GlobalLightData
 
 static void GlobalLightInit(Actor *this, const KvList params, Transform * /*transform*/)
 {
-	this->extraData = calloc(1, sizeof(GlobalLightData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(GlobalLightData));
 	GlobalLightData *data = this->extraData;
 	data->lightColor = KvGetColor(params, "light_color", COLOR_WHITE);
 	data->interpolationTicks = KvGetInt(params, "interpolation_ticks", PHYSICS_TARGET_TPS);
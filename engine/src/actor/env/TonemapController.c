@@ -10,12 +10,10 @@
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Map.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/Math/Transform.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <stdlib.h>
 
 static Actor *interpolatingActor = NULL;
 
@@ -31,8 +29,7 @@ typedef struct TonemapControllerData
 
 static void TonemapControllerInit(Actor *this, const KvList params, Transform * /*transform*/)
 {
-	this->extraData = calloc(1, sizeof(TonemapControllerData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(TonemapControllerData));
 	TonemapControllerData *data = this->extraData;
 	data->exposure = KvGetFloat(params, "exposure", 1.0f);
 	data->interpolationTicks = KvGetInt(params, "interpolation_ticks", PHYSICS_TARGET_TPS);
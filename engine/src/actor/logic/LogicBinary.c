@@ -6,11 +6,13 @@
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
 #include <engine/structs/KVList.h>
-#include <engine/subsystem/Error.h>
 #include <engine/subsystem/Logging.h>
 #include <joltc/Math/Transform.h>
 #include <stdbool.h>
-#include <stdlib.h>
+
+static ActorOutputId onTrueOutput;
+static ActorOutputId onFalseOutput;
+static ActorOutputId executionResultOutput;
 
 typedef enum LogicOp
 {
@@ -65,18 +67,17 @@ static void LogicBinaryExecuteHandler(Actor *this, const Actor * /*sender*/, con
 	}
 	if (result)
 	{
-		ActorFireOutput(this, LOGIC_BINARY_OUTPUT_ON_TRUE, PARAM_NONE);
+		ActorFireOutputId(this, onTrueOutput, PARAM_NONE);
 	} else
 	{
-		ActorFireOutput(this, LOGIC_BINARY_OUTPUT_ON_FALSE, PARAM_NONE);
+		ActorFireOutputId(this, onFalseOutput, PARAM_NONE);
 	}
-	ActorFireOutput(this, LOGIC_BINARY_OUTPUT_EXECUTION_RESULT, PARAM_BOOL(result));
+	ActorFireOutputId(this, executionResultOutput, PARAM_BOOL(result));
 }
 
 static void LogicBinaryInit(Actor *this, const KvList params, Transform * /*transform*/)
 {
-	this->extraData = malloc(sizeof(LogicBinaryData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(LogicBinaryData));
 	LogicBinaryData *data = this->extraData;
 	data->operandA = false;
 	data->operandB = false;
@@ -97,6 +98,9 @@ ActorDefinition logicBinaryActorDefinition = {
 void RegisterLogicBinary()
 {
 	RegisterDefaultActorInputs(&logicBinaryActorDefinition);
+	onTrueOutput = RegisterActorOutput(&logicBinaryActorDefinition, LOGIC_BINARY_OUTPUT_ON_TRUE);
+	onFalseOutput = RegisterActorOutput(&logicBinaryActorDefinition, LOGIC_BINARY_OUTPUT_ON_FALSE);
+	executionResultOutput = RegisterActorOutput(&logicBinaryActorDefinition, LOGIC_BINARY_OUTPUT_EXECUTION_RESULT);
 	RegisterActorInput(&logicBinaryActorDefinition, LOGIC_BINARY_INPUT_OPERAND_A, LogicBinaryOperandAHandler);
 	RegisterActorInput(&logicBinaryActorDefinition, LOGIC_BINARY_INPUT_OPERAND_B, LogicBinaryOperandBHandler);
 	RegisterActorInput(&logicBinaryActorDefinition, LOGIC_BINARY_INPUT_EXECUTE, LogicBinaryExecuteHandler);
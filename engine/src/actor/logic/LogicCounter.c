@@ -7,10 +7,14 @@
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
 #include <engine/structs/KVList.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/Math/Transform.h>
 #include <stdbool.h>
-#include <stdlib.h>
+
+static ActorOutputId hitMaxOutput;
+static ActorOutputId hitMinOutput;
+static ActorOutputId leftMaxOutput;
+static ActorOutputId leftMinOutput;
+static ActorOutputId counterChangedOutput;
 
 typedef struct LogicCounterData
 {
@@ -33,10 +37,10 @@ static inline void ChangeValue(const int change, LogicCounterData *data, Actor *
 		}
 		if (prevValue < data->max && data->counter == data->max)
 		{
-			ActorFireOutput(this, LOGIC_COUNTER_OUTPUT_HIT_MAX, PARAM_NONE);
+			ActorFireOutputId(this, hitMaxOutput, PARAM_NONE);
 		} else if (prevValue == data->max && data->counter < data->max)
 		{
-			ActorFireOutput(this, LOGIC_COUNTER_OUTPUT_LEFT_MAX, PARAM_NONE);
+			ActorFireOutputId(this, leftMaxOutput, PARAM_NONE);
 		}
 	}
 	if (data->clampToMin)
@@ -47,15 +51,15 @@ static inline void ChangeValue(const int change, LogicCounterData *data, Actor *
 		}
 		if (prevValue > data->min && data->counter == data->min)
 		{
-			ActorFireOutput(this, LOGIC_COUNTER_OUTPUT_HIT_MIN, PARAM_NONE);
+			ActorFireOutputId(this, hitMinOutput, PARAM_NONE);
 		} else if (prevValue == data->min && data->counter > data->min)
 		{
-			ActorFireOutput(this, LOGIC_COUNTER_OUTPUT_LEFT_MIN, PARAM_NONE);
+			ActorFireOutputId(this, leftMinOutput, PARAM_NONE);
 		}
 	}
 	if (prevValue != data->counter)
 	{
-		ActorFireOutput(this, LOGIC_COUNTER_OUTPUT_COUNTER_CHANGED, PARAM_INT(data->counter));
+		ActorFireOutputId(this, counterChangedOutput, PARAM_INT(data->counter));
 	}
 }
 
@@ -91,8 +95,7 @@ static void LogicCounterDecrementHandler(Actor *this, const Actor * /*sender*/,
 
 static void LogicCounterInit(Actor *this, const KvList params, Transform * /*transform*/)
 {
-	this->extraData = malloc(sizeof(LogicCounterData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(LogicCounterData));
 	LogicCounterData *data = this->extraData;
 	data->min = KvGetInt(params, "min", 0);
 	data->max = KvGetInt(params, "max", 100);
@@ -116,6 +119,11 @@ ActorDefinition logicCounterActorDefinition = {
 void RegisterLogicCounter()
 {
 	RegisterDefaultActorInputs(&logicCounterActorDefinition);
+	hitMaxOutput = RegisterActorOutput(&logicCounterActorDefinition, LOGIC_COUNTER_OUTPUT_HIT_MAX);
+	hitMinOutput = RegisterActorOutput(&logicCounterActorDefinition, LOGIC_COUNTER_OUTPUT_HIT_MIN);
+	leftMaxOutput = RegisterActorOutput(&logicCounterActorDefinition, LOGIC_COUNTER_OUTPUT_LEFT_MAX);
+	leftMinOutput = RegisterActorOutput(&logicCounterActorDefinition, LOGIC_COUNTER_OUTPUT_LEFT_MIN);
+	counterChangedOutput = RegisterActorOutput(&logicCounterActorDefinition, LOGIC_COUNTER_OUTPUT_COUNTER_CHANGED);
 	RegisterActorInput(&logicCounterActorDefinition, LOGIC_COUNTER_INPUT_ADD, LogicCounterAddHandler);
 	RegisterActorInput(&logicCounterActorDefinition, LOGIC_COUNTER_INPUT_SUBTRACT, LogicCounterSubtractHandler);
 	RegisterActorInput(&logicCounterActorDefinition, LOGIC_COUNTER_INPUT_INCREMENT, LogicCounterIncrementHandler);
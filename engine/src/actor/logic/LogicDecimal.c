@@ -6,11 +6,13 @@
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
 #include <engine/structs/KVList.h>
-#include <engine/subsystem/Error.h>
 #include <engine/subsystem/Logging.h>
 #include <joltc/Math/Transform.h>
 #include <stdbool.h>
-#include <stdlib.h>
+
+static ActorOutputId onTrueOutput;
+static ActorOutputId onFalseOutput;
+static ActorOutputId executionResultOutput;
 
 typedef enum LogicDecimalOp
 {
@@ -73,18 +75,17 @@ static void LogicDecimalExecuteHandler(Actor *this, const Actor * /*sender*/, co
 	}
 	if (result)
 	{
-		ActorFireOutput(this, LOGIC_DECIMAL_OUTPUT_ON_TRUE, PARAM_NONE);
+		ActorFireOutputId(this, onTrueOutput, PARAM_NONE);
 	} else
 	{
-		ActorFireOutput(this, LOGIC_DECIMAL_OUTPUT_ON_FALSE, PARAM_NONE);
+		ActorFireOutputId(this, onFalseOutput, PARAM_NONE);
 	}
-	ActorFireOutput(this, LOGIC_DECIMAL_OUTPUT_EXECUTION_RESULT, PARAM_BOOL(result));
+	ActorFireOutputId(this, executionResultOutput, PARAM_BOOL(result));
 }
 
 static void LogicDecimalInit(Actor *this, const KvList params, Transform * /*transform*/)
 {
-	this->extraData = malloc(sizeof(LogicDecimalData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(LogicDecimalData));
 	LogicDecimalData *data = this->extraData;
 	data->operandA = KvGetFloat(params, "operandA", .0f);
 	data->operandB = KvGetFloat(params, "operandB", .0f);
@@ -105,6 +106,9 @@ ActorDefinition logicDecimalActorDefinition = {
 void RegisterLogicDecimal()
 {
 	RegisterDefaultActorInputs(&logicDecimalActorDefinition);
+	onTrueOutput = RegisterActorOutput(&logicDecimalActorDefinition, LOGIC_DECIMAL_OUTPUT_ON_TRUE);
+	onFalseOutput = RegisterActorOutput(&logicDecimalActorDefinition, LOGIC_DECIMAL_OUTPUT_ON_FALSE);
+	executionResultOutput = RegisterActorOutput(&logicDecimalActorDefinition, LOGIC_DECIMAL_OUTPUT_EXECUTION_RESULT);
 	RegisterActorInput(&logicDecimalActorDefinition, LOGIC_DECIMAL_INPUT_OPERAND_A, LogicDecimalOperandAHandler);
 	RegisterActorInput(&logicDecimalActorDefinition, LOGIC_DECIMAL_INPUT_OPERAND_B, LogicDecimalOperandBHandler);
 	RegisterActorInput(&logicDecimalActorDefinition, LOGIC_DECIMAL_INPUT_EXECUTE, LogicDecimalExecuteHandler);
@@ -5,6 +5,7 @@
 #include <engine/actor/prop/Button.h>
 #include <engine/assets/AssetReader.h>
 #include <engine/assets/ModelLoader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -19,6 +20,9 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+static ActorOutputId pressedOutput;
+static ActorOutputId unpressedOutput;
+
 typedef struct ButtonData
 {
 	uint32_t offSkin;
@@ -36,9 +40,7 @@ static inline void CreateButtonCollider(Actor *this, const Transform *transform,
 																						   JPH_MotionType_Static,
 																						   OBJECT_LAYER_STATIC,
 																						   this);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
 
@@ -52,7 +54,7 @@ static void ButtonUpdate(Actor *this, const double /*delta*/)
 		{
 			data->pressed = false;
 			this->currentSkinIndex = data->offSkin;
-			ActorFireOutput(this, BUTTON_OUTPUT_UNPRESSED, PARAM_NONE);
+			ActorFireOutputId(this, unpressedOutput, PARAM_NONE);
 		}
 	}
 }
@@ -71,8 +73,7 @@ static void ButtonInit(Actor *this, const KvList params, Transform *transform)
 		this->flags |= ACTOR_FLAG_USING_BOUNDING_BOX_COLLISION;
 	}
 	CreateButtonCollider(this, transform, shape);
-	ButtonData *data = malloc(sizeof(ButtonData));
-	this->extraData = data;
+	ButtonData *data = ActorAllocExtraData(this, sizeof(ButtonData));
 	data->offSkin = KvGetInt(params, "off_skin", 0);
 	data->onSkin = KvGetInt(params, "on_skin", 1);
 	data->pressed = KvGetBool(params, "start_pressed", false);
@@ -95,7 +96,7 @@ static void ButtonInteract(Actor *this)
 	data->pressed = !data->pressed;
 	this->currentSkinIndex = data->pressed ? data->onSkin : data->offSkin;
 	data->timePressed = GetTimeMs();
-	ActorFireOutput(this, data->pressed ? BUTTON_OUTPUT_PRESSED : BUTTON_OUTPUT_UNPRESSED, PARAM_NONE);
+	ActorFireOutputId(this, data->pressed ? pressedOutput : unpressedOutput, PARAM_NONE);
 }
 
 ActorDefinition buttonActorDefinition = {
@@ -112,5 +113,7 @@ ActorDefinition buttonActorDefinition = {
 void RegisterButton()
 {
 	RegisterDefaultActorInputs(&buttonActorDefinition);
+	pressedOutput = RegisterActorOutput(&buttonActorDefinition, BUTTON_OUTPUT_PRESSED);
+	unpressedOutput = RegisterActorOutput(&buttonActorDefinition, BUTTON_OUTPUT_UNPRESSED);
 	RegisterActor(BUTTON_ACTOR_NAME, &buttonActorDefinition);
 }
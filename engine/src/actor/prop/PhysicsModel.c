@@ -4,6 +4,7 @@
 
 #include <engine/actor/prop/PhysicsModel.h>
 #include <engine/assets/ModelLoader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -52,9 +53,7 @@ static inline void CreatePhysicsModelCollider(Actor *this,
 														   JPH_OverrideMassProperties_CalculateInertia);
 	}
 
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
 
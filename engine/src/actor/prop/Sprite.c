@@ -3,6 +3,7 @@
 //
 
 #include <engine/actor/prop/Sprite.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -10,7 +11,6 @@
 #include <engine/structs/Color.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Vector2.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/enums.h>
 #include <joltc/Math/Transform.h>
 #include <joltc/Physics/Body/BodyCreationSettings.h>
@@ -18,8 +18,6 @@
 #include <joltc/Physics/Body/MassProperties.h>
 #include <joltc/Physics/Collision/Shape/Shape.h>
 #include <stdbool.h>
-#include <stdlib.h>
-#include <string.h>
 
 static inline void CreateSpriteCollider(Actor *this, const Transform *transform)
 {
@@ -35,9 +33,7 @@ static inline void CreateSpriteCollider(Actor *this, const Transform *transform)
 	JPH_BodyCreationSettings_SetMassPropertiesOverride(bodyCreationSettings, &massProperties);
 	JPH_BodyCreationSettings_SetOverrideMassProperties(bodyCreationSettings,
 													   JPH_OverrideMassProperties_CalculateInertia);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_Shape_Destroy(shape);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
@@ -45,13 +41,12 @@ static inline void CreateSpriteCollider(Actor *this, const Transform *transform)
 static void SpriteInit(Actor *this, const KvList params, Transform *transform)
 {
 	const Vector2 size = KvGetVec2(params, "size", v2s(16.0f));
-	this->wall = malloc(sizeof(ActorWall));
-	CheckAlloc(this->wall);
+	this->wall = ActorAlloc(this, sizeof(ActorWall));
 	this->wall->centerOffset = v2s(0);
 	this->wall->orientation = ACTOR_WALL_ORIENTATION_X_AXIS;
 	this->wall->length = size.x;
 	this->wall->height = size.y;
-	this->wall->texture = strdup(KvGetString(params, "texture", "level/uvtest"));
+	this->wall->texture = ActorStrdup(this, KvGetString(params, "texture", "level/uvtest"));
 	this->wall->uvScale = KvGetVec2(params, "uv_scale", v2s(1.0f));
 	this->wall->uvOffset = KvGetVec2(params, "uv_offset", v2s(0.0f));
 	this->wall->unshaded = KvGetBool(params, "unshaded", false);
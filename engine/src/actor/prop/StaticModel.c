@@ -4,6 +4,7 @@
 
 #include <engine/actor/prop/StaticModel.h>
 #include <engine/assets/ModelLoader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -37,9 +38,7 @@ static inline void CreateStaticModelCollider(Actor *this, const Transform *trans
 																	 this);
 		this->flags = ACTOR_FLAG_USING_BOUNDING_BOX_COLLISION;
 	}
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
 
@@ -14,7 +14,6 @@
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Vector2.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/Math/RVec3.h>
 #include <joltc/Math/Transform.h>
 #include <joltc/Physics/Body/BodyInterface.h>
@@ -22,7 +21,6 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <stdlib.h>
 
 typedef struct WorldTextData
 {
@@ -39,15 +37,12 @@ static void WorldTextInit(Actor *this, const KvList params, Transform *transform
 	this->wall = NULL;
 	ActorCreateEmptyBody(this, transform);
 
-	WorldTextData *data = malloc(sizeof(WorldTextData));
-	CheckAlloc(data);
+	WorldTextData *data = ActorAllocExtraData(this, sizeof(WorldTextData));
 	data->backgroundColor = KvGetColor(params, "background_color", COLOR(0x80000000));
 	data->textColor = KvGetColor(params, "text_color", COLOR_WHITE);
 	data->size = KvGetInt(params, "font_size", 16);
-	data->text = strdup(KvGetString(params, "text", "Hello, World!"));
+	data->text = ActorStrdup(this, KvGetString(params, "text", "Hello, World!"));
 	data->visibleDistance = KvGetFloat(params, "visible_distance", 80);
-
-	this->extraData = data;
 }
 
 static void WorldTextRenderUi(Actor *this)
@@ -76,7 +71,7 @@ static void WorldTextRenderUi(Actor *this)
 static void WorldTextDestroy(Actor *this)
 {
 	const WorldTextData *data = this->extraData;
-	free(data->text);
+	ActorFree(this, data->text);
 }
 
 ActorDefinition worldTextActorDefinition = {
@@ -4,6 +4,7 @@
 
 #include <dirent.h>
 #include <engine/assets/AddonLoader.h>
+#include <engine/assets/AssetIndex.h>
 #include <engine/assets/AssetReader.h>
 #include <engine/assets/GameConfigLoader.h>
 #include <engine/assets/KvlFile.h>
@@ -196,4 +197,5 @@ void ApplyAddonAssetPaths()
 		Addon *addon = ListGetPointer(addons, i);
 		ListInsertAfter(gameConfig.assetPaths, 0, &addon->assetPath);
 	}
+	RefreshAssetIndex();
 }
@@ -0,0 +1,460 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <dirent.h>
+#include <engine/assets/AssetIndex.h>
+#include <engine/assets/GameConfigLoader.h>
+#include <engine/assets/PackFile.h>
+#include <engine/debug/DPrint.h>
+#include <engine/structs/Color.h>
+#include <engine/structs/Dict.h>
+#include <engine/structs/List.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <errno.h>
+#include <m-core.h>
+#include <SDL3/SDL_mutex.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+typedef struct AssetPathListing AssetPathListing;
+typedef struct IndexedAsset IndexedAsset;
+
+struct AssetPathListing
+{
+	/// The asset path that was scanned, owned by the game config or an addon
+	const AssetPath *assetPath;
+	/// A copy of the asset path's directory, in case the AssetPath is freed and another one is allocated in its place
+	char *path;
+	/// The assets in the asset path's packs
+	List packedAssets;
+	/// The loose asset files in the asset path
+	List looseAssets;
+};
+
+struct IndexedAsset
+{
+	/// The highest priority asset path containing this asset
+	const AssetPath *assetPath;
+	/// The highest priority asset path with @c ASSET_PATH_ALLOW_CODE_EXECUTION containing this asset, or NULL
+	const AssetPath *codeAssetPath;
+	/// Whether the asset is in a pack of @c assetPath
+	bool packed;
+	/// Whether the asset is in a pack of @c codeAssetPath
+	bool codePacked;
+};
+
+DEFINE_DICT(AssetIndexDict, const char *, STR_OPLIST, IndexedAsset, M_POD_OPLIST);
+
+static bool indexInitialized = false;
+
+/// Listings of every scanned asset path. Only touched on the main thread, but freed with indexMutex held.
+static List listings;
+
+/// Protects everything below
+static SDL_Mutex *indexMutex = NULL;
+/// Every indexed asset by name
+static AssetIndexDict assetIndex;
+/// Every indexed asset name in sorted order, for enumerating folders. Points into the listings.
+static List sortedNames;
+
+/**
+ * Recursively add every file in a directory to a list
+ * @param root The asset path directory
+ * @param relDir The directory relative to root, or an empty string for root itself
+ * @param files The list to add the file names (relative to root) to
+ */
+static void ScanDirectory(const char *root, const char *relDir, List *files)
+{
+	const size_t dirPathLength = strlen(root) + 1 + strlen(relDir) + 1;
+	char *dirPath = malloc(dirPathLength);
+	CheckAlloc(dirPath);
+	snprintf(dirPath, dirPathLength, relDir[0] == '\0' ? "%s%s" : "%s/%s", root, relDir);
+
+	DIR *dir = opendir(dirPath);
+	if (dir == NULL)
+	{
+		if (errno != ENOENT)
+		{
+			LogError("Failed to open directory: %s\nError: %s\n", dirPath, strerror(errno));
+		}
+		free(dirPath);
+		return;
+	}
+
+	const struct dirent *ent = readdir(dir);
+	while (ent != NULL)
+	{
+		if (ent->d_name[0] != '.')
+		{
+			const size_t nameLength = strlen(relDir) + 1 + strlen(ent->d_name) + 1;
+			char *name = malloc(nameLength);
+			CheckAlloc(name);
+			snprintf(name, nameLength, relDir[0] == '\0' ? "%s%s" : "%s/%s", relDir, ent->d_name);
+
+			const size_t fullPathLength = strlen(root) + 1 + nameLength;
+			char *fullPath = malloc(fullPathLength);
+			CheckAlloc(fullPath);
+			snprintf(fullPath, fullPathLength, "%s/%s", root, name);
+
+			struct stat st;
+			if (stat(fullPath, &st) != 0)
+			{
+				free(name);
+			} else if (S_ISDIR(st.st_mode))
+			{
+				ScanDirectory(root, name, files);
+				free(name);
+			} else if (strstr(name, PACK_FILE_EXTENSION) != NULL && relDir[0] == '\0')
+			{
+				// Packs in the root are mounted, not loaded as assets
+				free(name);
+			} else
+			{
+				ListAdd(*files, name);
+			}
+			free(fullPath);
+		}
+		ent = readdir(dir);
+	}
+	closedir(dir);
+	free(dirPath);
+}
+
+static AssetPathListing *ScanAssetPath(const AssetPath *assetPath)
+{
+	AssetPathListing *listing = malloc(sizeof(AssetPathListing));
+	CheckAlloc(listing);
+	listing->assetPath = assetPath;
+	listing->path = strdup(assetPath->path);
+	CheckAlloc(listing->path);
+	ListInit(listing->packedAssets, LIST_POINTER);
+	ListInit(listing->looseAssets, LIST_POINTER);
+
+	List packedNames;
+	ListInit(packedNames, LIST_POINTER);
+	ListPackedAssets(assetPath, &packedNames);
+	for (size_t i = 0; i < packedNames.length; i++)
+	{
+		// Copied, since the pack may be unmounted before the listing is dropped
+		char *name = strdup(ListGetPointer(packedNames, i));
+		CheckAlloc(name);
+		ListAdd(listing->packedAssets, name);
+	}
+	ListFree(packedNames);
+
+	ScanDirectory(assetPath->path, "", &listing->looseAssets);
+	return listing;
+}
+
+static void FreeAssetPathListing(AssetPathListing *listing)
+{
+	free(listing->path);
+	ListAndContentsFree(listing->packedAssets);
+	ListAndContentsFree(listing->looseAssets);
+	free(listing);
+}
+
+/**
+ * Find the listing for an asset path
+ * @return The index of the listing, or -1 if the asset path has not been scanned
+ */
+static size_t FindListing(const AssetPath *assetPath)
+{
+	for (size_t i = 0; i < listings.length; i++)
+	{
+		const AssetPathListing *listing = ListGetPointer(listings, i);
+		if (listing->assetPath == assetPath && strcmp(listing->path, assetPath->path) == 0)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Add every asset in a list to the index, unless a higher priority asset path already provides it
+ */
+static void IndexAssets(const AssetPath *assetPath, const List *names, const bool packed)
+{
+	const bool allowCode = (assetPath->flags & ASSET_PATH_ALLOW_CODE_EXECUTION) != 0;
+	for (size_t i = 0; i < names->length; i++)
+	{
+		const char *name = ListGetPointer(*names, i);
+		IndexedAsset *asset = AssetIndexDict_get(assetIndex, name);
+		if (asset == NULL)
+		{
+			asset = AssetIndexDict_safe_get(assetIndex, name);
+			asset->assetPath = assetPath;
+			asset->packed = packed;
+			asset->codeAssetPath = NULL;
+			asset->codePacked = false;
+			ListAdd(sortedNames, (void *)name);
+		}
+		if (allowCode && asset->codeAssetPath == NULL)
+		{
+			asset->codeAssetPath = assetPath;
+			asset->codePacked = packed;
+		}
+	}
+}
+
+static int CompareNames(const void *a, const void *b)
+{
+	return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/**
+ * Rebuild the index from the listings, in asset path priority order. indexMutex must be held.
+ */
+static void RebuildAssetIndex()
+{
+	AssetIndexDict_reset(assetIndex);
+	ListClear(sortedNames);
+	for (size_t i = 0; i < gameConfig.assetPaths.length; i++)
+	{
+		const AssetPath *assetPath = ListGetPointer(gameConfig.assetPaths, i);
+		const size_t listingIndex = FindListing(assetPath);
+		if (listingIndex == (size_t)-1)
+		{
+			continue;
+		}
+		const AssetPathListing *listing = ListGetPointer(listings, listingIndex);
+		// Packs override loose files in the same asset path
+		IndexAssets(assetPath, &listing->packedAssets, true);
+		IndexAssets(assetPath, &listing->looseAssets, false);
+	}
+	if (sortedNames.length > 0)
+	{
+		qsort(sortedNames.data->pointerData, sortedNames.length, sizeof(void *), CompareNames);
+	}
+}
+
+void InitAssetIndex()
+{
+	if (indexMutex == NULL)
+	{
+		indexMutex = SDL_CreateMutex();
+	}
+	SDL_LockMutex(indexMutex);
+	AssetIndexDict_init(assetIndex);
+	ListInit(sortedNames, LIST_POINTER);
+	ListInit(listings, LIST_POINTER);
+	indexInitialized = true;
+	SDL_UnlockMutex(indexMutex);
+
+	RefreshAssetIndex();
+}
+
+void DestroyAssetIndex()
+{
+	if (!indexInitialized)
+	{
+		return;
+	}
+	SDL_LockMutex(indexMutex);
+	indexInitialized = false;
+	AssetIndexDict_clear(assetIndex);
+	ListFree(sortedNames);
+	for (size_t i = 0; i < listings.length; i++)
+	{
+		FreeAssetPathListing(ListGetPointer(listings, i));
+	}
+	ListFree(listings);
+	SDL_UnlockMutex(indexMutex);
+}
+
+void RefreshAssetIndex()
+{
+	if (!indexInitialized)
+	{
+		return;
+	}
+
+	// Scan new asset paths without the lock held, so loads on other threads are not blocked on the disk
+	List newListings;
+	ListInit(newListings, LIST_POINTER);
+	for (size_t i = 0; i < gameConfig.assetPaths.length; i++)
+	{
+		const AssetPath *assetPath = ListGetPointer(gameConfig.assetPaths, i);
+		if (FindListing(assetPath) == (size_t)-1)
+		{
+			ListAdd(newListings, ScanAssetPath(assetPath));
+		}
+	}
+
+	SDL_LockMutex(indexMutex);
+	for (size_t i = listings.length; i > 0; i--)
+	{
+		AssetPathListing *listing = ListGetPointer(listings, i - 1);
+		const size_t pathIndex = ListFind(gameConfig.assetPaths, listing->assetPath);
+		if (pathIndex == (size_t)-1 || strcmp(listing->path, listing->assetPath->path) != 0)
+		{
+			FreeAssetPathListing(listing);
+			ListRemoveAt(listings, i - 1);
+		}
+	}
+	for (size_t i = 0; i < newListings.length; i++)
+	{
+		ListAdd(listings, ListGetPointer(newListings, i));
+	}
+	RebuildAssetIndex();
+	SDL_UnlockMutex(indexMutex);
+
+	LogDebug("Asset index refreshed, scanned %zu new asset path(s)\n", newListings.length);
+	ListFree(newListings);
+}
+
+void AddPathToAssetIndex(const char *root, const char *relPath)
+{
+	if (!indexInitialized)
+	{
+		return;
+	}
+	const size_t fullPathLength = strlen(root) + 1 + strlen(relPath) + 1;
+	char *fullPath = malloc(fullPathLength);
+	CheckAlloc(fullPath);
+	snprintf(fullPath, fullPathLength, "%s/%s", root, relPath);
+
+	List files;
+	ListInit(files, LIST_POINTER);
+	struct stat st;
+	if (stat(fullPath, &st) != 0)
+	{
+		// Already deleted or moved away again
+	} else if (S_ISDIR(st.st_mode))
+	{
+		ScanDirectory(root, relPath, &files);
+	} else if (strstr(relPath, PACK_FILE_EXTENSION) == NULL || strchr(relPath, '/') != NULL)
+	{
+		char *name = strdup(relPath);
+		CheckAlloc(name);
+		ListAdd(files, name);
+	}
+	free(fullPath);
+
+	bool added = false;
+	SDL_LockMutex(indexMutex);
+	for (size_t i = 0; i < listings.length; i++)
+	{
+		AssetPathListing *listing = ListGetPointer(listings, i);
+		if (strcmp(listing->path, root) != 0)
+		{
+			continue;
+		}
+		for (size_t j = 0; j < files.length; j++)
+		{
+			const char *file = ListGetPointer(files, j);
+			bool listed = false;
+			for (size_t k = 0; k < listing->looseAssets.length && !listed; k++)
+			{
+				listed = strcmp(ListGetPointer(listing->looseAssets, k), file) == 0;
+			}
+			if (!listed)
+			{
+				char *name = strdup(file);
+				CheckAlloc(name);
+				ListAdd(listing->looseAssets, name);
+				added = true;
+			}
+		}
+	}
+	// The new files may be in a higher priority asset path than the one an asset was indexed from
+	if (added)
+	{
+		RebuildAssetIndex();
+	}
+	SDL_UnlockMutex(indexMutex);
+	ListAndContentsFree(files);
+}
+
+bool FindIndexedAsset(const char *relPath, const bool isCodeAsset, const AssetPath **assetPath, bool *packed)
+{
+	if (indexMutex == NULL)
+	{
+		return false;
+	}
+	SDL_LockMutex(indexMutex);
+	const IndexedAsset *asset = indexInitialized ? AssetIndexDict_get(assetIndex, relPath) : NULL;
+	bool found = false;
+	if (asset != NULL)
+	{
+		*assetPath = isCodeAsset ? asset->codeAssetPath : asset->assetPath;
+		*packed = isCodeAsset ? asset->codePacked : asset->packed;
+		found = *assetPath != NULL;
+	}
+	SDL_UnlockMutex(indexMutex);
+	return found;
+}
+
+void EnumerateIndexedAssets(const char *folder, const char *extension, const bool recursive, List *output)
+{
+	if (!indexInitialized)
+	{
+		return;
+	}
+	// An empty folder lists everything, so it must not get a separator
+	const size_t prefixLength = folder[0] == '\0' ? 0 : strlen(folder) + 1;
+	char *prefix = malloc(prefixLength + 1);
+	CheckAlloc(prefix);
+	snprintf(prefix, prefixLength + 1, "%s/", folder);
+	const size_t extensionLength = strlen(extension);
+
+	SDL_LockMutex(indexMutex);
+	// Binary search for the first name in the folder, everything in it is contiguous from there
+	size_t low = 0;
+	size_t high = sortedNames.length;
+	while (low < high)
+	{
+		const size_t mid = low + ((high - low) / 2);
+		if (strcmp(ListGetPointer(sortedNames, mid), prefix) < 0)
+		{
+			low = mid + 1;
+		} else
+		{
+			high = mid;
+		}
+	}
+	for (size_t i = low; i < sortedNames.length; i++)
+	{
+		const char *name = ListGetPointer(sortedNames, i);
+		if (strncmp(name, prefix, prefixLength) != 0)
+		{
+			break;
+		}
+		const char *assetName = name + prefixLength;
+		if (!recursive && strchr(assetName, '/') != NULL)
+		{
+			continue;
+		}
+		const size_t assetNameLength = strlen(assetName);
+		if (assetNameLength <= extensionLength ||
+			strcmp(assetName + assetNameLength - extensionLength, extension) != 0)
+		{
+			continue;
+		}
+		char *outputName = malloc(assetNameLength - extensionLength + 1);
+		CheckAlloc(outputName);
+		memcpy(outputName, assetName, assetNameLength - extensionLength);
+		outputName[assetNameLength - extensionLength] = '\0';
+		ListAdd(*output, outputName);
+	}
+	SDL_UnlockMutex(indexMutex);
+	free(prefix);
+}
+
+void DPrintAssetIndex()
+{
+	if (!indexInitialized)
+	{
+		return;
+	}
+	SDL_LockMutex(indexMutex);
+	DPrintF("Asset Index: %zu asset(s) in %zu asset path(s)", COLOR_WHITE, sortedNames.length, listings.length);
+	SDL_UnlockMutex(indexMutex);
+}
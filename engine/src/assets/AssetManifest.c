@@ -0,0 +1,247 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/assets/AssetManifest.h>
+#include <engine/assets/AssetReader.h>
+#include <engine/assets/AsyncAssetLoader.h>
+#include <engine/helpers/Arguments.h>
+#include <engine/structs/Dict.h>
+#include <engine/structs/List.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/Timing.h>
+#include <m-core.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_mutex.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+DEFINE_DICT(ManifestAssetSet, const char *, STR_OPLIST, bool, M_POD_OPLIST);
+
+/// Whether assets are being recorded. Only written on the main thread with manifestMutex held, but read without it by
+/// RecordManifestAsset on the asset loader threads.
+static SDL_AtomicInt isRecording;
+
+/// Protects everything below
+static SDL_Mutex *manifestMutex = NULL;
+/// The map the current recording is for
+static char *recordingMapName = NULL;
+/// When the current recording ends, from @c GetTimeMs, or 0 if the map is still loading
+static uint64_t recordingEndTime = 0;
+/// Every asset recorded so far
+static ManifestAssetSet recordedAssets;
+
+/**
+ * Get the asset path of a map's manifest
+ * @return Whether the map name fits in the path
+ */
+static bool GetManifestPath(const char *mapName, char path[MAX_MANIFEST_PATH_LENGTH])
+{
+	if (snprintf(path, MAX_MANIFEST_PATH_LENGTH, MANIFEST("%s"), mapName) >= MAX_MANIFEST_PATH_LENGTH)
+	{
+		LogError("Map name %s is too long for a manifest\n", mapName);
+		return false;
+	}
+	return true;
+}
+
+void InitAssetManifestRecorder()
+{
+	manifestMutex = SDL_CreateMutex();
+	ManifestAssetSet_init(recordedAssets);
+}
+
+void DestroyAssetManifestRecorder()
+{
+	if (manifestMutex == NULL)
+	{
+		return;
+	}
+	FinishMapManifestRecording();
+	ManifestAssetSet_clear(recordedAssets);
+	SDL_DestroyMutex(manifestMutex);
+	manifestMutex = NULL;
+}
+
+void StartMapManifestRecording(const char *mapName)
+{
+	FinishMapManifestRecording();
+
+	char manifestPath[MAX_MANIFEST_PATH_LENGTH];
+	if (manifestMutex == NULL || !GetManifestPath(mapName, manifestPath))
+	{
+		return;
+	}
+	if (!HasCliArg("--record-manifests") && AssetExists(manifestPath, false))
+	{
+		return;
+	}
+
+	SDL_LockMutex(manifestMutex);
+	recordingMapName = strdup(mapName);
+	CheckAlloc(recordingMapName);
+	recordingEndTime = 0;
+	ManifestAssetSet_reset(recordedAssets);
+	SDL_SetAtomicInt(&isRecording, true);
+	SDL_UnlockMutex(manifestMutex);
+	LogDebug("Recording the asset manifest of map %s\n", mapName);
+}
+
+void StartMapManifestPlayWindow()
+{
+	if (!SDL_GetAtomicInt(&isRecording))
+	{
+		return;
+	}
+	const int seconds = GetCliArgInt("--manifest-record-seconds", DEFAULT_MANIFEST_RECORD_SECONDS);
+	SDL_LockMutex(manifestMutex);
+	recordingEndTime = GetTimeMs() + ((uint64_t)(seconds > 0 ? seconds : 0) * 1000);
+	SDL_UnlockMutex(manifestMutex);
+}
+
+void UpdateMapManifestRecording()
+{
+	if (SDL_GetAtomicInt(&isRecording) && recordingEndTime != 0 && GetTimeMs() >= recordingEndTime)
+	{
+		FinishMapManifestRecording();
+	}
+}
+
+void RecordManifestAsset(const char *relPath, const bool isCodeAsset)
+{
+	if (!SDL_GetAtomicInt(&isRecording) || isCodeAsset)
+	{
+		return;
+	}
+	// Maps are loaded by the loading screen anyway, and prefetching another map would only waste memory
+	const size_t pathLength = strlen(relPath);
+	if (pathLength >= strlen(".gmap") && strcmp(relPath + pathLength - strlen(".gmap"), ".gmap") == 0)
+	{
+		return;
+	}
+	SDL_LockMutex(manifestMutex);
+	if (SDL_GetAtomicInt(&isRecording) && ManifestAssetSet_get(recordedAssets, relPath) == NULL)
+	{
+		ManifestAssetSet_set_at(recordedAssets, relPath, true);
+	}
+	SDL_UnlockMutex(manifestMutex);
+}
+
+static int CompareAssetPaths(const void *a, const void *b)
+{
+	return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/**
+ * Write the recorded assets to a file. Recording must have been stopped already.
+ */
+static void WriteManifest(const char *path)
+{
+	List assets;
+	ListInit(assets, LIST_POINTER);
+	ManifestAssetSet_iterator iterator;
+	for (ManifestAssetSet_it(iterator, recordedAssets); !ManifestAssetSet_end_p(iterator); ManifestAssetSet_next(iterator))
+	{
+		ListAdd(assets, ManifestAssetSet_cref(iterator)->key);
+	}
+	if (assets.length > 0)
+	{
+		// Sorted so that re-recording a map gives a readable diff
+		qsort(assets.data->pointerData, assets.length, sizeof(void *), CompareAssetPaths);
+	}
+
+	FILE *file = fopen(path, "w");
+	if (file == NULL)
+	{
+		LogWarning("Failed to write asset manifest %s\n", path);
+		ListFree(assets);
+		return;
+	}
+	fprintf(file, "# Assets used by map %s, prefetched while it loads\n", recordingMapName);
+	for (size_t i = 0; i < assets.length; i++)
+	{
+		fprintf(file, "%s\n", (const char *)ListGetPointer(assets, i));
+	}
+	fclose(file);
+	LogInfo("Wrote %zu asset(s) to manifest %s\n", assets.length, path);
+	ListFree(assets);
+}
+
+void FinishMapManifestRecording()
+{
+	if (!SDL_GetAtomicInt(&isRecording))
+	{
+		return;
+	}
+	SDL_LockMutex(manifestMutex);
+	SDL_SetAtomicInt(&isRecording, false);
+	SDL_UnlockMutex(manifestMutex);
+
+	// No more assets can be recorded, so the set can be read without the lock from here on
+	char mapPath[MAX_MANIFEST_PATH_LENGTH];
+	if (snprintf(mapPath, MAX_MANIFEST_PATH_LENGTH, MAP("%s"), recordingMapName) < MAX_MANIFEST_PATH_LENGTH)
+	{
+		char *looseMapPath = GetLooseAssetPath(mapPath);
+		if (looseMapPath != NULL)
+		{
+			const size_t baseLength = strlen(looseMapPath) - strlen(".gmap");
+			char *path = malloc(baseLength + strlen(ASSET_MANIFEST_EXTENSION) + 1);
+			CheckAlloc(path);
+			memcpy(path, looseMapPath, baseLength);
+			strcpy(path + baseLength, ASSET_MANIFEST_EXTENSION);
+			WriteManifest(path);
+			free(path);
+			free(looseMapPath);
+		} else
+		{
+			LogDebug("Not writing the asset manifest of map %s, since it is not a loose file\n", recordingMapName);
+		}
+	}
+	ManifestAssetSet_reset(recordedAssets);
+	free(recordingMapName);
+	recordingMapName = NULL;
+}
+
+size_t PrefetchMapManifest(const char *mapName, const AssetLoadCallback callback, void *userData, List *tickets)
+{
+	char manifestPath[MAX_MANIFEST_PATH_LENGTH];
+	if (!GetManifestPath(mapName, manifestPath) || !AssetExists(manifestPath, false))
+	{
+		return 0;
+	}
+	size_t size = 0;
+	uint8_t *data = LoadAssetFileData(manifestPath, false, &size);
+	if (data == NULL)
+	{
+		return 0;
+	}
+	char *text = malloc(size + 1);
+	CheckAlloc(text);
+	memcpy(text, data, size);
+	text[size] = '\0';
+	free(data);
+
+	size_t prefetchCount = 0;
+	char *savePtr = NULL;
+	for (char *line = strtok_r(text, "\r\n", &savePtr); line != NULL; line = strtok_r(NULL, "\r\n", &savePtr))
+	{
+		if (line[0] == '#' || line[0] == '\0')
+		{
+			continue;
+		}
+		const AssetLoadTicket ticket = LoadAssetAsync(line, ASSET_LOAD_PREFETCH, callback, userData);
+		if (ticket != ASSET_LOAD_TICKET_INVALID)
+		{
+			ListAdd(*tickets, ticket);
+			prefetchCount++;
+		}
+	}
+	free(text);
+	LogDebug("Prefetching %zu asset(s) from the manifest of map %s\n", prefetchCount, mapName);
+	return prefetchCount;
+}
@@ -3,14 +3,21 @@
 //
 
 #include <assert.h>
-#include <dirent.h>
 #include <engine/assets/AddonLoader.h>
+#include <engine/assets/AssetIndex.h>
+#include <engine/assets/AssetManifest.h>
 #include <engine/assets/AssetReader.h>
+#include <engine/assets/AsyncAssetLoader.h>
+#include <engine/assets/CookedAssetCache.h>
 #include <engine/assets/DataReader.h>
+#include <engine/assets/DataWriter.h>
 #include <engine/assets/GameConfigLoader.h>
+#include <engine/assets/MapLoader.h>
 #include <engine/assets/MapMaterialLoader.h>
 #include <engine/assets/ModelLoader.h>
+#include <engine/assets/PackFile.h>
 #include <engine/assets/TextureLoader.h>
+#include <engine/debug/AssetTrace.h>
 #include <engine/debug/DPrint.h>
 #include <engine/graphics/Font.h>
 #include <engine/graphics/RenderingHelpers.h>
@@ -23,8 +30,13 @@
 #include <engine/subsystem/Error.h>
 #include <engine/subsystem/Logging.h>
 #include <engine/subsystem/SoundSystem.h>
+#include <engine/subsystem/threads/LodThread.h>
+#include <engine/subsystem/threads/PhysicsThread.h>
+#include <engine/subsystem/threads/WorkerPool.h>
 #include <errno.h>
 #include <m-core.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_mutex.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -39,144 +51,284 @@
 #include <windows.h>
 #endif
 
-DEFINE_DICT(AssetCache, const char *, M_CSTR_OPLIST, Asset, ASSET_OPLIST);
+/// The number of asset types, for per-type cache accounting
+#define ASSET_TYPE_COUNT (ASSET_TYPE_KV_LIST + 1)
+
+typedef struct AssetCacheEntry AssetCacheEntry;
+
+struct AssetCacheEntry
+{
+	/// The cached asset
+	Asset asset;
+	/// The asset's key in the cache, used to erase it when it is evicted
+	char *relPath;
+	/// The next more recently used entry in the cache, or NULL if this is the most recently used one
+	AssetCacheEntry *newer;
+	/// The next less recently used entry in the cache, or NULL if this is the least recently used one
+	AssetCacheEntry *older;
+	/// The number of @c LoadAssetPinned calls that have not been matched with @c UnpinAsset yet
+	uint32_t pinCount;
+	/// Whether the asset was loaded by @c PrefetchAsset and has not been used since
+	bool prefetched;
+	/// Whether the asset was removed from the cache while pinned, so it must be freed by its last @c UnpinAsset
+	bool stale;
+};
+
+// Keys are copied, since they may be erased long after the string passed to LoadAsset is gone.
+// Entries are allocated separately and freed by hand, so that a pinned entry can outlive its key.
+DEFINE_DICT(AssetCache, const char *, STR_OPLIST, AssetCacheEntry *, M_PTR_OPLIST);
 
 static AssetCache assetCache;
+/// Entries that were removed from the cache while pinned, which are freed once they are unpinned
+static List staleAssetCacheEntries;
+/// Protects assetCache and the statistics below, since assets may be loaded from the asset loader threads
+static SDL_Mutex *assetCacheMutex = NULL;
 
-static FILE *OpenAssetFile(const char *relPath, const bool isCodeAsset)
+/// The most recently used entry in the cache
+static AssetCacheEntry *newestAssetCacheEntry = NULL;
+/// The least recently used entry in the cache, where eviction starts
+static AssetCacheEntry *oldestAssetCacheEntry = NULL;
+/// The number of bytes the cache may hold before evicting, or 0 for no limit
+static size_t assetCacheBudget = 0;
+/// The number of decompressed bytes held by the cache
+static size_t assetCacheBytes = 0;
+/// The number of decompressed bytes held by the cache, per asset type
+static size_t assetCacheBytesByType[ASSET_TYPE_COUNT];
+static size_t assetCacheHits = 0;
+static size_t assetCacheMisses = 0;
+static size_t assetCacheEvictions = 0;
+/// The number of prefetched assets that were handed over to an uncached load
+static size_t assetPrefetchHits = 0;
+
+static const char *assetTypeNames[ASSET_TYPE_COUNT] = {
+	[ASSET_TYPE_TEXTURE] = "texture",
+	[ASSET_TYPE_WAV] = "sound",
+	[ASSET_TYPE_MAP] = "map",
+	[ASSET_TYPE_SHADER] = "shader",
+	[ASSET_TYPE_MODEL] = "model",
+	[ASSET_TYPE_FONT] = "font",
+	[ASSET_TYPE_MAP_MATERIAL] = "material",
+	[ASSET_TYPE_KV_LIST] = "kvlist",
+};
+
+/**
+ * Free a cache entry and its asset data
+ */
+static void FreeAssetCacheEntry(AssetCacheEntry *entry)
 {
-	if (strlen(relPath) == 0)
+	free(entry->asset.data);
+	free(entry->relPath);
+	free(entry);
+}
+
+/**
+ * Make an entry the most recently used one. It must not be in the recently used list. The cache mutex must be held.
+ */
+static void LinkAssetCacheEntry(AssetCacheEntry *entry)
+{
+	entry->newer = NULL;
+	entry->older = newestAssetCacheEntry;
+	if (newestAssetCacheEntry != NULL)
 	{
-		LogError("Asset name must not be empty!\n");
-		return NULL;
+		newestAssetCacheEntry->newer = entry;
+	} else
+	{
+		oldestAssetCacheEntry = entry;
+	}
+	newestAssetCacheEntry = entry;
+}
+
+/**
+ * Take an entry out of the recently used list. The cache mutex must be held.
+ */
+static void UnlinkAssetCacheEntry(AssetCacheEntry *entry)
+{
+	if (entry->newer != NULL)
+	{
+		entry->newer->older = entry->older;
+	} else
+	{
+		newestAssetCacheEntry = entry->older;
+	}
+	if (entry->older != NULL)
+	{
+		entry->older->newer = entry->newer;
+	} else
+	{
+		oldestAssetCacheEntry = entry->newer;
+	}
+	entry->newer = NULL;
+	entry->older = NULL;
+}
+
+/**
+ * Look for an asset file in a single asset path, checking its packs before loose files
+ * @param assetPath The asset path to look in
+ * @param relPath The path of the asset, relative to the asset path
+ * @param onlyPacked Whether the asset is known to be in a pack, so the filesystem does not need to be probed
+ * @param file Where to store the opened file if the asset is a loose file
+ * @param packedData Where to store a pointer to the asset file if the asset is in a pack
+ * @param packedSize Where to store the size of the asset file if the asset is in a pack
+ * @param sourcePath Where to store the path of the loose file or pack the asset was found in (must be freed), or NULL
+ * @return Whether the asset was found
+ */
+static bool FindAssetFileInPath(const AssetPath *assetPath,
+								const char *relPath,
+								const bool onlyPacked,
+								FILE **file,
+								const uint8_t **packedData,
+								size_t *packedSize,
+								char **sourcePath)
+{
+	// Packs only override loose files from lower priority asset paths
+	const char *packPath = NULL;
+	if (FindPackedAsset(assetPath, relPath, packedData, packedSize, &packPath))
+	{
+		if (sourcePath)
+		{
+			*sourcePath = strdup(packPath);
+			CheckAlloc(*sourcePath);
+		}
+		return true;
+	}
+	if (onlyPacked)
+	{
+		return false;
 	}
 
 	const size_t maxPathLength = 300;
+	const size_t pathLen = strlen(assetPath->path) + 1 + strlen(relPath) + 1;
+	if (pathLen >= maxPathLength)
+	{
+		LogError("Path is too long: %s\n", relPath);
+		return false;
+	}
 	char *path = calloc(maxPathLength, sizeof(char));
 	CheckAlloc(path);
-	for (size_t i = 0; i < gameConfig.assetPaths.length; i++)
+	snprintf(path, maxPathLength, "%s/%s", assetPath->path, relPath);
+
+	if (access(path, F_OK) != 0)
 	{
-		const AssetPath *assetPath = ListGetPointer(gameConfig.assetPaths, i);
-		if (isCodeAsset && !(assetPath->flags & ASSET_PATH_ALLOW_CODE_EXECUTION))
-		{
-			continue;
-		}
-		const size_t pathLen = strlen(assetPath->path) + 1 + strlen(relPath) + 1;
-		if (pathLen >= maxPathLength)
-		{
-			LogError("Path is too long: %s\n", relPath);
-			continue;
-		}
-		if (snprintf(path, maxPathLength, "%s/%s", assetPath->path, relPath) > (int64_t)maxPathLength)
-		{
-			LogError("Asset path too long!\n");
-			continue;
-		}
+		free(path);
+		return false;
+	}
 
-		if (access(path, F_OK) != 0)
+	char *cPath = CanonicalFilePath(path);
+	if (cPath)
+	{
+		if (strcmp(path, cPath) != 0)
 		{
-			continue;
+			LogError("Resolved asset path \"%s\" was not absolute, refusing to read!\n", path);
+			LogDebug("cPath=%s", cPath);
+			free(cPath);
+			free(path);
+			return false;
 		}
-
-		char *cPath = CanonicalFilePath(path);
-		if (cPath)
-		{
-			if (strcmp(path, cPath) != 0)
-			{
-				LogError("Resolved asset path \"%s\" was not absolute, refusing to read!\n", path);
-				LogDebug("cPath=%s", cPath);
-				free(cPath);
-				continue;
-			}
-		} else
-		{
+	} else
+	{
 #ifdef WIN32
-			LogError("CanonicalFilePath failed! LastError=%d", GetLastError());
+		LogError("CanonicalFilePath failed! LastError=%d", GetLastError());
 #else
-			LogError("CanonicalFilePath failed! errno=%s", strerror(errno));
+		LogError("CanonicalFilePath failed! errno=%s", strerror(errno));
 #endif
-			continue;
-		}
-		free(cPath);
-
-
-		FILE *file = fopen(path, "rb");
-		if (file == NULL)
-		{
-			LogError("Asset fopen on \"%s\" failed! errno=%s", path, strerror(errno));
-			continue;
-		}
-
 		free(path);
+		return false;
+	}
+	free(cPath);
 
-		return file;
+	*file = fopen(path, "rb");
+	if (*file == NULL)
+	{
+		LogError("Asset fopen on \"%s\" failed! errno=%s", path, strerror(errno));
+		free(path);
+		return false;
 	}
 
-	free(path);
-	return NULL;
+	if (sourcePath)
+	{
+		*sourcePath = path;
+	} else
+	{
+		free(path);
+	}
+	return true;
 }
 
-void EnumerateAssetsInFolder(const char *folder, List *output, const char *extension)
+/**
+ * Find an asset file across all asset paths, in priority order
+ * @param relPath The path of the asset, relative to the asset paths
+ * @param isCodeAsset Whether to skip asset paths without @c ASSET_PATH_ALLOW_CODE_EXECUTION
+ * @param file Where to store the opened file if the asset is a loose file
+ * @param packedData Where to store a pointer to the asset file if the asset is in a pack
+ * @param packedSize Where to store the size of the asset file if the asset is in a pack
+ * @param sourcePath Where to store the path of the loose file or pack the asset was found in (must be freed), or NULL
+ * @return Whether the asset was found
+ */
+static bool FindAssetFile(const char *relPath,
+						  const bool isCodeAsset,
+						  FILE **file,
+						  const uint8_t **packedData,
+						  size_t *packedSize,
+						  char **sourcePath)
 {
-	// TODO this should do subfolders
-	ListFreeOnlyContents(*output);
-	ListClear(*output);
+	*file = NULL;
+	*packedData = NULL;
+	if (sourcePath)
+	{
+		*sourcePath = NULL;
+	}
+	if (strlen(relPath) == 0)
+	{
+		LogError("Asset name must not be empty!\n");
+		return false;
+	}
+
+	// The index knows which asset path wins, so only that one needs to be touched
+	const AssetPath *indexedPath = NULL;
+	bool indexedPacked = false;
+	if (FindIndexedAsset(relPath, isCodeAsset, &indexedPath, &indexedPacked) &&
+		FindAssetFileInPath(indexedPath, relPath, indexedPacked, file, packedData, packedSize, sourcePath))
+	{
+		return true;
+	}
+
+	// Not indexed (or changed on disk since the index was built), so probe every asset path
 	for (size_t i = 0; i < gameConfig.assetPaths.length; i++)
 	{
 		const AssetPath *assetPath = ListGetPointer(gameConfig.assetPaths, i);
-		char levelDataPath[300];
-		if (snprintf(levelDataPath, 300, "%s/%s/", assetPath->path, folder) > 300)
+		if (isCodeAsset && !(assetPath->flags & ASSET_PATH_ALLOW_CODE_EXECUTION))
 		{
-			LogError("Asset directory path is too long: %s/%s\n", assetPath->path, folder);
 			continue;
 		}
-
-		DIR *dir = opendir(levelDataPath);
-		if (dir == NULL)
+		if (FindAssetFileInPath(assetPath, relPath, false, file, packedData, packedSize, sourcePath))
 		{
-			if (errno != ENOENT)
-			{
-				LogError("Failed to open directory: %s\nError: %s\n", levelDataPath, strerror(errno));
-			}
-			continue;
+			return true;
 		}
-
-		const struct dirent *ent = readdir(dir);
-		while (ent != NULL)
-		{
-			if (strstr(ent->d_name, extension) != NULL)
-			{
-				char *levelName = malloc(strlen(ent->d_name) + 1);
-				CheckAlloc(levelName);
-				strcpy(levelName, ent->d_name);
-				// Remove the .gmap extension
-				levelName[strlen(levelName) - strlen(extension)] = '\0';
-
-				bool found = false;
-				for (size_t j = 0; j < output->length; j++)
-				{
-					const char *existing = ListGetPointer(*output, j);
-					if (strcmp(levelName, existing) == 0)
-					{
-						found = true;
-						break;
-					}
-				}
-				if (!found)
-				{
-					ListAdd(*output, levelName);
-				}
-			}
-			ent = readdir(dir);
-		}
-		closedir(dir);
 	}
+	return false;
+}
+
+void EnumerateAssetsInFolder(const char *folder, List *output, const char *extension)
+{
+	ListFreeOnlyContents(*output);
+	ListClear(*output);
+	EnumerateIndexedAssets(folder, extension, false, output);
 }
 
 void AssetCacheInit()
 {
 	LogDebug("Initializing asset cache...\n");
+	if (assetCacheMutex == NULL)
+	{
+		assetCacheMutex = SDL_CreateMutex();
+	}
 	AssetCache_init(assetCache);
+	ListInit(staleAssetCacheEntries, LIST_POINTER);
+	assetCacheBudget = gameConfig.assetCacheBudget;
+	MountAssetPacks();
+	InitAssetIndex();
+	InitAssetManifestRecorder();
+	InitCookedAssetCache();
 	InitModelLoader();
 	InitTextureLoader();
 }
@@ -184,17 +336,51 @@ void AssetCacheInit()
 void DestroyAssetCache()
 {
 	LogDebug("Cleaning up asset cache...\n");
+	CancelAllAssetLoads();
+	DestroyAssetManifestRecorder();
+	SDL_LockMutex(assetCacheMutex);
+	size_t pinnedAssets = staleAssetCacheEntries.length;
+	AssetCache_iterator iterator;
+	for (AssetCache_it(iterator, assetCache); !AssetCache_end_p(iterator); AssetCache_next(iterator))
+	{
+		AssetCacheEntry *entry = AssetCache_cref(iterator)->value;
+		pinnedAssets += entry->pinCount > 0 ? 1 : 0;
+		FreeAssetCacheEntry(entry);
+	}
 	AssetCache_clear(assetCache);
+	newestAssetCacheEntry = NULL;
+	oldestAssetCacheEntry = NULL;
+	for (size_t i = 0; i < staleAssetCacheEntries.length; i++)
+	{
+		FreeAssetCacheEntry(ListGetPointer(staleAssetCacheEntries, i));
+	}
+	ListFree(staleAssetCacheEntries);
+	if (pinnedAssets > 0)
+	{
+		LogWarning("Freed %zu asset(s) that were still pinned\n", pinnedAssets);
+	}
+	assetCacheBytes = 0;
+	memset(assetCacheBytesByType, 0, sizeof(assetCacheBytesByType));
+	SDL_UnlockMutex(assetCacheMutex);
 	ClearAddonIcons();
 	DestroyTextureLoader();
 	DestroyModelLoader();
 	DestroyMapMaterialLoader();
 	DestroyFontLoader();
+	DestroyCookedAssetCache();
+	DestroyAssetIndex();
+	UnmountAssetPacks();
 }
 
-static bool DecompressAsset(FILE *file, Asset *dest)
+/**
+ * Read an entire asset file into memory and close it
+ * @param file The file to read
+ * @param data Where to store the allocated file data
+ * @param size Where to store the size of the file data
+ * @return Whether the file was read
+ */
+static bool ReadAssetFile(FILE *file, uint8_t **data, size_t *size)
 {
-	CheckAlloc(dest);
 	fseek(file, 0, SEEK_END);
 	const size_t fileSize = ftell(file);
 
@@ -202,30 +388,192 @@ static bool DecompressAsset(FILE *file, Asset *dest)
 	CheckAlloc(assetData);
 	fseek(file, 0, SEEK_SET);
 	const size_t bytesRead = fread(assetData, 1, fileSize, file);
+	fclose(file);
 	if (bytesRead != fileSize)
 	{
 		free(assetData);
-		fclose(file);
 		LogError("Failed to read asset file\n");
 		return false;
 	}
 
-	fclose(file);
+	*data = assetData;
+	*size = fileSize;
+	return true;
+}
+
+/**
+ * Inflate a version 2 asset payload, which is a single gzip stream
+ * @param payload The compressed payload
+ * @param payloadSize The size of the compressed payload
+ * @param output The buffer to decompress into
+ * @param outputSize The decompressed size of the asset
+ * @return Whether the payload was decompressed
+ */
+static bool InflateSingleStream(const uint8_t *payload,
+								const size_t payloadSize,
+								uint8_t *output,
+								const size_t outputSize)
+{
+	z_stream stream = {0};
+
+	// Initialize the zlib stream
+	stream.next_in = (Bytef *)payload;
+	stream.avail_in = payloadSize;
+	stream.next_out = output;
+	stream.avail_out = outputSize;
+
+	// Initialize the zlib stream
+	if (inflateInit2(&stream, MAX_WBITS | 16) != Z_OK)
+	{
+		LogError("Failed to initialize zlib stream: %s\n", stream.msg);
+		return false;
+	}
+
+	// Decompress the data
+	int inflateReturnValue = inflate(&stream, Z_NO_FLUSH);
+	while (inflateReturnValue != Z_STREAM_END)
+	{
+		if (inflateReturnValue != Z_OK)
+		{
+			LogError("Failed to decompress zlib stream: %s\n", stream.msg);
+			inflateEnd(&stream);
+			return false;
+		}
+		inflateReturnValue = inflate(&stream, Z_NO_FLUSH);
+	}
+
+	// Clean up the zlib stream
+	if (inflateEnd(&stream) != Z_OK)
+	{
+		LogError("Failed to end zlib stream: %s\n", stream.msg);
+		return false;
+	}
+	return true;
+}
+
+typedef struct ChunkInflateJob
+{
+	const uint8_t *chunkData;
+	const uint64_t *chunkEnds;
+	uint32_t chunkSize;
+	uint8_t *output;
+	size_t outputSize;
+	SDL_AtomicInt failed;
+} ChunkInflateJob;
+
+static void InflateChunk(const size_t index, void *userData)
+{
+	ChunkInflateJob *job = userData;
+	uint64_t chunkEnd = 0;
+	uint64_t chunkStart = 0;
+	memcpy(&chunkEnd, &job->chunkEnds[index], sizeof(uint64_t));
+	if (index > 0)
+	{
+		memcpy(&chunkStart, &job->chunkEnds[index - 1], sizeof(uint64_t));
+	}
+	const size_t outputOffset = index * job->chunkSize;
+	uLongf chunkOutputSize = job->outputSize - outputOffset < job->chunkSize ? job->outputSize - outputOffset
+																			  : job->chunkSize;
+	const uLongf expectedSize = chunkOutputSize;
+	if (uncompress(job->output + outputOffset,
+				   &chunkOutputSize,
+				   job->chunkData + chunkStart,
+				   (uLong)(chunkEnd - chunkStart)) != Z_OK ||
+		chunkOutputSize != expectedSize)
+	{
+		SDL_SetAtomicInt(&job->failed, 1);
+	}
+}
+
+/**
+ * Inflate a version 3 asset payload, which is a chunk table followed by independently compressed zlib chunks
+ * @param payload The compressed payload
+ * @param payloadSize The size of the compressed payload
+ * @param output The buffer to decompress into
+ * @param outputSize The decompressed size of the asset
+ * @return Whether the payload was decompressed
+ */
+static bool InflateChunks(const uint8_t *payload, const size_t payloadSize, uint8_t *output, const size_t outputSize)
+{
+	if (payloadSize < ASSET_CHUNK_TABLE_HEADER_SIZE)
+	{
+		LogError("Asset is too small to contain a chunk table\n");
+		return false;
+	}
+	uint32_t chunkSize = 0;
+	uint32_t chunkCount = 0;
+	memcpy(&chunkSize, payload, sizeof(uint32_t));
+	memcpy(&chunkCount, payload + sizeof(uint32_t), sizeof(uint32_t));
+	if (chunkSize == 0 || chunkCount != (outputSize + chunkSize - 1) / chunkSize)
+	{
+		LogError("Asset chunk table does not match the decompressed size\n");
+		return false;
+	}
+	if ((payloadSize - ASSET_CHUNK_TABLE_HEADER_SIZE) / sizeof(uint64_t) < chunkCount)
+	{
+		LogError("Asset is too small to contain its chunk table\n");
+		return false;
+	}
+
+	ChunkInflateJob job = {
+		.chunkEnds = (const uint64_t *)(payload + ASSET_CHUNK_TABLE_HEADER_SIZE),
+		.chunkData = payload + ASSET_CHUNK_TABLE_HEADER_SIZE + (chunkCount * sizeof(uint64_t)),
+		.chunkSize = chunkSize,
+		.output = output,
+		.outputSize = outputSize,
+	};
+	SDL_SetAtomicInt(&job.failed, 0);
 
-	DataReader *reader = CreateDataReader(assetData, fileSize, 0);
+	// Validate the whole table up front so the chunk jobs can not read out of bounds
+	const size_t chunkDataSize = payloadSize - (size_t)(job.chunkData - payload);
+	uint64_t previousEnd = 0;
+	for (uint32_t i = 0; i < chunkCount; i++)
+	{
+		uint64_t chunkEnd = 0;
+		memcpy(&chunkEnd, &job.chunkEnds[i], sizeof(uint64_t));
+		if (chunkEnd < previousEnd || chunkEnd > chunkDataSize)
+		{
+			LogError("Asset chunk table is out of bounds\n");
+			return false;
+		}
+		previousEnd = chunkEnd;
+	}
+	if (previousEnd != chunkDataSize)
+	{
+		LogError("Asset chunk table does not cover the whole asset\n");
+		return false;
+	}
+
+	ParallelFor(chunkCount, InflateChunk, &job);
+	if (SDL_GetAtomicInt(&job.failed))
+	{
+		LogError("Failed to decompress an asset chunk\n");
+		return false;
+	}
+	return true;
+}
+
+bool DecompressAssetData(const uint8_t *assetData, const size_t fileSize, Asset *dest)
+{
+	CheckAlloc(dest);
+	if (fileSize < ASSET_HEADER_SIZE)
+	{
+		LogError("Failed to read an asset because it is smaller than the asset header.\n");
+		return false;
+	}
+
+	DataReader *reader = CreateDataReader((uint8_t *)assetData, fileSize, 0);
 
 	const uint32_t magic = ReadUint32(reader);
 	if (magic != ASSET_FORMAT_MAGIC)
 	{
-		free(assetData);
 		DestroyDataReader(reader);
 		LogError("Failed to read an asset because the magic was incorrect.\n");
 		return false;
 	}
 	const uint8_t assetVersion = ReadUint8(reader);
-	if (assetVersion != ASSET_FORMAT_VERSION)
+	if (assetVersion != ASSET_FORMAT_VERSION && assetVersion != ASSET_FORMAT_VERSION_SINGLE_STREAM)
 	{
-		free(assetData);
 		DestroyDataReader(reader);
 		LogError("Failed to read an asset because the version was incorrect.\n");
 		return false;
@@ -234,6 +582,7 @@ static bool DecompressAsset(FILE *file, Asset *dest)
 	const uint8_t typeVersion = ReadUint8(reader);
 	const size_t decompressedSize = ReadSizeT(reader);
 	const size_t compressedSize = ReadSizeT(reader);
+	DestroyDataReader(reader);
 
 	if (fileSize - ASSET_HEADER_SIZE != compressedSize)
 	{
@@ -241,8 +590,6 @@ static bool DecompressAsset(FILE *file, Asset *dest)
 				 "this asset.\n",
 				 compressedSize,
 				 fileSize - ASSET_HEADER_SIZE);
-		free(assetData);
-		DestroyDataReader(reader);
 		return false;
 	}
 
@@ -250,108 +597,471 @@ static bool DecompressAsset(FILE *file, Asset *dest)
 	uint8_t *decompressedData = malloc(decompressedSize);
 	CheckAlloc(decompressedData);
 
-	z_stream stream = {0};
+	const uint8_t *payload = assetData + ASSET_HEADER_SIZE;
+	const bool success = assetVersion == ASSET_FORMAT_VERSION_SINGLE_STREAM
+								 ? InflateSingleStream(payload, compressedSize, decompressedData, decompressedSize)
+								 : InflateChunks(payload, compressedSize, decompressedData, decompressedSize);
+	if (!success)
+	{
+		free(decompressedData);
+		return false;
+	}
 
-	// Initialize the zlib stream
-	stream.next_in = assetData + DataReaderGetOffset(reader); // skip header
-	stream.avail_in = compressedSize;
-	stream.next_out = decompressedData;
-	stream.avail_out = decompressedSize;
+	dest->size = decompressedSize;
+	dest->type = assetType;
+	dest->typeVersion = typeVersion;
+	dest->data = decompressedData;
 
-	DestroyDataReader(reader);
+	return true;
+}
 
-	// Initialize the zlib stream
-	if (inflateInit2(&stream, MAX_WBITS | 16) != Z_OK)
+Asset *LoadAssetFromFile(FILE *file)
+{
+	uint8_t *assetData = NULL;
+	size_t fileSize = 0;
+	if (!ReadAssetFile(file, &assetData, &fileSize))
 	{
-		free(decompressedData);
-		free(assetData);
-		LogError("Failed to initialize zlib stream: %s\n", stream.msg);
-		return false;
+		return NULL;
 	}
+	Asset *asset = malloc(sizeof(Asset));
+	CheckAlloc(asset);
+	const bool success = DecompressAssetData(assetData, fileSize, asset);
+	free(assetData);
+	if (!success)
+	{
+		free(asset);
+		return NULL;
+	}
+	return asset;
+}
 
-	// Decompress the data
-	int inflateReturnValue = inflate(&stream, Z_NO_FLUSH);
-	while (inflateReturnValue != Z_STREAM_END)
+/**
+ * Add or remove an asset from the cache accounting. The cache mutex must be held.
+ */
+static void AccountCachedAsset(const Asset *asset, const bool add)
+{
+	const size_t type = asset->type < ASSET_TYPE_COUNT ? asset->type : 0;
+	if (add)
 	{
-		if (inflateReturnValue != Z_OK)
+		assetCacheBytes += asset->size;
+		assetCacheBytesByType[type] += asset->size;
+	} else
+	{
+		assetCacheBytes -= asset->size;
+		assetCacheBytesByType[type] -= asset->size;
+	}
+}
+
+/**
+ * Evict the least recently used unpinned assets until the cache is within budget. The cache mutex must be held.
+ * @param keep An asset that must not be evicted, because it is about to be returned to the caller
+ */
+static void EvictAssets(const AssetCacheEntry *keep)
+{
+	AssetCacheEntry *entry = oldestAssetCacheEntry;
+	while (assetCacheBudget != 0 && assetCacheBytes > assetCacheBudget && entry != NULL)
+	{
+		AssetCacheEntry *newer = entry->newer;
+		if (entry != keep && entry->pinCount == 0)
 		{
-			free(decompressedData);
-			free(assetData);
-			LogError("Failed to decompress zlib stream: %s\n", stream.msg);
-			return false;
+			UnlinkAssetCacheEntry(entry);
+			AccountCachedAsset(&entry->asset, false);
+			AssetCache_erase(assetCache, entry->relPath);
+			FreeAssetCacheEntry(entry);
+			assetCacheEvictions++;
 		}
-		inflateReturnValue = inflate(&stream, Z_NO_FLUSH);
+		entry = newer;
 	}
+}
 
-	// Clean up the zlib stream
-	if (inflateEnd(&stream) != Z_OK)
+/**
+ * Read and decompress an asset file from the asset paths
+ * @param relPath The asset to load
+ * @param isCodeAsset Whether the asset is considered code, see @c LoadAsset
+ * @param asset Where to store the decompressed asset
+ * @return Whether the asset was loaded
+ */
+static bool ReadAndDecompressAsset(const char *relPath, const bool isCodeAsset, Asset *asset)
+{
+	FILE *file = NULL;
+	const uint8_t *packedData = NULL;
+	size_t packedSize = 0;
+	char *sourcePath = NULL;
+	const uint64_t openStart = AssetTraceBegin();
+	if (!FindAssetFile(relPath, isCodeAsset, &file, &packedData, &packedSize, &sourcePath))
 	{
-		free(decompressedData);
-		free(assetData);
-		LogError("Failed to end zlib stream: %s\n", stream.msg);
+		LogError("Failed to open asset file: %s\n", relPath);
 		return false;
 	}
+	AssetTraceEnd(relPath, ASSET_TRACE_OPEN, openStart, 0);
 
+	const uint64_t cookedStart = AssetTraceBegin();
+	if (LoadCookedAsset(sourcePath, relPath, asset))
+	{
+		AssetTraceEnd(relPath, ASSET_TRACE_READ, cookedStart, asset->size);
+		if (file != NULL)
+		{
+			fclose(file);
+		}
+		free(sourcePath);
+		return true;
+	}
+
+	uint8_t *assetData = NULL;
+	size_t fileSize = 0;
+	if (file != NULL)
+	{
+		const uint64_t readStart = AssetTraceBegin();
+		if (!ReadAssetFile(file, &assetData, &fileSize))
+		{
+			free(sourcePath);
+			return false;
+		}
+		AssetTraceEnd(relPath, ASSET_TRACE_READ, readStart, fileSize);
+	} else
+	{
+		// Packs are memory mapped, so the read happens while inflating
+		fileSize = packedSize;
+	}
+
+	const uint64_t inflateStart = AssetTraceBegin();
+	const bool success = DecompressAssetData(assetData ? assetData : packedData, fileSize, asset);
 	free(assetData);
-	dest->size = decompressedSize;
-	dest->type = assetType;
-	dest->typeVersion = typeVersion;
-	dest->data = decompressedData;
+	if (success)
+	{
+		AssetTraceEnd(relPath, ASSET_TRACE_INFLATE, inflateStart, asset->size);
+		StoreCookedAsset(sourcePath, relPath, asset);
+	}
+	free(sourcePath);
+	return success;
+}
+
+/**
+ * Load an asset through the cache
+ * @param relPath The asset to load
+ * @param isCodeAsset Whether the asset is considered code, see @c LoadAsset
+ * @param pin Whether to pin the asset
+ * @param prefetch Whether this is a load from @c PrefetchAsset
+ * @return The cached asset, or NULL on failure
+ */
+static Asset *LoadCachedAsset(const char *relPath, const bool isCodeAsset, const bool pin, const bool prefetch)
+{
+	SDL_LockMutex(assetCacheMutex);
+	AssetCacheEntry **cachedEntry = AssetCache_get(assetCache, relPath);
+	if (cachedEntry != NULL)
+	{
+		AssetCacheEntry *entry = *cachedEntry;
+		assetCacheHits++;
+		UnlinkAssetCacheEntry(entry);
+		LinkAssetCacheEntry(entry);
+		if (pin)
+		{
+			entry->pinCount++;
+		}
+		if (!prefetch)
+		{
+			entry->prefetched = false;
+		}
+		SDL_UnlockMutex(assetCacheMutex);
+		return &entry->asset;
+	}
+	assetCacheMisses++;
+	SDL_UnlockMutex(assetCacheMutex);
 
+	// Decompress outside the cache lock, so that other threads are not blocked on zlib
+	Asset loadedAsset;
+	if (!ReadAndDecompressAsset(relPath, isCodeAsset, &loadedAsset))
+	{
+		return NULL;
+	}
+
+	SDL_LockMutex(assetCacheMutex);
+	AssetCacheEntry *entry = NULL;
+	cachedEntry = AssetCache_get(assetCache, relPath);
+	if (cachedEntry != NULL)
+	{
+		// Another thread loaded the same asset in the meantime
+		entry = *cachedEntry;
+		free(loadedAsset.data);
+		UnlinkAssetCacheEntry(entry);
+	} else
+	{
+		entry = calloc(1, sizeof(AssetCacheEntry));
+		CheckAlloc(entry);
+		entry->asset = loadedAsset;
+		entry->relPath = strdup(relPath);
+		CheckAlloc(entry->relPath);
+		entry->prefetched = prefetch;
+		AssetCache_set_at(assetCache, relPath, entry);
+		AccountCachedAsset(&entry->asset, true);
+	}
+	LinkAssetCacheEntry(entry);
+	if (pin)
+	{
+		entry->pinCount++;
+	}
+	EvictAssets(entry);
+	SDL_UnlockMutex(assetCacheMutex);
+	return &entry->asset;
+}
+
+/**
+ * Take a prefetched asset out of the cache, handing ownership of its data to the caller
+ * @param relPath The asset to take
+ * @param asset Where to store the asset
+ * @return Whether the asset had been prefetched and was not in use
+ */
+static bool TakePrefetchedAsset(const char *relPath, Asset *asset)
+{
+	SDL_LockMutex(assetCacheMutex);
+	AssetCacheEntry **cachedEntry = AssetCache_get(assetCache, relPath);
+	AssetCacheEntry *entry = cachedEntry != NULL ? *cachedEntry : NULL;
+	if (entry == NULL || !entry->prefetched || entry->pinCount > 0)
+	{
+		SDL_UnlockMutex(assetCacheMutex);
+		return false;
+	}
+	*asset = entry->asset;
+	UnlinkAssetCacheEntry(entry);
+	AccountCachedAsset(&entry->asset, false);
+	AssetCache_erase(assetCache, relPath);
+	free(entry->relPath);
+	free(entry);
+	assetPrefetchHits++;
+	SDL_UnlockMutex(assetCacheMutex);
 	return true;
 }
 
-Asset *LoadAssetFromFile(FILE *file)
+Asset *LoadAsset(const char *relPath, const bool cache, const bool isCodeAsset)
 {
-	Asset *asset = malloc(sizeof(Asset));
-	CheckAlloc(asset);
-	if (!DecompressAsset(file, asset))
+	RecordManifestAsset(relPath, isCodeAsset);
+	if (cache)
+	{
+		return LoadCachedAsset(relPath, isCodeAsset, false, false);
+	}
+
+	Asset loadedAsset;
+	if (!TakePrefetchedAsset(relPath, &loadedAsset) && !ReadAndDecompressAsset(relPath, isCodeAsset, &loadedAsset))
 	{
-		free(asset);
 		return NULL;
 	}
+	Asset *asset = malloc(sizeof(Asset));
+	CheckAlloc(asset);
+	*asset = loadedAsset;
 	return asset;
 }
 
-Asset *LoadAsset(const char *relPath, const bool cache, const bool isCodeAsset)
+Asset *LoadAssetPinned(const char *relPath, const bool isCodeAsset)
 {
-	Asset *asset = NULL;
-	if (cache)
+	RecordManifestAsset(relPath, isCodeAsset);
+	return LoadCachedAsset(relPath, isCodeAsset, true, false);
+}
+
+Asset *PrefetchAsset(const char *relPath, const bool isCodeAsset)
+{
+	return LoadCachedAsset(relPath, isCodeAsset, true, true);
+}
+
+void UnpinAsset(const Asset *asset)
+{
+	// Cached assets are the first member of their entry
+	AssetCacheEntry *entry = (AssetCacheEntry *)asset;
+	SDL_LockMutex(assetCacheMutex);
+	assert(entry->pinCount > 0);
+	entry->pinCount--;
+	if (entry->stale)
 	{
-		asset = AssetCache_get(assetCache, relPath);
-		if (asset != NULL)
+		if (entry->pinCount == 0)
 		{
-			return asset;
+			ListRemoveAt(staleAssetCacheEntries, ListFind(staleAssetCacheEntries, entry));
+			FreeAssetCacheEntry(entry);
 		}
+	} else
+	{
+		// The cache may have gone over budget while this asset was pinned
+		EvictAssets(NULL);
 	}
+	SDL_UnlockMutex(assetCacheMutex);
+}
 
-	FILE *file = OpenAssetFile(relPath, isCodeAsset);
-	if (file == NULL)
+void SetAssetCacheBudget(const size_t budget)
+{
+	SDL_LockMutex(assetCacheMutex);
+	assetCacheBudget = budget;
+	EvictAssets(NULL);
+	SDL_UnlockMutex(assetCacheMutex);
+}
+
+uint8_t *LoadAssetFileData(const char *relPath, const bool isCodeAsset, size_t *size)
+{
+	FILE *file = NULL;
+	const uint8_t *packedData = NULL;
+	size_t packedSize = 0;
+	if (!FindAssetFile(relPath, isCodeAsset, &file, &packedData, &packedSize, NULL))
 	{
 		LogError("Failed to open asset file: %s\n", relPath);
 		return NULL;
 	}
 
-	if (cache)
+	uint8_t *data = NULL;
+	if (file != NULL)
 	{
-		asset = AssetCache_safe_get(assetCache, relPath);
-	} else
+		if (!ReadAssetFile(file, &data, size))
+		{
+			return NULL;
+		}
+		return data;
+	}
+	data = malloc(packedSize);
+	CheckAlloc(data);
+	memcpy(data, packedData, packedSize);
+	*size = packedSize;
+	return data;
+}
+
+bool AssetExists(const char *relPath, const bool isCodeAsset)
+{
+	FILE *file = NULL;
+	const uint8_t *packedData = NULL;
+	size_t packedSize = 0;
+	if (!FindAssetFile(relPath, isCodeAsset, &file, &packedData, &packedSize, NULL))
+	{
+		return false;
+	}
+	if (file != NULL)
 	{
-		asset = malloc(sizeof(Asset));
-		CheckAlloc(asset);
+		fclose(file);
 	}
+	return true;
+}
 
-	if (!DecompressAsset(file, asset))
+char *GetLooseAssetPath(const char *relPath)
+{
+	FILE *file = NULL;
+	const uint8_t *packedData = NULL;
+	size_t packedSize = 0;
+	char *sourcePath = NULL;
+	if (!FindAssetFile(relPath, false, &file, &packedData, &packedSize, &sourcePath))
 	{
-		free(asset);
 		return NULL;
 	}
-	return asset;
+	if (file == NULL)
+	{
+		// The asset is in a pack, so the source path is the pack
+		free(sourcePath);
+		return NULL;
+	}
+	fclose(file);
+	return sourcePath;
 }
 
 void RemoveAssetFromCache(const char *relPath)
 {
-	AssetCache_erase(assetCache, relPath);
+	SDL_LockMutex(assetCacheMutex);
+	AssetCacheEntry **cachedEntry = AssetCache_get(assetCache, relPath);
+	if (cachedEntry != NULL)
+	{
+		AssetCacheEntry *entry = *cachedEntry;
+		UnlinkAssetCacheEntry(entry);
+		AccountCachedAsset(&entry->asset, false);
+		AssetCache_erase(assetCache, relPath);
+		if (entry->pinCount > 0)
+		{
+			// Still in use, so keep it until it is unpinned, and let the next load read the new version
+			entry->stale = true;
+			ListAdd(staleAssetCacheEntries, entry);
+		} else
+		{
+			FreeAssetCacheEntry(entry);
+		}
+	}
+	SDL_UnlockMutex(assetCacheMutex);
+}
+
+bool RepackAssetFile(const char *inputPath, const char *outputPath)
+{
+	FILE *input = fopen(inputPath, "rb");
+	if (input == NULL)
+	{
+		LogError("Failed to open asset \"%s\": %s\n", inputPath, strerror(errno));
+		return false;
+	}
+	Asset *asset = LoadAssetFromFile(input);
+	if (asset == NULL)
+	{
+		return false;
+	}
+	if (asset->type == ASSET_TYPE_MAP && !UpgradeMapAsset(asset))
+	{
+		LogError("Failed to upgrade map \"%s\"\n", inputPath);
+		FreeAsset(asset);
+		return false;
+	}
+
+	DataWriter *writer = CreateDataWriter();
+	WriteCompressedAsset(writer, asset->type, asset->typeVersion, asset->data, asset->size, ASSET_CHUNK_SIZE);
+	FreeAsset(asset);
+
+	FILE *output = fopen(outputPath, "wb");
+	if (output == NULL)
+	{
+		LogError("Failed to open asset \"%s\" for writing: %s\n", outputPath, strerror(errno));
+		FreeDataWriter(writer);
+		return false;
+	}
+	const size_t size = DataWriterGetBufferSize(writer);
+	const bool success = fwrite(DataWriterGetBuffer(writer), 1, size, output) == size;
+	fclose(output);
+	FreeDataWriter(writer);
+	if (!success)
+	{
+		LogError("Failed to write asset \"%s\"\n", outputPath);
+	}
+	return success;
+}
+
+bool HasAssetExtension(const char *relPath, const char *extension)
+{
+	const size_t pathLength = strlen(relPath);
+	const size_t extensionLength = strlen(extension);
+	return pathLength >= extensionLength && strcmp(relPath + pathLength - extensionLength, extension) == 0;
+}
+
+void ReloadAsset(const char *relPath)
+{
+	RemoveAssetFromCache(relPath);
+	if (HasAssetExtension(relPath, ".gtex"))
+	{
+		const Image *image = ReloadImage(relPath);
+		if (image != NULL)
+		{
+			QueueTextureReload(image);
+			LogInfo("Reloaded texture %s\n", relPath);
+		}
+	} else if (HasAssetExtension(relPath, ".gmdl"))
+	{
+		// Actors and the LOD thread read models, so they are paused while the model is swapped
+		PhysicsThreadLockTickMutex();
+		LockLodThreadMutex();
+		const ModelDefinition *model = ReloadModel(relPath);
+		UnlockLodThreadMutex();
+		PhysicsThreadUnlockTickMutex();
+		if (model != NULL)
+		{
+			QueueModelReload(model);
+			LogInfo("Reloaded model %s\n", relPath);
+		}
+	} else if (HasAssetExtension(relPath, ".gmtl"))
+	{
+		if (ReloadMapMaterial(relPath) != NULL)
+		{
+			rendererQueuedActions |= QUEUED_ACTION_UPDATE_MAP_MATERIALS;
+			LogInfo("Reloaded map material %s\n", relPath);
+		}
+	} else
+	{
+		LogDebug("Dropped changed asset %s from the asset cache\n", relPath);
+	}
 }
 
 void HotReloadAssets()
@@ -367,5 +1077,38 @@ void HotReloadAssets()
 
 void DPrintAssetReader()
 {
-	DPrintF("Primary Asset Cache: %zu asset(s)", COLOR_WHITE, AssetCache_size(assetCache));
+	SDL_LockMutex(assetCacheMutex);
+	const double mib = 1024.0 * 1024.0;
+	if (assetCacheBudget != 0)
+	{
+		DPrintF("Primary Asset Cache: %zu asset(s), %.1f/%.1f MiB",
+				COLOR_WHITE,
+				AssetCache_size(assetCache),
+				(double)assetCacheBytes / mib,
+				(double)assetCacheBudget / mib);
+	} else
+	{
+		DPrintF("Primary Asset Cache: %zu asset(s), %.1f MiB (unlimited)",
+				COLOR_WHITE,
+				AssetCache_size(assetCache),
+				(double)assetCacheBytes / mib);
+	}
+	DPrintF("Asset Cache: %zu hit(s), %zu miss(es), %zu eviction(s), %zu prefetch hit(s)",
+			COLOR_WHITE,
+			assetCacheHits,
+			assetCacheMisses,
+			assetCacheEvictions,
+			assetPrefetchHits);
+	for (size_t i = 0; i < ASSET_TYPE_COUNT; i++)
+	{
+		if (assetCacheBytesByType[i] != 0)
+		{
+			DPrintF("    %s: %.1f MiB", COLOR_WHITE, assetTypeNames[i], (double)assetCacheBytesByType[i] / mib);
+		}
+	}
+	SDL_UnlockMutex(assetCacheMutex);
+	DPrintPackFiles();
+	DPrintAssetIndex();
+	DPrintCookedAssetCache();
+	DPrintAsyncAssetLoader();
 }
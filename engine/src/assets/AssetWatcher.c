@@ -0,0 +1,279 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/assets/AssetIndex.h>
+#include <engine/assets/AssetReader.h>
+#include <engine/assets/AssetWatcher.h>
+#include <engine/assets/GameConfigLoader.h>
+#include <engine/assets/PackFile.h>
+#include <engine/helpers/Arguments.h>
+#include <engine/structs/List.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <errno.h>
+#include <stdalign.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+typedef struct WatchedDirectory WatchedDirectory;
+
+struct WatchedDirectory
+{
+	/// The inotify watch descriptor of the directory
+	int watch;
+	/// The asset path directory this directory is in
+	char *root;
+	/// The directory relative to root, or an empty string for root itself
+	char *relDir;
+};
+
+/// The inotify instance, or -1 if assets are not being watched
+static int watcherFd = -1;
+/// Every watched directory, as @c WatchedDirectory pointers
+static List watchedDirectories;
+
+static WatchedDirectory *FindWatchedDirectory(const int watch)
+{
+	for (size_t i = 0; i < watchedDirectories.length; i++)
+	{
+		WatchedDirectory *directory = ListGetPointer(watchedDirectories, i);
+		if (directory->watch == watch)
+		{
+			return directory;
+		}
+	}
+	return NULL;
+}
+
+static void FreeWatchedDirectory(WatchedDirectory *directory)
+{
+	free(directory->root);
+	free(directory->relDir);
+	free(directory);
+}
+
+/**
+ * Join a directory relative to an asset path and a name in it
+ * @return The joined path, which must be freed
+ */
+static char *JoinAssetPath(const char *relDir, const char *name)
+{
+	const size_t length = strlen(relDir) + 1 + strlen(name) + 1;
+	char *path = malloc(length);
+	CheckAlloc(path);
+	snprintf(path, length, relDir[0] == '\0' ? "%s%s" : "%s/%s", relDir, name);
+	return path;
+}
+
+/**
+ * Watch a directory and all of its subdirectories
+ * @param root The asset path directory
+ * @param relDir The directory relative to root, or an empty string for root itself
+ */
+static void WatchDirectory(const char *root, const char *relDir)
+{
+	char *dirPath = relDir[0] == '\0' ? strdup(root) : JoinAssetPath(root, relDir);
+	CheckAlloc(dirPath);
+
+	const int watch = inotify_add_watch(watcherFd, dirPath, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+	if (watch < 0)
+	{
+		if (errno != ENOENT)
+		{
+			LogWarning("Failed to watch directory %s: %s\n", dirPath, strerror(errno));
+		}
+		free(dirPath);
+		return;
+	}
+	// inotify hands out the same descriptor for a directory that is already watched, such as a duplicate asset path
+	if (FindWatchedDirectory(watch) != NULL)
+	{
+		free(dirPath);
+		return;
+	}
+	WatchedDirectory *directory = malloc(sizeof(WatchedDirectory));
+	CheckAlloc(directory);
+	directory->watch = watch;
+	directory->root = strdup(root);
+	CheckAlloc(directory->root);
+	directory->relDir = strdup(relDir);
+	CheckAlloc(directory->relDir);
+	ListAdd(watchedDirectories, directory);
+
+	DIR *dir = opendir(dirPath);
+	if (dir == NULL)
+	{
+		free(dirPath);
+		return;
+	}
+	const struct dirent *ent = readdir(dir);
+	while (ent != NULL)
+	{
+		if (ent->d_name[0] != '.')
+		{
+			char *fullPath = JoinAssetPath(dirPath, ent->d_name);
+			struct stat st;
+			if (stat(fullPath, &st) == 0 && S_ISDIR(st.st_mode))
+			{
+				char *name = JoinAssetPath(relDir, ent->d_name);
+				WatchDirectory(root, name);
+				free(name);
+			}
+			free(fullPath);
+		}
+		ent = readdir(dir);
+	}
+	closedir(dir);
+	free(dirPath);
+}
+
+/**
+ * Handle a single inotify event
+ * @param event The event
+ * @param changedAssets A @c LIST_POINTER list of changed asset paths to add to, without duplicates
+ */
+static void HandleWatchEvent(const struct inotify_event *event, List *changedAssets)
+{
+	if (event->mask & IN_Q_OVERFLOW)
+	{
+		LogWarning("Too many assets changed at once, some of them were not reloaded\n");
+		return;
+	}
+	WatchedDirectory *directory = FindWatchedDirectory(event->wd);
+	if (directory == NULL)
+	{
+		return;
+	}
+	if (event->mask & IN_IGNORED)
+	{
+		// The directory was deleted
+		ListRemoveAt(watchedDirectories, ListFind(watchedDirectories, directory));
+		FreeWatchedDirectory(directory);
+		return;
+	}
+	if (event->len == 0 || event->name[0] == '.')
+	{
+		return;
+	}
+
+	char *relPath = JoinAssetPath(directory->relDir, event->name);
+	if (event->mask & IN_ISDIR)
+	{
+		WatchDirectory(directory->root, relPath);
+		// Files moved in along with a directory don't get events of their own
+		AddPathToAssetIndex(directory->root, relPath);
+		free(relPath);
+		return;
+	}
+	// Packs are mounted, not loaded as assets
+	const bool isPack = directory->relDir[0] == '\0' && HasAssetExtension(relPath, PACK_FILE_EXTENSION);
+	if (!isPack && event->mask & (IN_CREATE | IN_MOVED_TO))
+	{
+		AddPathToAssetIndex(directory->root, relPath);
+	}
+	// Files that were only created have not been written yet
+	if (isPack || !(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)))
+	{
+		free(relPath);
+		return;
+	}
+	for (size_t i = 0; i < changedAssets->length; i++)
+	{
+		if (strcmp(ListGetPointer(*changedAssets, i), relPath) == 0)
+		{
+			free(relPath);
+			return;
+		}
+	}
+	ListAdd(*changedAssets, relPath);
+}
+#endif
+
+void InitAssetWatcher()
+{
+	if (!HasCliArg("--watch-assets"))
+	{
+		return;
+	}
+#ifdef __linux__
+	watcherFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (watcherFd < 0)
+	{
+		LogError("Failed to start watching assets: %s\n", strerror(errno));
+		return;
+	}
+	ListInit(watchedDirectories, LIST_POINTER);
+	for (size_t i = 0; i < gameConfig.assetPaths.length; i++)
+	{
+		const AssetPath *assetPath = ListGetPointer(gameConfig.assetPaths, i);
+		WatchDirectory(assetPath->path, "");
+	}
+	LogInfo("Watching %zu asset folder(s) for changes\n", watchedDirectories.length);
+#else
+	LogWarning("Watching assets is only supported on Linux\n");
+#endif
+}
+
+void PollAssetWatcher()
+{
+#ifdef __linux__
+	if (watcherFd < 0)
+	{
+		return;
+	}
+	List changedAssets;
+	ListInit(changedAssets, LIST_POINTER);
+	alignas(struct inotify_event) char buffer[ASSET_WATCHER_BUFFER_SIZE];
+	ssize_t length = read(watcherFd, buffer, sizeof(buffer));
+	while (length > 0)
+	{
+		const char *pointer = buffer;
+		while (pointer < buffer + length)
+		{
+			const struct inotify_event *event = (const struct inotify_event *)pointer;
+			HandleWatchEvent(event, &changedAssets);
+			pointer += sizeof(struct inotify_event) + event->len;
+		}
+		length = read(watcherFd, buffer, sizeof(buffer));
+	}
+	if (length < 0 && errno != EAGAIN)
+	{
+		LogWarning("Failed to read asset changes: %s\n", strerror(errno));
+	}
+
+	// Editors often write a file several times when saving it, so each asset is only reloaded once per poll
+	for (size_t i = 0; i < changedAssets.length; i++)
+	{
+		ReloadAsset(ListGetPointer(changedAssets, i));
+	}
+	ListAndContentsFree(changedAssets);
+#endif
+}
+
+void DestroyAssetWatcher()
+{
+#ifdef __linux__
+	if (watcherFd < 0)
+	{
+		return;
+	}
+	close(watcherFd);
+	watcherFd = -1;
+	for (size_t i = 0; i < watchedDirectories.length; i++)
+	{
+		FreeWatchedDirectory(ListGetPointer(watchedDirectories, i));
+	}
+	ListFree(watchedDirectories);
+#endif
+}
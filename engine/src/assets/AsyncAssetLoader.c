@@ -0,0 +1,354 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/assets/AssetReader.h>
+#include <engine/assets/AsyncAssetLoader.h>
+#include <engine/debug/DPrint.h>
+#include <engine/structs/Asset.h>
+#include <engine/structs/Color.h>
+#include <engine/structs/List.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_mutex.h>
+#include <SDL3/SDL_thread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct AssetLoadJob AssetLoadJob;
+
+struct AssetLoadJob
+{
+	AssetLoadTicket ticket;
+	char *relPath;
+	AssetLoadFlags flags;
+	AssetLoadCallback callback;
+	void *userData;
+	/// The loaded asset, written by the worker thread
+	Asset *result;
+	/// Whether the job was cancelled after a worker picked it up
+	bool cancelled;
+};
+
+static SDL_Thread *workers[MAX_ASSET_LOADER_THREADS];
+static size_t workerCount = 0;
+static bool shouldExit = false;
+
+/// Protects everything below
+static SDL_Mutex *jobMutex = NULL;
+/// Signalled when a job is queued or the workers should exit
+static SDL_Condition *jobQueuedCondition = NULL;
+/// Signalled when a worker finishes a job
+static SDL_Condition *jobFinishedCondition = NULL;
+/// Jobs waiting for a worker, in FIFO order
+static List queuedJobs;
+/// Jobs currently being loaded by a worker
+static List runningJobs;
+/// Jobs waiting for their callback to be invoked on the main thread
+static List finishedJobs;
+/// Finished jobs that @c ProcessAssetLoadCallbacks is invoking the callbacks of, in order
+static List dispatchingJobs;
+
+/// The next ticket to hand out. Only touched on the main thread.
+static AssetLoadTicket nextTicket = ASSET_LOAD_TICKET_INVALID + 1;
+
+static void FreeAssetLoadJob(AssetLoadJob *job)
+{
+	// Cached assets are owned by the cache and pinned until the callback has run, uncached ones are only owned by the
+	// job until the callback runs
+	if (job->result && (job->flags & ASSET_LOAD_CACHE))
+	{
+		UnpinAsset(job->result);
+	} else if (job->result)
+	{
+		FreeAsset(job->result);
+	}
+	free(job->relPath);
+	free(job);
+}
+
+static void RunAssetLoadJob(AssetLoadJob *job)
+{
+	if (job->flags & ASSET_LOAD_PREFETCH)
+	{
+		job->result = PrefetchAsset(job->relPath, job->flags & ASSET_LOAD_CODE);
+	} else if (job->flags & ASSET_LOAD_CACHE)
+	{
+		// Pinned so that it cannot be evicted before the callback gets to it
+		job->result = LoadAssetPinned(job->relPath, job->flags & ASSET_LOAD_CODE);
+	} else
+	{
+		job->result = LoadAsset(job->relPath, false, job->flags & ASSET_LOAD_CODE);
+	}
+}
+
+static int AssetLoaderThreadMain(void * /*data*/)
+{
+	SDL_LockMutex(jobMutex);
+	while (true)
+	{
+		while (!shouldExit && queuedJobs.length == 0)
+		{
+			SDL_WaitCondition(jobQueuedCondition, jobMutex);
+		}
+		if (shouldExit)
+		{
+			break;
+		}
+
+		AssetLoadJob *job = ListGetPointer(queuedJobs, 0);
+		ListRemoveAt(queuedJobs, 0);
+		ListAdd(runningJobs, job);
+		SDL_UnlockMutex(jobMutex);
+
+		RunAssetLoadJob(job);
+
+		SDL_LockMutex(jobMutex);
+		ListRemoveAt(runningJobs, ListFind(runningJobs, job));
+		ListAdd(finishedJobs, job);
+		SDL_BroadcastCondition(jobFinishedCondition);
+	}
+	SDL_UnlockMutex(jobMutex);
+	return 0;
+}
+
+void InitAsyncAssetLoader()
+{
+	LogDebug("Starting asset loader threads...\n");
+	jobMutex = SDL_CreateMutex();
+	jobQueuedCondition = SDL_CreateCondition();
+	jobFinishedCondition = SDL_CreateCondition();
+	ListInit(queuedJobs, LIST_POINTER);
+	ListInit(runningJobs, LIST_POINTER);
+	ListInit(finishedJobs, LIST_POINTER);
+	ListInit(dispatchingJobs, LIST_POINTER);
+	shouldExit = false;
+
+	// Loads are mostly waiting on disk and zlib, so there is no point in using every core
+	const int cpuCount = SDL_GetNumLogicalCPUCores();
+	const size_t threadCount = cpuCount > 2 ? (size_t)cpuCount / 2 : 1;
+	workerCount = 0;
+	for (size_t i = 0; i < threadCount && i < MAX_ASSET_LOADER_THREADS; i++)
+	{
+		workers[workerCount] = SDL_CreateThread(AssetLoaderThreadMain, "GameAssetLoader", NULL);
+		if (workers[workerCount] == NULL)
+		{
+			LogWarning("Failed to start an asset loader thread\n");
+			break;
+		}
+		workerCount++;
+	}
+}
+
+void DestroyAsyncAssetLoader()
+{
+	if (jobMutex == NULL)
+	{
+		return;
+	}
+	LogDebug("Terminating asset loader threads...\n");
+	CancelAllAssetLoads();
+
+	SDL_LockMutex(jobMutex);
+	shouldExit = true;
+	SDL_BroadcastCondition(jobQueuedCondition);
+	SDL_UnlockMutex(jobMutex);
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		SDL_WaitThread(workers[i], NULL);
+	}
+	workerCount = 0;
+
+	ListFree(queuedJobs);
+	ListFree(runningJobs);
+	ListFree(finishedJobs);
+	ListFree(dispatchingJobs);
+	SDL_DestroyCondition(jobQueuedCondition);
+	SDL_DestroyCondition(jobFinishedCondition);
+	SDL_DestroyMutex(jobMutex);
+	jobMutex = NULL;
+}
+
+AssetLoadTicket LoadAssetAsync(const char *relPath,
+							   const AssetLoadFlags flags,
+							   const AssetLoadCallback callback,
+							   void *userData)
+{
+	AssetLoadJob *job = calloc(1, sizeof(AssetLoadJob));
+	CheckAlloc(job);
+	job->relPath = strdup(relPath);
+	CheckAlloc(job->relPath);
+	job->flags = (flags & ASSET_LOAD_PREFETCH) ? flags | ASSET_LOAD_CACHE : flags;
+	job->callback = callback;
+	job->userData = userData;
+	job->ticket = nextTicket++;
+	if (nextTicket == ASSET_LOAD_TICKET_INVALID)
+	{
+		nextTicket++;
+	}
+
+	if (workerCount == 0)
+	{
+		// No workers (not started yet, or thread creation failed), so load it now but keep the callback deferred
+		RunAssetLoadJob(job);
+		if (jobMutex == NULL)
+		{
+			// The loader has not been initialized, there is nowhere to defer the callback to
+			if (callback)
+			{
+				callback(job->ticket, job->result, userData);
+				if (!(job->flags & ASSET_LOAD_CACHE))
+				{
+					job->result = NULL; // ownership was passed to the callback
+				}
+			}
+			FreeAssetLoadJob(job);
+			return ASSET_LOAD_TICKET_INVALID;
+		}
+		SDL_LockMutex(jobMutex);
+		ListAdd(finishedJobs, job);
+		SDL_UnlockMutex(jobMutex);
+		return job->ticket;
+	}
+
+	SDL_LockMutex(jobMutex);
+	ListAdd(queuedJobs, job);
+	SDL_SignalCondition(jobQueuedCondition);
+	SDL_UnlockMutex(jobMutex);
+	return job->ticket;
+}
+
+/**
+ * Find a job by ticket in a job list
+ * @return The index of the job, or -1 if it is not in the list
+ */
+static size_t FindAssetLoadJob(const List *jobs, const AssetLoadTicket ticket)
+{
+	for (size_t i = 0; i < jobs->length; i++)
+	{
+		const AssetLoadJob *job = ListGetPointer(*jobs, i);
+		if (job->ticket == ticket)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+void CancelAssetLoad(const AssetLoadTicket ticket)
+{
+	if (ticket == ASSET_LOAD_TICKET_INVALID || jobMutex == NULL)
+	{
+		return;
+	}
+	SDL_LockMutex(jobMutex);
+	size_t index = FindAssetLoadJob(&queuedJobs, ticket);
+	if (index != (size_t)-1)
+	{
+		FreeAssetLoadJob(ListGetPointer(queuedJobs, index));
+		ListRemoveAt(queuedJobs, index);
+	} else if ((index = FindAssetLoadJob(&runningJobs, ticket)) != (size_t)-1)
+	{
+		((AssetLoadJob *)ListGetPointer(runningJobs, index))->cancelled = true;
+	} else if ((index = FindAssetLoadJob(&finishedJobs, ticket)) != (size_t)-1)
+	{
+		FreeAssetLoadJob(ListGetPointer(finishedJobs, index));
+		ListRemoveAt(finishedJobs, index);
+	} else if ((index = FindAssetLoadJob(&dispatchingJobs, ticket)) != (size_t)-1)
+	{
+		// Cancelled from the callback of another job finished in the same batch
+		FreeAssetLoadJob(ListGetPointer(dispatchingJobs, index));
+		ListRemoveAt(dispatchingJobs, index);
+	}
+	SDL_UnlockMutex(jobMutex);
+}
+
+void CancelAllAssetLoads()
+{
+	if (jobMutex == NULL)
+	{
+		return;
+	}
+	SDL_LockMutex(jobMutex);
+	for (size_t i = 0; i < queuedJobs.length; i++)
+	{
+		FreeAssetLoadJob(ListGetPointer(queuedJobs, i));
+	}
+	ListClear(queuedJobs);
+	while (runningJobs.length > 0)
+	{
+		SDL_WaitCondition(jobFinishedCondition, jobMutex);
+	}
+	for (size_t i = 0; i < finishedJobs.length; i++)
+	{
+		FreeAssetLoadJob(ListGetPointer(finishedJobs, i));
+	}
+	ListClear(finishedJobs);
+	for (size_t i = 0; i < dispatchingJobs.length; i++)
+	{
+		FreeAssetLoadJob(ListGetPointer(dispatchingJobs, i));
+	}
+	ListClear(dispatchingJobs);
+	SDL_UnlockMutex(jobMutex);
+}
+
+void ProcessAssetLoadCallbacks()
+{
+	if (jobMutex == NULL)
+	{
+		return;
+	}
+	SDL_LockMutex(jobMutex);
+	// Only the jobs that have finished so far, so that loads queued by a callback are not called back until next time
+	for (size_t i = 0; i < finishedJobs.length; i++)
+	{
+		ListAdd(dispatchingJobs, ListGetPointer(finishedJobs, i));
+	}
+	ListClear(finishedJobs);
+
+	// Each job is taken out with the lock held, so that a callback can cancel the jobs after it
+	while (dispatchingJobs.length > 0)
+	{
+		AssetLoadJob *job = ListGetPointer(dispatchingJobs, 0);
+		ListRemoveAt(dispatchingJobs, 0);
+		SDL_UnlockMutex(jobMutex);
+
+		// Callbacks run without the lock held so that they can queue more loads
+		if (!job->cancelled && job->callback)
+		{
+			job->callback(job->ticket, job->result, job->userData);
+			if (!(job->flags & ASSET_LOAD_CACHE))
+			{
+				job->result = NULL; // ownership was passed to the callback
+			}
+		}
+		FreeAssetLoadJob(job);
+
+		SDL_LockMutex(jobMutex);
+	}
+	SDL_UnlockMutex(jobMutex);
+}
+
+size_t GetPendingAssetLoadCount()
+{
+	if (jobMutex == NULL)
+	{
+		return 0;
+	}
+	SDL_LockMutex(jobMutex);
+	const size_t count = queuedJobs.length + runningJobs.length + finishedJobs.length + dispatchingJobs.length;
+	SDL_UnlockMutex(jobMutex);
+	return count;
+}
+
+void DPrintAsyncAssetLoader()
+{
+	DPrintF("Async Asset Loader: %zu thread(s), %zu pending load(s)",
+			COLOR_WHITE,
+			workerCount,
+			GetPendingAssetLoadCount());
+}
@@ -0,0 +1,555 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <ctype.h>
+#include <engine/assets/CookedAssetCache.h>
+#include <engine/assets/GameConfigLoader.h>
+#include <engine/debug/DPrint.h>
+#include <engine/Engine.h>
+#include <engine/helpers/Arguments.h>
+#include <engine/helpers/PlatformHelpers.h>
+#include <engine/structs/Asset.h>
+#include <engine/structs/Color.h>
+#include <engine/structs/GlobalState.h>
+#include <engine/structs/List.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <inttypes.h>
+#include <SDL3/SDL_filesystem.h>
+#include <SDL3/SDL_mutex.h>
+#include <SDL3/SDL_thread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+typedef struct CookedAssetHeader CookedAssetHeader;
+typedef struct CookedAssetWriteJob CookedAssetWriteJob;
+
+struct CookedAssetHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	/// The type of the asset
+	uint8_t type;
+	/// The version of the asset type
+	uint8_t typeVersion;
+	/// The length of the key that follows the header, not including a NUL terminator
+	uint32_t keyLength;
+	/// The offset of the decompressed asset data from the start of the file
+	uint64_t payloadOffset;
+	/// The size of the decompressed asset data
+	uint64_t payloadSize;
+	/// zlib crc32 of the decompressed asset data
+	uint32_t payloadChecksum;
+} __attribute__((packed));
+
+struct CookedAssetWriteJob
+{
+	/// Where to write the cooked asset
+	char *path;
+	/// The full key of the asset, stored in the file to detect hash collisions and stale entries
+	char *key;
+	/// A copy of the decompressed asset
+	Asset asset;
+};
+
+/// The directory cooked assets are stored in, with a trailing slash, or NULL if the cache is disabled
+static char *cacheDirectory = NULL;
+
+static SDL_Thread *writerThread = NULL;
+static bool shouldExit = false;
+
+/// Protects everything below
+static SDL_Mutex *cacheMutex = NULL;
+/// Signalled when a job is queued or the writer thread should exit
+static SDL_Condition *jobQueuedCondition = NULL;
+/// Cooked assets waiting to be written
+static List queuedJobs;
+/// The number of asset bytes in queuedJobs
+static size_t pendingBytes = 0;
+static size_t cacheHits = 0;
+static size_t cacheMisses = 0;
+static size_t cacheWrites = 0;
+static size_t cacheRejects = 0;
+
+/**
+ * 64-bit FNV-1a hash of a cooked asset key
+ */
+static uint64_t HashCookedAssetKey(const char *key)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	while (*key != '\0')
+	{
+		hash ^= (uint8_t)*key;
+		hash *= 0x100000001b3ull;
+		key++;
+	}
+	return hash;
+}
+
+/**
+ * Build the key identifying a specific version of an asset file
+ * @return The key (must be freed), or NULL if the source file could not be inspected
+ */
+static char *BuildCookedAssetKey(const char *sourcePath, const char *relPath)
+{
+	SDL_PathInfo info;
+	if (!SDL_GetPathInfo(sourcePath, &info))
+	{
+		return NULL;
+	}
+	const char *format = "%s\n%s\n%" PRIu64 "\n%" PRId64 "\n" ENGINE_VERSION;
+	const int keyLength = snprintf(NULL, 0, format, sourcePath, relPath, info.size, (int64_t)info.modify_time);
+	char *key = malloc(keyLength + 1);
+	CheckAlloc(key);
+	snprintf(key, keyLength + 1, format, sourcePath, relPath, info.size, (int64_t)info.modify_time);
+	return key;
+}
+
+/**
+ * Get the path of the cooked asset file for a key
+ * @return The path, which must be freed
+ */
+static char *GetCookedAssetPath(const char *key)
+{
+	const size_t pathLength = strlen(cacheDirectory) + 16 + strlen(COOKED_ASSET_EXTENSION) + 1;
+	char *path = malloc(pathLength);
+	CheckAlloc(path);
+	snprintf(path, pathLength, "%s%016" PRIx64 COOKED_ASSET_EXTENSION, cacheDirectory, HashCookedAssetKey(key));
+	return path;
+}
+
+/**
+ * Compute the crc32 of a buffer that may be larger than zlib's uInt
+ */
+static uint32_t ChecksumCookedAsset(const uint8_t *data, const size_t size)
+{
+	return (uint32_t)crc32_z(crc32_z(0L, Z_NULL, 0), data, size);
+}
+
+/**
+ * Pick the cooked asset cache directory: $XDG_CACHE_HOME (or ~/.cache) where available, otherwise next to the
+ * executable.
+ * @return The directory with a trailing slash (must be freed), or NULL if it could not be created
+ */
+static char *FindCacheDirectory()
+{
+	// The game title is used as the folder name, so strip anything that could be a problem in a path
+	char *gameFolder = strdup(gameConfig.gameTitle ? gameConfig.gameTitle : "game");
+	CheckAlloc(gameFolder);
+	for (char *c = gameFolder; *c != '\0'; c++)
+	{
+		if (!isalnum((unsigned char)*c) && *c != '-' && *c != '_')
+		{
+			*c = '_';
+		}
+	}
+
+	char *directory = NULL;
+#ifndef WIN32
+	const char *xdgCacheHome = getenv("XDG_CACHE_HOME");
+	const char *home = getenv("HOME");
+	// The XDG spec says relative paths must be ignored
+	const char *base = NULL;
+	const char *baseSuffix = "";
+	if (xdgCacheHome != NULL && xdgCacheHome[0] == '/')
+	{
+		base = xdgCacheHome;
+	} else if (home != NULL && home[0] == '/')
+	{
+		base = home;
+		baseSuffix = "/.cache";
+	}
+	if (base != NULL)
+	{
+		const size_t directoryLength = strlen(base) + strlen(baseSuffix) + 1 + strlen(gameFolder) +
+									   strlen("/cooked_assets/") + 1;
+		directory = malloc(directoryLength);
+		CheckAlloc(directory);
+		snprintf(directory, directoryLength, "%s%s/%s/cooked_assets/", base, baseSuffix, gameFolder);
+		if (!SDL_CreateDirectory(directory))
+		{
+			LogWarning("Failed to create cooked asset cache directory \"%s\": %s\n", directory, SDL_GetError());
+			free(directory);
+			directory = NULL;
+		}
+	}
+#endif
+	free(gameFolder);
+	if (directory != NULL)
+	{
+		return directory;
+	}
+
+	const char *executableFolder = GetState()->executableFolder;
+	const size_t directoryLength = strlen(executableFolder) + strlen("cooked_assets/") + 1;
+	directory = malloc(directoryLength);
+	CheckAlloc(directory);
+	snprintf(directory, directoryLength, "%scooked_assets/", executableFolder);
+	if (!SDL_CreateDirectory(directory))
+	{
+		LogWarning("Failed to create cooked asset cache directory \"%s\": %s\n", directory, SDL_GetError());
+		free(directory);
+		return NULL;
+	}
+	return directory;
+}
+
+static void FreeCookedAssetWriteJob(CookedAssetWriteJob *job)
+{
+	free(job->path);
+	free(job->key);
+	free(job->asset.data);
+	free(job);
+}
+
+static void WriteCookedAssetFile(const CookedAssetWriteJob *job)
+{
+	const size_t keyLength = strlen(job->key);
+	const size_t headerSize = sizeof(CookedAssetHeader) + keyLength;
+	const CookedAssetHeader header = {
+		.magic = COOKED_ASSET_MAGIC,
+		.version = COOKED_ASSET_VERSION,
+		.type = job->asset.type,
+		.typeVersion = job->asset.typeVersion,
+		.keyLength = keyLength,
+		.payloadOffset = (headerSize + COOKED_ASSET_PAYLOAD_ALIGNMENT - 1) & ~(uint64_t)(COOKED_ASSET_PAYLOAD_ALIGNMENT - 1),
+		.payloadSize = job->asset.size,
+		.payloadChecksum = ChecksumCookedAsset(job->asset.data, job->asset.size),
+	};
+
+	// Written to a temporary file first, so that a crash or a second instance never sees a partial file
+	const size_t tempPathLength = strlen(job->path) + strlen(".tmp") + 1;
+	char *tempPath = malloc(tempPathLength);
+	CheckAlloc(tempPath);
+	snprintf(tempPath, tempPathLength, "%s.tmp", job->path);
+
+	FILE *file = fopen(tempPath, "wb");
+	if (file == NULL)
+	{
+		LogWarning("Failed to open cooked asset \"%s\" for writing\n", tempPath);
+		free(tempPath);
+		return;
+	}
+	const uint8_t padding[COOKED_ASSET_PAYLOAD_ALIGNMENT] = {0};
+	const size_t paddingSize = header.payloadOffset - headerSize;
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+	success = success && fwrite(job->key, 1, keyLength, file) == keyLength;
+	success = success && fwrite(padding, 1, paddingSize, file) == paddingSize;
+	success = success && fwrite(job->asset.data, 1, job->asset.size, file) == job->asset.size;
+	success = fclose(file) == 0 && success;
+
+	if (success)
+	{
+		// rename does not replace existing files on Windows
+		remove(job->path);
+		success = rename(tempPath, job->path) == 0;
+	}
+	if (!success)
+	{
+		LogWarning("Failed to write cooked asset \"%s\"\n", job->path);
+		remove(tempPath);
+	}
+	free(tempPath);
+}
+
+static int CookedAssetWriterThreadMain(void * /*data*/)
+{
+	SDL_LockMutex(cacheMutex);
+	while (true)
+	{
+		while (!shouldExit && queuedJobs.length == 0)
+		{
+			SDL_WaitCondition(jobQueuedCondition, cacheMutex);
+		}
+		if (shouldExit)
+		{
+			break;
+		}
+
+		CookedAssetWriteJob *job = ListGetPointer(queuedJobs, 0);
+		ListRemoveAt(queuedJobs, 0);
+		SDL_UnlockMutex(cacheMutex);
+
+		WriteCookedAssetFile(job);
+
+		SDL_LockMutex(cacheMutex);
+		pendingBytes -= job->asset.size;
+		cacheWrites++;
+		FreeCookedAssetWriteJob(job);
+	}
+	SDL_UnlockMutex(cacheMutex);
+	return 0;
+}
+
+void InitCookedAssetCache()
+{
+	if (HasCliArg("--no-asset-cache"))
+	{
+		LogInfo("Cooked asset cache is disabled\n");
+		return;
+	}
+	cacheDirectory = FindCacheDirectory();
+	if (cacheDirectory == NULL)
+	{
+		return;
+	}
+	LogDebug("Using cooked asset cache directory \"%s\"\n", cacheDirectory);
+
+	cacheMutex = SDL_CreateMutex();
+	jobQueuedCondition = SDL_CreateCondition();
+	ListInit(queuedJobs, LIST_POINTER);
+	pendingBytes = 0;
+	shouldExit = false;
+	writerThread = SDL_CreateThread(CookedAssetWriterThreadMain, "GameCookedAssetWriter", NULL);
+	if (writerThread == NULL)
+	{
+		LogWarning("Failed to start the cooked asset writer thread, the cache will be read-only\n");
+	}
+}
+
+void DestroyCookedAssetCache()
+{
+	if (cacheMutex == NULL)
+	{
+		return;
+	}
+	SDL_LockMutex(cacheMutex);
+	shouldExit = true;
+	for (size_t i = 0; i < queuedJobs.length; i++)
+	{
+		FreeCookedAssetWriteJob(ListGetPointer(queuedJobs, i));
+	}
+	ListClear(queuedJobs);
+	pendingBytes = 0;
+	SDL_BroadcastCondition(jobQueuedCondition);
+	SDL_UnlockMutex(cacheMutex);
+	if (writerThread != NULL)
+	{
+		SDL_WaitThread(writerThread, NULL);
+		writerThread = NULL;
+	}
+
+	ListFree(queuedJobs);
+	SDL_DestroyCondition(jobQueuedCondition);
+	SDL_DestroyMutex(cacheMutex);
+	cacheMutex = NULL;
+	free(cacheDirectory);
+	cacheDirectory = NULL;
+}
+
+/**
+ * Check that a mapped cooked asset file is intact and matches the key
+ */
+static bool ValidateCookedAsset(const uint8_t *file, const size_t fileSize, const char *key)
+{
+	if (fileSize < sizeof(CookedAssetHeader))
+	{
+		return false;
+	}
+	CookedAssetHeader header;
+	memcpy(&header, file, sizeof(header));
+	if (header.magic != COOKED_ASSET_MAGIC || header.version != COOKED_ASSET_VERSION)
+	{
+		return false;
+	}
+	const size_t keyLength = strlen(key);
+	if (header.keyLength != keyLength ||
+		fileSize - sizeof(header) < keyLength ||
+		memcmp(file + sizeof(header), key, keyLength) != 0)
+	{
+		return false;
+	}
+	if (header.payloadOffset % COOKED_ASSET_PAYLOAD_ALIGNMENT != 0 ||
+		header.payloadOffset > fileSize ||
+		header.payloadSize != fileSize - header.payloadOffset)
+	{
+		return false;
+	}
+	return ChecksumCookedAsset(file + header.payloadOffset, header.payloadSize) == header.payloadChecksum;
+}
+
+/**
+ * Load an entry from the cache
+ * @param key The full key of the entry
+ * @param name What the entry is, for log messages
+ * @param asset Where to store the entry
+ * @return Whether the entry was found and passed its integrity checks
+ */
+static bool LoadCookedEntry(const char *key, const char *name, Asset *asset)
+{
+	char *path = GetCookedAssetPath(key);
+
+	size_t fileSize = 0;
+	const uint8_t *file = MapFileReadOnly(path, &fileSize);
+	if (file == NULL)
+	{
+		SDL_LockMutex(cacheMutex);
+		cacheMisses++;
+		SDL_UnlockMutex(cacheMutex);
+		free(path);
+		return false;
+	}
+
+	const bool valid = ValidateCookedAsset(file, fileSize, key);
+	if (valid)
+	{
+		CookedAssetHeader header;
+		memcpy(&header, file, sizeof(header));
+		// Asset data is always owned by malloc (the asset cache, FreeAsset and textures all free it), so the payload is
+		// copied out of the mapping. This is still a plain memcpy instead of an inflate.
+		asset->size = header.payloadSize;
+		asset->type = header.type;
+		asset->typeVersion = header.typeVersion;
+		asset->data = malloc(header.payloadSize);
+		CheckAlloc(asset->data);
+		memcpy(asset->data, file + header.payloadOffset, header.payloadSize);
+	}
+	UnmapFile(file, fileSize);
+
+	SDL_LockMutex(cacheMutex);
+	if (valid)
+	{
+		cacheHits++;
+	} else
+	{
+		cacheMisses++;
+		cacheRejects++;
+	}
+	SDL_UnlockMutex(cacheMutex);
+
+	if (!valid)
+	{
+		// Either corrupt, or a different entry that happens to have the same hash. Either way it gets rewritten.
+		LogWarning("Discarding invalid cooked asset \"%s\" for \"%s\"\n", path, name);
+		remove(path);
+	}
+	free(path);
+	return valid;
+}
+
+/**
+ * Queue an entry to be written to the cache in the background
+ * @param key The full key of the entry, which is taken over by the queue
+ * @param asset The entry. It is copied, so it may be freed right away.
+ */
+static void QueueCookedEntry(char *key, const Asset *asset)
+{
+	SDL_LockMutex(cacheMutex);
+	const bool full = pendingBytes + asset->size > COOKED_ASSET_MAX_PENDING_BYTES;
+	SDL_UnlockMutex(cacheMutex);
+	if (full)
+	{
+		free(key);
+		return;
+	}
+
+	CookedAssetWriteJob *job = malloc(sizeof(CookedAssetWriteJob));
+	CheckAlloc(job);
+	job->key = key;
+	job->path = GetCookedAssetPath(key);
+	job->asset = *asset;
+	job->asset.data = malloc(asset->size);
+	CheckAlloc(job->asset.data);
+	memcpy(job->asset.data, asset->data, asset->size);
+
+	SDL_LockMutex(cacheMutex);
+	pendingBytes += job->asset.size;
+	ListAdd(queuedJobs, job);
+	SDL_SignalCondition(jobQueuedCondition);
+	SDL_UnlockMutex(cacheMutex);
+}
+
+bool LoadCookedAsset(const char *sourcePath, const char *relPath, Asset *asset)
+{
+	if (cacheDirectory == NULL)
+	{
+		return false;
+	}
+	char *key = BuildCookedAssetKey(sourcePath, relPath);
+	if (key == NULL)
+	{
+		return false;
+	}
+	const bool found = LoadCookedEntry(key, relPath, asset);
+	free(key);
+	return found;
+}
+
+void StoreCookedAsset(const char *sourcePath, const char *relPath, const Asset *asset)
+{
+	if (cacheDirectory == NULL || writerThread == NULL || asset->size < COOKED_ASSET_MIN_SIZE)
+	{
+		return;
+	}
+	char *key = BuildCookedAssetKey(sourcePath, relPath);
+	if (key == NULL)
+	{
+		return;
+	}
+	QueueCookedEntry(key, asset);
+}
+
+bool IsCookedAssetCacheEnabled()
+{
+	return cacheDirectory != NULL;
+}
+
+uint8_t *LoadCookedData(const char *key, size_t *size)
+{
+	if (cacheDirectory == NULL)
+	{
+		return NULL;
+	}
+	Asset entry;
+	if (!LoadCookedEntry(key, key, &entry))
+	{
+		return NULL;
+	}
+	if (entry.type != COOKED_DATA_TYPE)
+	{
+		free(entry.data);
+		return NULL;
+	}
+	*size = entry.size;
+	return entry.data;
+}
+
+void StoreCookedData(const char *key, const uint8_t *data, const size_t size)
+{
+	if (cacheDirectory == NULL || writerThread == NULL)
+	{
+		return;
+	}
+	char *keyCopy = strdup(key);
+	CheckAlloc(keyCopy);
+	const Asset entry = {
+		.size = size,
+		.type = COOKED_DATA_TYPE,
+		.data = (uint8_t *)data,
+	};
+	QueueCookedEntry(keyCopy, &entry);
+}
+
+void DPrintCookedAssetCache()
+{
+	if (cacheMutex == NULL)
+	{
+		DPrintF("Cooked Asset Cache: disabled", COLOR_WHITE);
+		return;
+	}
+	SDL_LockMutex(cacheMutex);
+	DPrintF("Cooked Asset Cache: %zu hit(s), %zu miss(es), %zu written, %zu rejected, %zu queued",
+			COLOR_WHITE,
+			cacheHits,
+			cacheMisses,
+			cacheWrites,
+			cacheRejects,
+			queuedJobs.length);
+	SDL_UnlockMutex(cacheMutex);
+}
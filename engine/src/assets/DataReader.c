@@ -100,6 +100,60 @@ char *ReadStringSafe(DataReader *reader, size_t *outLength)
 	return NULL;
 }
 
+const char *ReadStringView(DataReader *reader, size_t *outLength)
+{
+	size_t remainingSize = reader->totalBufferSize - reader->offset;
+	if (remainingSize < sizeof(size_t))
+	{
+		return NULL;
+	}
+	const size_t stringLength = ReadSizeT(reader);
+	remainingSize -= sizeof(size_t);
+	if (stringLength == 0 || remainingSize < stringLength)
+	{
+		return NULL;
+	}
+	const char *string = (const char *)reader->data + reader->offset;
+	if (string[stringLength - 1] != '\0')
+	{
+		return NULL;
+	}
+	reader->offset += stringLength;
+	if (outLength)
+	{
+		*outLength = stringLength;
+	}
+	return string;
+}
+
+const void *ReadSpan(DataReader *reader, const size_t elementSize, const size_t count)
+{
+	// Checked as a division so that a huge count from a corrupt file cannot overflow the size
+	const size_t remainingSize = reader->totalBufferSize - reader->offset;
+	if (elementSize != 0 && count > remainingSize / elementSize)
+	{
+		Error("DataReader Buffer Overrun");
+	}
+	const void *span = reader->data + reader->offset;
+	reader->offset += elementSize * count;
+	return span;
+}
+
+void ReadFloatArray(DataReader *reader, const size_t count, float *dest)
+{
+	ReadStructArray(reader, sizeof(float), count, dest);
+}
+
+void ReadStructArray(DataReader *reader, const size_t elementSize, const size_t count, void *dest)
+{
+	const void *span = ReadSpan(reader, elementSize, count);
+	if (count == 0)
+	{
+		return;
+	}
+	memcpy(dest, span, elementSize * count);
+}
+
 void Seek(DataReader *reader, const size_t bytes)
 {
 	if (reader->offset + bytes > reader->totalBufferSize)
@@ -114,6 +168,11 @@ size_t DataReaderGetOffset(const DataReader *reader)
 	return reader->offset;
 }
 
+size_t DataReaderGetRemaining(const DataReader *reader)
+{
+	return reader->totalBufferSize - reader->offset;
+}
+
 uint16_t Checksum(const uint8_t *buffer, const size_t bufferSize)
 {
 	uint16_t checksum = 5873 + (bufferSize % 2367);
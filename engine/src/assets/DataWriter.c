@@ -2,14 +2,18 @@
 // Created by droc101 on 5/19/26.
 //
 
+#include <engine/assets/AssetReader.h>
 #include <engine/assets/DataWriter.h>
 #include <engine/subsystem/Error.h>
+#include <engine/subsystem/threads/WorkerPool.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <zconf.h>
+#include <zlib.h>
 
 /// The internal buffer of a DataWriter will always be a multiple of this size
 #define DATAWRITER_BUFFER_BLOCK_SIZE 1024
@@ -85,6 +89,80 @@ void WriteString(DataWriter *writer, const char *string)
 	WriteUint8(writer, 0); // null terminator
 }
 
+typedef struct ChunkDeflateJob
+{
+	const uint8_t *data;
+	size_t size;
+	uint32_t chunkSize;
+	/// The compressed data of each chunk
+	uint8_t **chunks;
+	/// The compressed size of each chunk
+	uLongf *chunkSizes;
+} ChunkDeflateJob;
+
+static void DeflateChunk(const size_t index, void *userData)
+{
+	const ChunkDeflateJob *job = userData;
+	const size_t offset = index * job->chunkSize;
+	const size_t size = job->size - offset < job->chunkSize ? job->size - offset : job->chunkSize;
+	job->chunkSizes[index] = compressBound(size);
+	job->chunks[index] = malloc(job->chunkSizes[index]);
+	CheckAlloc(job->chunks[index]);
+	if (compress2(job->chunks[index], &job->chunkSizes[index], job->data + offset, size, Z_BEST_COMPRESSION) != Z_OK)
+	{
+		Error("Failed to compress asset chunk");
+	}
+}
+
+void WriteCompressedAsset(DataWriter *writer,
+						  const uint8_t type,
+						  const uint8_t typeVersion,
+						  const uint8_t *data,
+						  const size_t size,
+						  const uint32_t chunkSize)
+{
+	const uint32_t chunkCount = (uint32_t)((size + chunkSize - 1) / chunkSize);
+	ChunkDeflateJob job = {
+		.data = data,
+		.size = size,
+		.chunkSize = chunkSize,
+		.chunks = calloc(chunkCount ? chunkCount : 1, sizeof(uint8_t *)),
+		.chunkSizes = calloc(chunkCount ? chunkCount : 1, sizeof(uLongf)),
+	};
+	CheckAlloc(job.chunks);
+	CheckAlloc(job.chunkSizes);
+	ParallelFor(chunkCount, DeflateChunk, &job);
+
+	size_t compressedSize = ASSET_CHUNK_TABLE_HEADER_SIZE + (chunkCount * sizeof(uint64_t));
+	for (uint32_t i = 0; i < chunkCount; i++)
+	{
+		compressedSize += job.chunkSizes[i];
+	}
+
+	WriteUint32(writer, ASSET_FORMAT_MAGIC);
+	WriteUint8(writer, ASSET_FORMAT_VERSION);
+	WriteUint8(writer, type);
+	WriteUint8(writer, typeVersion);
+	WriteSizeT(writer, size);
+	WriteSizeT(writer, compressedSize);
+
+	WriteUint32(writer, chunkSize);
+	WriteUint32(writer, chunkCount);
+	uint64_t chunkEnd = 0;
+	for (uint32_t i = 0; i < chunkCount; i++)
+	{
+		chunkEnd += job.chunkSizes[i];
+		WriteUint64(writer, chunkEnd);
+	}
+	for (uint32_t i = 0; i < chunkCount; i++)
+	{
+		WriteBuffer(writer, job.chunks[i], 1, job.chunkSizes[i]);
+		free(job.chunks[i]);
+	}
+	free(job.chunks);
+	free(job.chunkSizes);
+}
+
 #define DefineWriteFunction(T, name) \
 	DeclareWriteFunction(T, name) \
 	{ \
@@ -7,6 +7,7 @@
 #include <engine/assets/DataReader.h>
 #include <engine/assets/FontLoader.h>
 #include <engine/assets/TextureLoader.h>
+#include <engine/debug/AssetTrace.h>
 #include <engine/debug/DPrint.h>
 #include <engine/structs/Asset.h>
 #include <engine/structs/Color.h>
@@ -57,7 +58,7 @@ static Font *GenerateFallbackFont(const char *asset)
 	return font;
 }
 
-static Font *LoadFontInternal(const char *asset)
+Font *LoadFontInternal(const char *asset)
 {
 	Asset *assetData = LoadAsset(asset, false, false);
 	if (assetData == NULL)
@@ -65,6 +66,7 @@ static Font *LoadFontInternal(const char *asset)
 		LogError("Failed to load font from asset, asset was NULL!\n");
 		return GenerateFallbackFont(asset);
 	}
+	const uint64_t parseStart = AssetTraceBegin();
 	if (assetData->typeVersion != FONT_ASSET_VERSION)
 	{
 		LogError("Failed to load font from asset due to version mismatch (got %d, expected %d)\n",
@@ -125,6 +127,7 @@ static Font *LoadFontInternal(const char *asset)
 		font->charEndUVs[(int)chr] = (float)((double)(i + 1) / font->charCount - 1.0 / (double)img->width); // Here too
 	}
 	font->name = strdup(asset);
+	AssetTraceEnd(asset, ASSET_TRACE_PARSE, parseStart, assetData->size);
 	DestroyDataReader(reader);
 	FreeAsset(assetData);
 
@@ -149,18 +152,24 @@ Font *LoadFont(const char *asset)
 	return loaded;
 }
 
+void FreeFont(Font *font)
+{
+	if (font == NULL)
+	{
+		return;
+	}
+	free(font->name);
+	free(font->texture);
+	free(font);
+}
+
 void DestroyFontLoader()
 {
 	LogDebug("Cleaning up font cache...\n");
 	for (int i = 0; i < MAX_FONTS; i++)
 	{
-		if (fonts[i] != NULL)
-		{
-			free(fonts[i]->name);
-			free(fonts[i]->texture);
-			free(fonts[i]);
-			fonts[i] = NULL;
-		}
+		FreeFont(fonts[i]);
+		fonts[i] = NULL;
 	}
 	fontId = 0;
 }
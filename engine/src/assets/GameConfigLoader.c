@@ -5,6 +5,7 @@
 #include <engine/assets/AssetReader.h>
 #include <engine/assets/DataReader.h>
 #include <engine/assets/GameConfigLoader.h>
+#include <engine/helpers/Arguments.h>
 #include <engine/helpers/PlatformHelpers.h>
 #include <engine/structs/Asset.h>
 #include <engine/structs/GlobalState.h>
@@ -105,6 +106,16 @@ void LoadGameConfig(const char *game)
 	gameConfig.gameCopyright = strdup(KvGetString(configList, "game_copyright", ""));
 	gameConfig.discordAppId = KvGetUint64(configList, "discord_app_id", 0);
 	gameConfig.backgroundMap = strdup(KvGetString(configList, "background_map", "background"));
+	const int assetCacheBudgetMb = GetCliArgInt("--asset-cache-budget",
+												KvGetInt(configList,
+														 "asset_cache_budget_mb",
+														 DEFAULT_ASSET_CACHE_BUDGET_MB));
+	gameConfig.assetCacheBudget = assetCacheBudgetMb > 0 ? (size_t)assetCacheBudgetMb * 1024 * 1024 : 0;
+	const int actorIoChainDepthLimit = GetCliArgInt("--actor-io-chain-depth",
+													KvGetInt(configList,
+															 "actor_io_chain_depth_limit",
+															 DEFAULT_ACTOR_IO_CHAIN_DEPTH_LIMIT));
+	gameConfig.actorIoChainDepthLimit = actorIoChainDepthLimit > 0 ? (uint32_t)actorIoChainDepthLimit : 0;
 
 	ListInit(gameConfig.assetPaths, LIST_POINTER);
 
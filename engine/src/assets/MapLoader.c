@@ -5,22 +5,32 @@
 #include <assert.h>
 #include <engine/assets/AssetReader.h>
 #include <engine/assets/DataReader.h>
+#include <engine/assets/DataWriter.h>
 #include <engine/assets/MapLoader.h>
 #include <engine/assets/MapMaterialLoader.h>
 #include <engine/assets/ModelLoader.h>
+#include <engine/debug/MapLoadProfiler.h>
 #include <engine/graphics/RenderingHelpers.h>
+#include <engine/helpers/Realloc.h>
+#include <engine/physics/BodyBatch.h>
+#include <engine/physics/CookedShapes.h>
 #include <engine/physics/Physics.h>
 #include <engine/physics/PlayerPhysics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
 #include <engine/structs/ActorWall.h>
 #include <engine/structs/Asset.h>
+#include <engine/structs/Atom.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Light.h>
 #include <engine/structs/List.h>
 #include <engine/structs/Map.h>
+#include <engine/structs/MapArena.h>
 #include <engine/structs/Vector2.h>
 #include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/threads/WorkerPool.h>
+#include <engine/subsystem/Timing.h>
 #include <joltc/enums.h>
 #include <joltc/joltc.h>
 #include <joltc/Math/Quat.h>
@@ -36,291 +46,1292 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <zlib.h>
 
-bool LoadMap(Map *map, Asset *mapData)
+typedef enum MapLoadMode
 {
-	if (!map || !mapData)
+	/// Load everything, creating actors and uploading the map to the GPU
+	MAP_LOAD_FULL,
+	/// Only parse the map and build its collision shapes, without creating actors or physics bodies and without
+	/// uploading anything to the GPU
+	MAP_LOAD_HEADLESS,
+	/// Build everything that is safe to build off the main thread, leaving the rest to @c FinishDetachedMapLoad
+	MAP_LOAD_DETACHED,
+	/// Only find where each section of the map is, without building anything
+	MAP_LOAD_SCAN,
+	/// Build a chunk of another map off the main thread, keeping its collision shapes for @c AttachMapChunk instead of
+	/// adding bodies for them
+	MAP_LOAD_CHUNK,
+} MapLoadMode;
+
+/**
+ * Fail the current section if the reader does not have enough bytes left
+ */
+#define EXPECT_MAP_BYTES(reader, expected) \
+	{ \
+		if (DataReaderGetRemaining(reader) < (expected)) \
+		{ \
+			LogError("Not enough bytes remaining to read %zu bytes\n", (size_t)(expected)); \
+			return false; \
+		} \
+	}
+
+/**
+ * Check whether a load mode reads the actors, geometry and lightmap of a map
+ */
+static bool LoadsMapContents(const MapLoadMode mode)
+{
+	return mode == MAP_LOAD_FULL || mode == MAP_LOAD_DETACHED || mode == MAP_LOAD_CHUNK;
+}
+
+/// The size of each entry in the section table of a sectioned map
+#define MAP_SECTION_TABLE_ENTRY_SIZE ((sizeof(uint32_t) * 2) + (sizeof(size_t) * 2))
+
+typedef struct MapCollisionMesh MapCollisionMesh;
+typedef struct MapCollisionSubShape MapCollisionSubShape;
+typedef struct MapCollision MapCollision;
+typedef struct MapSectionSpan MapSectionSpan;
+typedef struct MapLoadContext MapLoadContext;
+
+struct MapCollisionMesh
+{
+	/// The position of the mesh's body
+	Vector3 position;
+	/// The index of the mesh's first sub-shape in @c MapCollision
+	size_t firstSubShape;
+	size_t subShapeCount;
+};
+
+struct MapCollisionSubShape
+{
+	size_t numVertices;
+	/// The vertices as 3 floats each, pointing into the map asset, or NULL for a triangle soup
+	const uint8_t *vertexData;
+	size_t numTriangles;
+	/// The triangles as 3 @c uint32_t vertex indices each, or as 9 floats each for a triangle soup, pointing into the
+	/// map asset
+	const uint8_t *triangleData;
+};
+
+/**
+ * The collision section of a map, indexed so that the shapes can be built in parallel or restored from the cache
+ */
+struct MapCollision
+{
+	/// Whether the sub-shapes are stored as indexed triangles instead of a triangle soup
+	bool indexed;
+	size_t meshCount;
+	MapCollisionMesh *meshes;
+	/// The compound shape of each mesh's sub-shapes, or NULL for meshes without any
+	JPH_Shape **meshShapes;
+	/// The number of sub-shapes across all meshes
+	size_t subShapeCount;
+	/// The number of sub-shapes there is space for
+	size_t subShapeCapacity;
+	MapCollisionSubShape *subShapeData;
+	/// The mesh shape built from each sub-shape's triangles
+	JPH_Shape **subShapes;
+};
+
+struct MapSectionSpan
+{
+	/// The offset of the section from the start of the map asset
+	size_t offset;
+	size_t size;
+	/// The crc32 of the section, from the section table of a sectioned map
+	uint32_t checksum;
+};
+
+/**
+ * Everything a map load shares between the sections of the map
+ */
+struct MapLoadContext
+{
+	Map *map;
+	MapLoadMode mode;
+	Asset *mapData;
+	/// Where each section is in the map asset
+	MapSectionSpan sections[MAP_SECTION_COUNT];
+	/// Whether each section of a sectioned map was read successfully
+	bool sectionLoaded[MAP_SECTION_COUNT];
+	/// The collision meshes, which are turned into bodies once every section has been read
+	MapCollision collision;
+};
+
+/**
+ * Read the collision section of a map, without building any shapes
+ * @param reader The reader, positioned at the start of the collision section
+ * @param collision Where to store the collision meshes, with @c indexed set to the format of the section.
+ *				   This must be freed with @c FreeMapCollision even on failure.
+ * @return Whether the section was read successfully
+ * @note The triangles are not copied, so the map asset must outlive @c collision.
+ */
+static bool ReadMapCollision(DataReader *reader, MapCollision *collision)
+{
+	EXPECT_MAP_BYTES(reader, sizeof(size_t));
+	const size_t meshCount = ReadSizeT(reader);
+	// Checked before allocating, so that a corrupt count can't allocate more meshes than the section could hold
+	if (meshCount > DataReaderGetRemaining(reader) / ((sizeof(float) * 3) + sizeof(size_t)))
 	{
+		LogError("Not enough bytes remaining to read %zu collision meshes\n", meshCount);
 		return false;
 	}
+	collision->meshes = calloc(meshCount, sizeof(MapCollisionMesh));
+	CheckAlloc(collision->meshes);
+	collision->meshShapes = calloc(meshCount, sizeof(JPH_Shape *));
+	CheckAlloc(collision->meshShapes);
+	for (size_t i = 0; i < meshCount; i++)
+	{
+		MapCollisionMesh *mesh = &collision->meshes[i];
+		collision->meshCount++;
+		EXPECT_MAP_BYTES(reader, (sizeof(float) * 3) + sizeof(size_t));
+		float position[3];
+		ReadFloatArray(reader, 3, position);
+		mesh->position = (Vector3){position[0], position[1], position[2]};
+		mesh->firstSubShape = collision->subShapeCount;
+		const size_t subShapeCount = ReadSizeT(reader);
+		for (size_t j = 0; j < subShapeCount; j++)
+		{
+			if (collision->subShapeCount == collision->subShapeCapacity)
+			{
+				collision->subShapeCapacity = collision->subShapeCapacity ? collision->subShapeCapacity * 2 : 16;
+				collision->subShapeData = GameReallocArray(collision->subShapeData,
+														   collision->subShapeCapacity,
+														   sizeof(MapCollisionSubShape));
+				CheckAlloc(collision->subShapeData);
+			}
+			MapCollisionSubShape *subShape = &collision->subShapeData[collision->subShapeCount];
+			collision->subShapeCount++;
+			mesh->subShapeCount++;
 
-	DataReader *reader = CreateDataReaderFromAsset(mapData);
+			subShape->numVertices = 0;
+			subShape->vertexData = NULL;
+			if (collision->indexed)
+			{
+				EXPECT_MAP_BYTES(reader, sizeof(size_t));
+				subShape->numVertices = ReadSizeT(reader);
+				if (subShape->numVertices > DataReaderGetRemaining(reader) / (sizeof(float) * 3))
+				{
+					LogError("Not enough bytes remaining to read %zu vertices\n", subShape->numVertices);
+					return false;
+				}
+				subShape->vertexData = ReadSpan(reader, sizeof(float) * 3, subShape->numVertices);
+			}
 
-	size_t bytesRemaining = mapData->size;
-	size_t strLength = 0;
+			const size_t triangleSize = collision->indexed ? sizeof(uint32_t) * 3 : sizeof(float) * 9;
+			EXPECT_MAP_BYTES(reader, sizeof(size_t));
+			subShape->numTriangles = ReadSizeT(reader);
+			if (subShape->numTriangles > DataReaderGetRemaining(reader) / triangleSize)
+			{
+				LogError("Not enough bytes remaining to read %zu triangles\n", subShape->numTriangles);
+				return false;
+			}
+			subShape->triangleData = ReadSpan(reader, triangleSize, subShape->numTriangles);
+			if (collision->indexed &&
+				!CheckStaticColliderIndices(subShape->triangleData, subShape->numTriangles, subShape->numVertices))
+			{
+				LogError("Map collision triangle has a vertex index out of range\n");
+				return false;
+			}
+		}
+	}
+	return true;
+}
 
-	JPH_BodyInterface *bodyInterface = JPH_PhysicsSystem_GetBodyInterface(map->physicsSystem);
+static void BuildMapCollisionSubShape(const size_t index, void *userData)
+{
+	MapCollision *collision = userData;
+	const MapCollisionSubShape *subShape = &collision->subShapeData[index];
+	collision->subShapes[index] = CreateStaticModelShapeFromData(subShape->vertexData,
+																 subShape->numVertices,
+																 subShape->triangleData,
+																 subShape->numTriangles);
+}
 
-	EXPECT_BYTES_BOOL(1, bytesRemaining);
-	map->renderSky = ReadUint8(reader);
-	if (map->renderSky)
+static void BuildMapCollisionMesh(const size_t index, void *userData)
+{
+	const MapCollision *collision = userData;
+	const MapCollisionMesh *mesh = &collision->meshes[index];
+	if (mesh->subShapeCount == 0)
 	{
-		map->skyTexture = ReadStringSafe(reader, &strLength);
-		bytesRemaining -= strLength;
-		bytesRemaining += sizeof(size_t);
-	} else
+		return;
+	}
+	JPH_StaticCompoundShapeSettings *compoundShapeSettings = JPH_StaticCompoundShapeSettings_Create();
+	for (size_t i = 0; i < mesh->subShapeCount; i++)
+	{
+		JPH_CompoundShapeSettings_AddShape2((JPH_CompoundShapeSettings *)compoundShapeSettings,
+											&Vector3_Zero,
+											&JPH_Quat_Identity,
+											collision->subShapes[mesh->firstSubShape + i],
+											0);
+	}
+	collision->meshShapes[index] = (JPH_Shape *)JPH_StaticCompoundShape_Create(compoundShapeSettings);
+	JPH_ShapeSettings_Destroy((JPH_ShapeSettings *)compoundShapeSettings);
+}
+
+/**
+ * Build the shapes of every collision mesh across the worker pool.
+ * All mesh shapes are built first, since they are the expensive part, and then all compound shapes.
+ */
+static void BuildMapCollision(MapCollision *collision)
+{
+	collision->subShapes = calloc(collision->subShapeCount, sizeof(JPH_Shape *));
+	CheckAlloc(collision->subShapes);
+	ParallelFor(collision->subShapeCount, BuildMapCollisionSubShape, collision);
+	ParallelFor(collision->meshCount, BuildMapCollisionMesh, collision);
+}
+
+/**
+ * Free a map's collision meshes. Shapes that are used by a body are kept alive by it.
+ */
+static void FreeMapCollision(MapCollision *collision)
+{
+	for (size_t i = 0; i < collision->subShapeCount && collision->subShapes != NULL; i++)
+	{
+		if (collision->subShapes[i] != NULL)
+		{
+			JPH_Shape_Destroy(collision->subShapes[i]);
+		}
+	}
+	for (size_t i = 0; i < collision->meshCount; i++)
+	{
+		if (collision->meshShapes[i] != NULL)
+		{
+			JPH_Shape_Destroy(collision->meshShapes[i]);
+		}
+	}
+	free(collision->subShapeData);
+	free(collision->subShapes);
+	free(collision->meshShapes);
+	free(collision->meshes);
+}
+
+/**
+ * Free the parts of a map that @c LoadMapInternal fills in, for maps that were parsed headless
+ */
+static void FreeHeadlessMapData(Map *map)
+{
+	FreeLoadTimeMapData(map);
+	MapArenaDestroy(&map->arena);
+}
+
+/**
+ * Compute the crc32 of a map section, which may be larger than zlib's uInt
+ */
+static uint32_t ChecksumMapSection(const uint8_t *data, const size_t size)
+{
+	return (uint32_t)crc32_z(crc32_z(0L, Z_NULL, 0), data, size);
+}
+
+/**
+ * Read a length prefixed string from a map into the map's arena
+ * @return The string, or NULL if the section is too short
+ */
+static char *ReadMapString(DataReader *reader, MapArena *arena)
+{
+	if (DataReaderGetRemaining(reader) < sizeof(size_t))
+	{
+		return NULL;
+	}
+	const size_t length = ReadSizeT(reader);
+	if (DataReaderGetRemaining(reader) < length)
+	{
+		return NULL;
+	}
+	const char *data = ReadSpan(reader, sizeof(char), length);
+	// Terminated here as well, in case the file's copy isn't
+	char *string = MapArenaAlloc(arena, length + 1);
+	memcpy(string, data, length);
+	string[length] = '\0';
+	return string;
+}
+
+/**
+ * Read a length prefixed string from a map and intern it
+ * @return The atom of the string, or @c ATOM_NONE if the section is too short
+ */
+static Atom ReadMapAtom(DataReader *reader)
+{
+	if (DataReaderGetRemaining(reader) < sizeof(size_t))
+	{
+		return ATOM_NONE;
+	}
+	const size_t length = ReadSizeT(reader);
+	if (DataReaderGetRemaining(reader) < length)
+	{
+		return ATOM_NONE;
+	}
+	return InternLength(ReadSpan(reader, sizeof(char), length), length);
+}
+
+/**
+ * Log how much of a map was allocated from its arena, once it has finished loading
+ */
+static void LogMapArenaUsage(const Map *map)
+{
+	LogDebug("Map arena holds %zu allocation(s), using %.1f KiB of %.1f KiB in %zu block(s)\n",
+			 map->arena.allocationCount,
+			 (double)map->arena.bytesAllocated / 1024.0,
+			 (double)map->arena.bytesReserved / 1024.0,
+			 map->arena.blockCount);
+}
+
+/**
+ * Create an actor read from a map and add it to the map
+ * @param map The map to add the actor to
+ * @param arena The arena to allocate the actor from, which is the arena of the map the actor was read from
+ * @param actorClass The class of the actor
+ * @param xfm The transform of the actor
+ * @param params The params of the actor, which are taken over by the actor
+ * @param ioConnections The I/O connections of the actor, which are taken over by the actor
+ * @return The actor, or NULL if it was the player
+ */
+static Actor *CreateMapActor(Map *map,
+							 MapArena *arena,
+							 JPH_BodyInterface *bodyInterface,
+							 const Atom actorClass,
+							 Transform *xfm,
+							 KvList params,
+							 const LockingList ioConnections)
+{
+	if (actorClass == Intern("player"))
+	{
+		map->player.playerCamera.nearZ = KvGetFloat(params, "near_z", DEFAULT_NEAR_Z);
+		map->player.playerCamera.farZ = KvGetFloat(params, "far_z", DEFAULT_FAR_Z);
+		SetPlayerTransform(&map->player, xfm);
+		KvListDestroy(params);
+		return NULL;
+	}
+
+	// Interned, since the params are freed once the actor is created
+	Atom actorName = ATOM_NONE;
+	if (KvHas(params, "name", PARAM_TYPE_STRING) && KvGetString(params, "name", "")[0] != '\0')
+	{
+		actorName = Intern(KvGetString(params, "name", ""));
+	}
+
+	Actor *actor = CreateActorInArena(xfm, AtomString(actorClass), params, bodyInterface, arena);
+	ListFree(actor->ioConnections);
+	actor->ioConnections = ioConnections;
+	InvalidateActorOutputLinks(actor);
+	AddActorToMap(actor, map);
+
+	if (actorName != ATOM_NONE)
 	{
-		map->skyTexture = NULL;
+		NameActor(actor, AtomString(actorName), map);
 	}
-	map->discordRpcIcon = ReadStringSafe(reader, &strLength);
-	bytesRemaining -= strLength;
-	bytesRemaining += sizeof(size_t);
-	map->discordRpcName = ReadStringSafe(reader, &strLength);
-	bytesRemaining -= strLength;
-	bytesRemaining += sizeof(size_t);
+	return actor;
+}
 
-	EXPECT_BYTES_BOOL(sizeof(size_t), bytesRemaining);
+/**
+ * Free a list of I/O connections that were read from a map but will not be used.
+ * The connections themselves are in the map's arena, which other sections may be allocating from, so only their param
+ * overrides are freed.
+ */
+static void DiscardMapConnections(LockingList *ioConnections)
+{
+	for (size_t i = 0; i < ioConnections->length; i++)
+	{
+		ActorConnection *connection = ListGetPointer(*ioConnections, i);
+		FreeParam(&connection->outParamOverride);
+	}
+	ListFree(*ioConnections);
+}
+
+/**
+ * Read an I/O connection from a map and add it to a list
+ * @return Whether the connection was read successfully. The connection is added to the list even on failure.
+ */
+static bool ReadMapConnection(DataReader *reader, MapArena *arena, LockingList *ioConnections)
+{
+	ActorConnection *connection = MapArenaAllocFreeable(arena, sizeof(ActorConnection));
+	connection->outParamOverride.type = PARAM_TYPE_NONE;
+	ListAdd(*ioConnections, connection);
+
+	connection->sourceActorOutput = ReadMapAtom(reader);
+	connection->targetActorName = ReadMapAtom(reader);
+	connection->targetActorInput = ReadMapAtom(reader);
+	if (connection->sourceActorOutput == ATOM_NONE || connection->targetActorName == ATOM_NONE ||
+		connection->targetActorInput == ATOM_NONE)
+	{
+		LogError("Failed to read actor connection from map\n");
+		return false;
+	}
+	EXPECT_MAP_BYTES(reader, sizeof(uint8_t));
+	const uint8_t hasOverride = ReadUint8(reader);
+	// TODO data size validation for params
+	if (hasOverride)
+	{
+		(void)ReadParam(reader, &connection->outParamOverride);
+	}
+	EXPECT_MAP_BYTES(reader, sizeof(size_t));
+	connection->numRefires = ReadSizeT(reader);
+	return true;
+}
+
+static bool ReadMapInfoSection(MapLoadContext *context, DataReader *reader)
+{
+	Map *map = context->map;
+	EXPECT_MAP_BYTES(reader, sizeof(uint8_t));
+	map->renderSky = ReadUint8(reader);
+	map->skyTexture = map->renderSky ? ReadMapString(reader, &map->arena) : NULL;
+	map->discordRpcIcon = ReadMapString(reader, &map->arena);
+	map->discordRpcName = ReadMapString(reader, &map->arena);
+	if ((map->renderSky && !map->skyTexture) || !map->discordRpcIcon || !map->discordRpcName)
+	{
+		LogError("Failed to read map info\n");
+		return false;
+	}
+	return true;
+}
+
+static bool ReadMapActorSection(MapLoadContext *context, DataReader *reader)
+{
+	Map *map = context->map;
+	MapArena *arena = &map->arena;
+	const bool keepActors = LoadsMapContents(context->mode);
+
+	EXPECT_MAP_BYTES(reader, sizeof(size_t));
 	const size_t numActors = ReadSizeT(reader);
 	for (size_t i = 0; i < numActors; i++)
 	{
-		size_t actorClassLength = 0;
-		char *actorClass = ReadStringSafe(reader, &actorClassLength);
-		bytesRemaining -= actorClassLength;
-		bytesRemaining -= sizeof(size_t);
+		const Atom actorClass = ReadMapAtom(reader);
+		if (actorClass == ATOM_NONE || AtomString(actorClass)[0] == '\0')
+		{
+			LogError("Failed to read actor class from map\n");
+			return false;
+		}
 
-		EXPECT_BYTES_BOOL(sizeof(float) * 6, bytesRemaining);
+		EXPECT_MAP_BYTES(reader, (sizeof(float) * 6) + sizeof(size_t));
+		float values[6];
+		ReadFloatArray(reader, 6, values);
 		Transform xfm;
-		xfm.position.x = ReadFloat(reader);
-		xfm.position.y = ReadFloat(reader);
-		xfm.position.z = ReadFloat(reader);
-		const float rotX = ReadFloat(reader);
-		const float rotY = ReadFloat(reader);
-		const float rotZ = ReadFloat(reader);
-		Vector3 eulerAngles = {rotX, rotY, rotZ};
+		xfm.position.x = values[0];
+		xfm.position.y = values[1];
+		xfm.position.z = values[2];
+		Vector3 eulerAngles = {values[3], values[4], values[5]};
 		JPH_Quat_FromEulerAngles(&eulerAngles, &xfm.rotation);
 
 		LockingList ioConnections = {0};
 		ListInit(ioConnections, LIST_POINTER);
-		EXPECT_BYTES_BOOL(sizeof(size_t), bytesRemaining);
 		const size_t numConnections = ReadSizeT(reader);
 		for (size_t j = 0; j < numConnections; j++)
 		{
-			ActorConnection *connection = malloc(sizeof(ActorConnection));
-			CheckAlloc(connection);
-			connection->sourceActorOutput = ReadStringSafe(reader, &strLength);
-			bytesRemaining -= strLength;
-			bytesRemaining += sizeof(size_t);
-			connection->targetActorName = ReadStringSafe(reader, &strLength);
-			bytesRemaining -= strLength;
-			bytesRemaining += sizeof(size_t);
-			connection->targetActorInput = ReadStringSafe(reader, &strLength);
-			bytesRemaining -= strLength;
-			bytesRemaining += sizeof(size_t);
-			uint8_t hasOverride = ReadUint8(reader);
-			// TODO data size validation for params
-			if (hasOverride)
-			{
-				size_t paramSize = ReadParam(reader, &connection->outParamOverride);
-				bytesRemaining -= paramSize;
-			} else
+			if (!ReadMapConnection(reader, arena, &ioConnections))
 			{
-				connection->outParamOverride.type = PARAM_TYPE_NONE;
+				DiscardMapConnections(&ioConnections);
+				return false;
 			}
-			connection->numRefires = ReadSizeT(reader);
-			ListAdd(ioConnections, connection);
+		}
+		if (DataReaderGetRemaining(reader) < sizeof(size_t))
+		{
+			LogError("Failed to read actor params from map\n");
+			DiscardMapConnections(&ioConnections);
+			return false;
 		}
 		KvList params;
-		// TODO: Add EXPECT_BYTES for this
-		bytesRemaining -= ReadKvList(reader, params);
+		(void)ReadKvList(reader, params);
 
-		if (strcmp(actorClass, "player") == 0)
+		if (!keepActors)
 		{
-			map->player.playerCamera.nearZ = KvGetFloat(params, "near_z", DEFAULT_NEAR_Z);
-			map->player.playerCamera.farZ = KvGetFloat(params, "far_z", DEFAULT_FAR_Z);
-			SetPlayerTransform(&map->player, &xfm);
 			KvListDestroy(params);
-			ListFree(ioConnections);
-			free(actorClass);
+			DiscardMapConnections(&ioConnections);
 			continue;
 		}
+		// Actor init functions expect to run on the main thread with the map loaded, so they are created later
+		MapPendingActor *pendingActor = MapArenaAlloc(arena, sizeof(MapPendingActor));
+		pendingActor->actorClass = actorClass;
+		pendingActor->transform = xfm;
+		KvList_init_move(pendingActor->params, params);
+		pendingActor->ioConnections = ioConnections;
+		ListAdd(map->pendingActors, pendingActor);
+	}
+	return true;
+}
 
-		const char *actorName = NULL;
-		if (KvHas(params, "name", PARAM_TYPE_STRING))
+static bool ReadMapModelSection(MapLoadContext *context, DataReader *reader)
+{
+	Map *map = context->map;
+	MapArena *arena = &map->arena;
+	// Headless maps are never drawn, so their geometry is only skipped over
+	const bool loadGeometry = LoadsMapContents(context->mode);
+
+	EXPECT_MAP_BYTES(reader, sizeof(size_t));
+	const size_t modelCount = ReadSizeT(reader);
+	// Checked before allocating, so that a corrupt count can't allocate more models than the section could hold
+	if (modelCount > DataReaderGetRemaining(reader) / (sizeof(size_t) + (sizeof(uint32_t) * 2)))
+	{
+		LogError("Not enough bytes remaining to read %zu models\n", modelCount);
+		return false;
+	}
+	if (loadGeometry)
+	{
+		map->modelCount = modelCount;
+		// Zeroed so that a map that failed to load part way through can still be destroyed
+		map->models = MapArenaCalloc(arena, modelCount, sizeof(MapModel));
+		map->pendingMaterialNames = MapArenaCalloc(arena, modelCount, sizeof(char *));
+	}
+	// MapVertex is 7 tightly packed floats, the same layout as the file
+	static_assert(sizeof(MapVertex) == sizeof(float) * 7);
+	for (size_t i = 0; i < modelCount; i++)
+	{
+		const char *materialName = ReadStringView(reader, NULL);
+		if (!materialName)
 		{
-			actorName = KvGetString(params, "name", "");
-			if (actorName[0] != '\0')
-			{
-				actorName = strdup(actorName);
-			} else
-			{
-				actorName = NULL;
-			}
+			LogError("Failed to read model material from map\n");
+			return false;
+		}
+		EXPECT_MAP_BYTES(reader, sizeof(uint32_t));
+		const uint32_t vertexCount = ReadUint32(reader);
+		EXPECT_MAP_BYTES(reader, sizeof(MapVertex) * (size_t)vertexCount);
+		const void *vertices = ReadSpan(reader, sizeof(MapVertex), vertexCount);
+		EXPECT_MAP_BYTES(reader, sizeof(uint32_t));
+		const uint32_t indexCount = ReadUint32(reader);
+		EXPECT_MAP_BYTES(reader, sizeof(uint32_t) * (size_t)indexCount);
+		const void *indices = ReadSpan(reader, sizeof(uint32_t), indexCount);
+		if (!loadGeometry)
+		{
+			continue;
 		}
 
-		Actor *actor = CreateActor(&xfm, actorClass, params, bodyInterface);
-		ListFree(actor->ioConnections);
-		actor->ioConnections = ioConnections;
-		ListAdd(map->actors, actor);
-		free(actorClass);
+		MapModel *model = &map->models[i];
+		// The material cache may only be used from the main thread, so materials are loaded by FinishDetachedMapLoad
+		map->pendingMaterialNames[i] = MapArenaStrdup(arena, materialName);
+		// Vertices and indices stay on the heap, since FreeLoadTimeMapData frees them once they are on the GPU
+		model->vertexCount = vertexCount;
+		model->vertices = malloc(sizeof(MapVertex) * vertexCount);
+		CheckAlloc(model->vertices);
+		memcpy(model->vertices, vertices, sizeof(MapVertex) * vertexCount);
+		model->indexCount = indexCount;
+		model->indices = malloc(sizeof(uint32_t) * indexCount);
+		CheckAlloc(model->indices);
+		memcpy(model->indices, indices, sizeof(uint32_t) * indexCount);
+	}
+	return true;
+}
 
-		if (actorName && actorName[0] != '\0')
+static bool ReadMapCollisionSection(MapLoadContext *context, DataReader *reader)
+{
+	const bool headless = context->mode == MAP_LOAD_HEADLESS;
+	MapCollision *collision = &context->collision;
+	const uint64_t collisionParseStart = GetTimeNs();
+	// The cooked shape cache is keyed by the raw bytes of the section
+	const uint8_t *collisionData = ReadSpan(reader, sizeof(uint8_t), 0);
+	const size_t collisionOffset = DataReaderGetOffset(reader);
+	collision->indexed = context->mapData->typeVersion >= MAP_ASSET_VERSION_INDEXED_COLLISION;
+	if (!ReadMapCollision(reader, collision))
+	{
+		return false;
+	}
+	if (context->mode == MAP_LOAD_SCAN)
+	{
+		return true;
+	}
+
+	const uint64_t collisionBuildStart = GetTimeNs();
+	const size_t collisionSize = DataReaderGetOffset(reader) - collisionOffset;
+	const bool cooked = LoadCookedShapes("map", collisionData, collisionSize, collision->meshShapes, collision->meshCount);
+	if (!cooked)
+	{
+		BuildMapCollision(collision);
+		StoreCookedShapes("map", collisionData, collisionSize, collision->meshShapes, collision->meshCount);
+	}
+	if (!headless && cooked)
+	{
+		LogInfo("Restored %zu cooked collision mesh(es) in %.3f ms, parsing took %.3f ms\n",
+				collision->meshCount,
+				(double)(GetTimeNs() - collisionBuildStart) / 1000000.0,
+				(double)(collisionBuildStart - collisionParseStart) / 1000000.0);
+	} else if (!headless)
+	{
+		LogInfo("Built %zu collision mesh(es) from %zu sub-shape(s) in %.3f ms on %zu thread(s), parsing took %.3f ms\n",
+				collision->meshCount,
+				collision->subShapeCount,
+				(double)(GetTimeNs() - collisionBuildStart) / 1000000.0,
+				GetWorkerPoolThreadCount(),
+				(double)(collisionBuildStart - collisionParseStart) / 1000000.0);
+	}
+	return true;
+}
+
+static bool ReadMapLightmapSection(MapLoadContext *context, DataReader *reader)
+{
+	Map *map = context->map;
+	EXPECT_MAP_BYTES(reader, sizeof(size_t) * 2);
+	const size_t width = ReadSizeT(reader);
+	const size_t height = ReadSizeT(reader);
+	// uint16_t because float16
+	const size_t pixelSize = sizeof(uint16_t) * 4;
+	if (width != 0 && (width > DataReaderGetRemaining(reader) || height > DataReaderGetRemaining(reader) / pixelSize / width))
+	{
+		LogError("Not enough bytes remaining to read a %zux%zu lightmap\n", width, height);
+		return false;
+	}
+	const size_t lightmapDataSize = pixelSize * width * height;
+	const void *pixels = ReadSpan(reader, sizeof(uint8_t), lightmapDataSize);
+	// Headless maps are never drawn, so the lightmap is only skipped over
+	if (!LoadsMapContents(context->mode))
+	{
+		return true;
+	}
+	map->lightmapWidth = width;
+	map->lightmapHeight = height;
+	map->lightmapPixels = malloc(lightmapDataSize);
+	CheckAlloc(map->lightmapPixels);
+	memcpy(map->lightmapPixels, pixels, lightmapDataSize);
+	return true;
+}
+
+static bool ReadMapLightSection(MapLoadContext *context, DataReader *reader)
+{
+	Map *map = context->map;
+	EXPECT_MAP_BYTES(reader, sizeof(uint16_t));
+	map->lightCount = ReadUint16(reader);
+	EXPECT_MAP_BYTES(reader, ((sizeof(float) * 16) + sizeof(uint32_t)) * map->lightCount);
+	map->pointLights = MapArenaCalloc(&map->arena, map->lightCount, sizeof(Light));
+	for (size_t i = 0; i < map->lightCount; i++)
+	{
+		Light *light = &map->pointLights[i];
+		light->type = ReadUint32(reader);
+		float values[16];
+		ReadFloatArray(reader, 16, values);
+		light->transform.position.x = values[0];
+		light->transform.position.y = values[1];
+		light->transform.position.z = values[2];
+		Vector3 rotation = {values[3], values[4], values[5]};
+		JPH_Quat_FromEulerAngles(&rotation, &light->transform.rotation);
+
+		light->color[0] = values[6];
+		light->color[1] = values[7];
+		light->color[2] = values[8];
+
+		light->brightness = values[9];
+		light->constantAttenuation = values[10];
+		light->linearAttenuation = values[11];
+		light->quadraticAttenuation = values[12];
+		light->attenuationMultiplier = values[13];
+		light->brightAngle = values[14];
+		light->fadingAngle = values[15];
+	}
+	return true;
+}
+
+/**
+ * Read one section of a map
+ * @param context The load context. Each section only writes the parts of the context and map that belong to it, so
+ *				  different sections may be read at the same time.
+ * @param reader A reader positioned at the start of the section
+ * @return Whether the section was read successfully
+ */
+typedef bool (*MapSectionReader)(MapLoadContext *context, DataReader *reader);
+
+static const MapSectionReader mapSectionReaders[MAP_SECTION_COUNT] = {
+	[MAP_SECTION_INFO] = ReadMapInfoSection,
+	[MAP_SECTION_ACTORS] = ReadMapActorSection,
+	[MAP_SECTION_MODELS] = ReadMapModelSection,
+	[MAP_SECTION_COLLISION] = ReadMapCollisionSection,
+	[MAP_SECTION_LIGHTMAP] = ReadMapLightmapSection,
+	[MAP_SECTION_LIGHTS] = ReadMapLightSection,
+};
+
+/// The name of each section in the map load profile
+static const char *const mapSectionStageNames[MAP_SECTION_COUNT] = {
+	[MAP_SECTION_INFO] = "parse info",
+	[MAP_SECTION_ACTORS] = "parse actors",
+	[MAP_SECTION_MODELS] = "parse render models",
+	[MAP_SECTION_COLLISION] = "collision",
+	[MAP_SECTION_LIGHTMAP] = "parse lightmap",
+	[MAP_SECTION_LIGHTS] = "parse lights",
+};
+
+/**
+ * Check whether a map section has to be read at all when loading a sectioned map
+ */
+static bool IsMapSectionNeeded(const MapLoadMode mode, const MapSectionId section)
+{
+	if (mode == MAP_LOAD_HEADLESS)
+	{
+		// Headless maps are never drawn
+		return section != MAP_SECTION_MODELS && section != MAP_SECTION_LIGHTMAP;
+	}
+	return true;
+}
+
+/**
+ * Read every section of a version 1 map, which has to be done in order since the sections are not indexed
+ */
+static bool ReadMapSectionsV1(MapLoadContext *context)
+{
+	DataReader *reader = CreateDataReaderFromAsset(context->mapData);
+	for (size_t i = 0; i < MAP_SECTION_COUNT; i++)
+	{
+		const size_t sectionStart = DataReaderGetOffset(reader);
+		const MapLoadStageTimer timer = StartMapLoadStage(&context->map->arena);
+		if (!mapSectionReaders[i](context, reader))
 		{
-			ListAdd(map->namedActorNames, actorName);
-			ListAdd(map->namedActorPointers, actor);
+			DestroyDataReader(reader);
+			return false;
 		}
+		EndMapLoadStage(mapSectionStageNames[i], &timer);
+		context->sections[i].offset = sectionStart;
+		context->sections[i].size = DataReaderGetOffset(reader) - sectionStart;
 	}
+	DestroyDataReader(reader);
+	return true;
+}
 
-	EXPECT_BYTES_BOOL(sizeof(size_t), bytesRemaining);
-	map->modelCount = ReadSizeT(reader);
-	map->models = malloc(sizeof(MapModel) * map->modelCount);
-	CheckAlloc(map->models);
-	for (size_t i = 0; i < map->modelCount; i++)
+/**
+ * Read the section table of a sectioned map into @c context->sections
+ */
+static bool ReadMapSectionTable(MapLoadContext *context)
+{
+	const Asset *mapData = context->mapData;
+	if (mapData->size < sizeof(uint32_t))
 	{
-		MapModel *model = &map->models[i];
-		char *materialName = ReadStringSafe(reader, &strLength);
-		bytesRemaining -= sizeof(size_t);
-		bytesRemaining -= strLength;
-		model->material = LoadMapMaterial(materialName);
-		assert(model->material);
-		free(materialName);
-
-		EXPECT_BYTES_BOOL(sizeof(uint32_t), bytesRemaining);
-		model->vertexCount = ReadUint32(reader);
-		model->vertices = malloc(sizeof(MapVertex) * model->vertexCount);
-		CheckAlloc(model->vertices);
-		for (uint32_t j = 0; j < model->vertexCount; j++)
+		LogError("Map is too small to hold a section table\n");
+		return false;
+	}
+	uint32_t sectionCount = 0;
+	memcpy(&sectionCount, mapData->data, sizeof(uint32_t));
+	if (sectionCount > (mapData->size - sizeof(uint32_t)) / MAP_SECTION_TABLE_ENTRY_SIZE)
+	{
+		LogError("Map section table with %u section(s) does not fit in the map\n", sectionCount);
+		return false;
+	}
+
+	bool foundSections[MAP_SECTION_COUNT] = {false};
+	DataReader *reader = CreateDataReader(mapData->data, mapData->size, sizeof(uint32_t));
+	for (uint32_t i = 0; i < sectionCount; i++)
+	{
+		const uint32_t id = ReadUint32(reader);
+		const uint32_t checksum = ReadUint32(reader);
+		const size_t offset = ReadSizeT(reader);
+		const size_t size = ReadSizeT(reader);
+		if (offset > mapData->size || size > mapData->size - offset)
 		{
-			MapVertex *vertex = model->vertices + j;
-			EXPECT_BYTES_BOOL(sizeof(float) * 7, bytesRemaining);
-			vertex->position.x = ReadFloat(reader);
-			vertex->position.y = ReadFloat(reader);
-			vertex->position.z = ReadFloat(reader);
-			vertex->uv.x = ReadFloat(reader);
-			vertex->uv.y = ReadFloat(reader);
-			vertex->lightmapUv.x = ReadFloat(reader);
-			vertex->lightmapUv.y = ReadFloat(reader);
+			LogError("Map section %u is out of bounds\n", id);
+			DestroyDataReader(reader);
+			return false;
 		}
-		EXPECT_BYTES_BOOL(sizeof(uint32_t), bytesRemaining);
-		model->indexCount = ReadUint32(reader);
-		EXPECT_BYTES_BOOL(sizeof(uint32_t) * model->indexCount, bytesRemaining);
-		model->indices = malloc(sizeof(uint32_t) * model->indexCount);
-		CheckAlloc(model->indices);
-		ReadBuffer(reader, sizeof(uint32_t) * model->indexCount, model->indices);
+		// Sections added by newer versions of the map compiler are ignored
+		if (id >= MAP_SECTION_COUNT)
+		{
+			continue;
+		}
+		context->sections[id] = (MapSectionSpan){
+			.offset = offset,
+			.size = size,
+			.checksum = checksum,
+		};
+		foundSections[id] = true;
+	}
+	DestroyDataReader(reader);
+
+	for (size_t i = 0; i < MAP_SECTION_COUNT; i++)
+	{
+		if (!foundSections[i])
+		{
+			LogError("Map is missing section %zu\n", i);
+			return false;
+		}
+	}
+	return true;
+}
+
+static void ReadMapSection(const size_t index, void *userData)
+{
+	MapLoadContext *context = userData;
+	if (!IsMapSectionNeeded(context->mode, (MapSectionId)index))
+	{
+		context->sectionLoaded[index] = true;
+		return;
+	}
+	const MapSectionSpan *section = &context->sections[index];
+	uint8_t *sectionData = context->mapData->data + section->offset;
+	// Only the sections that are actually read are checked, so skipped sections cost nothing
+	if (ChecksumMapSection(sectionData, section->size) != section->checksum)
+	{
+		LogError("Map section %zu is corrupt\n", index);
+		return;
 	}
+	// Allocations aren't counted, since the other sections are allocating from the same arena at the same time
+	const MapLoadStageTimer timer = StartMapLoadStage(NULL);
+	DataReader *reader = CreateDataReader(sectionData, section->size, 0);
+	context->sectionLoaded[index] = mapSectionReaders[index](context, reader);
+	DestroyDataReader(reader);
+	EndMapLoadStage(mapSectionStageNames[index], &timer);
+}
 
+/**
+ * Read every section of a sectioned map at once across the worker pool
+ */
+static bool ReadMapSectionsSectioned(MapLoadContext *context)
+{
+	if (!ReadMapSectionTable(context))
+	{
+		return false;
+	}
+	ParallelFor(MAP_SECTION_COUNT, ReadMapSection, context);
+	for (size_t i = 0; i < MAP_SECTION_COUNT; i++)
+	{
+		if (!context->sectionLoaded[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
 
-	Transform collisionXfm = {
+/**
+ * Create the static body of a collision mesh
+ * @param bodyInterface The body interface to create the body with, which must be in a body batch
+ * @param bodies The @c LIST_UINT32 list to add the body to
+ * @param shape The shape of the mesh
+ * @param position The position of the mesh
+ */
+static void CreateMapCollisionBody(JPH_BodyInterface *bodyInterface,
+								   List *bodies,
+								   JPH_Shape *shape,
+								   const Vector3 *position)
+{
+	const Transform collisionXfm = {
+		.position = *position,
 		.rotation = JPH_Quat_Identity,
 	};
+	JPH_BodyCreationSettings *bodyCreationSettings = JPH_BodyCreationSettings_Create2_GAME(shape,
+																						   &collisionXfm,
+																						   JPH_MotionType_Static,
+																						   OBJECT_LAYER_STATIC,
+																						   0);
+	JPH_BodyCreationSettings_SetFriction(bodyCreationSettings, 68.0f);
+	const JPH_BodyID body = CreateAndAddBody(bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
+	ListAdd(*bodies, body);
+	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
+}
 
-	EXPECT_BYTES_BOOL(sizeof(size_t), bytesRemaining);
-	const size_t numCollisionMeshes = ReadSizeT(reader);
-	for (size_t i = 0; i < numCollisionMeshes; i++)
+/**
+ * Create a static body for every collision mesh of a map
+ */
+static void AddMapCollisionBodies(Map *map, const MapCollision *collision)
+{
+	const MapLoadStageTimer bodyTimer = StartMapLoadStage(&map->arena);
+	JPH_BodyInterface *bodyInterface = JPH_PhysicsSystem_GetBodyInterface(map->physicsSystem);
+	BeginBodyBatch(bodyInterface);
+	for (size_t i = 0; i < collision->meshCount; i++)
 	{
-		EXPECT_BYTES_BOOL((sizeof(float) * 3) + sizeof(size_t), bytesRemaining);
-		collisionXfm.position.x = ReadFloat(reader);
-		collisionXfm.position.y = ReadFloat(reader);
-		collisionXfm.position.z = ReadFloat(reader);
-		const size_t subShapeCount = ReadSizeT(reader);
-		if (subShapeCount == 0)
+		if (collision->meshShapes[i] != NULL)
 		{
-			continue;
+			CreateMapCollisionBody(bodyInterface,
+								   &map->joltBodies,
+								   collision->meshShapes[i],
+								   &collision->meshes[i].position);
 		}
+	}
+	EndBodyBatch();
+	EndMapLoadStage("collision bodies", &bodyTimer);
+}
 
-		JPH_StaticCompoundShapeSettings *compoundShapeSettings = JPH_StaticCompoundShapeSettings_Create();
+/**
+ * Keep the collision shapes of a map chunk until it is attached, since a chunk has no physics system of its own
+ */
+static void KeepMapChunkCollision(Map *chunk, MapCollision *collision)
+{
+	chunk->pendingCollisionShapes = calloc(collision->meshCount, sizeof(JPH_Shape *));
+	CheckAlloc(chunk->pendingCollisionShapes);
+	chunk->pendingCollisionPositions = calloc(collision->meshCount, sizeof(Vector3));
+	CheckAlloc(chunk->pendingCollisionPositions);
+	for (size_t i = 0; i < collision->meshCount; i++)
+	{
+		if (collision->meshShapes[i] == NULL)
+		{
+			continue;
+		}
+		chunk->pendingCollisionShapes[chunk->pendingCollisionCount] = collision->meshShapes[i];
+		chunk->pendingCollisionPositions[chunk->pendingCollisionCount] = collision->meshes[i].position;
+		chunk->pendingCollisionCount++;
+		collision->meshShapes[i] = NULL;
+	}
+}
 
-		for (size_t j = 0; j < subShapeCount; j++)
+/**
+ * Read a map from its asset
+ * @param map The map to load into
+ * @param mapData The map asset, which is freed on success
+ * @param mode What to build from the map
+ */
+static bool LoadMapInternal(Map *map, Asset *mapData, const MapLoadMode mode)
+{
+	MapLoadContext context = {
+		.map = map,
+		.mode = mode,
+		.mapData = mapData,
+	};
+	bool success = false;
+	if (mapData->typeVersion == MAP_ASSET_VERSION_V1)
+	{
+		success = ReadMapSectionsV1(&context);
+	} else if (mapData->typeVersion == MAP_ASSET_VERSION_SECTIONED ||
+			   mapData->typeVersion == MAP_ASSET_VERSION_INDEXED_COLLISION)
+	{
+		success = ReadMapSectionsSectioned(&context);
+	} else
+	{
+		LogError("Unsupported map version %d\n", mapData->typeVersion);
+	}
+	if (!success)
+	{
+		FreeMapCollision(&context.collision);
+		if (mode == MAP_LOAD_HEADLESS)
 		{
-			ModelStaticCollider staticCollider;
-			EXPECT_BYTES_BOOL(sizeof(size_t), bytesRemaining);
-			staticCollider.numTriangles = ReadSizeT(reader);
-			staticCollider.tris = malloc(sizeof(JPH_Triangle) * staticCollider.numTriangles);
-			CheckAlloc(staticCollider.tris);
-			for (size_t k = 0; k < staticCollider.numTriangles; k++)
-			{
-				JPH_Triangle *triangle = &staticCollider.tris[k];
-				triangle->materialIndex = 0;
-				EXPECT_BYTES_BOOL(sizeof(float) * 9, bytesRemaining);
+			FreeHeadlessMapData(map);
+		}
+		return false;
+	}
 
-				triangle->v1.x = ReadFloat(reader);
-				triangle->v1.y = ReadFloat(reader);
-				triangle->v1.z = ReadFloat(reader);
+	// Bodies are only added once every shape has been built, so the body interface is only used from this thread
+	if (mode == MAP_LOAD_CHUNK)
+	{
+		KeepMapChunkCollision(map, &context.collision);
+	} else if (mode != MAP_LOAD_HEADLESS)
+	{
+		AddMapCollisionBodies(map, &context.collision);
+	}
+	FreeMapCollision(&context.collision);
+	FreeAsset(mapData);
 
-				triangle->v2.x = ReadFloat(reader);
-				triangle->v2.y = ReadFloat(reader);
-				triangle->v2.z = ReadFloat(reader);
+	if (mode == MAP_LOAD_HEADLESS)
+	{
+		FreeHeadlessMapData(map);
+	} else if (mode == MAP_LOAD_FULL)
+	{
+		FinishDetachedMapLoad(map);
+	}
+	return true;
+}
 
-				triangle->v3.x = ReadFloat(reader);
-				triangle->v3.y = ReadFloat(reader);
-				triangle->v3.z = ReadFloat(reader);
-			}
-			JPH_Shape *subShape = CreateStaticModelShape(&staticCollider);
+bool LoadMap(Map *map, Asset *mapData)
+{
+	if (!map || !mapData)
+	{
+		return false;
+	}
+	return LoadMapInternal(map, mapData, MAP_LOAD_FULL);
+}
 
-			JPH_CompoundShapeSettings_AddShape2((JPH_CompoundShapeSettings *)compoundShapeSettings,
-												&Vector3_Zero,
-												&JPH_Quat_Identity,
-												subShape,
-												0);
+bool LoadMapDetached(Map *map, Asset *mapData)
+{
+	if (!map || !mapData)
+	{
+		return false;
+	}
+	return LoadMapInternal(map, mapData, MAP_LOAD_DETACHED);
+}
 
-			JPH_Shape_Destroy(subShape);
-			free(staticCollider.tris);
+void FinishDetachedMapLoad(Map *map)
+{
+	const MapLoadStageTimer materialTimer = StartMapLoadStage(&map->arena);
+	for (size_t i = 0; i < map->modelCount; i++)
+	{
+		map->models[i].material = LoadMapMaterial(map->pendingMaterialNames[i]);
+		assert(map->models[i].material);
+	}
+	map->pendingMaterialNames = NULL;
+	EndMapLoadStage("materials", &materialTimer);
+
+	// Actor bodies are batched, so that the broadphase only has to be built once for the whole map
+	JPH_BodyInterface *bodyInterface = JPH_PhysicsSystem_GetBodyInterface(map->physicsSystem);
+	BeginBodyBatch(bodyInterface);
+	for (size_t i = 0; i < map->pendingActors.length; i++)
+	{
+		MapPendingActor *pendingActor = ListGetPointer(map->pendingActors, i);
+		const MapLoadStageTimer actorTimer = StartMapLoadStage(&map->arena);
+		CreateMapActor(map,
+					   &map->arena,
+					   bodyInterface,
+					   pendingActor->actorClass,
+					   &pendingActor->transform,
+					   pendingActor->params,
+					   pendingActor->ioConnections);
+		if (actorTimer.startTime != 0)
+		{
+			char stageName[MAP_LOAD_STAGE_NAME_LENGTH];
+			snprintf(stageName, sizeof(stageName), "actor init: %s", AtomString(pendingActor->actorClass));
+			EndMapLoadStage(stageName, &actorTimer);
 		}
-		JPH_Shape *shape = (JPH_Shape *)JPH_StaticCompoundShape_Create(compoundShapeSettings);
-
-		JPH_BodyCreationSettings *bodyCreationSettings = JPH_BodyCreationSettings_Create2_GAME(shape,
-																							   &collisionXfm,
-																							   JPH_MotionType_Static,
-																							   OBJECT_LAYER_STATIC,
-																							   0);
-		JPH_BodyCreationSettings_SetFriction(bodyCreationSettings, 68.0f);
-		const JPH_BodyID body = JPH_BodyInterface_CreateAndAddBody(bodyInterface,
-																   bodyCreationSettings,
-																   JPH_Activation_Activate);
-		ListAdd(map->joltBodies, body);
-		JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
-		JPH_ShapeSettings_Destroy((JPH_ShapeSettings *)compoundShapeSettings);
-		JPH_Shape_Destroy(shape);
 	}
+	ListClear(map->pendingActors);
+	const MapLoadStageTimer bodyTimer = StartMapLoadStage(&map->arena);
+	EndBodyBatch();
+	EndMapLoadStage("actor bodies", &bodyTimer);
 
+	// The map is not simulated until it has finished loading, so the broadphase can be optimized here
+	const MapLoadStageTimer optimizeTimer = StartMapLoadStage(&map->arena);
 	JPH_PhysicsSystem_OptimizeBroadPhase(map->physicsSystem);
+	EndMapLoadStage("broadphase optimize", &optimizeTimer);
 
-	EXPECT_BYTES_BOOL(sizeof(size_t) * 2, bytesRemaining);
-	map->lightmapWidth = ReadSizeT(reader);
-	map->lightmapHeight = ReadSizeT(reader);
-	size_t lightmapDataSize = sizeof(uint16_t) *
-							  4 *
-							  map->lightmapHeight *
-							  map->lightmapWidth; // uint16_t because float16
-	EXPECT_BYTES_BOOL(lightmapDataSize, bytesRemaining);
-	map->lightmapPixels = malloc(lightmapDataSize);
-	CheckAlloc(map->lightmapPixels);
-	ReadBuffer(reader, lightmapDataSize, map->lightmapPixels);
+	// Every actor has been named by now, so the links built here stay valid until something is spawned or renamed
+	const MapLoadStageTimer linkTimer = StartMapLoadStage(&map->arena);
+	LinkLoadedActorOutputs(map, 0);
+	EndMapLoadStage("I/O links", &linkTimer);
 
-	EXPECT_BYTES_BOOL(sizeof(uint16_t), bytesRemaining);
-	map->lightCount = ReadUint16(reader);
-	map->pointLights = malloc(sizeof(Light) * map->lightCount);
-	CheckAlloc(map->pointLights);
-	EXPECT_BYTES_BOOL((sizeof(float) * 16 + sizeof(uint32_t)) * map->lightCount, bytesRemaining);
-	for (size_t i = 0; i < map->lightCount; i++)
+	MapArenaSeal(&map->arena);
+	LogMapArenaUsage(map);
+	LoadMapModels(map);
+}
+
+bool ParseMapHeadless(Asset *mapData)
+{
+	if (!mapData)
 	{
-		Light *light = &map->pointLights[i];
-		light->type = ReadUint32(reader);
-		light->transform.position.x = ReadFloat(reader);
-		light->transform.position.y = ReadFloat(reader);
-		light->transform.position.z = ReadFloat(reader);
-		Vector3 rotation;
-		rotation.x = ReadFloat(reader);
-		rotation.y = ReadFloat(reader);
-		rotation.z = ReadFloat(reader);
-		JPH_Quat_FromEulerAngles(&rotation, &light->transform.rotation);
+		return false;
+	}
+	Map map = {0};
+	return LoadMapInternal(&map, mapData, MAP_LOAD_HEADLESS);
+}
+
+bool LoadMapChunk(Map *chunk, Asset *mapData)
+{
+	if (!chunk || !mapData)
+	{
+		return false;
+	}
+	return LoadMapInternal(chunk, mapData, MAP_LOAD_CHUNK);
+}
+
+void AttachMapChunk(Map *map, Map *chunk)
+{
+	for (size_t i = 0; i < chunk->modelCount; i++)
+	{
+		chunk->models[i].material = LoadMapMaterial(chunk->pendingMaterialNames[i]);
+		assert(chunk->models[i].material);
+	}
+	chunk->pendingMaterialNames = NULL;
+
+	JPH_BodyInterface *bodyInterface = JPH_PhysicsSystem_GetBodyInterface(map->physicsSystem);
+	BeginBodyBatch(bodyInterface);
+	for (size_t i = 0; i < chunk->pendingCollisionCount; i++)
+	{
+		CreateMapCollisionBody(bodyInterface,
+							   &chunk->joltBodies,
+							   chunk->pendingCollisionShapes[i],
+							   &chunk->pendingCollisionPositions[i]);
+		JPH_Shape_Destroy(chunk->pendingCollisionShapes[i]);
+	}
+	chunk->pendingCollisionCount = 0;
+	free(chunk->pendingCollisionShapes);
+	chunk->pendingCollisionShapes = NULL;
+	free(chunk->pendingCollisionPositions);
+	chunk->pendingCollisionPositions = NULL;
+
+	// The actors' memory lives in the chunk's arena, so that it can be freed with it, but they are simulated as part of
+	// the map. The chunk keeps handles to them, since they may be removed and freed before the chunk is unloaded.
+	const size_t firstActor = map->actors.length;
+	for (size_t i = 0; i < chunk->pendingActors.length; i++)
+	{
+		MapPendingActor *pendingActor = ListGetPointer(chunk->pendingActors, i);
+		if (pendingActor->actorClass == Intern("player"))
+		{
+			LogWarning("Ignoring the player in a map chunk\n");
+			KvListDestroy(pendingActor->params);
+			DiscardMapConnections(&pendingActor->ioConnections);
+			continue;
+		}
+		Actor *actor = CreateMapActor(map,
+									  &chunk->arena,
+									  bodyInterface,
+									  pendingActor->actorClass,
+									  &pendingActor->transform,
+									  pendingActor->params,
+									  pendingActor->ioConnections);
+		ListAdd(chunk->actors, actor->handle);
+	}
+	ListClear(chunk->pendingActors);
+	EndBodyBatch();
+	LinkLoadedActorOutputs(map, firstActor);
+
+	MapArenaSeal(&chunk->arena);
+}
+
+/**
+ * A corner of a collision triangle, sorted by position so that corners that share a vertex end up next to each other
+ */
+typedef struct MapCollisionCorner
+{
+	float position[3];
+	/// The index of the corner in the triangle soup
+	size_t corner;
+} MapCollisionCorner;
 
-		light->color[0] = ReadFloat(reader);
-		light->color[1] = ReadFloat(reader);
-		light->color[2] = ReadFloat(reader);
+static int CompareCollisionCorners(const void *a, const void *b)
+{
+	const MapCollisionCorner *cornerA = a;
+	const MapCollisionCorner *cornerB = b;
+	// Only positions that are exactly the same are welded, so comparing the bits is enough
+	const int order = memcmp(cornerA->position, cornerB->position, sizeof(cornerA->position));
+	if (order != 0)
+	{
+		return order;
+	}
+	return (cornerA->corner > cornerB->corner) - (cornerA->corner < cornerB->corner);
+}
 
-		light->brightness = ReadFloat(reader);
-		light->constantAttenuation = ReadFloat(reader);
-		light->linearAttenuation = ReadFloat(reader);
-		light->quadraticAttenuation = ReadFloat(reader);
-		light->attenuationMultiplier = ReadFloat(reader);
-		light->brightAngle = ReadFloat(reader);
-		light->fadingAngle = ReadFloat(reader);
+/**
+ * Write a triangle soup sub-shape as indexed triangles, welding the corners that share a position
+ */
+static void WriteIndexedMapCollisionSubShape(DataWriter *writer, const MapCollisionSubShape *subShape)
+{
+	const size_t cornerCount = subShape->numTriangles * 3;
+	MapCollisionCorner *corners = malloc(sizeof(MapCollisionCorner) * cornerCount);
+	CheckAlloc(corners);
+	for (size_t i = 0; i < cornerCount; i++)
+	{
+		memcpy(corners[i].position, subShape->triangleData + (sizeof(float) * 3 * i), sizeof(float) * 3);
+		corners[i].corner = i;
 	}
+	qsort(corners, cornerCount, sizeof(MapCollisionCorner), CompareCollisionCorners);
 
+	uint32_t *indices = malloc(sizeof(uint32_t) * cornerCount);
+	CheckAlloc(indices);
+	size_t numVertices = 0;
+	for (size_t i = 0; i < cornerCount; i++)
+	{
+		if (i == 0 || memcmp(corners[i].position, corners[i - 1].position, sizeof(corners[i].position)) != 0)
+		{
+			numVertices++;
+		}
+		indices[corners[i].corner] = numVertices - 1;
+	}
+
+	WriteSizeT(writer, numVertices);
+	for (size_t i = 0; i < cornerCount; i++)
+	{
+		if (i == 0 || memcmp(corners[i].position, corners[i - 1].position, sizeof(corners[i].position)) != 0)
+		{
+			WriteBuffer(writer, corners[i].position, sizeof(float), 3);
+		}
+	}
+	WriteSizeT(writer, subShape->numTriangles);
+	WriteBuffer(writer, indices, sizeof(uint32_t), cornerCount);
+	free(indices);
+	free(corners);
+}
+
+/**
+ * Write the collision section of a version 3 map from the collision of an older map
+ */
+static void WriteIndexedMapCollision(DataWriter *writer, const MapCollision *collision)
+{
+	WriteSizeT(writer, collision->meshCount);
+	for (size_t i = 0; i < collision->meshCount; i++)
+	{
+		const MapCollisionMesh *mesh = &collision->meshes[i];
+		WriteFloat(writer, mesh->position.x);
+		WriteFloat(writer, mesh->position.y);
+		WriteFloat(writer, mesh->position.z);
+		WriteSizeT(writer, mesh->subShapeCount);
+		for (size_t j = 0; j < mesh->subShapeCount; j++)
+		{
+			WriteIndexedMapCollisionSubShape(writer, &collision->subShapeData[mesh->firstSubShape + j]);
+		}
+	}
+}
+
+/**
+ * Read the collision section of a version 2 map, for upgrading it
+ */
+static bool ReadSectionedMapCollision(MapLoadContext *context)
+{
+	if (!ReadMapSectionTable(context))
+	{
+		return false;
+	}
+	const MapSectionSpan *section = &context->sections[MAP_SECTION_COLLISION];
+	const uint8_t *sectionData = context->mapData->data + section->offset;
+	if (ChecksumMapSection(sectionData, section->size) != section->checksum)
+	{
+		LogError("Map section %d is corrupt\n", MAP_SECTION_COLLISION);
+		return false;
+	}
+	DataReader *reader = CreateDataReader(sectionData, section->size, 0);
+	const bool success = ReadMapCollision(reader, &context->collision);
 	DestroyDataReader(reader);
-	FreeAsset(mapData);
+	return success;
+}
 
-	LoadMapModels(map);
+bool UpgradeMapAsset(Asset *mapData)
+{
+	if (mapData->typeVersion == MAP_ASSET_VERSION_INDEXED_COLLISION)
+	{
+		return true;
+	}
+
+	Map map = {0};
+	MapLoadContext context = {
+		.map = &map,
+		.mode = MAP_LOAD_SCAN,
+		.mapData = mapData,
+	};
+	bool scanned = false;
+	if (mapData->typeVersion == MAP_ASSET_VERSION_V1)
+	{
+		scanned = ReadMapSectionsV1(&context);
+	} else if (mapData->typeVersion == MAP_ASSET_VERSION_SECTIONED)
+	{
+		scanned = ReadSectionedMapCollision(&context);
+	} else
+	{
+		LogError("Unsupported map version %d\n", mapData->typeVersion);
+	}
+	FreeHeadlessMapData(&map);
+	if (!scanned)
+	{
+		FreeMapCollision(&context.collision);
+		return false;
+	}
+
+	DataWriter *collisionWriter = CreateDataWriter();
+	WriteIndexedMapCollision(collisionWriter, &context.collision);
+	FreeMapCollision(&context.collision);
+	LogInfo("Indexed map collision takes %zu bytes instead of %zu\n",
+			DataWriterGetBufferSize(collisionWriter),
+			context.sections[MAP_SECTION_COLLISION].size);
+
+	// Every other section is copied as it is, so it parses exactly the same as before
+	const uint8_t *sectionData[MAP_SECTION_COUNT];
+	size_t sectionSizes[MAP_SECTION_COUNT];
+	for (size_t i = 0; i < MAP_SECTION_COUNT; i++)
+	{
+		sectionData[i] = mapData->data + context.sections[i].offset;
+		sectionSizes[i] = context.sections[i].size;
+	}
+	sectionData[MAP_SECTION_COLLISION] = DataWriterGetBuffer(collisionWriter);
+	sectionSizes[MAP_SECTION_COLLISION] = DataWriterGetBufferSize(collisionWriter);
+
+	DataWriter *writer = CreateDataWriter();
+	WriteUint32(writer, MAP_SECTION_COUNT);
+	size_t sectionOffset = sizeof(uint32_t) + (MAP_SECTION_TABLE_ENTRY_SIZE * MAP_SECTION_COUNT);
+	for (size_t i = 0; i < MAP_SECTION_COUNT; i++)
+	{
+		WriteUint32(writer, i);
+		WriteUint32(writer, ChecksumMapSection(sectionData[i], sectionSizes[i]));
+		WriteSizeT(writer, sectionOffset);
+		WriteSizeT(writer, sectionSizes[i]);
+		sectionOffset += sectionSizes[i];
+	}
+	for (size_t i = 0; i < MAP_SECTION_COUNT; i++)
+	{
+		WriteBuffer(writer, sectionData[i], sizeof(uint8_t), sectionSizes[i]);
+	}
+	FreeDataWriter(collisionWriter);
 
-	return map;
+	const size_t size = DataWriterGetBufferSize(writer);
+	uint8_t *data = malloc(size);
+	CheckAlloc(data);
+	memcpy(data, DataWriterGetBuffer(writer), size);
+	FreeDataWriter(writer);
+	free(mapData->data);
+	mapData->data = data;
+	mapData->size = size;
+	mapData->typeVersion = MAP_ASSET_VERSION_INDEXED_COLLISION;
+	return true;
 }
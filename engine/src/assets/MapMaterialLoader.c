@@ -7,6 +7,7 @@
 #include <engine/assets/MapMaterialLoader.h>
 #include <engine/assets/ModelLoader.h>
 #include <engine/assets/TextureLoader.h>
+#include <engine/debug/AssetTrace.h>
 #include <engine/structs/Asset.h>
 #include <engine/subsystem/Error.h>
 #include <engine/subsystem/Logging.h>
@@ -27,44 +28,26 @@ static MapMaterial fallbackMaterial = {
 	.texture = MISSING_TEXTURE_NAME,
 };
 
-MapMaterial *LoadMapMaterial(const char *path)
+MapMaterial *LoadMapMaterialInternal(const char *path)
 {
-	for (int i = 0; i < MAX_MAP_MATERIALS; i++)
-	{
-		MapMaterial *material = mapMaterials[i];
-		if (material == NULL)
-		{
-			break;
-		}
-		if (strcmp(path, material->name) == 0)
-		{
-			return material;
-		}
-	}
-
-	if (mapMaterialId >= MAX_MAP_MATERIALS)
-	{
-		Error("Map Material ID heap exhausted. Please increase MAX_MAP_MATERIALS\n");
-	}
-
-	MapMaterial *material = malloc(sizeof(MapMaterial));
-	CheckAlloc(material);
-
 	Asset *mapMaterialAsset = LoadAsset(path, false, false);
 	if (mapMaterialAsset == NULL || mapMaterialAsset->type != ASSET_TYPE_MAP_MATERIAL)
 	{
-		free(material);
-		return &fallbackMaterial;
+		return NULL;
 	}
-	DataReader *reader = CreateDataReaderFromAsset(mapMaterialAsset);
-
+	const uint64_t parseStart = AssetTraceBegin();
 	if (mapMaterialAsset->typeVersion != MAP_MATERIAL_ASSET_VERSION)
 	{
 		LogError("Failed to load map material from asset due to version mismatch (got %d, expected %d)\n",
 				 mapMaterialAsset->typeVersion,
 				 MAP_MATERIAL_ASSET_VERSION);
-		return &fallbackMaterial;
+		FreeAsset(mapMaterialAsset);
+		return NULL;
 	}
+
+	MapMaterial *material = malloc(sizeof(MapMaterial));
+	CheckAlloc(material);
+	DataReader *reader = CreateDataReaderFromAsset(mapMaterialAsset);
 	size_t bytesRemaining = mapMaterialAsset->size;
 	size_t strLength = 0;
 
@@ -77,15 +60,48 @@ MapMaterial *LoadMapMaterial(const char *path)
 	material->shader = ReadUint8(reader);
 	material->soundClass = ReadUint8(reader);
 
-	material->id = mapMaterialId;
+	material->id = -1;
 
 	const size_t nameLength = strlen(path);
 	material->name = malloc(nameLength + 1);
 	CheckAlloc(material->name);
-	strncpy(material->name, path, nameLength);
+	strncpy(material->name, path, nameLength + 1);
 
-	mapMaterials[mapMaterialId] = material;
+	AssetTraceEnd(path, ASSET_TRACE_PARSE, parseStart, mapMaterialAsset->size);
+	DestroyDataReader(reader);
+	FreeAsset(mapMaterialAsset);
+
+	return material;
+}
+
+MapMaterial *LoadMapMaterial(const char *path)
+{
+	for (int i = 0; i < MAX_MAP_MATERIALS; i++)
+	{
+		MapMaterial *material = mapMaterials[i];
+		if (material == NULL)
+		{
+			break;
+		}
+		if (strcmp(path, material->name) == 0)
+		{
+			return material;
+		}
+	}
+
+	if (mapMaterialId >= MAX_MAP_MATERIALS)
+	{
+		Error("Map Material ID heap exhausted. Please increase MAX_MAP_MATERIALS\n");
+	}
+
+	MapMaterial *material = LoadMapMaterialInternal(path);
+	if (material == NULL)
+	{
+		return &fallbackMaterial;
+	}
 
+	material->id = mapMaterialId;
+	mapMaterials[mapMaterialId] = material;
 	mapMaterialId++;
 
 	if (mapMaterialId >= MAX_MAP_MATERIALS - 10)
@@ -94,20 +110,61 @@ MapMaterial *LoadMapMaterial(const char *path)
 				   MAX_MAP_MATERIALS - mapMaterialId);
 	}
 
-	DestroyDataReader(reader);
-	FreeAsset(mapMaterialAsset);
+	return material;
+}
+
+MapMaterial *ReloadMapMaterial(const char *path)
+{
+	MapMaterial *material = NULL;
+	for (uint32_t i = 0; i < mapMaterialId; i++)
+	{
+		if (strcmp(path, mapMaterials[i]->name) == 0)
+		{
+			material = mapMaterials[i];
+			break;
+		}
+	}
+	if (material == NULL)
+	{
+		return NULL;
+	}
 
+	MapMaterial *reloaded = LoadMapMaterialInternal(path);
+	if (reloaded == NULL)
+	{
+		LogError("Failed to reload map material %s, keeping the old version\n", path);
+		return NULL;
+	}
+	if (reloaded->shader != material->shader)
+	{
+		LogWarning("The shader of map material %s changed, which only takes effect once the map is reloaded\n", path);
+	}
+
+	// Updated in place, since map models point at the material
+	char *oldTexture = material->texture;
+	material->texture = reloaded->texture;
+	reloaded->texture = oldTexture;
+	material->soundClass = reloaded->soundClass;
+	FreeMapMaterial(reloaded);
 	return material;
 }
 
+void FreeMapMaterial(MapMaterial *material)
+{
+	if (material == NULL)
+	{
+		return;
+	}
+	free(material->name);
+	free(material->texture);
+	free(material);
+}
+
 void DestroyMapMaterialLoader()
 {
 	for (uint32_t i = 0; i < mapMaterialId; i++)
 	{
-		MapMaterial *material = mapMaterials[i];
-		free(material->name);
-		free(material->texture);
-		free(material);
+		FreeMapMaterial(mapMaterials[i]);
 		mapMaterials[i] = NULL;
 	}
 	mapMaterialId = 0;
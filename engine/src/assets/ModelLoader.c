@@ -2,11 +2,15 @@
 // Created by droc101 on 7/23/25.
 //
 
+#include <assert.h>
 #include <engine/assets/AssetReader.h>
 #include <engine/assets/DataReader.h>
 #include <engine/assets/ModelLoader.h>
+#include <engine/debug/AssetTrace.h>
 #include <engine/debug/DPrint.h>
+#include <engine/physics/CookedShapes.h>
 #include <engine/structs/Asset.h>
+#include <engine/structs/Atom.h>
 #include <engine/structs/Color.h>
 #include <engine/subsystem/Error.h>
 #include <engine/subsystem/Logging.h>
@@ -41,7 +45,8 @@ ModelDefinition *LoadModelInternal(const char *asset)
 		LogError("Failed to load model from asset, asset was NULL!\n");
 		return NULL;
 	}
-	if (assetData->typeVersion != MODEL_ASSET_VERSION)
+	const uint64_t parseStart = AssetTraceBegin();
+	if (assetData->typeVersion != MODEL_ASSET_VERSION && assetData->typeVersion != MODEL_ASSET_VERSION_TRIANGLE_SOUP)
 	{
 		LogError("Failed to load model from asset due to version mismatch (got %d, expected %d)\n",
 				 assetData->typeVersion,
@@ -59,6 +64,7 @@ ModelDefinition *LoadModelInternal(const char *asset)
 	model->name = malloc(nameLength);
 	CheckAlloc(model->name);
 	strncpy(model->name, asset, nameLength);
+	model->nameAtom = Intern(asset);
 
 	DataReader *reader = CreateDataReaderFromAsset(assetData);
 
@@ -78,10 +84,12 @@ ModelDefinition *LoadModelInternal(const char *asset)
 		bytesRemaining -= sizeof(size_t);
 		bytesRemaining -= strLength;
 		EXPECT_BYTES((sizeof(float) * 4) + sizeof(uint32_t), bytesRemaining);
-		mat->color.r = ReadFloat(reader);
-		mat->color.g = ReadFloat(reader);
-		mat->color.b = ReadFloat(reader);
-		mat->color.a = ReadFloat(reader);
+		float color[4];
+		ReadFloatArray(reader, 4, color);
+		mat->color.r = color[0];
+		mat->color.g = color[1];
+		mat->color.b = color[2];
+		mat->color.a = color[3];
 		mat->shader = ReadUint32(reader);
 	}
 
@@ -93,12 +101,8 @@ ModelDefinition *LoadModelInternal(const char *asset)
 	{
 		model->skinMaterialIndices[i] = malloc(skinSize);
 		CheckAlloc(model->skinMaterialIndices[i]);
-		uint32_t *skin = model->skinMaterialIndices[i];
-		EXPECT_BYTES(sizeof(uint32_t) * model->materialSlotCount, bytesRemaining);
-		for (uint32_t j = 0; j < model->materialSlotCount; j++)
-		{
-			skin[j] = ReadUint32(reader);
-		}
+		EXPECT_BYTES(skinSize, bytesRemaining);
+		ReadStructArray(reader, sizeof(uint32_t), model->materialSlotCount, model->skinMaterialIndices[i]);
 	}
 
 	model->lods = malloc(sizeof(ModelLod) * model->lodCount);
@@ -122,14 +126,14 @@ ModelDefinition *LoadModelInternal(const char *asset)
 		EXPECT_BYTES(vertexDataSize, bytesRemaining);
 		lod->vertexData = malloc(vertexDataSize);
 		CheckAlloc(lod->vertexData);
-		ReadBuffer(reader, vertexDataSize, lod->vertexData);
+		ReadStructArray(reader, sizeof(ModelVertex), lod->vertexCount, lod->vertexData);
 
 		lod->totalIndexCount = ReadUint32(reader);
 		const size_t indexCountSize = model->materialSlotCount * sizeof(uint32_t);
 		EXPECT_BYTES(indexCountSize, bytesRemaining);
 		lod->indexCount = malloc(indexCountSize);
 		CheckAlloc(lod->indexCount);
-		ReadBuffer(reader, indexCountSize, lod->indexCount);
+		ReadStructArray(reader, sizeof(uint32_t), model->materialSlotCount, lod->indexCount);
 
 		lod->indexData = malloc(sizeof(uint32_t *) * model->materialSlotCount);
 		CheckAlloc(lod->indexData);
@@ -139,78 +143,99 @@ ModelDefinition *LoadModelInternal(const char *asset)
 			uint32_t *indexData = malloc(lod->indexCount[j] * sizeof(uint32_t));
 			CheckAlloc(indexData);
 			lod->indexData[j] = indexData;
-			ReadBuffer(reader, lod->indexCount[j] * sizeof(uint32_t), indexData);
+			ReadStructArray(reader, sizeof(uint32_t), lod->indexCount[j], indexData);
 		}
 	}
 
 	EXPECT_BYTES(sizeof(float) * 6, bytesRemaining);
-	model->boundingBoxOrigin.x = ReadFloat(reader);
-	model->boundingBoxOrigin.y = ReadFloat(reader);
-	model->boundingBoxOrigin.z = ReadFloat(reader);
-	model->boundingBoxExtents.x = ReadFloat(reader);
-	model->boundingBoxExtents.y = ReadFloat(reader);
-	model->boundingBoxExtents.z = ReadFloat(reader);
+	float boundingBox[6];
+	ReadFloatArray(reader, 6, boundingBox);
+	model->boundingBoxOrigin = (Vector3){boundingBox[0], boundingBox[1], boundingBox[2]};
+	model->boundingBoxExtents = (Vector3){boundingBox[3], boundingBox[4], boundingBox[5]};
 	model->boundingBoxShape = (JPH_Shape *)JPH_BoxShape_Create(&model->boundingBoxExtents, BOUNDING_BOX_CONVEX_RADIUS);
 
+	// The collision section is hashed as it is in the file to find the cooked shape, so the shape is only built from it
+	// if it has not been cooked yet or the model has changed since
+	const size_t collisionOffset = DataReaderGetOffset(reader);
 	if (model->collisionModelType == COLLISION_MODEL_TYPE_DYNAMIC)
 	{
 		EXPECT_BYTES(sizeof(size_t), bytesRemaining);
 		const size_t numHulls = ReadSizeT(reader);
-		ModelConvexHull *hulls = malloc(sizeof(ModelConvexHull) * numHulls);
-		CheckAlloc(hulls);
+		const size_t hullsOffset = DataReaderGetOffset(reader);
 		for (size_t i = 0; i < numHulls; i++)
 		{
-			ModelConvexHull *hull = &hulls[i];
 			EXPECT_BYTES(sizeof(size_t) + (sizeof(float) * 3), bytesRemaining);
-			hull->numPoints = ReadSizeT(reader);
-			hull->offset.x = ReadFloat(reader);
-			hull->offset.y = ReadFloat(reader);
-			hull->offset.z = ReadFloat(reader);
-			hull->points = malloc(sizeof(Vector3) * hull->numPoints);
-			CheckAlloc(hull->points);
-			for (size_t p = 0; p < hull->numPoints; p++)
-			{
-				Vector3 *point = &hull->points[p];
-				EXPECT_BYTES(sizeof(float) * 3, bytesRemaining);
-				point->x = ReadFloat(reader);
-				point->y = ReadFloat(reader);
-				point->z = ReadFloat(reader);
-			}
+			const size_t numPoints = ReadSizeT(reader);
+			EXPECT_BYTES(sizeof(float) * 3 * numPoints, bytesRemaining);
+			Seek(reader, (sizeof(float) * 3) + (sizeof(float) * 3 * numPoints));
 		}
-		model->collisionModelShape = CreateDynamicModelShape(numHulls, hulls);
-		for (size_t i = 0; i < numHulls; i++)
+		const uint8_t *collisionData = assetData->data + collisionOffset;
+		const size_t collisionSize = DataReaderGetOffset(reader) - collisionOffset;
+		if (!LoadCookedShapes("dynamic", collisionData, collisionSize, &model->collisionModelShape, 1))
 		{
-			free(hulls[i].points);
+			DataReader *hullReader = CreateDataReader(assetData->data, assetData->size, hullsOffset);
+			ModelConvexHull *hulls = malloc(sizeof(ModelConvexHull) * numHulls);
+			CheckAlloc(hulls);
+			for (size_t i = 0; i < numHulls; i++)
+			{
+				ModelConvexHull *hull = &hulls[i];
+				hull->numPoints = ReadSizeT(hullReader);
+				float offset[3];
+				ReadFloatArray(hullReader, 3, offset);
+				hull->offset = (Vector3){offset[0], offset[1], offset[2]};
+				hull->points = malloc(sizeof(Vector3) * hull->numPoints);
+				CheckAlloc(hull->points);
+				static_assert(sizeof(Vector3) == sizeof(float) * 3);
+				ReadStructArray(hullReader, sizeof(Vector3), hull->numPoints, hull->points);
+			}
+			DestroyDataReader(hullReader);
+			model->collisionModelShape = CreateDynamicModelShape(numHulls, hulls);
+			StoreCookedShapes("dynamic", collisionData, collisionSize, &model->collisionModelShape, 1);
+			for (size_t i = 0; i < numHulls; i++)
+			{
+				free(hulls[i].points);
+			}
+			free(hulls);
 		}
-		free(hulls);
 	} else if (model->collisionModelType == COLLISION_MODEL_TYPE_STATIC)
 	{
-		ModelStaticCollider staticCollider;
+		// Version 1 models store the collider as a triangle soup, newer ones as indexed triangles
+		const bool indexed = assetData->typeVersion != MODEL_ASSET_VERSION_TRIANGLE_SOUP;
+		size_t numVertices = 0;
+		const uint8_t *vertexData = NULL;
+		if (indexed)
+		{
+			EXPECT_BYTES(sizeof(size_t), bytesRemaining);
+			numVertices = ReadSizeT(reader);
+			EXPECT_BYTES(sizeof(float) * 3 * numVertices, bytesRemaining);
+			vertexData = ReadSpan(reader, sizeof(float) * 3, numVertices);
+		}
 		EXPECT_BYTES(sizeof(size_t), bytesRemaining);
-		staticCollider.numTriangles = ReadSizeT(reader);
-		staticCollider.tris = malloc(sizeof(JPH_Triangle) * staticCollider.numTriangles);
-		CheckAlloc(staticCollider.tris);
-		for (size_t i = 0; i < staticCollider.numTriangles; i++)
+		const size_t numTriangles = ReadSizeT(reader);
+		const size_t triangleSize = indexed ? sizeof(uint32_t) * 3 : sizeof(float) * 9;
+		EXPECT_BYTES(triangleSize * numTriangles, bytesRemaining);
+		const uint8_t *triangleData = ReadSpan(reader, triangleSize, numTriangles);
+		if (indexed && !CheckStaticColliderIndices(triangleData, numTriangles, numVertices))
 		{
-			JPH_Triangle *triangle = &staticCollider.tris[i];
-			triangle->materialIndex = 0;
-			Vector3 *verts[3] = {&triangle->v1, &triangle->v2, &triangle->v3};
-			for (int v = 0; v < 3; v++)
-			{
-				Vector3 *point = verts[v];
-				EXPECT_BYTES(sizeof(float) * 3, bytesRemaining);
-				point->x = ReadFloat(reader);
-				point->y = ReadFloat(reader);
-				point->z = ReadFloat(reader);
-			}
+			LogError("Model %s has a collision triangle with a vertex index out of range\n", asset);
+			return NULL;
+		}
+		const uint8_t *collisionData = assetData->data + collisionOffset;
+		const size_t collisionSize = DataReaderGetOffset(reader) - collisionOffset;
+		if (!LoadCookedShapes("static", collisionData, collisionSize, &model->collisionModelShape, 1))
+		{
+			model->collisionModelShape = CreateStaticModelShapeFromData(vertexData,
+																		numVertices,
+																		triangleData,
+																		numTriangles);
+			StoreCookedShapes("static", collisionData, collisionSize, &model->collisionModelShape, 1);
 		}
-		model->collisionModelShape = CreateStaticModelShape(&staticCollider);
-		free(staticCollider.tris);
 	} else
 	{
 		model->collisionModelShape = NULL;
 	}
 
+	AssetTraceEnd(asset, ASSET_TRACE_PARSE, parseStart, assetData->size);
 	DestroyDataReader(reader);
 	FreeAsset(assetData);
 
@@ -224,14 +249,15 @@ ModelDefinition *LoadModel(const char *asset)
 		Error("Model ID heap exhausted. Please increase MAX_MODELS\n");
 	}
 
-	for (uint32_t i = 0; i < modelId; i++)
+	const Atom assetAtom = FindAtom(asset);
+	for (uint32_t i = 0; assetAtom != ATOM_NONE && i < modelId; i++)
 	{
 		ModelDefinition *model = models[i];
 		if (model == NULL)
 		{
 			continue;
 		}
-		if (strcmp(asset, model->name) == 0)
+		if (model->nameAtom == assetAtom)
 		{
 			return model;
 		}
@@ -259,6 +285,48 @@ ModelDefinition *LoadModel(const char *asset)
 	return model;
 }
 
+ModelDefinition *ReloadModel(const char *asset)
+{
+	ModelDefinition *model = NULL;
+	const Atom assetAtom = FindAtom(asset);
+	for (uint32_t i = 0; assetAtom != ATOM_NONE && i < modelId; i++)
+	{
+		if (models[i] != NULL && models[i]->nameAtom == assetAtom)
+		{
+			model = models[i];
+			break;
+		}
+	}
+	if (model == NULL)
+	{
+		return NULL;
+	}
+
+	ModelDefinition *reloaded = LoadModelInternal(asset);
+	if (reloaded == NULL)
+	{
+		LogError("Failed to reload model %s, keeping the old version\n", asset);
+		return NULL;
+	}
+	// Actors and the renderer index into these, so they can't change without reloading everything
+	if (reloaded->lodCount != model->lodCount || reloaded->skinCount != model->skinCount ||
+		reloaded->materialSlotCount != model->materialSlotCount)
+	{
+		LogWarning("Model %s changed its LOD, skin or material slot count, which needs a full asset reload\n", asset);
+		FreeModel(reloaded);
+		return NULL;
+	}
+
+	// Swapped in place, so the model keeps its ID and every pointer to it stays valid. The LODs get new IDs, so the
+	// renderer uploads them again instead of drawing with the old geometry.
+	const ModelDefinition old = *model;
+	*model = *reloaded;
+	model->id = old.id;
+	*reloaded = old;
+	FreeModel(reloaded);
+	return model;
+}
+
 inline ModelDefinition *GetModelFromId(const size_t id)
 {
 	if (id >= modelId)
@@ -347,12 +415,85 @@ JPH_Shape *CreateDynamicModelShape(const size_t numHulls, const ModelConvexHull
 
 inline JPH_Shape *CreateStaticModelShape(const ModelStaticCollider *staticCollider)
 {
-	JPH_MeshShapeSettings *settings = JPH_MeshShapeSettings_Create(staticCollider->tris, staticCollider->numTriangles);
+	JPH_MeshShapeSettings *settings = NULL;
+	if (staticCollider->indexedTris != NULL)
+	{
+		// Shared vertices are already welded, so Jolt does not have to find them again
+		settings = JPH_MeshShapeSettings_Create2(staticCollider->vertices,
+												 staticCollider->numVertices,
+												 staticCollider->indexedTris,
+												 staticCollider->numTriangles);
+	} else
+	{
+		settings = JPH_MeshShapeSettings_Create(staticCollider->tris, staticCollider->numTriangles);
+	}
 	JPH_Shape *meshShape = (JPH_Shape *)JPH_MeshShapeSettings_CreateShape(settings);
 	JPH_ShapeSettings_Destroy((JPH_ShapeSettings *)settings);
 	return meshShape;
 }
 
+bool CheckStaticColliderIndices(const uint8_t *triangleData, const size_t numTriangles, const size_t numVertices)
+{
+	for (size_t i = 0; i < numTriangles * 3; i++)
+	{
+		uint32_t index = 0;
+		memcpy(&index, triangleData + (sizeof(uint32_t) * i), sizeof(uint32_t));
+		if (index >= numVertices)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+JPH_Shape *CreateStaticModelShapeFromData(const uint8_t *vertexData,
+										  const size_t numVertices,
+										  const uint8_t *triangleData,
+										  const size_t numTriangles)
+{
+	ModelStaticCollider staticCollider = {
+		.numTriangles = numTriangles,
+	};
+	if (vertexData != NULL)
+	{
+		staticCollider.numVertices = numVertices;
+		staticCollider.vertices = malloc(sizeof(Vector3) * numVertices);
+		CheckAlloc(staticCollider.vertices);
+		static_assert(sizeof(Vector3) == sizeof(float) * 3);
+		memcpy(staticCollider.vertices, vertexData, sizeof(Vector3) * numVertices);
+		staticCollider.indexedTris = malloc(sizeof(JPH_IndexedTriangle) * numTriangles);
+		CheckAlloc(staticCollider.indexedTris);
+		for (size_t i = 0; i < numTriangles; i++)
+		{
+			uint32_t indices[3];
+			memcpy(indices, triangleData + (sizeof(uint32_t) * 3 * i), sizeof(indices));
+			staticCollider.indexedTris[i] = (JPH_IndexedTriangle){
+				.i1 = indices[0],
+				.i2 = indices[1],
+				.i3 = indices[2],
+			};
+		}
+	} else
+	{
+		staticCollider.tris = malloc(sizeof(JPH_Triangle) * numTriangles);
+		CheckAlloc(staticCollider.tris);
+		for (size_t i = 0; i < numTriangles; i++)
+		{
+			JPH_Triangle *triangle = &staticCollider.tris[i];
+			triangle->materialIndex = 0;
+			const uint8_t *triangleVertices = triangleData + (sizeof(float) * 9 * i);
+			memcpy(&triangle->v1, triangleVertices, sizeof(float) * 3);
+			memcpy(&triangle->v2, triangleVertices + (sizeof(float) * 3), sizeof(float) * 3);
+			memcpy(&triangle->v3, triangleVertices + (sizeof(float) * 6), sizeof(float) * 3);
+		}
+	}
+	JPH_Shape *shape = CreateStaticModelShape(&staticCollider);
+	free(staticCollider.tris);
+	free(staticCollider.vertices);
+	free(staticCollider.indexedTris);
+	return shape;
+}
+
 void DPrintModelLoader()
 {
 	DPrintF("Model Cache: %zu/%zu models", COLOR_WHITE, modelId, MAX_MODELS);
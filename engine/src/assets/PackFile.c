@@ -0,0 +1,535 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <dirent.h>
+#include <engine/assets/GameConfigLoader.h>
+#include <engine/assets/PackFile.h>
+#include <engine/debug/DPrint.h>
+#include <engine/helpers/PlatformHelpers.h>
+#include <engine/structs/Color.h>
+#include <engine/structs/List.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/// Packed asset data is aligned to this many bytes inside the pack
+#define PACK_FILE_DATA_ALIGNMENT 16
+
+typedef struct PackFileHeader PackFileHeader;
+typedef struct PackFileEntry PackFileEntry;
+typedef struct MountedPack MountedPack;
+typedef struct PackSourceFile PackSourceFile;
+
+struct PackFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	/// The number of entries in the table of contents
+	uint64_t entryCount;
+	/// The offset of the table of contents, which is sorted by hash
+	uint64_t tocOffset;
+	/// The offset of the NUL-separated name table
+	uint64_t namesOffset;
+	/// The size of the name table in bytes
+	uint64_t namesSize;
+} __attribute__((packed));
+
+struct PackFileEntry
+{
+	/// @c HashPackPath of the name
+	uint64_t hash;
+	/// The offset of the name in the name table
+	uint64_t nameOffset;
+	/// The offset of the asset file data from the start of the pack
+	uint64_t dataOffset;
+	/// The size of the asset file data
+	uint64_t dataSize;
+} __attribute__((packed));
+
+struct MountedPack
+{
+	/// The asset path this pack was found in
+	char *assetPathRoot;
+	/// The path of the pack file
+	char *fileName;
+	/// The mapped pack file
+	const uint8_t *data;
+	/// The size of the mapped pack file
+	size_t size;
+	const PackFileEntry *entries;
+	size_t entryCount;
+	const char *names;
+};
+
+struct PackSourceFile
+{
+	char *name;
+	char *fullPath;
+	uint64_t hash;
+	uint64_t nameOffset;
+	uint64_t dataOffset;
+	uint64_t dataSize;
+};
+
+/// Mounted packs, in search order
+static List mountedPacks = {0};
+
+/**
+ * 64-bit FNV-1a hash of an asset path
+ */
+static uint64_t HashPackPath(const char *path)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	while (*path != '\0')
+	{
+		hash ^= (uint8_t)*path;
+		hash *= 0x100000001b3ull;
+		path++;
+	}
+	return hash;
+}
+
+static bool RangeInFile(const uint64_t offset, const uint64_t size, const size_t fileSize)
+{
+	return offset <= fileSize && size <= fileSize - offset;
+}
+
+/**
+ * Validate a mapped pack file and fill out the table pointers of a mounted pack
+ * @return Whether the pack file is valid
+ */
+static bool ValidatePack(MountedPack *pack)
+{
+	if (pack->size < sizeof(PackFileHeader))
+	{
+		LogError("Pack file \"%s\" is too small\n", pack->fileName);
+		return false;
+	}
+	const PackFileHeader *header = (const PackFileHeader *)pack->data;
+	if (header->magic != PACK_FILE_MAGIC)
+	{
+		LogError("Pack file magic is incorrect (expected %x, got %x)\n", PACK_FILE_MAGIC, header->magic);
+		return false;
+	}
+	if (header->version != PACK_FILE_VERSION)
+	{
+		LogError("Pack file version is incorrect (expected %d, got %d)\n", PACK_FILE_VERSION, header->version);
+		return false;
+	}
+	if (header->entryCount > pack->size / sizeof(PackFileEntry) ||
+		!RangeInFile(header->tocOffset, header->entryCount * sizeof(PackFileEntry), pack->size) ||
+		!RangeInFile(header->namesOffset, header->namesSize, pack->size))
+	{
+		LogError("Pack file \"%s\" has an out of bounds table\n", pack->fileName);
+		return false;
+	}
+	if (header->entryCount > 0 && (header->namesSize == 0 || pack->data[header->namesOffset + header->namesSize - 1]))
+	{
+		LogError("Pack file \"%s\" has an unterminated name table\n", pack->fileName);
+		return false;
+	}
+
+	pack->entries = (const PackFileEntry *)(pack->data + header->tocOffset);
+	pack->entryCount = header->entryCount;
+	pack->names = (const char *)(pack->data + header->namesOffset);
+
+	for (size_t i = 0; i < pack->entryCount; i++)
+	{
+		const PackFileEntry *entry = &pack->entries[i];
+		if (entry->nameOffset >= header->namesSize || !RangeInFile(entry->dataOffset, entry->dataSize, pack->size))
+		{
+			LogError("Pack file \"%s\" has an out of bounds entry\n", pack->fileName);
+			return false;
+		}
+		if (i > 0 && pack->entries[i - 1].hash > entry->hash)
+		{
+			LogError("Pack file \"%s\" has an unsorted table of contents\n", pack->fileName);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void MountPack(const AssetPath *assetPath, const char *fileName)
+{
+	const size_t pathLength = strlen(assetPath->path) + 1 + strlen(fileName) + 1;
+	char *path = malloc(pathLength);
+	CheckAlloc(path);
+	snprintf(path, pathLength, "%s/%s", assetPath->path, fileName);
+
+	MountedPack *pack = calloc(1, sizeof(MountedPack));
+	CheckAlloc(pack);
+	pack->fileName = path;
+	pack->data = MapFileReadOnly(path, &pack->size);
+	if (pack->data == NULL)
+	{
+		LogError("Failed to map pack file \"%s\"\n", path);
+		free(path);
+		free(pack);
+		return;
+	}
+	if (!ValidatePack(pack))
+	{
+		UnmapFile(pack->data, pack->size);
+		free(path);
+		free(pack);
+		return;
+	}
+
+	pack->assetPathRoot = strdup(assetPath->path);
+	CheckAlloc(pack->assetPathRoot);
+	ListAdd(mountedPacks, pack);
+	LogInfo("Mounted pack file \"%s\" with %zu asset(s)\n", path, pack->entryCount);
+}
+
+static int CompareStringsDescending(const void *a, const void *b)
+{
+	return strcmp(*(char *const *)b, *(char *const *)a);
+}
+
+void MountAssetPacks()
+{
+	ListInit(mountedPacks, LIST_POINTER);
+	for (size_t i = 0; i < gameConfig.assetPaths.length; i++)
+	{
+		const AssetPath *assetPath = ListGetPointer(gameConfig.assetPaths, i);
+		DIR *dir = opendir(assetPath->path);
+		if (dir == NULL)
+		{
+			continue;
+		}
+
+		List packNames;
+		ListInit(packNames, LIST_POINTER);
+		const struct dirent *ent = readdir(dir);
+		while (ent != NULL)
+		{
+			const size_t nameLength = strlen(ent->d_name);
+			const size_t extensionLength = strlen(PACK_FILE_EXTENSION);
+			if (nameLength > extensionLength &&
+				strcmp(ent->d_name + nameLength - extensionLength, PACK_FILE_EXTENSION) == 0)
+			{
+				char *name = strdup(ent->d_name);
+				CheckAlloc(name);
+				ListAdd(packNames, name);
+			}
+			ent = readdir(dir);
+		}
+		closedir(dir);
+
+		// readdir order is unspecified, so sort to get a stable override order
+		qsort(packNames.data->pointerData, packNames.length, sizeof(void *), CompareStringsDescending);
+		for (size_t j = 0; j < packNames.length; j++)
+		{
+			MountPack(assetPath, ListGetPointer(packNames, j));
+		}
+		ListAndContentsFree(packNames);
+	}
+}
+
+void UnmountAssetPacks()
+{
+	for (size_t i = 0; i < mountedPacks.length; i++)
+	{
+		MountedPack *pack = ListGetPointer(mountedPacks, i);
+		UnmapFile(pack->data, pack->size);
+		free(pack->assetPathRoot);
+		free(pack->fileName);
+	}
+	ListAndContentsFree(mountedPacks);
+}
+
+/**
+ * Find an entry in a pack by name
+ * @return The entry, or NULL if it is not in the pack
+ */
+static const PackFileEntry *FindPackEntry(const MountedPack *pack, const char *relPath, const uint64_t hash)
+{
+	size_t low = 0;
+	size_t high = pack->entryCount;
+	while (low < high)
+	{
+		const size_t mid = low + ((high - low) / 2);
+		if (pack->entries[mid].hash < hash)
+		{
+			low = mid + 1;
+		} else
+		{
+			high = mid;
+		}
+	}
+
+	// low is now the first entry with a matching hash (if any), so only collisions need to be walked
+	for (size_t i = low; i < pack->entryCount && pack->entries[i].hash == hash; i++)
+	{
+		if (strcmp(pack->names + pack->entries[i].nameOffset, relPath) == 0)
+		{
+			return &pack->entries[i];
+		}
+	}
+	return NULL;
+}
+
+bool FindPackedAsset(const AssetPath *assetPath,
+					 const char *relPath,
+					 const uint8_t **data,
+					 size_t *size,
+					 const char **packPath)
+{
+	if (mountedPacks.length == 0)
+	{
+		return false;
+	}
+	const uint64_t hash = HashPackPath(relPath);
+	for (size_t i = 0; i < mountedPacks.length; i++)
+	{
+		const MountedPack *pack = ListGetPointer(mountedPacks, i);
+		if (strcmp(pack->assetPathRoot, assetPath->path) != 0)
+		{
+			continue;
+		}
+		const PackFileEntry *entry = FindPackEntry(pack, relPath, hash);
+		if (entry != NULL)
+		{
+			*data = pack->data + entry->dataOffset;
+			*size = entry->dataSize;
+			if (packPath)
+			{
+				*packPath = pack->fileName;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+void ListPackedAssets(const AssetPath *assetPath, List *output)
+{
+	for (size_t i = 0; i < mountedPacks.length; i++)
+	{
+		const MountedPack *pack = ListGetPointer(mountedPacks, i);
+		if (strcmp(pack->assetPathRoot, assetPath->path) != 0)
+		{
+			continue;
+		}
+		for (size_t j = 0; j < pack->entryCount; j++)
+		{
+			ListAdd(*output, (void *)(pack->names + pack->entries[j].nameOffset));
+		}
+	}
+}
+
+/**
+ * Recursively collect every file in a directory
+ * @param root The directory being packed
+ * @param relDir The directory relative to root, or an empty string for root itself
+ * @param files The list to add @c PackSourceFile entries to
+ * @return Whether the directory was successfully read
+ */
+static bool CollectPackSourceFiles(const char *root, const char *relDir, List *files)
+{
+	const size_t dirPathLength = strlen(root) + 1 + strlen(relDir) + 1;
+	char *dirPath = malloc(dirPathLength);
+	CheckAlloc(dirPath);
+	snprintf(dirPath, dirPathLength, relDir[0] == '\0' ? "%s%s" : "%s/%s", root, relDir);
+
+	DIR *dir = opendir(dirPath);
+	if (dir == NULL)
+	{
+		LogError("Failed to open directory: %s\nError: %s\n", dirPath, strerror(errno));
+		free(dirPath);
+		return false;
+	}
+
+	bool success = true;
+	const struct dirent *ent = readdir(dir);
+	while (ent != NULL && success)
+	{
+		if (ent->d_name[0] != '.' && strstr(ent->d_name, PACK_FILE_EXTENSION) == NULL)
+		{
+			const size_t nameLength = strlen(relDir) + 1 + strlen(ent->d_name) + 1;
+			char *name = malloc(nameLength);
+			CheckAlloc(name);
+			snprintf(name, nameLength, relDir[0] == '\0' ? "%s%s" : "%s/%s", relDir, ent->d_name);
+
+			const size_t fullPathLength = strlen(root) + 1 + nameLength;
+			char *fullPath = malloc(fullPathLength);
+			CheckAlloc(fullPath);
+			snprintf(fullPath, fullPathLength, "%s/%s", root, name);
+
+			struct stat st;
+			if (stat(fullPath, &st) != 0)
+			{
+				LogError("Failed to stat \"%s\": %s\n", fullPath, strerror(errno));
+				success = false;
+				free(fullPath);
+				free(name);
+			} else if (S_ISDIR(st.st_mode))
+			{
+				success = CollectPackSourceFiles(root, name, files);
+				free(fullPath);
+				free(name);
+			} else
+			{
+				PackSourceFile *file = calloc(1, sizeof(PackSourceFile));
+				CheckAlloc(file);
+				file->name = name;
+				file->fullPath = fullPath;
+				file->hash = HashPackPath(name);
+				file->dataSize = (uint64_t)st.st_size;
+				ListAdd(*files, file);
+			}
+		}
+		ent = readdir(dir);
+	}
+	closedir(dir);
+	free(dirPath);
+	return success;
+}
+
+static int ComparePackSourceFiles(const void *a, const void *b)
+{
+	const PackSourceFile *fileA = *(PackSourceFile *const *)a;
+	const PackSourceFile *fileB = *(PackSourceFile *const *)b;
+	if (fileA->hash != fileB->hash)
+	{
+		return fileA->hash < fileB->hash ? -1 : 1;
+	}
+	return strcmp(fileA->name, fileB->name);
+}
+
+static bool WritePackData(FILE *output, const List *files)
+{
+	static const uint8_t padding[PACK_FILE_DATA_ALIGNMENT] = {0};
+	for (size_t i = 0; i < files->length; i++)
+	{
+		const PackSourceFile *file = ListGetPointer(*files, i);
+		const long position = ftell(output);
+		if (position < 0 || fwrite(padding, 1, file->dataOffset - (uint64_t)position, output) !=
+									file->dataOffset - (uint64_t)position)
+		{
+			return false;
+		}
+
+		FILE *input = fopen(file->fullPath, "rb");
+		if (input == NULL)
+		{
+			LogError("Failed to open \"%s\": %s\n", file->fullPath, strerror(errno));
+			return false;
+		}
+		uint8_t *buffer = malloc(file->dataSize);
+		CheckAlloc(buffer);
+		const bool copied = fread(buffer, 1, file->dataSize, input) == file->dataSize &&
+							fwrite(buffer, 1, file->dataSize, output) == file->dataSize;
+		free(buffer);
+		fclose(input);
+		if (!copied)
+		{
+			LogError("Failed to copy \"%s\" into pack file\n", file->fullPath);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool WritePackFile(const char *directory, const char *outputPath)
+{
+	List files;
+	ListInit(files, LIST_POINTER);
+	if (!CollectPackSourceFiles(directory, "", &files))
+	{
+		for (size_t i = 0; i < files.length; i++)
+		{
+			PackSourceFile *file = ListGetPointer(files, i);
+			free(file->name);
+			free(file->fullPath);
+		}
+		ListAndContentsFree(files);
+		return false;
+	}
+	qsort(files.data->pointerData, files.length, sizeof(void *), ComparePackSourceFiles);
+
+	// Lay out the pack: header, table of contents, name table, then the aligned asset data
+	PackFileHeader header = {
+		.magic = PACK_FILE_MAGIC,
+		.version = PACK_FILE_VERSION,
+		.entryCount = files.length,
+		.tocOffset = sizeof(PackFileHeader),
+	};
+	header.namesOffset = header.tocOffset + (files.length * sizeof(PackFileEntry));
+	for (size_t i = 0; i < files.length; i++)
+	{
+		PackSourceFile *file = ListGetPointer(files, i);
+		file->nameOffset = header.namesSize;
+		header.namesSize += strlen(file->name) + 1;
+	}
+	uint64_t dataOffset = header.namesOffset + header.namesSize;
+	for (size_t i = 0; i < files.length; i++)
+	{
+		PackSourceFile *file = ListGetPointer(files, i);
+		dataOffset = (dataOffset + PACK_FILE_DATA_ALIGNMENT - 1) & ~(uint64_t)(PACK_FILE_DATA_ALIGNMENT - 1);
+		file->dataOffset = dataOffset;
+		dataOffset += file->dataSize;
+	}
+
+	bool success = false;
+	FILE *output = fopen(outputPath, "wb");
+	if (output == NULL)
+	{
+		LogError("Failed to open pack file \"%s\" for writing: %s\n", outputPath, strerror(errno));
+	} else
+	{
+		success = fwrite(&header, sizeof(PackFileHeader), 1, output) == 1;
+		for (size_t i = 0; i < files.length && success; i++)
+		{
+			const PackSourceFile *file = ListGetPointer(files, i);
+			const PackFileEntry entry = {
+				.hash = file->hash,
+				.nameOffset = file->nameOffset,
+				.dataOffset = file->dataOffset,
+				.dataSize = file->dataSize,
+			};
+			success = fwrite(&entry, sizeof(PackFileEntry), 1, output) == 1;
+		}
+		for (size_t i = 0; i < files.length && success; i++)
+		{
+			const PackSourceFile *file = ListGetPointer(files, i);
+			success = fwrite(file->name, 1, strlen(file->name) + 1, output) == strlen(file->name) + 1;
+		}
+		success = success && WritePackData(output, &files);
+		fclose(output);
+		if (!success)
+		{
+			LogError("Failed to write pack file \"%s\"\n", outputPath);
+		}
+	}
+
+	for (size_t i = 0; i < files.length; i++)
+	{
+		PackSourceFile *file = ListGetPointer(files, i);
+		free(file->name);
+		free(file->fullPath);
+	}
+	ListAndContentsFree(files);
+	return success;
+}
+
+void DPrintPackFiles()
+{
+	size_t entryCount = 0;
+	for (size_t i = 0; i < mountedPacks.length; i++)
+	{
+		const MountedPack *pack = ListGetPointer(mountedPacks, i);
+		entryCount += pack->entryCount;
+	}
+	DPrintF("Pack Files: %zu pack(s), %zu asset(s)", COLOR_WHITE, mountedPacks.length, entryCount);
+}
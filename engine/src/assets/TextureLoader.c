@@ -6,8 +6,10 @@
 #include <engine/assets/AssetReader.h>
 #include <engine/assets/DataReader.h>
 #include <engine/assets/TextureLoader.h>
+#include <engine/debug/AssetTrace.h>
 #include <engine/debug/DPrint.h>
 #include <engine/structs/Asset.h>
+#include <engine/structs/Atom.h>
 #include <engine/structs/Color.h>
 #include <engine/subsystem/Error.h>
 #include <engine/subsystem/Logging.h>
@@ -24,10 +26,18 @@ static Image *images[MAX_TEXTURES];
 #define MISSING_TEX_COLOR_A 0xFF000000
 #define MISSING_TEX_COLOR_B 0xFFFF00FF
 
+/**
+ * Compare two atoms for sorting, without the overflow a subtraction could cause
+ */
+static inline int CompareAtoms(const Atom a, const Atom b)
+{
+	return (a > b) - (a < b);
+}
+
 static inline int ImageNameMatch(const void *imageName, const void *image)
 {
 	assert(image && *(const Image **)image);
-	return strcmp(imageName, (*(const Image **)image)->name);
+	return CompareAtoms(*(const Atom *)imageName, (*(const Image **)image)->nameAtom);
 }
 
 static inline int ImagesNameCompare(const void *img1, const void *img2)
@@ -43,12 +53,17 @@ static inline int ImagesNameCompare(const void *img1, const void *img2)
 	{
 		return -1;
 	}
-	return strcmp(imageOne->name, imageTwo->name);
+	return CompareAtoms(imageOne->nameAtom, imageTwo->nameAtom);
 }
 
 static Image *GetCachedImage(const char *name)
 {
-	Image **foundImage = bsearch(name, images, textureId, sizeof(Image *), ImageNameMatch);
+	const Atom nameAtom = FindAtom(name);
+	if (nameAtom == ATOM_NONE)
+	{
+		return NULL;
+	}
+	Image **foundImage = bsearch(&nameAtom, images, textureId, sizeof(Image *), ImageNameMatch);
 	if (foundImage != NULL && *foundImage != NULL)
 	{
 		return *foundImage;
@@ -68,6 +83,7 @@ void GenFallbackImage(Image *src)
 	uint32_t *pixelData = malloc(pixelDataSize);
 	CheckAlloc(pixelData);
 	src->pixelData = (uint8_t *)pixelData;
+	src->pixelDataBuffer = pixelData;
 
 	for (int x = 0; x < MISSING_TEX_SIZE; x++)
 	{
@@ -84,7 +100,7 @@ void GenFallbackImage(Image *src)
 	}
 }
 
-bool LoadImageFromAsset(const Asset *asset, Image *image)
+bool LoadImageFromAsset(Asset *asset, Image *image)
 {
 	if (asset == NULL || asset->type != ASSET_TYPE_TEXTURE)
 	{
@@ -124,9 +140,10 @@ bool LoadImageFromAsset(const Asset *asset, Image *image)
 		return false;
 	}
 
-	image->pixelData = malloc(pixelDataSize);
-	CheckAlloc(image->pixelData);
-	ReadBuffer(reader, pixelDataSize, image->pixelData);
+	// Adopt the decompressed buffer instead of copying the pixels out of it
+	image->pixelData = (uint8_t *)ReadSpan(reader, pixelDataSize, 1);
+	image->pixelDataBuffer = asset->data;
+	asset->data = NULL;
 
 	DestroyDataReader(reader);
 
@@ -150,10 +167,12 @@ Image *LoadImage(const char *asset)
 	CheckAlloc(img);
 
 	Asset *textureAsset = LoadAsset(asset, false, false);
+	const uint64_t parseStart = AssetTraceBegin();
 	if (!LoadImageFromAsset(textureAsset, img))
 	{
 		GenFallbackImage(img);
 	}
+	AssetTraceEnd(asset, ASSET_TRACE_PARSE, parseStart, textureAsset ? textureAsset->size : 0);
 
 	const size_t nameLength = strlen(asset) + 1;
 	img->name = malloc(nameLength);
@@ -173,12 +192,77 @@ Image *LoadImage(const char *asset)
 	return img;
 }
 
+Image *ReloadImage(const char *asset)
+{
+	Image *image = GetCachedImage(asset);
+	if (image == NULL)
+	{
+		return NULL;
+	}
+
+	Asset *textureAsset = LoadAsset(asset, false, false);
+	Image *reloaded = malloc(sizeof(Image));
+	CheckAlloc(reloaded);
+	const bool loaded = LoadImageFromAsset(textureAsset, reloaded);
+	if (textureAsset != NULL)
+	{
+		FreeAsset(textureAsset);
+	}
+	if (!loaded)
+	{
+		LogError("Failed to reload texture %s, keeping the old version\n", asset);
+		free(reloaded);
+		return NULL;
+	}
+
+	// A reload the renderer has not taken yet is out of date now
+	if (image->pendingReload != NULL)
+	{
+		free(image->pendingReload->pixelDataBuffer);
+		free(image->pendingReload);
+	}
+	image->pendingReload = reloaded;
+	return image;
+}
+
+bool ApplyImageReload(Image *image)
+{
+	Image *reloaded = image->pendingReload;
+	if (reloaded == NULL)
+	{
+		return false;
+	}
+	// Updated in place, so the image keeps its ID and every pointer to it stays valid
+	free(image->pixelDataBuffer);
+	image->width = reloaded->width;
+	image->height = reloaded->height;
+	image->pixelFormat = reloaded->pixelFormat;
+	image->filter = reloaded->filter;
+	image->repeat = reloaded->repeat;
+	image->mipmaps = reloaded->mipmaps;
+	image->pixelData = reloaded->pixelData;
+	image->pixelDataBuffer = reloaded->pixelDataBuffer;
+	free(reloaded);
+	image->pendingReload = NULL;
+	return true;
+}
+
+void ApplyAllImageReloads()
+{
+	for (uint32_t i = 0; i < textureId; i++)
+	{
+		ApplyImageReload(images[i]);
+	}
+}
+
 bool RegisterImage(Image *image)
 {
 	if (GetCachedImage(image->name))
 	{
 		return false;
 	}
+	image->nameAtom = Intern(image->name);
+	image->pendingReload = NULL;
 
 	if (textureId >= MAX_TEXTURES)
 	{
@@ -238,7 +322,12 @@ void DestroyTextureLoader()
 		if (images[i] != NULL)
 		{
 			free(images[i]->name);
-			free(images[i]->pixelData);
+			free(images[i]->pixelDataBuffer);
+			if (images[i]->pendingReload != NULL)
+			{
+				free(images[i]->pendingReload->pixelDataBuffer);
+				free(images[i]->pendingReload);
+			}
 			free(images[i]);
 			images[i] = NULL;
 		}
@@ -0,0 +1,129 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/assets/AssetReader.h>
+#include <engine/assets/DataWriter.h>
+#include <engine/debug/AssetBenchmark.h>
+#include <engine/structs/Asset.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/threads/WorkerPool.h>
+#include <engine/subsystem/Timing.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <zconf.h>
+#include <zlib.h>
+
+/**
+ * Write an asset in the single gzip stream format (version 2)
+ */
+static bool WriteSingleStreamAsset(DataWriter *writer, const Asset *asset)
+{
+	uLongf compressedSize = compressBound(asset->size) + 32; // gzip header and trailer
+	uint8_t *compressed = malloc(compressedSize);
+	CheckAlloc(compressed);
+
+	z_stream stream = {0};
+	if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, MAX_WBITS | 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		free(compressed);
+		return false;
+	}
+	stream.next_in = asset->data;
+	stream.avail_in = asset->size;
+	stream.next_out = compressed;
+	stream.avail_out = compressedSize;
+	const bool success = deflate(&stream, Z_FINISH) == Z_STREAM_END;
+	compressedSize = stream.total_out;
+	deflateEnd(&stream);
+	if (!success)
+	{
+		free(compressed);
+		return false;
+	}
+
+	WriteUint32(writer, ASSET_FORMAT_MAGIC);
+	WriteUint8(writer, ASSET_FORMAT_VERSION_SINGLE_STREAM);
+	WriteUint8(writer, asset->type);
+	WriteUint8(writer, asset->typeVersion);
+	WriteSizeT(writer, asset->size);
+	WriteSizeT(writer, compressedSize);
+	WriteBuffer(writer, compressed, 1, compressedSize);
+	free(compressed);
+	return true;
+}
+
+/**
+ * Decompress an asset file repeatedly
+ * @return The average time per decompression in nanoseconds, or 0 on failure
+ */
+static uint64_t TimeDecompression(const DataWriter *writer, const size_t iterations)
+{
+	const uint64_t start = GetTimeNs();
+	for (size_t i = 0; i < iterations; i++)
+	{
+		Asset asset;
+		if (!DecompressAssetData(DataWriterGetBuffer(writer), DataWriterGetBufferSize(writer), &asset))
+		{
+			return 0;
+		}
+		free(asset.data);
+	}
+	return (GetTimeNs() - start) / iterations;
+}
+
+static void LogBenchmarkResult(const char *name, const DataWriter *writer, const size_t size, const uint64_t timeNs)
+{
+	LogInfo("%-12s %10zu bytes compressed, %10.3f ms, %8.1f MB/s\n",
+			name,
+			DataWriterGetBufferSize(writer),
+			(double)timeNs / 1000000.0,
+			timeNs ? ((double)size / (1024.0 * 1024.0)) / ((double)timeNs / 1000000000.0) : 0.0);
+}
+
+bool BenchmarkAssetCompression(const char *relPath, const size_t iterations)
+{
+	size_t fileSize = 0;
+	uint8_t *fileData = LoadAssetFileData(relPath, false, &fileSize);
+	if (fileData == NULL)
+	{
+		return false;
+	}
+	Asset asset;
+	const bool decompressed = DecompressAssetData(fileData, fileSize, &asset);
+	free(fileData);
+	if (!decompressed)
+	{
+		return false;
+	}
+
+	DataWriter *singleStream = CreateDataWriter();
+	DataWriter *chunked = CreateDataWriter();
+	bool success = WriteSingleStreamAsset(singleStream, &asset);
+	WriteCompressedAsset(chunked, asset.type, asset.typeVersion, asset.data, asset.size, ASSET_CHUNK_SIZE);
+
+	if (success)
+	{
+		const size_t runs = iterations ? iterations : 1;
+		const uint64_t singleStreamTime = TimeDecompression(singleStream, runs);
+		const uint64_t chunkedTime = TimeDecompression(chunked, runs);
+		success = singleStreamTime != 0 && chunkedTime != 0;
+
+		LogInfo("Asset compression benchmark for \"%s\" (%zu bytes, %zu chunk(s), %zu thread(s), %zu iteration(s)):\n",
+				relPath,
+				asset.size,
+				(asset.size + ASSET_CHUNK_SIZE - 1) / ASSET_CHUNK_SIZE,
+				GetWorkerPoolThreadCount(),
+				runs);
+		LogBenchmarkResult("Single stream", singleStream, asset.size, singleStreamTime);
+		LogBenchmarkResult("Chunked", chunked, asset.size, chunkedTime);
+	}
+
+	FreeDataWriter(singleStream);
+	FreeDataWriter(chunked);
+	free(asset.data);
+	return success;
+}
@@ -0,0 +1,351 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/debug/AssetTrace.h>
+#include <engine/debug/DPrint.h>
+#include <engine/helpers/Arguments.h>
+#include <engine/structs/Color.h>
+#include <engine/structs/Dict.h>
+#include <engine/structs/List.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/Timing.h>
+#include <m-core.h>
+#include <SDL3/SDL_mutex.h>
+#include <SDL3/SDL_thread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct AssetTraceEvent AssetTraceEvent;
+typedef struct AssetTraceTotal AssetTraceTotal;
+typedef struct AssetTraceTopEntry AssetTraceTopEntry;
+
+struct AssetTraceEvent
+{
+	char *asset;
+	AssetTracePhase phase;
+	/// The thread the phase ran on
+	SDL_ThreadID thread;
+	uint64_t startTime;
+	uint64_t duration;
+	size_t bytes;
+};
+
+struct AssetTraceTotal
+{
+	/// The time spent in each phase
+	uint64_t duration[ASSET_TRACE_PHASE_COUNT];
+	/// The time spent in all phases
+	uint64_t totalDuration;
+	/// The number of bytes read from disk
+	size_t bytes;
+};
+
+struct AssetTraceTopEntry
+{
+	/// Points into the totals dict the entry was taken from
+	const char *asset;
+	const AssetTraceTotal *total;
+};
+
+DEFINE_DICT(AssetTraceTotals, const char *, STR_OPLIST, AssetTraceTotal, M_POD_OPLIST);
+
+static const char *const phaseNames[ASSET_TRACE_PHASE_COUNT] = {
+	[ASSET_TRACE_OPEN] = "open",
+	[ASSET_TRACE_READ] = "read",
+	[ASSET_TRACE_INFLATE] = "inflate",
+	[ASSET_TRACE_PARSE] = "parse",
+	[ASSET_TRACE_UPLOAD] = "upload",
+};
+
+static bool traceEnabled = false;
+static const char *reportPath = NULL;
+static SDL_ThreadID mainThread = 0;
+
+/// Protects everything below
+static SDL_Mutex *traceMutex = NULL;
+/// Every recorded event, in the order they finished
+static List events;
+/// The time spent on each asset since tracing started
+static AssetTraceTotals totals;
+
+void InitAssetTrace()
+{
+	reportPath = GetCliArgStr("--asset-trace", NULL);
+	if (reportPath == NULL || reportPath[0] == '\0')
+	{
+		return;
+	}
+	traceMutex = SDL_CreateMutex();
+	ListInit(events, LIST_POINTER);
+	AssetTraceTotals_init(totals);
+	mainThread = SDL_GetCurrentThreadID();
+	traceEnabled = true;
+	LogInfo("Tracing asset loads to %s\n", reportPath);
+}
+
+uint64_t AssetTraceBegin()
+{
+	return traceEnabled ? GetTimeNs() : 0;
+}
+
+void AssetTraceEnd(const char *asset, const AssetTracePhase phase, const uint64_t startTime, const size_t bytes)
+{
+	if (!traceEnabled || startTime == 0)
+	{
+		return;
+	}
+	AssetTraceEvent *event = malloc(sizeof(AssetTraceEvent));
+	CheckAlloc(event);
+	event->duration = GetTimeNs() - startTime;
+	event->asset = strdup(asset);
+	CheckAlloc(event->asset);
+	event->phase = phase;
+	event->thread = SDL_GetCurrentThreadID();
+	event->startTime = startTime;
+	event->bytes = bytes;
+
+	SDL_LockMutex(traceMutex);
+	ListAdd(events, event);
+	AssetTraceTotal *total = AssetTraceTotals_safe_get(totals, asset);
+	total->duration[phase] += event->duration;
+	total->totalDuration += event->duration;
+	if (phase == ASSET_TRACE_READ)
+	{
+		total->bytes += bytes;
+	}
+	SDL_UnlockMutex(traceMutex);
+}
+
+/**
+ * Insert an asset into a list of the slowest assets, if it is slow enough
+ * @param top The slowest assets so far, slowest first
+ * @param topCount The number of valid entries in @c top
+ */
+static void InsertTopEntry(AssetTraceTopEntry *top, size_t *topCount, const char *asset, const AssetTraceTotal *total)
+{
+	size_t index = *topCount;
+	while (index > 0 && top[index - 1].total->totalDuration < total->totalDuration)
+	{
+		index--;
+	}
+	if (index >= ASSET_TRACE_TOP_COUNT)
+	{
+		return;
+	}
+	const size_t moveCount = (*topCount < ASSET_TRACE_TOP_COUNT ? *topCount : ASSET_TRACE_TOP_COUNT - 1) - index;
+	memmove(&top[index + 1], &top[index], sizeof(AssetTraceTopEntry) * moveCount);
+	top[index].asset = asset;
+	top[index].total = total;
+	if (*topCount < ASSET_TRACE_TOP_COUNT)
+	{
+		(*topCount)++;
+	}
+}
+
+/**
+ * Find the slowest assets in a totals dict
+ * @param from The totals to search
+ * @param top Where to store the slowest assets, slowest first
+ * @return The number of entries stored in @c top
+ */
+static size_t FindSlowestAssets(const AssetTraceTotals from, AssetTraceTopEntry top[ASSET_TRACE_TOP_COUNT])
+{
+	size_t topCount = 0;
+	AssetTraceTotals_iterator iterator;
+	for (AssetTraceTotals_it(iterator, from); !AssetTraceTotals_end_p(iterator); AssetTraceTotals_next(iterator))
+	{
+		const AssetTraceTotals_pair *pair = AssetTraceTotals_cref(iterator);
+		InsertTopEntry(top, &topCount, pair->key, &pair->value);
+	}
+	return topCount;
+}
+
+void LogAssetTraceSummary(const uint64_t since)
+{
+	if (!traceEnabled)
+	{
+		return;
+	}
+	uint64_t phaseDuration[ASSET_TRACE_PHASE_COUNT] = {0};
+	AssetTraceTotals windowTotals;
+	AssetTraceTotals_init(windowTotals);
+
+	SDL_LockMutex(traceMutex);
+	for (size_t i = events.length; i > 0; i--)
+	{
+		const AssetTraceEvent *event = ListGetPointer(events, i - 1);
+		if (event->startTime < since)
+		{
+			continue;
+		}
+		phaseDuration[event->phase] += event->duration;
+		AssetTraceTotal *total = AssetTraceTotals_safe_get(windowTotals, event->asset);
+		total->duration[event->phase] += event->duration;
+		total->totalDuration += event->duration;
+	}
+	SDL_UnlockMutex(traceMutex);
+
+	LogInfo("Asset load time by phase (summed across threads):\n");
+	for (size_t i = 0; i < ASSET_TRACE_PHASE_COUNT; i++)
+	{
+		LogInfo("  %-8s %10.3f ms\n", phaseNames[i], (double)phaseDuration[i] / 1000000.0);
+	}
+	AssetTraceTopEntry top[ASSET_TRACE_TOP_COUNT];
+	const size_t topCount = FindSlowestAssets(windowTotals, top);
+	for (size_t i = 0; i < topCount; i++)
+	{
+		LogInfo("  %10.3f ms  %s\n", (double)top[i].total->totalDuration / 1000000.0, top[i].asset);
+	}
+	AssetTraceTotals_clear(windowTotals);
+}
+
+/**
+ * Write a string to a file with quotes around it
+ * @param file The file to write to
+ * @param string The string to write
+ * @param json Whether to use JSON escapes instead of CSV ones
+ */
+static void WriteQuotedString(FILE *file, const char *string, const bool json)
+{
+	fputc('"', file);
+	for (const char *c = string; *c != '\0'; c++)
+	{
+		if (*c == '"')
+		{
+			fputs(json ? "\\\"" : "\"\"", file);
+		} else if (*c == '\\' && json)
+		{
+			fputs("\\\\", file);
+		} else if ((unsigned char)*c < 0x20)
+		{
+			if (json)
+			{
+				fprintf(file, "\\u%04x", *c);
+			}
+		} else
+		{
+			fputc(*c, file);
+		}
+	}
+	fputc('"', file);
+}
+
+static void WriteThread(FILE *file, const SDL_ThreadID thread, const bool json)
+{
+	if (thread == mainThread)
+	{
+		fputs(json ? "\"main\"" : "main", file);
+	} else
+	{
+		fprintf(file, json ? "\"%llu\"" : "%llu", (unsigned long long)thread);
+	}
+}
+
+/**
+ * Write every recorded event to the report file. traceMutex must be held.
+ */
+static void WriteAssetTraceReport()
+{
+	FILE *file = fopen(reportPath, "w");
+	if (file == NULL)
+	{
+		LogError("Failed to open asset trace report file: %s\n", reportPath);
+		return;
+	}
+	const size_t pathLength = strlen(reportPath);
+	const bool json = pathLength >= strlen(".json") && strcmp(reportPath + pathLength - strlen(".json"), ".json") == 0;
+
+	if (json)
+	{
+		fputs("[\n", file);
+	} else
+	{
+		fputs("asset,phase,thread,start_ms,duration_ms,bytes\n", file);
+	}
+	for (size_t i = 0; i < events.length; i++)
+	{
+		const AssetTraceEvent *event = ListGetPointer(events, i);
+		if (json)
+		{
+			fputs("\t{\"asset\": ", file);
+			WriteQuotedString(file, event->asset, true);
+			fprintf(file, ", \"phase\": \"%s\", \"thread\": ", phaseNames[event->phase]);
+			WriteThread(file, event->thread, true);
+			fprintf(file,
+					", \"start_ms\": %.3f, \"duration_ms\": %.3f, \"bytes\": %zu}%s\n",
+					(double)event->startTime / 1000000.0,
+					(double)event->duration / 1000000.0,
+					event->bytes,
+					i + 1 < events.length ? "," : "");
+		} else
+		{
+			WriteQuotedString(file, event->asset, false);
+			fprintf(file, ",%s,", phaseNames[event->phase]);
+			WriteThread(file, event->thread, false);
+			fprintf(file,
+					",%.3f,%.3f,%zu\n",
+					(double)event->startTime / 1000000.0,
+					(double)event->duration / 1000000.0,
+					event->bytes);
+		}
+	}
+	if (json)
+	{
+		fputs("]\n", file);
+	}
+	fclose(file);
+	LogInfo("Wrote %zu asset trace event(s) to %s\n", events.length, reportPath);
+}
+
+void DestroyAssetTrace()
+{
+	if (!traceEnabled)
+	{
+		return;
+	}
+	SDL_LockMutex(traceMutex);
+	traceEnabled = false;
+	WriteAssetTraceReport();
+	for (size_t i = 0; i < events.length; i++)
+	{
+		AssetTraceEvent *event = ListGetPointer(events, i);
+		free(event->asset);
+	}
+	ListAndContentsFree(events);
+	AssetTraceTotals_clear(totals);
+	SDL_UnlockMutex(traceMutex);
+	SDL_DestroyMutex(traceMutex);
+	traceMutex = NULL;
+}
+
+void DPrintAssetTrace()
+{
+	if (!traceEnabled)
+	{
+		DPrintF("Asset Trace: disabled (--asset-trace=<file>)", COLOR_WHITE);
+		return;
+	}
+	SDL_LockMutex(traceMutex);
+	DPrintF("Asset Trace: %zu event(s)", COLOR_WHITE, events.length);
+	AssetTraceTopEntry top[ASSET_TRACE_TOP_COUNT];
+	const size_t topCount = FindSlowestAssets(totals, top);
+	for (size_t i = 0; i < topCount; i++)
+	{
+		const AssetTraceTotal *total = top[i].total;
+		DPrintF("%7.2f ms %s (read %.2f, inflate %.2f, parse %.2f, upload %.2f)",
+				COLOR_WHITE,
+				(double)total->totalDuration / 1000000.0,
+				top[i].asset,
+				(double)(total->duration[ASSET_TRACE_OPEN] + total->duration[ASSET_TRACE_READ]) / 1000000.0,
+				(double)total->duration[ASSET_TRACE_INFLATE] / 1000000.0,
+				(double)total->duration[ASSET_TRACE_PARSE] / 1000000.0,
+				(double)total->duration[ASSET_TRACE_UPLOAD] / 1000000.0);
+	}
+	SDL_UnlockMutex(traceMutex);
+}
@@ -7,6 +7,7 @@
 #include <engine/assets/ModelLoader.h>
 #include <engine/assets/TextureLoader.h>
 #include <engine/Commit.h>
+#include <engine/debug/AssetTrace.h>
 #include <engine/debug/DebugEntryManager.h>
 #include <engine/debug/DebugGraph.h>
 #include <engine/debug/DPrint.h>
@@ -14,6 +15,10 @@
 #include <engine/debug/FrameGrapher.h>
 #include <engine/Engine.h>
 #include <engine/graphics/RenderingHelpers.h>
+#include <engine/helpers/MapChunkStreamer.h>
+#include <engine/helpers/MapPreloader.h>
+#include <engine/structs/ActorIoQueue.h>
+#include <engine/structs/ActorPool.h>
 #include <engine/structs/Camera.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/ControlOptions.h>
@@ -21,6 +26,7 @@
 #include <engine/structs/InputAction.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/List.h>
+#include <engine/structs/MapArena.h>
 #include <engine/structs/Player.h>
 #include <engine/structs/Vector2.h>
 #include <engine/subsystem/Error.h>
@@ -31,6 +37,7 @@
 #include <joltc/joltc.h>
 #include <joltc/Math/Quat.h>
 #include <joltc/Math/Vector3.h>
+#include <SDL3/SDL_atomic.h>
 #include <SDL3/SDL_cpuinfo.h>
 #include <SDL3/SDL_platform.h>
 #include <SDL3/SDL_video.h>
@@ -80,8 +87,31 @@ static void DebugEntryMap()
 	{
 		DPrintF("Map: %s", COLOR_WHITE, GetState()->map->mapName);
 		DPrintF("Actors: %d", COLOR_WHITE, GetState()->map->actors.length);
+		ActorPoolStats actorPoolStats;
+		GetActorPoolStats(&actorPoolStats);
+		DPrintF("Actor pool: %zu live, %zu peak, %zu stale handle lookup(s), %zu retired slot(s)",
+				COLOR_WHITE,
+				actorPoolStats.liveActors,
+				actorPoolStats.peakActors,
+				actorPoolStats.staleHandleLookups,
+				actorPoolStats.retiredSlots);
 		DPrintF("Models: %d", COLOR_WHITE, GetState()->map->modelCount);
 		DPrintF("Lights: %d", COLOR_WHITE, GetState()->map->lightCount);
+		const MapArena *arena = &GetState()->map->arena;
+		DPrintF("Arena: %zu allocation(s), %.1f / %.1f KiB in %zu block(s)",
+				COLOR_WHITE,
+				arena->allocationCount,
+				(double)arena->bytesAllocated / 1024.0,
+				(double)arena->bytesReserved / 1024.0,
+				arena->blockCount);
+		DPrintF("I/O relinks: %d", COLOR_WHITE, SDL_GetAtomicInt(&GetState()->map->ioRelinkCount));
+		ActorIoQueue *ioQueue = &GetState()->map->ioQueue;
+		DPrintF("I/O queue: %zu queued, %zu sent last tick, %zu dropped by the depth limit, %zu tick(s) over budget",
+				COLOR_WHITE,
+				GetQueuedActorInputCount(ioQueue),
+				ioQueue->dispatchedLastTick,
+				ioQueue->chainDepthDrops,
+				ioQueue->overBudgetTicks);
 	}
 }
 
@@ -223,6 +253,9 @@ void InitDebugEntryManager()
 	RegisterDebugEntry("system_specs", DebugEntrySystem, DEBUG_ENTRY_DISABLED, 5);
 	RegisterDebugEntry("sound_system", DPrintSoundSystem, DEBUG_ENTRY_DISABLED, 5);
 	RegisterDebugEntry("asset_caches", DebugEntryAssetLoaders, DEBUG_ENTRY_DISABLED, 5);
+	RegisterDebugEntry("asset_trace", DPrintAssetTrace, DEBUG_ENTRY_DISABLED, 5);
+	RegisterDebugEntry("map_preloader", DPrintMapPreloader, DEBUG_ENTRY_DISABLED, 5);
+	RegisterDebugEntry("map_chunks", DPrintMapChunks, DEBUG_ENTRY_DISABLED, 5);
 
 	// Console
 	RegisterDebugEntry("console", DrawDPrintConsole, DEBUG_ENTRY_SHOWN, 5);
@@ -0,0 +1,182 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/debug/MapLoadProfiler.h>
+#include <engine/helpers/Arguments.h>
+#include <engine/structs/List.h>
+#include <engine/structs/MapArena.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/Timing.h>
+#include <SDL3/SDL_mutex.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct MapLoadStage MapLoadStage;
+
+struct MapLoadStage
+{
+	char name[MAP_LOAD_STAGE_NAME_LENGTH];
+	/// The number of times the stage was recorded
+	size_t calls;
+	/// The time spent in the stage, summed across threads
+	uint64_t duration;
+	/// Whether any of the stage's calls counted their allocations
+	bool countsAllocations;
+	/// The number of allocations the stage made from the map's arena
+	size_t allocations;
+	/// The number of bytes the stage allocated from the map's arena
+	size_t bytes;
+};
+
+/// Whether a map load is being profiled. Only written with profileMutex held.
+static bool profiling = false;
+
+/// Protects everything below
+static SDL_Mutex *profileMutex = NULL;
+/// The map that is being profiled
+static char *profileMapName = NULL;
+/// When the current profile started
+static uint64_t profileStartTime = 0;
+/// The stages recorded so far, in the order they were first recorded
+static List stages;
+
+void InitMapLoadProfiler()
+{
+	profileMutex = SDL_CreateMutex();
+	ListInit(stages, LIST_POINTER);
+}
+
+void DestroyMapLoadProfiler()
+{
+	if (profileMutex == NULL)
+	{
+		return;
+	}
+	ListAndContentsFree(stages);
+	free(profileMapName);
+	profileMapName = NULL;
+	SDL_DestroyMutex(profileMutex);
+	profileMutex = NULL;
+	profiling = false;
+}
+
+void BeginMapLoadProfile(const char *mapName)
+{
+	if (profileMutex == NULL || !HasCliArg("--profile-map-load"))
+	{
+		return;
+	}
+	SDL_LockMutex(profileMutex);
+	for (size_t i = 0; i < stages.length; i++)
+	{
+		free(ListGetPointer(stages, i));
+	}
+	ListClear(stages);
+	free(profileMapName);
+	profileMapName = strdup(mapName);
+	CheckAlloc(profileMapName);
+	profileStartTime = GetTimeNs();
+	profiling = true;
+	SDL_UnlockMutex(profileMutex);
+}
+
+/**
+ * Log the recorded stages as a table. profileMutex must be held.
+ */
+static void LogMapLoadProfile(const uint64_t totalTime)
+{
+	LogInfo("Map load profile of %s, %.3f ms in total:\n", profileMapName, (double)totalTime / 1000000.0);
+	LogInfo("  %-40s %6s %10s %6s %8s %10s\n", "stage", "calls", "ms", "%", "allocs", "KiB");
+	for (size_t i = 0; i < stages.length; i++)
+	{
+		const MapLoadStage *stage = ListGetPointer(stages, i);
+		char allocations[32] = "-";
+		char kib[32] = "-";
+		if (stage->countsAllocations)
+		{
+			snprintf(allocations, sizeof(allocations), "%zu", stage->allocations);
+			snprintf(kib, sizeof(kib), "%.1f", (double)stage->bytes / 1024.0);
+		}
+		LogInfo("  %-40s %6zu %10.3f %6.1f %8s %10s\n",
+				stage->name,
+				stage->calls,
+				(double)stage->duration / 1000000.0,
+				totalTime ? (double)stage->duration * 100.0 / (double)totalTime : 0.0,
+				allocations,
+				kib);
+	}
+	LogInfo("  Stages that run on several threads at once can add up to more than the total time\n");
+}
+
+void FinishMapLoadProfile()
+{
+	if (profileMutex == NULL || !profiling)
+	{
+		return;
+	}
+	SDL_LockMutex(profileMutex);
+	profiling = false;
+	LogMapLoadProfile(GetTimeNs() - profileStartTime);
+	SDL_UnlockMutex(profileMutex);
+}
+
+MapLoadStageTimer StartMapLoadStage(const MapArena *arena)
+{
+	if (!profiling)
+	{
+		return (MapLoadStageTimer){0};
+	}
+	return (MapLoadStageTimer){
+		.startTime = GetTimeNs(),
+		.arena = arena,
+		.startAllocations = arena ? arena->allocationCount : 0,
+		.startBytes = arena ? arena->bytesAllocated : 0,
+	};
+}
+
+void EndMapLoadStage(const char *stage, const MapLoadStageTimer *timer)
+{
+	if (timer->startTime == 0)
+	{
+		return;
+	}
+	const uint64_t duration = GetTimeNs() - timer->startTime;
+	SDL_LockMutex(profileMutex);
+	if (!profiling)
+	{
+		SDL_UnlockMutex(profileMutex);
+		return;
+	}
+	MapLoadStage *entry = NULL;
+	for (size_t i = 0; i < stages.length; i++)
+	{
+		MapLoadStage *existing = ListGetPointer(stages, i);
+		if (strncmp(existing->name, stage, MAP_LOAD_STAGE_NAME_LENGTH - 1) == 0)
+		{
+			entry = existing;
+			break;
+		}
+	}
+	if (entry == NULL)
+	{
+		entry = calloc(1, sizeof(MapLoadStage));
+		CheckAlloc(entry);
+		snprintf(entry->name, sizeof(entry->name), "%s", stage);
+		ListAdd(stages, entry);
+	}
+	entry->calls++;
+	entry->duration += duration;
+	if (timer->arena != NULL)
+	{
+		entry->countsAllocations = true;
+		entry->allocations += timer->arena->allocationCount - timer->startAllocations;
+		entry->bytes += timer->arena->bytesAllocated - timer->startBytes;
+	}
+	SDL_UnlockMutex(profileMutex);
+}
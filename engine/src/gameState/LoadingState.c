@@ -3,14 +3,23 @@
 //
 
 #include <assert.h>
+#include <engine/assets/AssetManifest.h>
 #include <engine/assets/AssetReader.h>
+#include <engine/assets/AsyncAssetLoader.h>
+#include <engine/debug/AssetTrace.h>
+#include <engine/debug/MapLoadProfiler.h>
 #include <engine/gameState/LoadingState.h>
+#include <engine/graphics/Drawing.h>
 #include <engine/graphics/Font.h>
 #include <engine/graphics/RenderingHelpers.h>
+#include <engine/helpers/Arguments.h>
+#include <engine/helpers/MapPreloader.h>
 #include <engine/physics/MapPhysics.h>
+#include <engine/structs/Asset.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/GameState.h>
 #include <engine/structs/GlobalState.h>
+#include <engine/structs/List.h>
 #include <engine/structs/Map.h>
 #include <engine/structs/Vector2.h>
 #include <engine/subsystem/Error.h>
@@ -26,7 +35,10 @@ typedef enum LoadingStateStage
 {
 	/// Drawing the first frame ("LOADING" text)
 	LSS_WAITING_FOR_FRAME,
-	/// Loading the map from disk and performing the first frame update
+	/// Waiting for the asset loader threads to read and decompress the map and prefetch its manifest, or for the
+	/// map's preload to finish
+	LSS_READING_LEVEL,
+	/// Loading the map from the map asset and performing the first frame update
 	LSS_LOADING_LEVEL,
 	/// Performing the first physics tick
 	LSS_WAITING_FOR_TICK,
@@ -37,6 +49,12 @@ typedef enum LoadingStateStage
 /// The minimum time the loading screen should be visible for, to prevent quick flashes
 #define LEVEL_LOAD_MIN_TIME_MS 250
 
+/// The part of the progress bar that is filled by reading the map's assets, until a map has been loaded
+#define DEFAULT_READING_PROGRESS_SHARE 0.5
+
+#define PROGRESS_BAR_WIDTH 200
+#define PROGRESS_BAR_HEIGHT 4
+
 LoadingStateDoneFunction LoadingStateDoneCallback = NULL;
 LoadingStateErrorFunction LoadingStateErrorCallback = NULL;
 
@@ -45,6 +63,37 @@ MapTransition *loadStateTransition = NULL;
 
 static uint64_t levelLoadStartTime;
 static LoadingStateStage stage;
+static AssetLoadTicket mapAssetTicket = ASSET_LOAD_TICKET_INVALID;
+static bool mapAssetLoaded = false;
+static Asset *mapAsset = NULL;
+/// The tickets of the manifest prefetches that have not finished yet
+static List prefetchTickets;
+/// Whether the map is taken from the map preloader instead of being loaded here
+static bool usingPreload = false;
+/// The number of manifest assets that were prefetched
+static size_t prefetchCount = 0;
+/// When reading the map's assets started, from @c GetTimeNs
+static uint64_t readingStartTime = 0;
+/// Times reading the map's assets, for the map load profile
+static MapLoadStageTimer readingTimer;
+/// The part of the progress bar that is filled by reading the map's assets, measured on the last map load
+static double readingProgressShare = DEFAULT_READING_PROGRESS_SHARE;
+
+static void PrefetchedAssetCallback(const AssetLoadTicket ticket, Asset * /*asset*/, void * /*userData*/)
+{
+	const size_t index = ListFind(prefetchTickets, ticket);
+	if (index != (size_t)-1)
+	{
+		ListRemoveAt(prefetchTickets, index);
+	}
+}
+
+static void MapAssetLoadedCallback(const AssetLoadTicket /*ticket*/, Asset *asset, void * /*userData*/)
+{
+	mapAssetTicket = ASSET_LOAD_TICKET_INVALID;
+	mapAssetLoaded = true;
+	mapAsset = asset;
+}
 
 static void LoadingStateFixedUpdate(GlobalState *state, const double delta)
 {
@@ -55,13 +104,58 @@ static void LoadingStateFixedUpdate(GlobalState *state, const double delta)
 	}
 }
 
+/**
+ * Start reading the map asset and prefetching the map's manifest
+ */
+static void StartMapAssetLoad()
+{
+	mapAssetTicket = LoadMapAssetAsync(loadStateLevelname, MapAssetLoadedCallback, NULL);
+	// The manifest is prefetched alongside the map, so that assets that would otherwise be loaded on first use are
+	// already in memory by the time the map is done loading
+	prefetchCount = PrefetchMapManifest(loadStateLevelname, PrefetchedAssetCallback, NULL, &prefetchTickets);
+	if (mapAssetTicket == ASSET_LOAD_TICKET_INVALID)
+	{
+		mapAssetLoaded = true; // ChangeMapFromAsset will fail and report the error
+	}
+}
+
 static void LoadingStateUpdate(GlobalState *state, const double delta)
 {
+	if (stage == LSS_READING_LEVEL && usingPreload)
+	{
+		const MapPreloadStatus status = GetMapPreloadStatus(loadStateLevelname);
+		if (status == MAP_PRELOAD_READY)
+		{
+			EndMapLoadStage("wait for map preload", &readingTimer);
+			stage = LSS_LOADING_LEVEL;
+		} else if (status == MAP_PRELOAD_NONE)
+		{
+			LogWarning("The preload of map %s failed, loading it normally\n", loadStateLevelname);
+			usingPreload = false;
+			StartMapAssetLoad();
+		}
+	} else if (stage == LSS_READING_LEVEL && mapAssetLoaded && prefetchTickets.length == 0)
+	{
+		EndMapLoadStage("read map and prefetch assets", &readingTimer);
+		stage = LSS_LOADING_LEVEL;
+	}
 	if (stage == LSS_LOADING_LEVEL)
 	{
 		const uint64_t realLoadStart = GetTimeNs();
-		if (!ChangeMapByName(loadStateLevelname))
+		const uint64_t readingTime = realLoadStart - readingStartTime;
+		bool loaded = false;
+		if (usingPreload)
 		{
+			loaded = ChangeMapFromPreload(loadStateLevelname, TakePreloadedMap(loadStateLevelname));
+		} else
+		{
+			Asset *asset = mapAsset;
+			mapAsset = NULL;
+			loaded = ChangeMapFromAsset(loadStateLevelname, asset);
+		}
+		if (!loaded)
+		{
+			FinishMapLoadProfile();
 			LogError("Failed to load map: %s\n", loadStateLevelname);
 			if (LoadingStateErrorCallback)
 			{
@@ -81,14 +175,25 @@ static void LoadingStateUpdate(GlobalState *state, const double delta)
 			memcpy(GetState()->map->transition, loadStateTransition, sizeof(MapTransition));
 			GetState()->map->transition->entranceName = strdup(loadStateTransition->entranceName); // not POD
 		}
-		LogInfo("Loaded map %s in %f ms\n", loadStateLevelname, (double)realLoadTime / 1000000.0);
+		LogInfo("Loaded map %s in %f ms%s\n",
+				loadStateLevelname,
+				(double)realLoadTime / 1000000.0,
+				usingPreload ? " (preloaded)" : "");
+		FinishMapLoadProfile();
+		if (!usingPreload && readingTime + realLoadTime > 0)
+		{
+			readingProgressShare = (double)readingTime / (double)(readingTime + realLoadTime);
+		}
+		LogAssetTraceSummary(levelLoadStartTime * 1000000);
 		MapUpdate(state, delta);
 		stage = LSS_WAITING_FOR_TICK;
 	}
 	const uint64_t currentTime = GetTimeMs();
 	const uint64_t loadTime = currentTime - levelLoadStartTime;
-	if (stage == LSS_DONE && loadTime > LEVEL_LOAD_MIN_TIME_MS)
+	// Preloaded maps are swapped in right away, since the point of preloading them is to not show a loading screen
+	if (stage == LSS_DONE && (loadTime > LEVEL_LOAD_MIN_TIME_MS || usingPreload))
 	{
+		StartMapManifestPlayWindow();
 		if (LoadingStateDoneCallback)
 		{
 			LoadingStateDoneCallback();
@@ -99,6 +204,39 @@ static void LoadingStateUpdate(GlobalState *state, const double delta)
 	}
 }
 
+/**
+ * Get how far along loading the map is, from 0 to 1
+ */
+static double GetLoadingProgress()
+{
+	if (stage == LSS_WAITING_FOR_FRAME || (stage == LSS_READING_LEVEL && usingPreload))
+	{
+		return 0.0;
+	}
+	if (stage == LSS_READING_LEVEL)
+	{
+		// The map asset and every prefetched asset count the same, since most of them are read in parallel
+		const size_t readCount = (mapAssetLoaded ? 1 : 0) + prefetchCount - prefetchTickets.length;
+		return readingProgressShare * (double)readCount / (double)(prefetchCount + 1);
+	}
+	return stage == LSS_LOADING_LEVEL ? readingProgressShare : 1.0;
+}
+
+/**
+ * Draw a bar under the loading text showing how far along loading the map is, if @c --loading-progress-bar was passed
+ */
+static void DrawLoadingProgressBar()
+{
+	if (!HasCliArg("--loading-progress-bar"))
+	{
+		return;
+	}
+	const int x = (ScaledWindowWidth() - PROGRESS_BAR_WIDTH) / 2;
+	const int y = (ScaledWindowHeight() / 2) + 16;
+	DrawRect(x, y, PROGRESS_BAR_WIDTH, PROGRESS_BAR_HEIGHT, COLOR(0x40FFFFFF));
+	DrawRect(x, y, (int)(PROGRESS_BAR_WIDTH * GetLoadingProgress()), PROGRESS_BAR_HEIGHT, COLOR_WHITE);
+}
+
 static void LoadingStateRender(GlobalState * /*state*/, const double /*delta*/)
 {
 	DrawTextAligned("LOADING",
@@ -109,9 +247,10 @@ static void LoadingStateRender(GlobalState * /*state*/, const double /*delta*/)
 					FONT_HALIGN_CENTER,
 					FONT_VALIGN_MIDDLE,
 					FONT("small_font"));
+	DrawLoadingProgressBar();
 	if (stage == LSS_WAITING_FOR_FRAME)
 	{
-		stage = LSS_LOADING_LEVEL;
+		stage = LSS_READING_LEVEL;
 	}
 }
 
@@ -120,10 +259,33 @@ static void LoadingStateSet()
 	levelLoadStartTime = GetTimeMs();
 	assert(loadStateLevelname);
 	stage = LSS_WAITING_FOR_FRAME;
+	mapAssetLoaded = false;
+	prefetchCount = 0;
+	BeginMapLoadProfile(loadStateLevelname);
+	readingStartTime = GetTimeNs();
+	readingTimer = StartMapLoadStage(NULL);
+	StartMapManifestRecording(loadStateLevelname);
+	ListInit(prefetchTickets, LIST_UINT32);
+	// Preloads of other maps are no longer useful, and would only take memory away from this one
+	DiscardMapPreloads(loadStateLevelname);
+	usingPreload = GetMapPreloadStatus(loadStateLevelname) != MAP_PRELOAD_NONE;
+	if (!usingPreload)
+	{
+		StartMapAssetLoad();
+	}
 }
 
 static void LoadingStateDestroy()
 {
+	CancelAssetLoad(mapAssetTicket);
+	mapAssetTicket = ASSET_LOAD_TICKET_INVALID;
+	for (size_t i = 0; i < prefetchTickets.length; i++)
+	{
+		CancelAssetLoad(ListGetUint32(prefetchTickets, i));
+	}
+	ListFree(prefetchTickets);
+	FreeAsset(mapAsset);
+	mapAsset = NULL;
 	free(loadStateLevelname);
 	if (loadStateTransition)
 	{
@@ -9,6 +9,7 @@
 #include <cglm/mat4.h>
 #include <cglm/types.h>
 #include <engine/assets/AssetReader.h>
+#include <engine/assets/AssetWatcher.h>
 #include <engine/assets/TextureLoader.h>
 #include <engine/graphics/RenderingHelpers.h>
 #include <engine/graphics/vulkan/Vulkan.h>
@@ -151,6 +152,7 @@ bool FrameStart()
 		HotReloadAssets();
 		rendererQueuedActions &= ~QUEUED_ACTION_RELOAD_ALL_ASSETS;
 	}
+	PollAssetWatcher();
 	return VK_FrameStart();
 }
 
@@ -220,7 +222,22 @@ void LoadMapModels(Map *map)
 {
 	assert(map->lightmapPixels && map->models);
 	VK_LoadMap(map);
-	FreeLoadTimeMapData(map);
+	// The geometry is uploaded together with the geometry of the resident chunks, so it is needed again whenever one
+	// is streamed in or out
+	if (map->chunks.length == 0)
+	{
+		FreeLoadTimeMapData(map);
+	}
+}
+
+void QueueTextureReload(const Image *image)
+{
+	VK_QueueTextureReload(image);
+}
+
+void QueueModelReload(const ModelDefinition *model)
+{
+	VK_QueueModelReload(model);
 }
 
 inline void GetColor(const uint32_t argb, Color *color)
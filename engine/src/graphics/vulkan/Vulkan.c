@@ -7,7 +7,9 @@
 #include <engine/assets/AssetReader.h>
 #include <engine/assets/ModelLoader.h>
 #include <engine/assets/TextureLoader.h>
+#include <engine/debug/AssetTrace.h>
 #include <engine/debug/DPrint.h>
+#include <engine/debug/MapLoadProfiler.h>
 #include <engine/graphics/Drawing.h>
 #include <engine/graphics/RenderingHelpers.h>
 #include <engine/graphics/vulkan/Vulkan.h>
@@ -15,9 +17,11 @@
 #include <engine/graphics/vulkan/VulkanHelpers.h>
 #include <engine/graphics/vulkan/VulkanInternal.h>
 #include <engine/graphics/vulkan/VulkanResources.h>
+#include <engine/helpers/MapChunkStreamer.h>
 #include <engine/structs/Camera.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/GlobalState.h>
+#include <engine/structs/List.h>
 #include <engine/structs/Map.h>
 #include <engine/structs/Vector2.h>
 #include <engine/structs/Viewmodel.h>
@@ -48,6 +52,10 @@
 static const Map *loadedMap;
 static LunaImage lightmap = LUNA_NULL_HANDLE;
 static size_t skyModelIndexCount;
+/// The images passed to @c VK_QueueTextureReload since the last frame
+static List reloadedTextures;
+/// The IDs of the models passed to @c VK_QueueModelReload since the last frame
+static List reloadedModelIds;
 
 static inline VkResult LoadSky(const ModelDefinition *model)
 {
@@ -399,11 +407,27 @@ static inline VkResult UpdateMapInstanceData(const Map *map)
 {
 	const size_t materialCount = lunaGetBufferSize(buffers.map.instanceData) / sizeof(uint32_t);
 	uint32_t textureIndices[materialCount];
-	for (size_t i = 0; i < map->modelCount; i++)
+	size_t materialIndex = 0;
+	for (size_t i = 0; i < map->modelCount && materialIndex < materialCount; i++)
 	{
 		const MapModel *model = &map->models[i];
-		textureIndices[i] = TextureIndex(model->material->texture);
+		textureIndices[materialIndex] = TextureIndex(model->material->texture);
+		materialIndex++;
 	}
+	// The models of the resident chunks follow the map's own models, in the same order LoadMapGeometry uploaded them
+	List chunks;
+	ListInit(chunks, LIST_POINTER);
+	GetResidentMapChunks(map, &chunks);
+	for (size_t i = 0; i < chunks.length; i++)
+	{
+		const Map *chunk = ListGetPointer(chunks, i);
+		for (size_t j = 0; j < chunk->modelCount && materialIndex < materialCount; j++)
+		{
+			textureIndices[materialIndex] = TextureIndex(chunk->models[j].material->texture);
+			materialIndex++;
+		}
+	}
+	ListFree(chunks);
 	const LunaBufferWriteInfo instanceDataBufferWriteInfo = {
 		.bytes = lunaGetBufferSize(buffers.map.instanceData),
 		.data = textureIndices,
@@ -418,7 +442,7 @@ static inline VkResult UpdateMapInstanceData(const Map *map)
 	return VK_SUCCESS;
 }
 
-static inline VkResult LoadLightmap(const Map *map)
+static inline VkResult LoadLightmap(const size_t width, const size_t height, const void *pixels)
 {
 	if (lightmap != LUNA_NULL_HANDLE)
 	{
@@ -436,14 +460,14 @@ static inline VkResult LoadLightmap(const Map *map)
 	};
 	const LunaImageCreationInfo imageCreationInfo = {
 		.format = VK_FORMAT_R16G16B16A16_SFLOAT,
-		.width = map->lightmapWidth,
-		.height = map->lightmapHeight,
+		.width = width,
+		.height = height,
 		.usage = VK_IMAGE_USAGE_SAMPLED_BIT,
 		.queueFamilyIndexCount = 1,
 		.queueFamilyIndices = &queueFamilyIndex,
 		.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-		.writeInfo.bytes = map->lightmapWidth * map->lightmapHeight * sizeof(_Float16) * 4,
-		.writeInfo.pixels = map->lightmapPixels,
+		.writeInfo.bytes = width * height * sizeof(_Float16) * 4,
+		.writeInfo.pixels = pixels,
 		.writeInfo.sourceStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
 		.writeInfo.destinationStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
 		.writeInfo.destinationAccessMask = VK_ACCESS_SHADER_READ_BIT,
@@ -468,6 +492,98 @@ static inline VkResult LoadLightmap(const Map *map)
 	return VK_SUCCESS;
 }
 
+/**
+ * Upload the models and lightmap of a map together with those of its resident chunks.
+ * The lightmap of each chunk is stacked below the previous one in a single atlas, so the lightmap UVs of the chunk
+ * models are remapped into their page of it.
+ * @param map The map, which must still have its geometry and lightmap
+ */
+static inline VkResult LoadMapGeometry(const Map *map)
+{
+	// The map is the first page of the atlas, followed by each chunk
+	List pages;
+	ListInit(pages, LIST_POINTER);
+	ListAdd(pages, map);
+	GetResidentMapChunks(map, &pages);
+	if (pages.length == 1)
+	{
+		ListFree(pages);
+		const MapLoadStageTimer modelTimer = StartMapLoadStage(NULL);
+		VulkanTestReturnResult(LoadMapModelsToBuffer(map->modelCount, map->models), "Failed to load map models!");
+		EndMapLoadStage("upload render models", &modelTimer);
+
+		const MapLoadStageTimer lightmapTimer = StartMapLoadStage(NULL);
+		VulkanTestReturnResult(LoadLightmap(map->lightmapWidth, map->lightmapHeight, map->lightmapPixels),
+							   "Failed to load lightmap!");
+		EndMapLoadStage("upload lightmap", &lightmapTimer);
+		return VK_SUCCESS;
+	}
+
+	size_t atlasWidth = 0;
+	size_t atlasHeight = 0;
+	size_t modelCount = 0;
+	for (size_t i = 0; i < pages.length; i++)
+	{
+		const Map *page = ListGetPointer(pages, i);
+		atlasWidth = page->lightmapWidth > atlasWidth ? page->lightmapWidth : atlasWidth;
+		atlasHeight += page->lightmapHeight;
+		modelCount += page->modelCount;
+	}
+	const size_t pixelSize = sizeof(_Float16) * 4;
+	uint8_t *atlasPixels = calloc(atlasWidth * atlasHeight, pixelSize);
+	CheckAlloc(atlasPixels);
+	MapModel *models = malloc(sizeof(MapModel) * modelCount);
+	CheckAlloc(models);
+
+	size_t pageOffset = 0;
+	size_t modelIndex = 0;
+	for (size_t i = 0; i < pages.length; i++)
+	{
+		const Map *page = ListGetPointer(pages, i);
+		for (size_t row = 0; row < page->lightmapHeight; row++)
+		{
+			memcpy(atlasPixels + ((pageOffset + row) * atlasWidth * pixelSize),
+				   (const uint8_t *)page->lightmapPixels + (row * page->lightmapWidth * pixelSize),
+				   page->lightmapWidth * pixelSize);
+		}
+		const float uScale = (float)page->lightmapWidth / (float)atlasWidth;
+		const float vScale = (float)page->lightmapHeight / (float)atlasHeight;
+		const float vOffset = (float)pageOffset / (float)atlasHeight;
+		for (size_t j = 0; j < page->modelCount; j++)
+		{
+			MapModel *model = &models[modelIndex];
+			*model = page->models[j];
+			model->vertices = malloc(sizeof(MapVertex) * model->vertexCount);
+			CheckAlloc(model->vertices);
+			for (size_t k = 0; k < model->vertexCount; k++)
+			{
+				model->vertices[k] = page->models[j].vertices[k];
+				model->vertices[k].lightmapUv.x *= uScale;
+				model->vertices[k].lightmapUv.y = vOffset + (model->vertices[k].lightmapUv.y * vScale);
+			}
+			modelIndex++;
+		}
+		pageOffset += page->lightmapHeight;
+	}
+	ListFree(pages);
+
+	const VkResult modelResult = LoadMapModelsToBuffer(modelCount, models);
+	for (size_t i = 0; i < modelCount; i++)
+	{
+		free(models[i].vertices);
+	}
+	free(models);
+	if (modelResult != VK_SUCCESS)
+	{
+		free(atlasPixels);
+	}
+	VulkanTestReturnResult(modelResult, "Failed to load map and chunk models!");
+	const VkResult lightmapResult = LoadLightmap(atlasWidth, atlasHeight, atlasPixels);
+	free(atlasPixels);
+	VulkanTestReturnResult(lightmapResult, "Failed to load lightmap atlas!");
+	return VK_SUCCESS;
+}
+
 static inline VkResult DrawSky(const LunaGraphicsPipelineBindInfo *pipelineBindInfo)
 {
 	if (skyModelIndexCount == 0)
@@ -844,8 +960,18 @@ static inline VkResult HandleMapChangeFlags(Map *map)
 
 static inline bool HandleRendererQueuedActions()
 {
+	// Handled first, so that the instance data updated below matches the models in the map buffers
+	if (rendererQueuedActions & QUEUED_ACTION_RELOAD_MAP_GEOMETRY)
+	{
+		if (loadedMap != NULL && loadedMap == GetState()->map)
+		{
+			VulkanTest(LoadMapGeometry(loadedMap), "Failed to reload map geometry!");
+		}
+		rendererQueuedActions &= ~QUEUED_ACTION_RELOAD_MAP_GEOMETRY;
+	}
 	if (rendererQueuedActions & QUEUED_ACTION_CLEAR_ALL_TEXTURES)
 	{
+		ApplyAllImageReloads();
 		if (!ClearTextureCache())
 		{
 			return false;
@@ -867,7 +993,9 @@ static inline bool HandleRendererQueuedActions()
 				skyTextureIndex = TextureIndex(loadedMap->skyTexture);
 			}
 		}
-		rendererQueuedActions &= ~QUEUED_ACTION_CLEAR_ALL_TEXTURES;
+		// Every texture was just uploaded again anyway
+		ListClear(reloadedTextures);
+		rendererQueuedActions &= ~(QUEUED_ACTION_CLEAR_ALL_TEXTURES | QUEUED_ACTION_RELOAD_TEXTURES);
 	}
 	if (rendererQueuedActions & QUEUED_ACTION_CLEAR_ALL_MODELS)
 	{
@@ -876,7 +1004,45 @@ static inline bool HandleRendererQueuedActions()
 			return false;
 		}
 		buffers.player.modelDefinition = LoadModel(MODEL("player"));
-		rendererQueuedActions &= ~QUEUED_ACTION_CLEAR_ALL_MODELS;
+		ListClear(reloadedModelIds);
+		rendererQueuedActions &= ~(QUEUED_ACTION_CLEAR_ALL_MODELS | QUEUED_ACTION_RELOAD_MODELS);
+	}
+	if (rendererQueuedActions & QUEUED_ACTION_RELOAD_TEXTURES)
+	{
+		for (size_t i = 0; i < reloadedTextures.length; i++)
+		{
+			Image *image = ListGetPointer(reloadedTextures, i);
+			ApplyImageReload(image);
+			if (!ReloadTexture(image))
+			{
+				return false;
+			}
+		}
+		ListClear(reloadedTextures);
+		rendererQueuedActions &= ~QUEUED_ACTION_RELOAD_TEXTURES;
+	}
+	if (rendererQueuedActions & QUEUED_ACTION_RELOAD_MODELS)
+	{
+		for (size_t i = 0; i < reloadedModelIds.length; i++)
+		{
+			const uint32_t modelId = ListGetUint32(reloadedModelIds, i);
+			UnloadModelLods(modelId);
+			// The viewmodel has buffers of its own, unlike actor models
+			if (loadedMap != NULL && loadedMap->viewmodel.model != NULL && loadedMap->viewmodel.model->id == modelId)
+			{
+				VulkanTest(LoadViewmodel(&loadedMap->viewmodel), "Failed to load reloaded viewmodel!");
+			}
+		}
+		ListClear(reloadedModelIds);
+		rendererQueuedActions &= ~QUEUED_ACTION_RELOAD_MODELS;
+	}
+	if (rendererQueuedActions & QUEUED_ACTION_UPDATE_MAP_MATERIALS)
+	{
+		if (loadedMap != NULL)
+		{
+			VulkanTest(UpdateMapInstanceData(loadedMap), "Failed to update map instance data for reloaded materials!");
+		}
+		rendererQueuedActions &= ~QUEUED_ACTION_UPDATE_MAP_MATERIALS;
 	}
 
 	return true;
@@ -949,6 +1115,8 @@ bool VK_Init(SDL_Window *window)
 				VK_API_VERSION_PATCH(physicalDeviceProperties.apiVersion));
 
 		InitActorLoadingVariables();
+		ListInit(reloadedTextures, LIST_POINTER);
+		ListInit(reloadedModelIds, LIST_UINT32);
 
 		return true;
 	}
@@ -1203,6 +1371,8 @@ void VK_Cleanup()
 	free(buffers.ui.vertexData);
 	free(buffers.ui.indexData);
 	free(buffers.player.instanceData);
+	ListFree(reloadedTextures);
+	ListFree(reloadedModelIds);
 	VulkanTestInternal(lunaDestroyInstance(), (void)0, "Cleanup failed!");
 }
 
@@ -1230,13 +1400,20 @@ bool VK_LoadMap(const Map *map)
 		return true;
 	}
 
-	VulkanTest(LoadMapModelsToBuffer(map->modelCount, map->models), "Failed to load map models!");
+	const uint64_t uploadStart = AssetTraceBegin();
+	size_t uploadBytes = 0;
+	for (size_t i = 0; i < map->modelCount; i++)
+	{
+		uploadBytes += (map->models[i].vertexCount * sizeof(MapVertex)) + (map->models[i].indexCount * sizeof(uint32_t));
+	}
 
-	VulkanTest(LoadLightmap(map), "Failed to load lightmap!");
+	VulkanTest(LoadMapGeometry(map), "Failed to load map geometry!");
 
 	VulkanTest(LoadViewmodel(&map->viewmodel), "Failed to load viewmodel!");
 
+	const MapLoadStageTimer actorTimer = StartMapLoadStage(NULL);
 	VulkanTest(LoadActors(&map->actors), "Failed to load actors!");
+	EndMapLoadStage("upload actor models", &actorTimer);
 
 	if (map->renderSky)
 	{
@@ -1250,9 +1427,29 @@ bool VK_LoadMap(const Map *map)
 
 	loadedMap = map;
 
+	AssetTraceEnd(map->mapName ? map->mapName : "map", ASSET_TRACE_UPLOAD, uploadStart, uploadBytes);
+
 	return true;
 }
 
+void VK_QueueTextureReload(const Image *image)
+{
+	if (ListFind(reloadedTextures, image) == SIZE_MAX)
+	{
+		ListAdd(reloadedTextures, image);
+	}
+	rendererQueuedActions |= QUEUED_ACTION_RELOAD_TEXTURES;
+}
+
+void VK_QueueModelReload(const ModelDefinition *model)
+{
+	if (ListFind(reloadedModelIds, model->id) == SIZE_MAX)
+	{
+		ListAdd(reloadedModelIds, model->id);
+	}
+	rendererQueuedActions |= QUEUED_ACTION_RELOAD_MODELS;
+}
+
 bool VK_UpdateViewportSize()
 {
 	const Vector2 windowSize = ActualWindowSizeIgnoreDPI();
@@ -561,6 +561,16 @@ VkResult UpdateActors()
 	return VK_SUCCESS;
 }
 
+void UnloadModelLods(const uint32_t modelId)
+{
+	// The old LODs stay in the vertex and index buffers until the next ClearModelCache, but nothing draws them anymore
+	const size_t index = ListFind(loadedModelIds, modelId);
+	if (index != SIZE_MAX)
+	{
+		ListRemoveAt(loadedModelIds, index);
+	}
+}
+
 bool ClearModelCache()
 {
 	ListClear(loadedModelIds);
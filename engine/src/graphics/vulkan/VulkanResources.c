@@ -6,6 +6,7 @@
 #include <engine/assets/AssetReader.h>
 #include <engine/assets/ModelLoader.h>
 #include <engine/assets/TextureLoader.h>
+#include <engine/debug/AssetTrace.h>
 #include <engine/graphics/vulkan/VulkanHelpers.h>
 #include <engine/graphics/vulkan/VulkanResources.h>
 #include <engine/helpers/MathEx.h>
@@ -564,8 +565,15 @@ VkResult ResizeDebugDrawBuffers()
 	return VK_SUCCESS;
 }
 
-bool LoadTexture(const Image *image)
+/**
+ * Upload an image to a new texture, without adding it to the texture array
+ * @param image The image to upload
+ * @param lunaImage Where to store the created texture
+ * @return Whether the texture was created
+ */
+static bool CreateTextureImage(const Image *image, LunaImage *lunaImage)
 {
+	const uint64_t uploadStart = AssetTraceBegin();
 	const bool useMipmaps = GetState()->options.mipmaps && image->mipmaps;
 	LunaSampler sampler = LUNA_NULL_HANDLE;
 	if (image->filter && image->repeat)
@@ -620,13 +628,19 @@ bool LoadTexture(const Image *image)
 		.writeInfo.submitInfo = &submitInfo,
 		.sampler = sampler,
 	};
-	LunaImage lunaImage = LUNA_NULL_HANDLE;
-	const size_t index = textures.length;
-	VulkanTest(lunaCreateImage(device, secondaryCommandBuffer, &imageCreationInfo, &lunaImage),
+	VulkanTest(lunaCreateImage(device, secondaryCommandBuffer, &imageCreationInfo, lunaImage),
 			   "Failed to create texture!");
-	imageAssetIdToIndexMap[image->id] = index;
-	ListAdd(textures, lunaImage);
 
+	AssetTraceEnd(image->name, ASSET_TRACE_UPLOAD, uploadStart, imageCreationInfo.writeInfo.bytes);
+
+	return true;
+}
+
+/**
+ * Point a slot of the texture array at a texture
+ */
+static void WriteTextureDescriptor(const LunaImage lunaImage, const size_t index)
+{
 	const LunaDescriptorImageInfo imageInfo = {
 		.image = lunaImage,
 		.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
@@ -639,6 +653,39 @@ bool LoadTexture(const Image *image)
 		.imageInfos = &imageInfo,
 	};
 	lunaWriteDescriptorSets(device, 1, &writeDescriptor);
+}
+
+bool LoadTexture(const Image *image)
+{
+	LunaImage lunaImage = LUNA_NULL_HANDLE;
+	if (!CreateTextureImage(image, &lunaImage))
+	{
+		return false;
+	}
+	const size_t index = textures.length;
+	imageAssetIdToIndexMap[image->id] = index;
+	ListAdd(textures, lunaImage);
+	WriteTextureDescriptor(lunaImage, index);
+
+	return true;
+}
+
+bool ReloadTexture(const Image *image)
+{
+	const uint32_t index = imageAssetIdToIndexMap[image->id];
+	if (index == -1u)
+	{
+		// Not uploaded yet, so the new pixels will be uploaded when the texture is first used
+		return true;
+	}
+	LunaImage lunaImage = LUNA_NULL_HANDLE;
+	if (!CreateTextureImage(image, &lunaImage))
+	{
+		return false;
+	}
+	lunaDestroyImage(device, (LunaImage)ListGetUint64(textures, index));
+	ListSet(textures, index, lunaImage);
+	WriteTextureDescriptor(lunaImage, index);
 
 	return true;
 }
@@ -3,6 +3,7 @@
 //
 
 #include <engine/assets/AssetReader.h>
+#include <engine/assets/AsyncAssetLoader.h>
 #include <engine/assets/GameConfigLoader.h>
 #include <engine/graphics/Drawing.h>
 #include <engine/graphics/Font.h>
@@ -10,6 +11,7 @@
 #include <engine/helpers/Arguments.h>
 #include <engine/helpers/BackgroundMapManager.h>
 #include <engine/physics/MapPhysics.h>
+#include <engine/structs/Asset.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/Map.h>
@@ -25,6 +27,16 @@
 static size_t backgroundMapLoadFrameCounter = 0;
 static float placeholderOpacity = 1.0f;
 static bool dontLoadBackgroundMap = false;
+static AssetLoadTicket backgroundMapTicket = ASSET_LOAD_TICKET_INVALID;
+static bool backgroundMapAssetLoaded = false;
+static Asset *backgroundMapAsset = NULL;
+
+static void BackgroundMapAssetLoadedCallback(const AssetLoadTicket /*ticket*/, Asset *asset, void * /*userData*/)
+{
+	backgroundMapTicket = ASSET_LOAD_TICKET_INVALID;
+	backgroundMapAssetLoaded = true;
+	backgroundMapAsset = asset;
+}
 
 static bool IsBackgroundMapLoadedIgnoreTicks()
 {
@@ -45,6 +57,11 @@ void EnterMenuBackgroundState()
 		backgroundMapLoadFrameCounter = 0;
 		placeholderOpacity = 1.0f;
 		dontLoadBackgroundMap = HasCliArg("--no-background-map");
+		CancelAssetLoad(backgroundMapTicket);
+		backgroundMapTicket = ASSET_LOAD_TICKET_INVALID;
+		FreeAsset(backgroundMapAsset);
+		backgroundMapAsset = NULL;
+		backgroundMapAssetLoaded = false;
 		if (dontLoadBackgroundMap)
 		{
 			ChangeMap(NULL);
@@ -60,10 +77,24 @@ void UpdateMenuBackground(GlobalState *state, const double delta)
 		{
 			// TODO: Waiting a frame here allows a single frame where if the physics thread starts, finishes,
 			//  and starts the lod thread then the game will attempt to read from a null map
-			if (backgroundMapLoadFrameCounter > 1)
+			if (backgroundMapLoadFrameCounter > 1 &&
+				!backgroundMapAssetLoaded &&
+				backgroundMapTicket == ASSET_LOAD_TICKET_INVALID)
+			{
+				// Read and decompress the map off the main thread so the placeholder keeps animating
+				backgroundMapTicket = LoadMapAssetAsync(gameConfig.backgroundMap, BackgroundMapAssetLoadedCallback, NULL);
+				if (backgroundMapTicket == ASSET_LOAD_TICKET_INVALID)
+				{
+					backgroundMapAssetLoaded = true;
+				}
+			}
+			if (backgroundMapAssetLoaded)
 			{
+				backgroundMapAssetLoaded = false;
+				Asset *asset = backgroundMapAsset;
+				backgroundMapAsset = NULL;
 				const uint64_t realLoadStart = GetTimeNs();
-				if (!ChangeMapByName(gameConfig.backgroundMap))
+				if (!ChangeMapFromAsset(gameConfig.backgroundMap, asset))
 				{
 					LogError("Failed to load background map: %s\n", gameConfig.backgroundMap);
 					dontLoadBackgroundMap = true;
@@ -0,0 +1,324 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/assets/AsyncAssetLoader.h>
+#include <engine/assets/MapLoader.h>
+#include <engine/debug/DPrint.h>
+#include <engine/graphics/RenderingHelpers.h>
+#include <engine/helpers/MapChunkStreamer.h>
+#include <engine/structs/Asset.h>
+#include <engine/structs/Color.h>
+#include <engine/structs/GlobalState.h>
+#include <engine/structs/List.h>
+#include <engine/structs/Map.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/threads/LodThread.h>
+#include <engine/subsystem/threads/PhysicsThread.h>
+#include <engine/subsystem/Timing.h>
+#include <joltc/Math/Vector3.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_thread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum MapChunkStage
+{
+	/// Not loaded, waiting for the camera to come close enough
+	MAP_CHUNK_STAGE_UNLOADED,
+	/// Waiting for the asset loader threads to read and decompress the chunk
+	MAP_CHUNK_STAGE_READING,
+	/// Being built on its own thread
+	MAP_CHUNK_STAGE_BUILDING,
+	/// Attached to the map
+	MAP_CHUNK_STAGE_RESIDENT,
+	/// Failed to load. Kept so that it is not retried every frame.
+	MAP_CHUNK_STAGE_FAILED,
+} MapChunkStage;
+
+typedef struct MapChunk MapChunk;
+
+struct MapChunk
+{
+	char *mapName;
+	/// The position the distance to the chunk is measured from
+	Vector3 position;
+	float loadRadius;
+	float unloadRadius;
+	MapChunkStage stage;
+	AssetLoadTicket ticket;
+	/// The asset being built, owned by the build thread
+	Asset *asset;
+	/// The chunk's map, from @c CreateMapChunk, while it is being built or is resident
+	Map *map;
+	SDL_Thread *thread;
+	/// Set by the build thread once it is done
+	SDL_AtomicInt built;
+	/// Whether the build succeeded, only valid once @c built is set
+	bool buildSucceeded;
+};
+
+static int MapChunkThreadMain(void *data)
+{
+	MapChunk *chunk = data;
+	const uint64_t start = GetTimeNs();
+	chunk->buildSucceeded = LoadMapChunk(chunk->map, chunk->asset);
+	if (chunk->buildSucceeded)
+	{
+		LogDebug("Built map chunk \"%s\" in %.3f ms\n", chunk->mapName, (double)(GetTimeNs() - start) / 1000000.0);
+	} else
+	{
+		LogWarning("Failed to load map chunk \"%s\"\n", chunk->mapName);
+		FreeAsset(chunk->asset);
+	}
+	chunk->asset = NULL;
+	SDL_SetAtomicInt(&chunk->built, 1);
+	return 0;
+}
+
+static void MapChunkAssetLoadedCallback(const AssetLoadTicket /*ticket*/, Asset *asset, void *userData)
+{
+	MapChunk *chunk = userData;
+	chunk->ticket = ASSET_LOAD_TICKET_INVALID;
+	chunk->stage = MAP_CHUNK_STAGE_FAILED;
+	if (asset == NULL)
+	{
+		LogWarning("Failed to read map chunk \"%s\"\n", chunk->mapName);
+		return;
+	}
+
+	chunk->map = CreateMapChunk();
+	chunk->asset = asset;
+	SDL_SetAtomicInt(&chunk->built, 0);
+	chunk->thread = SDL_CreateThread(MapChunkThreadMain, "GameMapChunk", chunk);
+	if (chunk->thread == NULL)
+	{
+		LogWarning("Failed to start a map chunk thread: %s\n", SDL_GetError());
+		DestroyMapChunk(NULL, chunk->map);
+		chunk->map = NULL;
+		FreeAsset(asset);
+	} else
+	{
+		chunk->stage = MAP_CHUNK_STAGE_BUILDING;
+	}
+}
+
+/**
+ * Get the squared distance from a position to a chunk
+ */
+static float GetMapChunkDistanceSquared(const MapChunk *chunk, const Vector3 *position)
+{
+	const float x = position->x - chunk->position.x;
+	const float y = position->y - chunk->position.y;
+	const float z = position->z - chunk->position.z;
+	return (x * x) + (y * y) + (z * z);
+}
+
+/**
+ * Attach a chunk that finished building to its map, with the physics and LOD threads paused
+ */
+static void AttachBuiltMapChunk(Map *map, MapChunk *chunk)
+{
+	PhysicsThreadLockTickMutex();
+	LockLodThreadMutex();
+	AttachMapChunk(map, chunk->map);
+	UnlockLodThreadMutex();
+	PhysicsThreadUnlockTickMutex();
+	chunk->stage = MAP_CHUNK_STAGE_RESIDENT;
+	LogDebug("Attached map chunk \"%s\" with %zu actor(s)\n", chunk->mapName, chunk->map->actors.length);
+}
+
+/**
+ * Detach a resident chunk from its map and free it, with the physics and LOD threads paused
+ */
+static void DetachMapChunk(Map *map, MapChunk *chunk)
+{
+	PhysicsThreadLockTickMutex();
+	LockLodThreadMutex();
+	DestroyMapChunk(map, chunk->map);
+	UnlockLodThreadMutex();
+	PhysicsThreadUnlockTickMutex();
+	chunk->map = NULL;
+	chunk->stage = MAP_CHUNK_STAGE_UNLOADED;
+	LogDebug("Detached map chunk \"%s\"\n", chunk->mapName);
+}
+
+void RegisterMapChunk(Map *map,
+					  const char *chunkMapName,
+					  const Vector3 *position,
+					  const float loadRadius,
+					  const float unloadRadius)
+{
+	for (size_t i = 0; i < map->chunks.length; i++)
+	{
+		const MapChunk *chunk = ListGetPointer(map->chunks, i);
+		if (strcmp(chunk->mapName, chunkMapName) == 0)
+		{
+			return;
+		}
+	}
+	MapChunk *chunk = calloc(1, sizeof(MapChunk));
+	CheckAlloc(chunk);
+	chunk->mapName = strdup(chunkMapName);
+	CheckAlloc(chunk->mapName);
+	chunk->position = *position;
+	chunk->loadRadius = loadRadius;
+	chunk->unloadRadius = unloadRadius > loadRadius ? unloadRadius : loadRadius;
+	chunk->stage = MAP_CHUNK_STAGE_UNLOADED;
+	chunk->ticket = ASSET_LOAD_TICKET_INVALID;
+	ListAdd(map->chunks, chunk);
+}
+
+void UpdateMapChunks(Map *map)
+{
+	if (map->chunks.length == 0)
+	{
+		return;
+	}
+	const GlobalState *state = GetState();
+	const Vector3 *viewPosition = state->camera != NULL ? &state->camera->transform.position
+														: &map->player.transform.position;
+
+	size_t loadsInFlight = 0;
+	for (size_t i = 0; i < map->chunks.length; i++)
+	{
+		const MapChunk *chunk = ListGetPointer(map->chunks, i);
+		if (chunk->stage == MAP_CHUNK_STAGE_READING || chunk->stage == MAP_CHUNK_STAGE_BUILDING)
+		{
+			loadsInFlight++;
+		}
+	}
+
+	bool geometryChanged = false;
+	for (size_t i = 0; i < map->chunks.length; i++)
+	{
+		MapChunk *chunk = ListGetPointer(map->chunks, i);
+		const float distanceSquared = GetMapChunkDistanceSquared(chunk, viewPosition);
+		const bool inLoadRadius = distanceSquared <= chunk->loadRadius * chunk->loadRadius;
+		const bool outOfUnloadRadius = distanceSquared > chunk->unloadRadius * chunk->unloadRadius;
+		switch (chunk->stage)
+		{
+			case MAP_CHUNK_STAGE_UNLOADED:
+				if (inLoadRadius && loadsInFlight < MAX_MAP_CHUNK_LOADS)
+				{
+					chunk->ticket = LoadMapAssetAsync(chunk->mapName, MapChunkAssetLoadedCallback, chunk);
+					chunk->stage = chunk->ticket == ASSET_LOAD_TICKET_INVALID ? MAP_CHUNK_STAGE_FAILED
+																			  : MAP_CHUNK_STAGE_READING;
+					loadsInFlight++;
+				}
+				break;
+			case MAP_CHUNK_STAGE_READING:
+				if (outOfUnloadRadius)
+				{
+					CancelAssetLoad(chunk->ticket);
+					chunk->ticket = ASSET_LOAD_TICKET_INVALID;
+					chunk->stage = MAP_CHUNK_STAGE_UNLOADED;
+				}
+				break;
+			case MAP_CHUNK_STAGE_BUILDING:
+				if (!SDL_GetAtomicInt(&chunk->built))
+				{
+					break;
+				}
+				SDL_WaitThread(chunk->thread, NULL);
+				chunk->thread = NULL;
+				if (!chunk->buildSucceeded)
+				{
+					DestroyMapChunk(NULL, chunk->map);
+					chunk->map = NULL;
+					chunk->stage = MAP_CHUNK_STAGE_FAILED;
+				} else if (outOfUnloadRadius)
+				{
+					// The camera moved away while the chunk was being built
+					DestroyMapChunk(NULL, chunk->map);
+					chunk->map = NULL;
+					chunk->stage = MAP_CHUNK_STAGE_UNLOADED;
+				} else
+				{
+					AttachBuiltMapChunk(map, chunk);
+					geometryChanged = true;
+				}
+				break;
+			case MAP_CHUNK_STAGE_RESIDENT:
+				if (outOfUnloadRadius)
+				{
+					DetachMapChunk(map, chunk);
+					geometryChanged = true;
+				}
+				break;
+			case MAP_CHUNK_STAGE_FAILED:
+			default:
+				break;
+		}
+	}
+
+	if (geometryChanged)
+	{
+		rendererQueuedActions |= QUEUED_ACTION_RELOAD_MAP_GEOMETRY;
+	}
+}
+
+void GetResidentMapChunks(const Map *map, List *chunkMaps)
+{
+	for (size_t i = 0; i < map->chunks.length; i++)
+	{
+		const MapChunk *chunk = ListGetPointer(map->chunks, i);
+		if (chunk->stage == MAP_CHUNK_STAGE_RESIDENT)
+		{
+			ListAdd(*chunkMaps, chunk->map);
+		}
+	}
+}
+
+void DestroyMapChunks(Map *map)
+{
+	for (size_t i = 0; i < map->chunks.length; i++)
+	{
+		MapChunk *chunk = ListGetPointer(map->chunks, i);
+		CancelAssetLoad(chunk->ticket);
+		if (chunk->thread != NULL)
+		{
+			SDL_WaitThread(chunk->thread, NULL);
+		}
+		if (chunk->map != NULL)
+		{
+			DestroyMapChunk(chunk->stage == MAP_CHUNK_STAGE_RESIDENT ? map : NULL, chunk->map);
+		}
+		free(chunk->mapName);
+		free(chunk);
+	}
+	ListClear(map->chunks);
+}
+
+void DPrintMapChunks()
+{
+	const Map *map = GetState()->map;
+	if (map == NULL || map->chunks.length == 0)
+	{
+		DPrintF("Map Chunks: none", COLOR_WHITE);
+		return;
+	}
+	static const char *const stageNames[] = {
+		[MAP_CHUNK_STAGE_UNLOADED] = "unloaded",
+		[MAP_CHUNK_STAGE_READING] = "reading",
+		[MAP_CHUNK_STAGE_BUILDING] = "building",
+		[MAP_CHUNK_STAGE_RESIDENT] = "resident",
+		[MAP_CHUNK_STAGE_FAILED] = "failed",
+	};
+	size_t residentCount = 0;
+	for (size_t i = 0; i < map->chunks.length; i++)
+	{
+		const MapChunk *chunk = ListGetPointer(map->chunks, i);
+		residentCount += chunk->stage == MAP_CHUNK_STAGE_RESIDENT ? 1 : 0;
+	}
+	DPrintF("Map Chunks: %zu/%zu resident", COLOR_WHITE, residentCount, map->chunks.length);
+	for (size_t i = 0; i < map->chunks.length; i++)
+	{
+		const MapChunk *chunk = ListGetPointer(map->chunks, i);
+		DPrintF("%s: %s", COLOR_WHITE, chunk->mapName, stageNames[chunk->stage]);
+	}
+}
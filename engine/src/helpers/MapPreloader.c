@@ -0,0 +1,451 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/assets/AssetManifest.h>
+#include <engine/assets/AsyncAssetLoader.h>
+#include <engine/assets/MapLoader.h>
+#include <engine/debug/DPrint.h>
+#include <engine/helpers/Arguments.h>
+#include <engine/helpers/MapPreloader.h>
+#include <engine/structs/Asset.h>
+#include <engine/structs/Color.h>
+#include <engine/structs/GlobalState.h>
+#include <engine/structs/List.h>
+#include <engine/structs/Map.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/Timing.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_mutex.h>
+#include <SDL3/SDL_thread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum MapPreloadStage
+{
+	/// Requested, but not started yet
+	MAP_PRELOAD_STAGE_REQUESTED,
+	/// Waiting for the asset loader threads to read and decompress the map
+	MAP_PRELOAD_STAGE_READING,
+	/// Being built on its own thread
+	MAP_PRELOAD_STAGE_BUILDING,
+	/// Done, waiting to be taken
+	MAP_PRELOAD_STAGE_READY,
+	/// Failed. Kept so that it is not retried every frame, but does not count toward @c MAX_MAP_PRELOADS.
+	MAP_PRELOAD_STAGE_FAILED,
+	/// Did not fit in the budget. Requested again by @c UpdateMapPreloads once there is room for it.
+	MAP_PRELOAD_STAGE_OVER_BUDGET,
+} MapPreloadStage;
+
+typedef struct MapPreload MapPreload;
+
+struct MapPreload
+{
+	char *mapName;
+	MapPreloadStage stage;
+	/// The last time the map was requested, from @c GetTimeMs
+	uint64_t lastRequestTime;
+	AssetLoadTicket ticket;
+	/// The decompressed size of the map asset, used as an estimate of how much memory the map uses
+	size_t size;
+	/// The asset being built, owned by the build thread
+	Asset *asset;
+	Map *map;
+	SDL_Thread *thread;
+	/// Set by the build thread once it is done
+	SDL_AtomicInt built;
+	/// Whether the build succeeded, only valid once @c built is set
+	bool buildSucceeded;
+};
+
+static bool preloaderEnabled = false;
+/// The most memory preloaded maps may use, in bytes
+static size_t preloadBudget = 0;
+
+/// Protects everything below. Only RequestMapPreload is called off the main thread.
+static SDL_Mutex *preloadMutex = NULL;
+/// Every preload, in the order they were requested
+static List preloads;
+
+/**
+ * Find the preload of a map. preloadMutex must be held.
+ * @return The index of the preload in @c preloads, or -1 if there is none
+ */
+static size_t FindMapPreload(const char *mapName)
+{
+	for (size_t i = 0; i < preloads.length; i++)
+	{
+		const MapPreload *preload = ListGetPointer(preloads, i);
+		if (strcmp(preload->mapName, mapName) == 0)
+		{
+			return i;
+		}
+	}
+	return (size_t)-1;
+}
+
+/**
+ * Whether a preload is in progress or done, as opposed to one that failed or is waiting for room in the budget
+ */
+static bool IsMapPreloadActive(const MapPreload *preload)
+{
+	return preload->stage != MAP_PRELOAD_STAGE_FAILED && preload->stage != MAP_PRELOAD_STAGE_OVER_BUDGET;
+}
+
+/**
+ * Count the preloads that count toward @c MAX_MAP_PRELOADS. preloadMutex must be held.
+ */
+static size_t CountActiveMapPreloads()
+{
+	size_t count = 0;
+	for (size_t i = 0; i < preloads.length; i++)
+	{
+		count += IsMapPreloadActive(ListGetPointer(preloads, i)) ? 1 : 0;
+	}
+	return count;
+}
+
+/**
+ * Cancel or wait for a preload and free it and its map. It must already be removed from @c preloads.
+ */
+static void FreeMapPreload(MapPreload *preload)
+{
+	CancelAssetLoad(preload->ticket);
+	if (preload->thread != NULL)
+	{
+		SDL_WaitThread(preload->thread, NULL);
+	}
+	if (preload->map != NULL)
+	{
+		DestroyMap(preload->map);
+	}
+	free(preload->mapName);
+	free(preload);
+}
+
+static int MapPreloadThreadMain(void *data)
+{
+	MapPreload *preload = data;
+	const uint64_t start = GetTimeNs();
+	preload->buildSucceeded = LoadMapDetached(preload->map, preload->asset);
+	if (preload->buildSucceeded)
+	{
+		LogInfo("Preloaded map \"%s\" in %.3f ms\n", preload->mapName, (double)(GetTimeNs() - start) / 1000000.0);
+	} else
+	{
+		LogWarning("Failed to preload map \"%s\"\n", preload->mapName);
+		FreeAsset(preload->asset);
+	}
+	preload->asset = NULL;
+	SDL_SetAtomicInt(&preload->built, 1);
+	return 0;
+}
+
+/**
+ * Check whether a preload fits in the budget, discarding finished preloads that were requested less recently than it if
+ * that makes it fit. preloadMutex must be held.
+ * @param newPreload The preload to make room for, whose size must be known
+ * @param discard Whether to discard preloads to make room, or only check whether doing so would
+ * @return Whether the preload fits, or would fit once preloads are discarded if @c discard is false
+ */
+static bool MakeRoomForMapPreload(const MapPreload *newPreload, const bool discard)
+{
+	while (true)
+	{
+		size_t usedBytes = 0;
+		size_t discardableBytes = 0;
+		MapPreload *oldest = NULL;
+		for (size_t i = 0; i < preloads.length; i++)
+		{
+			MapPreload *preload = ListGetPointer(preloads, i);
+			if (preload == newPreload)
+			{
+				continue;
+			}
+			if (preload->stage == MAP_PRELOAD_STAGE_BUILDING || preload->stage == MAP_PRELOAD_STAGE_READY)
+			{
+				usedBytes += preload->size;
+			}
+			// Only preloads wanted less recently than the new one make way for it, so two maps can't keep evicting each other
+			if (preload->stage == MAP_PRELOAD_STAGE_READY && preload->lastRequestTime < newPreload->lastRequestTime)
+			{
+				discardableBytes += preload->size;
+				if (oldest == NULL || preload->lastRequestTime < oldest->lastRequestTime)
+				{
+					oldest = preload;
+				}
+			}
+		}
+		if (usedBytes + newPreload->size <= preloadBudget)
+		{
+			return true;
+		}
+		if (usedBytes - discardableBytes + newPreload->size > preloadBudget)
+		{
+			// Discarding would not make enough room, so nothing is discarded for nothing
+			return false;
+		}
+		if (!discard)
+		{
+			return true;
+		}
+		LogDebug("Discarding the preload of map \"%s\" to stay within the preload budget\n", oldest->mapName);
+		ListRemoveAt(preloads, ListFind(preloads, oldest));
+		FreeMapPreload(oldest);
+	}
+}
+
+static void MapPreloadAssetLoadedCallback(const AssetLoadTicket /*ticket*/, Asset *asset, void *userData)
+{
+	MapPreload *preload = userData;
+	SDL_LockMutex(preloadMutex);
+	preload->ticket = ASSET_LOAD_TICKET_INVALID;
+	preload->stage = MAP_PRELOAD_STAGE_FAILED;
+	if (asset == NULL)
+	{
+		SDL_UnlockMutex(preloadMutex);
+		return;
+	}
+	preload->size = asset->size;
+	if (!MakeRoomForMapPreload(preload, true))
+	{
+		LogDebug("Not preloading map \"%s\" yet, since it does not fit in the preload budget\n", preload->mapName);
+		preload->stage = MAP_PRELOAD_STAGE_OVER_BUDGET;
+		FreeAsset(asset);
+		SDL_UnlockMutex(preloadMutex);
+		return;
+	}
+
+	// The map is created here since CreateMap uses the global state, everything after that is done on the thread
+	preload->map = CreateMap();
+	preload->asset = asset;
+	SDL_SetAtomicInt(&preload->built, 0);
+	preload->thread = SDL_CreateThread(MapPreloadThreadMain, "GameMapPreload", preload);
+	if (preload->thread == NULL)
+	{
+		LogWarning("Failed to start a map preload thread: %s\n", SDL_GetError());
+		DestroyMap(preload->map);
+		preload->map = NULL;
+		FreeAsset(asset);
+	} else
+	{
+		preload->stage = MAP_PRELOAD_STAGE_BUILDING;
+	}
+	SDL_UnlockMutex(preloadMutex);
+}
+
+/**
+ * Called for each asset prefetched from a preloaded map's manifest, which is left in the asset cache
+ */
+static void MapPreloadPrefetchCallback(const AssetLoadTicket /*ticket*/, Asset * /*asset*/, void * /*userData*/) {}
+
+void InitMapPreloader()
+{
+	const int budgetMb = GetCliArgInt("--map-preload-budget", DEFAULT_MAP_PRELOAD_BUDGET_MB);
+	preloaderEnabled = budgetMb > 0;
+	preloadBudget = preloaderEnabled ? (size_t)budgetMb * 1024 * 1024 : 0;
+	preloadMutex = SDL_CreateMutex();
+	ListInit(preloads, LIST_POINTER);
+}
+
+void DestroyMapPreloader()
+{
+	if (preloadMutex == NULL)
+	{
+		return;
+	}
+	DiscardMapPreloads(NULL);
+	ListFree(preloads);
+	SDL_DestroyMutex(preloadMutex);
+	preloadMutex = NULL;
+	preloaderEnabled = false;
+}
+
+void RequestMapPreload(const char *mapName)
+{
+	if (!preloaderEnabled)
+	{
+		return;
+	}
+	SDL_LockMutex(preloadMutex);
+	const size_t index = FindMapPreload(mapName);
+	if (index != (size_t)-1)
+	{
+		MapPreload *preload = ListGetPointer(preloads, index);
+		preload->lastRequestTime = GetTimeMs();
+	} else if (CountActiveMapPreloads() < MAX_MAP_PRELOADS)
+	{
+		MapPreload *preload = calloc(1, sizeof(MapPreload));
+		CheckAlloc(preload);
+		preload->mapName = strdup(mapName);
+		CheckAlloc(preload->mapName);
+		preload->stage = MAP_PRELOAD_STAGE_REQUESTED;
+		preload->lastRequestTime = GetTimeMs();
+		preload->ticket = ASSET_LOAD_TICKET_INVALID;
+		ListAdd(preloads, preload);
+	}
+	SDL_UnlockMutex(preloadMutex);
+}
+
+void UpdateMapPreloads()
+{
+	if (!preloaderEnabled)
+	{
+		return;
+	}
+	SDL_LockMutex(preloadMutex);
+	for (size_t i = 0; i < preloads.length; i++)
+	{
+		MapPreload *preload = ListGetPointer(preloads, i);
+		if (preload->stage == MAP_PRELOAD_STAGE_REQUESTED)
+		{
+			preload->ticket = LoadMapAssetAsync(preload->mapName, MapPreloadAssetLoadedCallback, preload);
+			preload->stage = preload->ticket == ASSET_LOAD_TICKET_INVALID ? MAP_PRELOAD_STAGE_FAILED
+																			: MAP_PRELOAD_STAGE_READING;
+			// The assets the map uses are prefetched into the asset cache as well, so that switching to it does not
+			// have to wait for them either
+			List prefetchTickets;
+			ListInit(prefetchTickets, LIST_UINT32);
+			PrefetchMapManifest(preload->mapName, MapPreloadPrefetchCallback, NULL, &prefetchTickets);
+			ListFree(prefetchTickets);
+		} else if (preload->stage == MAP_PRELOAD_STAGE_BUILDING && SDL_GetAtomicInt(&preload->built))
+		{
+			SDL_WaitThread(preload->thread, NULL);
+			preload->thread = NULL;
+			if (preload->buildSucceeded)
+			{
+				preload->stage = MAP_PRELOAD_STAGE_READY;
+			} else
+			{
+				DestroyMap(preload->map);
+				preload->map = NULL;
+				preload->stage = MAP_PRELOAD_STAGE_FAILED;
+			}
+		} else if (preload->stage == MAP_PRELOAD_STAGE_OVER_BUDGET &&
+				   CountActiveMapPreloads() < MAX_MAP_PRELOADS &&
+				   MakeRoomForMapPreload(preload, false))
+		{
+			// Read again rather than kept around, since holding on to the asset would use the memory the budget is for
+			preload->stage = MAP_PRELOAD_STAGE_REQUESTED;
+		}
+	}
+	SDL_UnlockMutex(preloadMutex);
+}
+
+MapPreloadStatus GetMapPreloadStatus(const char *mapName)
+{
+	if (!preloaderEnabled)
+	{
+		return MAP_PRELOAD_NONE;
+	}
+	MapPreloadStatus status = MAP_PRELOAD_NONE;
+	SDL_LockMutex(preloadMutex);
+	const size_t index = FindMapPreload(mapName);
+	if (index != (size_t)-1)
+	{
+		MapPreload *preload = ListGetPointer(preloads, index);
+		preload->lastRequestTime = GetTimeMs();
+		switch (preload->stage)
+		{
+			case MAP_PRELOAD_STAGE_REQUESTED:
+			case MAP_PRELOAD_STAGE_READING:
+			case MAP_PRELOAD_STAGE_BUILDING:
+				status = MAP_PRELOAD_LOADING;
+				break;
+			case MAP_PRELOAD_STAGE_READY:
+				status = MAP_PRELOAD_READY;
+				break;
+			case MAP_PRELOAD_STAGE_FAILED:
+			case MAP_PRELOAD_STAGE_OVER_BUDGET:
+			default:
+				status = MAP_PRELOAD_NONE;
+				break;
+		}
+	}
+	SDL_UnlockMutex(preloadMutex);
+	return status;
+}
+
+Map *TakePreloadedMap(const char *mapName)
+{
+	if (!preloaderEnabled)
+	{
+		return NULL;
+	}
+	Map *map = NULL;
+	SDL_LockMutex(preloadMutex);
+	const size_t index = FindMapPreload(mapName);
+	if (index != (size_t)-1)
+	{
+		MapPreload *preload = ListGetPointer(preloads, index);
+		if (preload->stage == MAP_PRELOAD_STAGE_READY)
+		{
+			map = preload->map;
+			preload->map = NULL;
+			ListRemoveAt(preloads, index);
+			FreeMapPreload(preload);
+		}
+	}
+	SDL_UnlockMutex(preloadMutex);
+	return map;
+}
+
+void DiscardMapPreloads(const char *keepMapName)
+{
+	if (preloadMutex == NULL)
+	{
+		return;
+	}
+	SDL_LockMutex(preloadMutex);
+	for (size_t i = preloads.length; i > 0; i--)
+	{
+		MapPreload *preload = ListGetPointer(preloads, i - 1);
+		if (keepMapName != NULL && strcmp(preload->mapName, keepMapName) == 0)
+		{
+			continue;
+		}
+		ListRemoveAt(preloads, i - 1);
+		FreeMapPreload(preload);
+	}
+	SDL_UnlockMutex(preloadMutex);
+}
+
+void DPrintMapPreloader()
+{
+	if (!preloaderEnabled)
+	{
+		DPrintF("Map Preloader: disabled", COLOR_WHITE);
+		return;
+	}
+	static const char *const stageNames[] = {
+		[MAP_PRELOAD_STAGE_REQUESTED] = "requested",
+		[MAP_PRELOAD_STAGE_READING] = "reading",
+		[MAP_PRELOAD_STAGE_BUILDING] = "building",
+		[MAP_PRELOAD_STAGE_READY] = "ready",
+		[MAP_PRELOAD_STAGE_FAILED] = "failed",
+		[MAP_PRELOAD_STAGE_OVER_BUDGET] = "over budget",
+	};
+	SDL_LockMutex(preloadMutex);
+	size_t usedBytes = 0;
+	for (size_t i = 0; i < preloads.length; i++)
+	{
+		const MapPreload *preload = ListGetPointer(preloads, i);
+		usedBytes += IsMapPreloadActive(preload) ? preload->size : 0;
+	}
+	DPrintF("Map Preloader: %zu/%d maps, %.1f/%zu MiB",
+			COLOR_WHITE,
+			CountActiveMapPreloads(),
+			MAX_MAP_PRELOADS,
+			(double)usedBytes / (1024.0 * 1024.0),
+			preloadBudget / (1024 * 1024));
+	for (size_t i = 0; i < preloads.length; i++)
+	{
+		const MapPreload *preload = ListGetPointer(preloads, i);
+		DPrintF("%s: %s", COLOR_WHITE, preload->mapName, stageNames[preload->stage]);
+	}
+	SDL_UnlockMutex(preloadMutex);
+}
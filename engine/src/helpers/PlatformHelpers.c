@@ -7,13 +7,22 @@
 #include <engine/subsystem/Logging.h>
 #include <SDL3/SDL_video.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <unistd.h>
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #ifdef WIN32
 #include <ctype.h>
 #include <dwmapi.h>
+#include <fileapi.h>
 #include <handleapi.h>
+#include <memoryapi.h>
 #include <minwindef.h>
 #include <processthreadsapi.h>
 #include <SDL3/SDL_properties.h>
@@ -194,3 +203,75 @@ void RestoreFd(const int modifiedFd, int *pipeFds, const int originalFd)
 	close(pipeFds[0]);
 #endif
 }
+
+const void *MapFileReadOnly(const char *path, size_t *size)
+{
+#ifdef WIN32
+	const HANDLE file = CreateFile(path,
+								   GENERIC_READ,
+								   FILE_SHARE_READ,
+								   NULL,
+								   OPEN_EXISTING,
+								   FILE_ATTRIBUTE_NORMAL,
+								   NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return NULL;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+	const HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping == NULL)
+	{
+		return NULL;
+	}
+	// The view keeps the mapping object alive, so the handle can be closed right away
+	const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (data == NULL)
+	{
+		return NULL;
+	}
+	*size = (size_t)fileSize.QuadPart;
+	return data;
+#else
+	const int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return NULL;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0)
+	{
+		close(fd);
+		return NULL;
+	}
+	void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		return NULL;
+	}
+	*size = (size_t)st.st_size;
+	return data;
+#endif
+}
+
+void UnmapFile(const void *data, const size_t size)
+{
+	if (data == NULL)
+	{
+		return;
+	}
+#ifdef WIN32
+	(void)size;
+	UnmapViewOfFile(data);
+#else
+	munmap((void *)data, size);
+#endif
+}
@@ -0,0 +1,94 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/physics/BodyBatch.h>
+
+// Jolt.h must come before any other Jolt header
+#include <Jolt/Jolt.h>
+
+#include <cassert>
+#include <cstddef>
+#include <Jolt/Core/Array.h>
+#include <Jolt/Physics/Body/Body.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <Jolt/Physics/Body/BodyInterface.h>
+#include <Jolt/Physics/EActivation.h>
+
+namespace
+{
+	struct BodyBatch
+	{
+		JPH::BodyInterface *bodyInterface = nullptr;
+		/// The number of batches that have been started on this thread and not ended yet
+		size_t depth = 0;
+		/// The bodies to add and activate
+		JPH::Array<JPH::BodyID> activeBodies;
+		/// The bodies to add without activating them
+		JPH::Array<JPH::BodyID> inactiveBodies;
+	};
+
+	/// Each thread has its own batch, since the map loader and the physics thread can both create bodies
+	thread_local BodyBatch batch;
+
+	void AddBodies(JPH::BodyInterface *bodyInterface, JPH::Array<JPH::BodyID> &bodies, const JPH::EActivation activation)
+	{
+		if (bodies.empty())
+		{
+			return;
+		}
+		const int count = static_cast<int>(bodies.size());
+		const JPH::BodyInterface::AddState state = bodyInterface->AddBodiesPrepare(bodies.data(), count);
+		bodyInterface->AddBodiesFinalize(bodies.data(), count, state, activation);
+		// The capacity is kept, so that later batches on this thread don't have to grow the array again
+		bodies.clear();
+	}
+} // namespace
+
+void BeginBodyBatch(JPH_BodyInterface *bodyInterface)
+{
+	if (batch.depth == 0)
+	{
+		batch.bodyInterface = reinterpret_cast<JPH::BodyInterface *>(bodyInterface);
+	}
+	batch.depth++;
+}
+
+size_t EndBodyBatch()
+{
+	assert(batch.depth > 0);
+	batch.depth--;
+	if (batch.depth > 0)
+	{
+		return 0;
+	}
+	const size_t count = batch.activeBodies.size() + batch.inactiveBodies.size();
+	AddBodies(batch.bodyInterface, batch.activeBodies, JPH::EActivation::Activate);
+	AddBodies(batch.bodyInterface, batch.inactiveBodies, JPH::EActivation::DontActivate);
+	batch.bodyInterface = nullptr;
+	return count;
+}
+
+JPH_BodyID CreateAndAddBody(JPH_BodyInterface *bodyInterface,
+							const JPH_BodyCreationSettings *settings,
+							const JPH_Activation activation)
+{
+	JPH::BodyInterface *joltBodyInterface = reinterpret_cast<JPH::BodyInterface *>(bodyInterface);
+	const JPH::BodyCreationSettings &joltSettings = *reinterpret_cast<const JPH::BodyCreationSettings *>(settings);
+	const bool activate = activation == JPH_Activation_Activate;
+	if (batch.depth == 0 || joltBodyInterface != batch.bodyInterface)
+	{
+		return joltBodyInterface
+				->CreateAndAddBody(joltSettings, activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate)
+				.GetIndexAndSequenceNumber();
+	}
+
+	const JPH::Body *body = joltBodyInterface->CreateBody(joltSettings);
+	if (body == nullptr)
+	{
+		return JPH::BodyID::cInvalidBodyID;
+	}
+	(activate ? batch.activeBodies : batch.inactiveBodies).push_back(body->GetID());
+	return body->GetID().GetIndexAndSequenceNumber();
+}
@@ -0,0 +1,91 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/assets/CookedAssetCache.h>
+#include <engine/Engine.h>
+#include <engine/physics/CookedShapes.h>
+#include <engine/physics/ShapeBinaryState.h>
+#include <inttypes.h>
+#include <joltc/Physics/Collision/Shape/Shape.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <zlib.h>
+
+/// The maximum length of a cooked shape key
+#define MAX_COOKED_SHAPES_KEY_LENGTH 256
+
+/**
+ * Compute the crc32 of the source data of some shapes, which may be larger than zlib's uInt
+ */
+static uint32_t HashShapeSource(const uint8_t *data, const size_t size)
+{
+	return (uint32_t)crc32_z(crc32_z(0L, Z_NULL, 0), data, size);
+}
+
+/**
+ * Build the cooked asset cache key of some shapes. The source data is hashed, so that changed data is never matched.
+ */
+static void BuildCookedShapesKey(const char *kind,
+								 const void *sourceData,
+								 const size_t sourceSize,
+								 const size_t shapeCount,
+								 char key[MAX_COOKED_SHAPES_KEY_LENGTH])
+{
+	snprintf(key,
+			 MAX_COOKED_SHAPES_KEY_LENGTH,
+			 "shapes\n%d\n%.64s\n%zu\n%zu\n%08" PRIx32 "\n" ENGINE_VERSION,
+			 COOKED_SHAPES_VERSION,
+			 kind,
+			 shapeCount,
+			 sourceSize,
+			 HashShapeSource(sourceData, sourceSize));
+}
+
+bool LoadCookedShapes(const char *kind,
+					  const void *sourceData,
+					  const size_t sourceSize,
+					  JPH_Shape **shapes,
+					  const size_t shapeCount)
+{
+	if (!IsCookedAssetCacheEnabled())
+	{
+		return false;
+	}
+	char key[MAX_COOKED_SHAPES_KEY_LENGTH];
+	BuildCookedShapesKey(kind, sourceData, sourceSize, shapeCount, key);
+	size_t size = 0;
+	uint8_t *data = LoadCookedData(key, &size);
+	if (data == NULL)
+	{
+		return false;
+	}
+	const bool restored = RestoreShapesBinaryState(data, size, shapes, shapeCount);
+	free(data);
+	return restored;
+}
+
+void StoreCookedShapes(const char *kind,
+					   const void *sourceData,
+					   const size_t sourceSize,
+					   JPH_Shape *const *shapes,
+					   const size_t shapeCount)
+{
+	if (!IsCookedAssetCacheEnabled())
+	{
+		return;
+	}
+	char key[MAX_COOKED_SHAPES_KEY_LENGTH];
+	BuildCookedShapesKey(kind, sourceData, sourceSize, shapeCount, key);
+	size_t size = 0;
+	uint8_t *data = SaveShapesBinaryState(shapes, shapeCount, &size);
+	if (data == NULL)
+	{
+		return;
+	}
+	StoreCookedData(key, data, size);
+	free(data);
+}
@@ -10,6 +10,7 @@
 #include <engine/physics/PlayerPhysics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
+#include <engine/structs/ActorIoQueue.h>
 #include <engine/structs/ControlOptions.h>
 #include <engine/structs/GameState.h>
 #include <engine/structs/GlobalState.h>
@@ -112,6 +113,9 @@ void MapFixedUpdate(GlobalState *state, const double delta)
 		LogError("Failed to update Jolt physics system with error %d\n", result);
 		Error("Failed to update physics!");
 	}
+
+	// Sent once the actors and physics have updated, so that outputs fired by either are handled on the same tick
+	DispatchActorInputs(state->map, ACTOR_IO_EVENTS_PER_TICK);
 	GetState()->map->physicsTick++;
 
 	// WARNING: Any access to `state->level->actors` with ANY chance of modifying it MUST not happen after this!
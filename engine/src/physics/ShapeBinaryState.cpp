@@ -0,0 +1,186 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/physics/ShapeBinaryState.h>
+
+// Jolt.h must come before any other Jolt header
+#include <Jolt/Jolt.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <Jolt/Core/Reference.h>
+#include <Jolt/Core/StreamIn.h>
+#include <Jolt/Core/StreamOut.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+
+extern "C" {
+#include <engine/subsystem/Logging.h>
+#include <stdlib.h>
+}
+
+namespace
+{
+	/// Written before the shapes, so that data saved by another version of Jolt is rejected instead of misread
+	struct ShapeBinaryStateHeader
+	{
+		uint32_t joltVersion[3];
+		uint64_t shapeCount;
+	};
+
+	/// Writes into a malloc'd buffer, so that it can be handed to C code
+	class BufferStreamOut final : public JPH::StreamOut
+	{
+		public:
+			void WriteBytes(const void *inData, const size_t inNumBytes) override
+			{
+				if (failed)
+				{
+					return;
+				}
+				if (size + inNumBytes > capacity)
+				{
+					const size_t newCapacity = capacity * 2 > size + inNumBytes ? capacity * 2 : size + inNumBytes + 4096;
+					uint8_t *newData = static_cast<uint8_t *>(realloc(data, newCapacity));
+					if (newData == nullptr)
+					{
+						failed = true;
+						return;
+					}
+					data = newData;
+					capacity = newCapacity;
+				}
+				memcpy(data + size, inData, inNumBytes);
+				size += inNumBytes;
+			}
+
+			[[nodiscard]] bool IsFailed() const override
+			{
+				return failed;
+			}
+
+			uint8_t *data = nullptr;
+			size_t size = 0;
+			size_t capacity = 0;
+			bool failed = false;
+	};
+
+	/// Reads from a buffer, failing instead of reading past its end
+	class BufferStreamIn final : public JPH::StreamIn
+	{
+		public:
+			BufferStreamIn(const uint8_t *data, const size_t size): data(data), size(size) {}
+
+			void ReadBytes(void *outData, const size_t inNumBytes) override
+			{
+				if (inNumBytes > size - offset)
+				{
+					memset(outData, 0, inNumBytes);
+					offset = size;
+					eof = true;
+					return;
+				}
+				memcpy(outData, data + offset, inNumBytes);
+				offset += inNumBytes;
+			}
+
+			/// Like @c std::istream, this is only set once a read went past the end
+			[[nodiscard]] bool IsEOF() const override
+			{
+				return eof;
+			}
+
+			[[nodiscard]] bool IsFailed() const override
+			{
+				return eof;
+			}
+
+		private:
+			const uint8_t *data;
+			size_t size;
+			size_t offset = 0;
+			bool eof = false;
+	};
+} // namespace
+
+uint8_t *SaveShapesBinaryState(JPH_Shape *const *shapes, const size_t shapeCount, size_t *size)
+{
+	BufferStreamOut stream;
+	const ShapeBinaryStateHeader header = {
+		.joltVersion = {JPH_VERSION_MAJOR, JPH_VERSION_MINOR, JPH_VERSION_PATCH},
+		.shapeCount = shapeCount,
+	};
+	stream.Write(header);
+
+	// Shared between all shapes, so that a child used by several of them is only saved once
+	JPH::Shape::ShapeToIDMap shapeMap;
+	JPH::Shape::MaterialToIDMap materialMap;
+	for (size_t i = 0; i < shapeCount; i++)
+	{
+		const bool hasShape = shapes[i] != nullptr;
+		stream.Write(hasShape);
+		if (hasShape)
+		{
+			reinterpret_cast<const JPH::Shape *>(shapes[i])->SaveWithChildren(stream, shapeMap, materialMap);
+		}
+	}
+	if (stream.IsFailed())
+	{
+		free(stream.data);
+		return nullptr;
+	}
+	*size = stream.size;
+	return stream.data;
+}
+
+bool RestoreShapesBinaryState(const uint8_t *data, const size_t size, JPH_Shape **shapes, const size_t shapeCount)
+{
+	BufferStreamIn stream(data, size);
+	ShapeBinaryStateHeader header{};
+	stream.Read(header);
+	if (stream.IsFailed() ||
+		header.joltVersion[0] != JPH_VERSION_MAJOR ||
+		header.joltVersion[1] != JPH_VERSION_MINOR ||
+		header.joltVersion[2] != JPH_VERSION_PATCH ||
+		header.shapeCount != shapeCount)
+	{
+		return false;
+	}
+
+	JPH::Shape::IDToShapeMap shapeMap;
+	JPH::Shape::IDToMaterialMap materialMap;
+	JPH::Array<JPH::Ref<JPH::Shape>> restoredShapes(shapeCount);
+	for (size_t i = 0; i < shapeCount; i++)
+	{
+		bool hasShape = false;
+		stream.Read(hasShape);
+		if (stream.IsFailed())
+		{
+			return false;
+		}
+		if (!hasShape)
+		{
+			continue;
+		}
+		const JPH::Shape::ShapeResult result = JPH::Shape::sRestoreWithChildren(stream, shapeMap, materialMap);
+		if (result.HasError())
+		{
+			LogWarning("Failed to restore a cooked shape: %s\n", result.GetError().c_str());
+			return false;
+		}
+		restoredShapes[i] = result.Get();
+	}
+
+	// Like the joltc create functions, each shape is handed out with a reference that JPH_Shape_Destroy releases
+	for (size_t i = 0; i < shapeCount; i++)
+	{
+		JPH::Shape *shape = restoredShapes[i].GetPtr();
+		if (shape != nullptr)
+		{
+			shape->AddRef();
+		}
+		shapes[i] = reinterpret_cast<JPH_Shape *>(shape);
+	}
+	return true;
+}
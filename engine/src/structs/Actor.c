@@ -3,13 +3,19 @@
 //
 
 #include <assert.h>
+#include <engine/assets/GameConfigLoader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
+#include <engine/structs/ActorIoQueue.h>
+#include <engine/structs/ActorPool.h>
+#include <engine/structs/Atom.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/List.h>
+#include <engine/structs/MapArena.h>
 #include <engine/structs/Map.h>
 #include <engine/subsystem/Error.h>
 #include <engine/subsystem/Logging.h>
@@ -21,6 +27,7 @@
 #include <joltc/Physics/Body/BodyID.h>
 #include <joltc/Physics/Body/BodyInterface.h>
 #include <joltc/Physics/Collision/Shape/Shape.h>
+#include <SDL3/SDL_atomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -31,8 +38,18 @@ static uint64_t actorId;
 
 Actor *CreateActor(Transform *transform, const char *actorType, KvList params, JPH_BodyInterface *bodyInterface)
 {
-	Actor *actor = calloc(1, sizeof(Actor));
-	CheckAlloc(actor);
+	return CreateActorInArena(transform, actorType, params, bodyInterface, NULL);
+}
+
+Actor *CreateActorInArena(Transform *transform,
+						  const char *actorType,
+						  KvList params,
+						  JPH_BodyInterface *bodyInterface,
+						  MapArena *arena)
+{
+	Actor *actor = AllocPooledActor();
+	actor->arena = arena;
+	actor->mapIndex = SIZE_MAX;
 	// Simply incrementing this is fine, because if one actor were loaded every nanosecond it would take ~585 years to overflow
 	actor->id = actorId++;
 	actor->definition = GetActorDefinition(actorType);
@@ -41,9 +58,14 @@ Actor *CreateActor(Transform *transform, const char *actorType, KvList params, J
 	actor->bodyInterface = bodyInterface;
 	actor->bodyId = JPH_BodyId_InvalidBodyID;
 	ListInit(actor->ioConnections, LIST_POINTER);
+	actor->outputLinks = NULL;
+	actor->outputLinkStarts = NULL;
+	actor->outputLinkGeneration = -1;
+	actor->removed = false;
+	actor->name = ATOM_NONE;
 
 	actor->definition->Init(actor, params, transform); // kindly allow the Actor to initialize itself
-	ActorFireOutput(actor, ACTOR_OUTPUT_SPAWNED, PARAM_NONE);
+	ActorFireOutputId(actor, ACTOR_OUTPUT_SPAWNED_ID, PARAM_NONE);
 
 	if (params)
 	{
@@ -57,11 +79,11 @@ void FreeActor(Actor *actor)
 	actor->definition->Destroy(actor);
 	if (!actor->hasModel && actor->wall != NULL)
 	{
-		free(actor->wall->texture);
-		free(actor->wall);
+		ActorFree(actor, actor->wall->texture);
+		ActorFree(actor, actor->wall);
 		actor->wall = NULL;
 	}
-	free(actor->extraData);
+	ReleaseActorBlock(actor->definition->extraDataPool, actor->extraData);
 	actor->extraData = NULL;
 	if (actor->bodyId != JPH_BodyId_InvalidBodyID && actor->bodyInterface != NULL)
 	{
@@ -73,14 +95,15 @@ void FreeActor(Actor *actor)
 		DestroyActorConnection(connection);
 	}
 	ListFree(actor->ioConnections);
-	free(actor);
+	free(actor->outputLinks);
+	free(actor->outputLinkStarts);
+	ReleasePooledActor(actor);
 	actor = NULL;
 }
 
 void ActorTriggerInput(const Actor *sender, Actor *receiver, const char *input, const Param *param)
 {
-	LogDebug("Triggering input \"%s\" on actor %p from actor %p\n", input, receiver, sender);
-	const ActorInputHandlerFunction handler = GetActorInputHandler(receiver->definition, input);
+	const ActorInputHandlerFunction handler = GetActorInputHandler(receiver->definition, FindAtom(input));
 	if (handler)
 	{
 		handler(receiver, sender, param);
@@ -92,56 +115,138 @@ void ActorTriggerInput(const Actor *sender, Actor *receiver, const char *input,
 
 void ActorFireOutput(Actor *sender, const char *output, const Param defaultParam)
 {
+	const ActorOutputId outputId = GetActorOutputId(sender->definition, FindAtom(output));
+	if (outputId == ACTOR_OUTPUT_INVALID)
+	{
+		LogWarning("Tried to fire output \"%s\" from a %s, which does not have it!\n",
+				   output,
+				   sender->definition->className);
+		return;
+	}
+	ActorFireOutputId(sender, outputId, defaultParam);
+}
+
+/**
+ * Destroy the connections of an actor that ran out of refires
+ */
+static void RemoveSpentActorConnections(Actor *actor)
+{
+	for (size_t i = actor->ioConnections.length; i > 0; i--)
+	{
+		ActorConnection *connection = ListGetPointer(actor->ioConnections, i - 1);
+		if (connection->spent)
+		{
+			// get vaporized idiot
+			DestroyActorConnection(connection);
+			ListRemoveAt(actor->ioConnections, i - 1);
+		}
+	}
+	actor->outputLinkGeneration = -1;
+}
+
+void ActorFireOutputId(Actor *sender, const ActorOutputId output, const Param defaultParam)
+{
+	ActorFireOutputIdDelayed(sender, output, defaultParam, 0);
+}
+
+void ActorFireOutputIdDelayed(Actor *sender,
+							  const ActorOutputId output,
+							  const Param defaultParam,
+							  const uint32_t delayTicks)
+{
+	Map *map = GetState()->map;
+	if (map == NULL)
+	{
+		return;
+	}
 	ListLock(sender->ioConnections);
-	for (size_t i = 0; i < sender->ioConnections.length; i++)
+	if (sender->outputLinkGeneration != SDL_GetAtomicInt(&map->ioLinkGeneration))
+	{
+		LinkActorOutputs(sender, map);
+	}
+	if (sender->outputLinkStarts == NULL || output >= sender->definition->outputCount)
+	{
+		ListUnlock(sender->ioConnections);
+		return;
+	}
+
+	bool connectionSpent = false;
+	for (size_t i = sender->outputLinkStarts[output]; i < sender->outputLinkStarts[output + 1]; i++)
 	{
-		ActorConnection *connection = ListGetPointer(sender->ioConnections, i);
-		if (strcmp(connection->sourceActorOutput, output) == 0)
+		const ActorOutputLink *link = &sender->outputLinks[i];
+		ActorConnection *connection = link->connection;
+		if (connection->spent)
+		{
+			continue;
+		}
+		if (link->handler != NULL && !link->target->removed)
 		{
-			List actors;
-			GetActorsByName(connection->targetActorName, GetState()->map, &actors);
-			if (actors.length == 0)
+			const Param *param = &defaultParam;
+			if (connection->outParamOverride.type != PARAM_TYPE_NONE)
 			{
-				LogWarning("Tried to fire signal to actor %s, but it was not found!\n", connection->targetActorName);
-			} else
+				param = &connection->outParamOverride;
+			}
+			if (!QueueActorInput(&map->ioQueue, sender, link->target, link->handler, param, map->physicsTick, delayTicks))
 			{
-				for (size_t j = 0; j < actors.length; j++)
-				{
-					Actor *actor = ListGetPointer(actors, j);
-					const Param *param = &defaultParam;
-					if (connection->outParamOverride.type != PARAM_TYPE_NONE)
-					{
-						param = &connection->outParamOverride;
-					}
-					ActorTriggerInput(sender, actor, connection->targetActorInput, param);
-				}
-				ListFree(actors);
+				LogWarning("Dropped input \"%s\" sent to %s from %s, since its chain of inputs went past the depth limit "
+						   "of %u\n",
+						   AtomString(connection->targetActorInput),
+						   AtomString(connection->targetActorName),
+						   sender->definition->className,
+						   gameConfig.actorIoChainDepthLimit);
 			}
+		}
 
-			// connections that have 0 refires at this point have infinite refires
-			if (connection->numRefires > 0)
+		// connections that have 0 refires at this point have infinite refires
+		if (link->lastOfConnection && connection->numRefires > 0)
+		{
+			connection->numRefires--;
+			if (connection->numRefires == 0)
 			{
-				connection->numRefires--;
-				if (connection->numRefires == 0)
-				{
-					// get vaporized idiot
-					DestroyActorConnection(connection);
-					ListRemoveAt(sender->ioConnections, i);
-				}
+				connection->spent = true;
+				connectionSpent = true;
 			}
 		}
 	}
+	if (connectionSpent)
+	{
+		RemoveSpentActorConnections(sender);
+	}
 	ListUnlock(sender->ioConnections);
 }
 
+void InvalidateActorOutputLinks(Actor *actor)
+{
+	actor->outputLinkGeneration = -1;
+}
+
 void DestroyActorConnection(ActorConnection *connection)
 {
-	free(connection->targetActorName);
-	free(connection->sourceActorOutput);
-	free(connection->targetActorInput);
 	FreeParam(&connection->outParamOverride);
-	free(connection);
+	MapArenaFree(connection);
+}
+
+void *ActorAllocExtraData(Actor *this, const size_t size)
+{
+	this->extraData = AllocActorBlock(this->definition->extraDataPool, size);
+	return this->extraData;
+}
+
+void *ActorAlloc(const Actor *this, const size_t size)
+{
+	return MapArenaAllocFreeable(this->arena, size);
+}
+
+char *ActorStrdup(const Actor *this, const char *string)
+{
+	return MapArenaStrdupFreeable(this->arena, string);
+}
+
+void ActorFree(const Actor * /*this*/, void *pointer)
+{
+	MapArenaFree(pointer);
 }
+
 void DefaultActorUpdate(Actor * /*this*/, double /*delta*/) {}
 
 void ActorSignalKill(Actor *this, const Actor * /*sender*/, const Param * /*param*/)
@@ -169,9 +274,7 @@ void ActorCreateEmptyBody(Actor *this, const Transform *transform)
 																						  JPH_MotionType_Static,
 																						  OBJECT_LAYER_STATIC,
 																						  this);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_DontActivate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_DontActivate);
 	JPH_ShapeSettings_Destroy(shapeSettings);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
@@ -12,6 +12,7 @@
 #include <engine/actor/logic/LogicBinary.h>
 #include <engine/actor/logic/LogicCounter.h>
 #include <engine/actor/logic/LogicDecimal.h>
+#include <engine/actor/MapChunk.h>
 #include <engine/actor/prop/Button.h>
 #include <engine/actor/prop/PhysicsModel.h>
 #include <engine/actor/prop/Sprite.h>
@@ -22,17 +23,21 @@
 #include <engine/actor/TriggerMap.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
+#include <engine/structs/ActorPool.h>
+#include <engine/structs/Atom.h>
 #include <engine/subsystem/Error.h>
 #include <engine/subsystem/Logging.h>
 #include <stddef.h>
+#include <stdlib.h>
 
 static ActorDefinitionDict actorDefinitions;
 
 void RegisterActor(const char *actorTypeName, ActorDefinition *definition)
 {
 	// Please don't be bad.
-	assert(ActorDefinitionDict_get(actorDefinitions, actorTypeName) == NULL); // Actor name already registered
 	assert(actorTypeName != NULL);
+	const Atom actorType = Intern(actorTypeName);
+	assert(ActorDefinitionDict_get(actorDefinitions, actorType) == NULL); // Actor name already registered
 	assert(definition != NULL);
 	assert(definition->Update != NULL);
 	assert(definition->OnPlayerContactAdded != NULL);
@@ -53,7 +58,9 @@ void RegisterActor(const char *actorTypeName, ActorDefinition *definition)
 	}
 #endif
 	definition->className = actorTypeName;
-	ActorDefinitionDict_set_at(actorDefinitions, actorTypeName, definition);
+	definition->extraDataPool = calloc(1, sizeof(ActorBlockPool));
+	CheckAlloc(definition->extraDataPool);
+	ActorDefinitionDict_set_at(actorDefinitions, actorType, definition);
 }
 
 void RegisterActorInput(ActorDefinition *definition, const char *name, const ActorInputHandlerFunction handler)
@@ -61,22 +68,44 @@ void RegisterActorInput(ActorDefinition *definition, const char *name, const Act
 	assert(definition != NULL);
 	assert(handler != NULL);
 	assert(name != NULL);
-	assert(ActorInputHandlerFunctionDict_get(definition->inputHandlers, name) ==
+	const Atom input = Intern(name);
+	assert(ActorInputHandlerFunctionDict_get(definition->inputHandlers, input) ==
 		   NULL); // Signal name already registered
-	ActorInputHandlerFunctionDict_set_at(definition->inputHandlers, name, handler);
+	ActorInputHandlerFunctionDict_set_at(definition->inputHandlers, input, handler);
 }
 
 void UnregisterActorInput(ActorDefinition *definition, const char *name)
 {
 	assert(definition != NULL);
 	assert(name != NULL);
-	ActorInputHandlerFunctionDict_erase(definition->inputHandlers, name);
+	ActorInputHandlerFunctionDict_erase(definition->inputHandlers, Intern(name));
+}
+
+ActorOutputId RegisterActorOutput(ActorDefinition *definition, const char *name)
+{
+	assert(definition != NULL);
+	assert(name != NULL);
+	const Atom output = Intern(name);
+	assert(ActorOutputIdDict_get(definition->outputIds, output) == NULL); // Output name already registered
+	const ActorOutputId id = definition->outputCount;
+	ActorOutputIdDict_set_at(definition->outputIds, output, id);
+	definition->outputCount++;
+	return id;
 }
 
 void RegisterDefaultActorInputs(ActorDefinition *definition)
 {
 	ActorInputHandlerFunctionDict_init(definition->inputHandlers);
 	RegisterActorInput(definition, ACTOR_INPUT_KILL, ActorSignalKill);
+
+	ActorOutputIdDict_init(definition->outputIds);
+	definition->outputCount = 0;
+	const ActorOutputId spawnedOutput = RegisterActorOutput(definition, ACTOR_OUTPUT_SPAWNED);
+	const ActorOutputId killedOutput = RegisterActorOutput(definition, ACTOR_OUTPUT_KILLED);
+	assert(spawnedOutput == ACTOR_OUTPUT_SPAWNED_ID);
+	assert(killedOutput == ACTOR_OUTPUT_KILLED_ID);
+	(void)spawnedOutput;
+	(void)killedOutput;
 }
 
 void RegisterActors(const RegisterGameActorsFunction RegisterGameActors)
@@ -101,13 +130,14 @@ void RegisterActors(const RegisterGameActorsFunction RegisterGameActors)
 	RegisterTriggerMap();
 	RegisterEntrance();
 	RegisterWorldText();
+	RegisterMapChunkActor();
 
 	RegisterGameActors();
 }
 
 const ActorDefinition *GetActorDefinition(const char *actorType)
 {
-	ActorDefinition **definition = ActorDefinitionDict_get(actorDefinitions, actorType);
+	ActorDefinition **definition = ActorDefinitionDict_get(actorDefinitions, FindAtom(actorType));
 	if (definition == NULL)
 	{
 		Error("Unknown actor type!");
@@ -115,7 +145,7 @@ const ActorDefinition *GetActorDefinition(const char *actorType)
 	return *definition;
 }
 
-ActorInputHandlerFunction GetActorInputHandler(const ActorDefinition *definition, const char *input)
+ActorInputHandlerFunction GetActorInputHandler(const ActorDefinition *definition, const Atom input)
 {
 	const ActorInputHandlerFunction *handler = ActorInputHandlerFunctionDict_get(definition->inputHandlers, input);
 	if (handler == NULL)
@@ -125,6 +155,16 @@ ActorInputHandlerFunction GetActorInputHandler(const ActorDefinition *definition
 	return *handler;
 }
 
+ActorOutputId GetActorOutputId(const ActorDefinition *definition, const Atom output)
+{
+	const ActorOutputId *id = ActorOutputIdDict_get(definition->outputIds, output);
+	if (id == NULL)
+	{
+		return ACTOR_OUTPUT_INVALID;
+	}
+	return *id;
+}
+
 void DestroyActorDefinitions()
 {
 	ActorDefinitionDict_iterator it;
@@ -133,6 +173,10 @@ void DestroyActorDefinitions()
 	{
 		const ActorDefinitionDict_pair *pair = ActorDefinitionDict_ref(it);
 		ActorInputHandlerFunctionDict_clear(pair->value->inputHandlers);
+		ActorOutputIdDict_clear(pair->value->outputIds);
+		DestroyActorBlockPool(pair->value->extraDataPool);
+		free(pair->value->extraDataPool);
+		pair->value->extraDataPool = NULL;
 		ActorDefinitionDict_next(it);
 	}
 
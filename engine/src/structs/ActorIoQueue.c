@@ -0,0 +1,339 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <assert.h>
+#include <engine/assets/GameConfigLoader.h>
+#include <engine/structs/Actor.h>
+#include <engine/structs/ActorIoQueue.h>
+#include <engine/structs/ActorPool.h>
+#include <engine/structs/Atom.h>
+#include <engine/structs/KVList.h>
+#include <engine/structs/Map.h>
+#include <engine/subsystem/Error.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_thread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Get the smallest capacity that holds a number of inputs, which is always a power of two
+ */
+static size_t GetActorIoQueueCapacity(const size_t capacity, const size_t count)
+{
+	size_t newCapacity = capacity != 0 ? capacity : ACTOR_IO_QUEUE_INITIAL_CAPACITY;
+	while (newCapacity < count)
+	{
+		newCapacity *= 2;
+	}
+	return newCapacity;
+}
+
+/**
+ * Make room for more inputs in the ring buffer and the delayed input heap. The queue must be locked.
+ * The lock is dropped while allocating, so that the physics thread is never left spinning on an allocation, which means
+ * anything read from the queue before this must be read again after it.
+ * @param count The number of inputs to make room for in the ring buffer
+ * @param delayedCount The number of inputs to make room for in the delayed input heap
+ */
+static void ReserveActorInputs(ActorIoQueue *queue, const size_t count, const size_t delayedCount)
+{
+	while (queue->count + count > queue->capacity || queue->delayedCount + delayedCount > queue->delayedCapacity)
+	{
+		const size_t capacity = queue->capacity;
+		const size_t delayedCapacity = queue->delayedCapacity;
+		const size_t newCapacity = capacity >= queue->count + count
+										   ? capacity
+										   : GetActorIoQueueCapacity(capacity, queue->count + count);
+		const size_t newDelayedCapacity = delayedCapacity >= queue->delayedCount + delayedCount
+												  ? delayedCapacity
+												  : GetActorIoQueueCapacity(delayedCapacity,
+																			queue->delayedCount + delayedCount);
+		SDL_UnlockSpinlock(&queue->lock);
+		ActorIoEvent *events = NULL;
+		ActorIoEvent *delayedEvents = NULL;
+		if (newCapacity != capacity)
+		{
+			events = malloc(sizeof(ActorIoEvent) * newCapacity);
+			CheckAlloc(events);
+		}
+		if (newDelayedCapacity != delayedCapacity)
+		{
+			delayedEvents = malloc(sizeof(ActorIoEvent) * newDelayedCapacity);
+			CheckAlloc(delayedEvents);
+		}
+		SDL_LockSpinlock(&queue->lock);
+
+		if (queue->capacity != capacity || queue->delayedCapacity != delayedCapacity)
+		{
+			// Another thread grew the queue in the meantime, so start over from what it did
+			free(events);
+			free(delayedEvents);
+			continue;
+		}
+		if (events != NULL)
+		{
+			// Unwrapped while copying, so that the oldest input ends up first
+			const size_t headCount = queue->capacity - queue->head;
+			const size_t firstCount = queue->count < headCount ? queue->count : headCount;
+			if (queue->count > 0)
+			{
+				memcpy(events, queue->events + queue->head, sizeof(ActorIoEvent) * firstCount);
+				memcpy(events + firstCount, queue->events, sizeof(ActorIoEvent) * (queue->count - firstCount));
+			}
+			free(queue->events);
+			queue->events = events;
+			queue->capacity = newCapacity;
+			queue->head = 0;
+		}
+		if (delayedEvents != NULL)
+		{
+			if (queue->delayedCount > 0)
+			{
+				memcpy(delayedEvents, queue->delayedEvents, sizeof(ActorIoEvent) * queue->delayedCount);
+			}
+			free(queue->delayedEvents);
+			queue->delayedEvents = delayedEvents;
+			queue->delayedCapacity = newDelayedCapacity;
+		}
+	}
+}
+
+/**
+ * Add an input to the end of the ring buffer, which must have room for it
+ */
+static void PushActorInput(ActorIoQueue *queue, const ActorIoEvent *event)
+{
+	assert(queue->count < queue->capacity);
+	// The capacity is always a power of two
+	queue->events[(queue->head + queue->count) & (queue->capacity - 1)] = *event;
+	queue->count++;
+}
+
+/**
+ * Free the param of an input, unless it is an interned string
+ */
+static void FreeActorIoEventParam(ActorIoEvent *event)
+{
+	if (event->param.type != PARAM_TYPE_STRING)
+	{
+		FreeParam(&event->param);
+	}
+}
+
+/**
+ * Whether a delayed input is due before another
+ */
+static bool ActorInputDueBefore(const ActorIoEvent *a, const ActorIoEvent *b)
+{
+	return a->fireTick < b->fireTick || (a->fireTick == b->fireTick && a->sequence < b->sequence);
+}
+
+/**
+ * Add an input to the delayed input heap, which must have room for it
+ */
+static void PushDelayedActorInput(ActorIoQueue *queue, const ActorIoEvent *event)
+{
+	assert(queue->delayedCount < queue->delayedCapacity);
+	size_t index = queue->delayedCount;
+	queue->delayedCount++;
+	while (index > 0)
+	{
+		const size_t parent = (index - 1) / 2;
+		if (!ActorInputDueBefore(event, &queue->delayedEvents[parent]))
+		{
+			break;
+		}
+		queue->delayedEvents[index] = queue->delayedEvents[parent];
+		index = parent;
+	}
+	queue->delayedEvents[index] = *event;
+}
+
+/**
+ * Remove the delayed input that is due first from the heap
+ */
+static void PopDelayedActorInput(ActorIoQueue *queue)
+{
+	queue->delayedCount--;
+	const ActorIoEvent last = queue->delayedEvents[queue->delayedCount];
+	size_t index = 0;
+	while (true)
+	{
+		size_t child = (index * 2) + 1;
+		if (child >= queue->delayedCount)
+		{
+			break;
+		}
+		if (child + 1 < queue->delayedCount &&
+			ActorInputDueBefore(&queue->delayedEvents[child + 1], &queue->delayedEvents[child]))
+		{
+			child++;
+		}
+		if (!ActorInputDueBefore(&queue->delayedEvents[child], &last))
+		{
+			break;
+		}
+		queue->delayedEvents[index] = queue->delayedEvents[child];
+		index = child;
+	}
+	queue->delayedEvents[index] = last;
+}
+
+/**
+ * Move the delayed inputs that are due to the ring buffer. The queue must be locked.
+ */
+static void PromoteDueActorInputs(ActorIoQueue *queue, const uint64_t tick)
+{
+	while (queue->delayedCount > 0 && queue->delayedEvents[0].fireTick <= tick)
+	{
+		if (queue->count == queue->capacity)
+		{
+			// The lock is dropped while growing, so the heap has to be checked again
+			ReserveActorInputs(queue, 1, 0);
+			continue;
+		}
+		PushActorInput(queue, &queue->delayedEvents[0]);
+		PopDelayedActorInput(queue);
+	}
+}
+
+/**
+ * Take the oldest input out of the ring buffer, and make it the one being dispatched
+ * @return Whether there was an input
+ */
+static bool PopActorInput(ActorIoQueue *queue, ActorIoEvent *event)
+{
+	SDL_LockSpinlock(&queue->lock);
+	if (queue->count == 0)
+	{
+		SDL_UnlockSpinlock(&queue->lock);
+		return false;
+	}
+	*event = queue->events[queue->head];
+	queue->head = (queue->head + 1) & (queue->capacity - 1);
+	queue->count--;
+	queue->dispatchChainDepth = event->chainDepth;
+	SDL_UnlockSpinlock(&queue->lock);
+	return true;
+}
+
+bool QueueActorInput(ActorIoQueue *queue,
+					 const Actor *sender,
+					 Actor *target,
+					 const ActorInputHandlerFunction handler,
+					 const Param *param,
+					 const uint64_t tick,
+					 const uint32_t delayTicks)
+{
+	ActorIoEvent event = {
+		.sender = sender->handle,
+		.target = target->handle,
+		.handler = handler,
+		.fireTick = tick + delayTicks,
+	};
+	if (param->type == PARAM_TYPE_STRING)
+	{
+		// Interned instead of copied, so that the event does not own any memory. Outputs almost always send the same
+		// few strings from the map, so interning rarely adds anything.
+		event.param.type = PARAM_TYPE_STRING;
+		event.param.stringValue = (char *)AtomString(Intern(param->stringValue));
+	} else
+	{
+		// Copied outside of the lock, since arrays and KV lists have to allocate
+		CopyParam(param, &event.param);
+	}
+
+	SDL_LockSpinlock(&queue->lock);
+	// A delay breaks the chain, so that actors can keep firing each other on purpose, like a clock
+	if (delayTicks == 0 && queue->dispatchThread == SDL_GetCurrentThreadID())
+	{
+		event.chainDepth = queue->dispatchChainDepth + 1;
+		if (gameConfig.actorIoChainDepthLimit != 0 && event.chainDepth > gameConfig.actorIoChainDepthLimit)
+		{
+			queue->chainDepthDrops++;
+			SDL_UnlockSpinlock(&queue->lock);
+			FreeActorIoEventParam(&event);
+			return false;
+		}
+	}
+	ReserveActorInputs(queue, delayTicks == 0 ? 1 : 0, delayTicks == 0 ? 0 : 1);
+	event.sequence = queue->nextSequence;
+	queue->nextSequence++;
+	if (delayTicks == 0)
+	{
+		PushActorInput(queue, &event);
+	} else
+	{
+		PushDelayedActorInput(queue, &event);
+	}
+	SDL_UnlockSpinlock(&queue->lock);
+	return true;
+}
+
+size_t DispatchActorInputs(Map *map, const size_t budget)
+{
+	ActorIoQueue *queue = &map->ioQueue;
+	SDL_LockSpinlock(&queue->lock);
+	PromoteDueActorInputs(queue, map->physicsTick);
+	queue->dispatchThread = SDL_GetCurrentThreadID();
+	SDL_UnlockSpinlock(&queue->lock);
+
+	SDL_AddAtomicInt(&map->ioDispatchDepth, 1);
+	size_t dispatched = 0;
+	ActorIoEvent event;
+	while (dispatched < budget && PopActorInput(queue, &event))
+	{
+		// Actors removed by an earlier input are kept until the dispatch finishes, so they can still be checked here
+		Actor *target = GetActorFromHandle(event.target);
+		if (target != NULL && !target->removed)
+		{
+			event.handler(target, GetActorFromHandle(event.sender), &event.param);
+		}
+		FreeActorIoEventParam(&event);
+		dispatched++;
+	}
+
+	SDL_LockSpinlock(&queue->lock);
+	queue->dispatchThread = 0;
+	queue->dispatchChainDepth = 0;
+	queue->dispatchedLastTick = dispatched;
+	if (queue->count > 0)
+	{
+		queue->overBudgetTicks++;
+	}
+	SDL_UnlockSpinlock(&queue->lock);
+
+	// SDL_AddAtomicInt returns the value from before the add
+	if (SDL_AddAtomicInt(&map->ioDispatchDepth, -1) == 1)
+	{
+		FreeRemovedActors(map);
+	}
+	return dispatched;
+}
+
+size_t GetQueuedActorInputCount(ActorIoQueue *queue)
+{
+	SDL_LockSpinlock(&queue->lock);
+	const size_t count = queue->count + queue->delayedCount;
+	SDL_UnlockSpinlock(&queue->lock);
+	return count;
+}
+
+void DestroyActorIoQueue(ActorIoQueue *queue)
+{
+	for (size_t i = 0; i < queue->count; i++)
+	{
+		FreeActorIoEventParam(&queue->events[(queue->head + i) & (queue->capacity - 1)]);
+	}
+	for (size_t i = 0; i < queue->delayedCount; i++)
+	{
+		FreeActorIoEventParam(&queue->delayedEvents[i]);
+	}
+	free(queue->events);
+	free(queue->delayedEvents);
+	memset(queue, 0, sizeof(ActorIoQueue));
+}
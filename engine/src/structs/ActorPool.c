@@ -0,0 +1,274 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <assert.h>
+#include <engine/structs/Actor.h>
+#include <engine/structs/ActorPool.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <SDL3/SDL_atomic.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ACTOR_HANDLE_INDEX_MASK ((UINT64_C(1) << ACTOR_HANDLE_INDEX_BITS) - 1)
+#define ACTOR_POOL_SLAB_COUNT (MAX_POOLED_ACTORS / ACTOR_POOL_SLAB_SIZE)
+#define ACTOR_BLOCK_ALIGNMENT alignof(max_align_t)
+
+typedef struct ActorPoolSlot
+{
+	Actor actor;
+	/// The generation of handles to the slot's current actor. Bumped when the actor is freed, never 0, and never bumped
+	/// past @c ACTOR_HANDLE_MAX_GENERATION.
+	SDL_AtomicU32 generation;
+	/// The index of the next free slot plus one, or 0 if this is the last one. Only used while the slot is free.
+	uint32_t nextFree;
+} ActorPoolSlot;
+
+struct ActorBlockSlab
+{
+	ActorBlockSlab *next;
+	alignas(max_align_t) uint8_t blocks[];
+};
+
+/// The slabs of the pool, which are published once and never move, so handles can be resolved without a lock
+static ActorPoolSlot *slabs[ACTOR_POOL_SLAB_COUNT];
+/// Held while taking or returning a slot
+static SDL_SpinLock poolLock;
+/// The number of slots that have ever been used, which are the first this many of the pool
+static uint32_t usedSlotCount;
+/// The index of the least recently freed slot plus one, or 0 if no slot is free
+static uint32_t freeHead;
+/// The index of the most recently freed slot plus one, or 0 if no slot is free
+static uint32_t freeTail;
+
+static size_t liveActors;
+static size_t peakActors;
+static size_t slabCount;
+static size_t retiredSlots;
+static SDL_AtomicInt staleHandleLookups;
+
+/**
+ * Get a slot that has been used. Its slab must exist.
+ */
+static ActorPoolSlot *GetActorPoolSlot(const uint32_t index)
+{
+	ActorPoolSlot *slab = SDL_GetAtomicPointer((void **)&slabs[index / ACTOR_POOL_SLAB_SIZE]);
+	return &slab[index % ACTOR_POOL_SLAB_SIZE];
+}
+
+/**
+ * Allocate the slab that a slot which has never been used is in. The pool must be locked.
+ */
+static void AddActorPoolSlab(const uint32_t index)
+{
+	ActorPoolSlot *slab = malloc(sizeof(ActorPoolSlot) * ACTOR_POOL_SLAB_SIZE);
+	CheckAlloc(slab);
+	for (size_t i = 0; i < ACTOR_POOL_SLAB_SIZE; i++)
+	{
+		SDL_SetAtomicU32(&slab[i].generation, 1);
+		slab[i].nextFree = 0;
+	}
+	SDL_SetAtomicPointer((void **)&slabs[index / ACTOR_POOL_SLAB_SIZE], slab);
+	slabCount++;
+}
+
+Actor *AllocPooledActor(void)
+{
+	SDL_LockSpinlock(&poolLock);
+	uint32_t index;
+	if (freeHead != 0)
+	{
+		// Least recently freed first, so that a slot is not reused over and over while others sit free
+		index = freeHead - 1;
+		freeHead = GetActorPoolSlot(index)->nextFree;
+		if (freeHead == 0)
+		{
+			freeTail = 0;
+		}
+	} else
+	{
+		if (usedSlotCount == MAX_POOLED_ACTORS)
+		{
+			Error("Too many actors");
+		}
+		index = usedSlotCount;
+		if (index % ACTOR_POOL_SLAB_SIZE == 0)
+		{
+			AddActorPoolSlab(index);
+		}
+		usedSlotCount++;
+	}
+	liveActors++;
+	if (liveActors > peakActors)
+	{
+		peakActors = liveActors;
+	}
+	SDL_UnlockSpinlock(&poolLock);
+
+	ActorPoolSlot *slot = GetActorPoolSlot(index);
+	memset(&slot->actor, 0, sizeof(Actor));
+	slot->actor.handle = ((ActorHandle)SDL_GetAtomicU32(&slot->generation) << ACTOR_HANDLE_INDEX_BITS) | index;
+	return &slot->actor;
+}
+
+void ReleasePooledActor(Actor *actor)
+{
+	const uint32_t index = actor->handle & ACTOR_HANDLE_INDEX_MASK;
+	ActorPoolSlot *slot = GetActorPoolSlot(index);
+	assert(&slot->actor == actor);
+	const uint32_t generation = SDL_GetAtomicU32(&slot->generation);
+	actor->handle = ACTOR_HANDLE_NONE;
+	if (generation == ACTOR_HANDLE_MAX_GENERATION)
+	{
+		// Wrapping around would let a handle from the slot's first actor resolve again, so the slot is never reused.
+		// Generation 0 is never handed out, so every handle to it is stale from now on.
+		SDL_SetAtomicU32(&slot->generation, 0);
+		SDL_LockSpinlock(&poolLock);
+		retiredSlots++;
+		liveActors--;
+		SDL_UnlockSpinlock(&poolLock);
+		return;
+	}
+	// Bumped before the slot is free to reuse, so that a handle to the old actor can never resolve to the new one
+	SDL_SetAtomicU32(&slot->generation, generation + 1);
+
+	SDL_LockSpinlock(&poolLock);
+	slot->nextFree = 0;
+	if (freeTail != 0)
+	{
+		GetActorPoolSlot(freeTail - 1)->nextFree = index + 1;
+	} else
+	{
+		freeHead = index + 1;
+	}
+	freeTail = index + 1;
+	liveActors--;
+	SDL_UnlockSpinlock(&poolLock);
+}
+
+Actor *GetActorFromHandle(const ActorHandle handle)
+{
+	const uint32_t generation = handle >> ACTOR_HANDLE_INDEX_BITS;
+	const uint64_t index = handle & ACTOR_HANDLE_INDEX_MASK;
+	if (generation == 0 || index >= MAX_POOLED_ACTORS)
+	{
+		return NULL;
+	}
+	ActorPoolSlot *slab = SDL_GetAtomicPointer((void **)&slabs[index / ACTOR_POOL_SLAB_SIZE]);
+	if (slab == NULL || SDL_GetAtomicU32(&slab[index % ACTOR_POOL_SLAB_SIZE].generation) != generation)
+	{
+		SDL_AddAtomicInt(&staleHandleLookups, 1);
+		return NULL;
+	}
+	return &slab[index % ACTOR_POOL_SLAB_SIZE].actor;
+}
+
+void GetActorPoolStats(ActorPoolStats *stats)
+{
+	SDL_LockSpinlock(&poolLock);
+	stats->liveActors = liveActors;
+	stats->peakActors = peakActors;
+	stats->slabCount = slabCount;
+	stats->bytesReserved = slabCount * sizeof(ActorPoolSlot) * ACTOR_POOL_SLAB_SIZE;
+	stats->retiredSlots = retiredSlots;
+	SDL_UnlockSpinlock(&poolLock);
+	stats->staleHandleLookups = (size_t)SDL_GetAtomicInt(&staleHandleLookups);
+}
+
+void DestroyActorPool(void)
+{
+	SDL_LockSpinlock(&poolLock);
+	if (liveActors > 0)
+	{
+		LogWarning("Freeing the actor pool with %zu actor(s) still in it\n", liveActors);
+	}
+	for (size_t i = 0; i < ACTOR_POOL_SLAB_COUNT; i++)
+	{
+		free(slabs[i]);
+		SDL_SetAtomicPointer((void **)&slabs[i], NULL);
+	}
+	usedSlotCount = 0;
+	freeHead = 0;
+	freeTail = 0;
+	liveActors = 0;
+	peakActors = 0;
+	slabCount = 0;
+	retiredSlots = 0;
+	SDL_SetAtomicInt(&staleHandleLookups, 0);
+	SDL_UnlockSpinlock(&poolLock);
+}
+
+/**
+ * Carve a new slab into free blocks. The pool must be locked.
+ */
+static void AddActorBlockSlab(ActorBlockPool *pool)
+{
+	ActorBlockSlab *slab = malloc(offsetof(ActorBlockSlab, blocks) + (pool->blockSize * pool->blocksPerSlab));
+	CheckAlloc(slab);
+	slab->next = pool->slabs;
+	pool->slabs = slab;
+	// Linked back to front, so that the first block is handed out first
+	for (size_t i = pool->blocksPerSlab; i > 0; i--)
+	{
+		void *block = slab->blocks + (pool->blockSize * (i - 1));
+		*(void **)block = pool->freeBlocks;
+		pool->freeBlocks = block;
+	}
+}
+
+void *AllocActorBlock(ActorBlockPool *pool, const size_t size)
+{
+	SDL_LockSpinlock(&pool->lock);
+	if (pool->blockSize == 0)
+	{
+		const size_t blockSize = size > sizeof(void *) ? size : sizeof(void *);
+		pool->blockSize = (blockSize + ACTOR_BLOCK_ALIGNMENT - 1) & ~(ACTOR_BLOCK_ALIGNMENT - 1);
+		const size_t slabSpace = ACTOR_BLOCK_POOL_SLAB_BYTES - offsetof(ActorBlockSlab, blocks);
+		pool->blocksPerSlab = pool->blockSize < slabSpace ? slabSpace / pool->blockSize : 1;
+	}
+	assert(size <= pool->blockSize); // Every actor of a class must have the same size of extra data
+	if (pool->freeBlocks == NULL)
+	{
+		AddActorBlockSlab(pool);
+	}
+	void *block = pool->freeBlocks;
+	pool->freeBlocks = *(void **)block;
+	pool->blocksInUse++;
+	SDL_UnlockSpinlock(&pool->lock);
+
+	memset(block, 0, pool->blockSize);
+	return block;
+}
+
+void ReleaseActorBlock(ActorBlockPool *pool, void *block)
+{
+	if (block == NULL)
+	{
+		return;
+	}
+	SDL_LockSpinlock(&pool->lock);
+	*(void **)block = pool->freeBlocks;
+	pool->freeBlocks = block;
+	pool->blocksInUse--;
+	SDL_UnlockSpinlock(&pool->lock);
+}
+
+void DestroyActorBlockPool(ActorBlockPool *pool)
+{
+	if (pool->blocksInUse > 0)
+	{
+		LogWarning("Freeing an actor extra data pool with %zu block(s) still in use\n", pool->blocksInUse);
+	}
+	ActorBlockSlab *slab = pool->slabs;
+	while (slab != NULL)
+	{
+		ActorBlockSlab *next = slab->next;
+		free(slab);
+		slab = next;
+	}
+	memset(pool, 0, sizeof(ActorBlockPool));
+}
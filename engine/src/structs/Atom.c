@@ -0,0 +1,220 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/structs/Atom.h>
+#include <engine/structs/MapArena.h>
+#include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
+#include <SDL3/SDL_atomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/// The number of atoms in each chunk of entries. Chunks are never moved, so entries can be read without a lock.
+#define ATOM_CHUNK_SIZE 4096
+/// The number of slots in the first hash table
+#define INITIAL_ATOM_TABLE_SIZE 1024
+
+typedef struct AtomEntry
+{
+	/// The interned string, which lives in @c atomArena
+	const char *string;
+	uint32_t hash;
+	uint32_t length;
+} AtomEntry;
+
+typedef struct AtomTable
+{
+	/// The number of slots, which is a power of two
+	uint32_t size;
+	/// Open addressed slots, where @c ATOM_NONE marks an empty slot. Slots are only ever filled.
+	SDL_AtomicU32 slots[];
+} AtomTable;
+
+/// The entries of every atom, in chunks of @c ATOM_CHUNK_SIZE. Entries are written before their atom is published and
+/// never change after.
+static AtomEntry *atomChunks[MAX_ATOMS / ATOM_CHUNK_SIZE];
+/// The current hash table, or NULL if nothing has been interned. It is replaced by a table twice the size once it is half
+/// full, and old tables are kept until @c DestroyAtoms, since threads looking strings up may still be probing them.
+static AtomTable *atomTable;
+/// The number of interned strings
+static uint32_t atomCount;
+/// Held while interning, so that two threads can't add the same string at once
+static SDL_SpinLock internLock;
+/// Holds the interned strings, their entries and the hash tables
+static MapArena atomArena;
+
+/**
+ * Hash a string with 32 bit FNV-1a
+ */
+static uint32_t HashAtomString(const char *string, const size_t length)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= (uint8_t)string[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static const AtomEntry *GetAtomEntry(const Atom atom)
+{
+	const AtomEntry *chunk = SDL_GetAtomicPointer((void **)&atomChunks[atom / ATOM_CHUNK_SIZE]);
+	return &chunk[atom % ATOM_CHUNK_SIZE];
+}
+
+/**
+ * Find the slot of a string in an atom table
+ * @return The slot, which holds either the string's atom or @c ATOM_NONE if the string has not been interned
+ */
+static uint32_t FindAtomSlot(AtomTable *table, const char *string, const size_t length, const uint32_t hash)
+{
+	uint32_t slot = hash & (table->size - 1);
+	while (true)
+	{
+		const Atom atom = SDL_GetAtomicU32(&table->slots[slot]);
+		if (atom == ATOM_NONE)
+		{
+			return slot;
+		}
+		const AtomEntry *entry = GetAtomEntry(atom);
+		if (entry->hash == hash && entry->length == length && memcmp(entry->string, string, length) == 0)
+		{
+			return slot;
+		}
+		slot = (slot + 1) & (table->size - 1);
+	}
+}
+
+/**
+ * Look a string up in the current atom table without locking
+ * @return The atom of the string, or @c ATOM_NONE if it has not been interned
+ */
+static Atom LookupAtom(const char *string, const size_t length, const uint32_t hash)
+{
+	AtomTable *table = SDL_GetAtomicPointer((void **)&atomTable);
+	if (table == NULL)
+	{
+		return ATOM_NONE;
+	}
+	return SDL_GetAtomicU32(&table->slots[FindAtomSlot(table, string, length, hash)]);
+}
+
+/**
+ * Publish a table twice the size of the current one (or the first table) with every atom in it. internLock must be held.
+ */
+static void GrowAtomTable()
+{
+	const uint32_t size = atomTable == NULL ? INITIAL_ATOM_TABLE_SIZE : atomTable->size * 2;
+	AtomTable *table = MapArenaCalloc(&atomArena, 1, sizeof(AtomTable) + (sizeof(SDL_AtomicU32) * size));
+	table->size = size;
+	for (Atom atom = 1; atom <= atomCount; atom++)
+	{
+		uint32_t slot = GetAtomEntry(atom)->hash & (size - 1);
+		while (SDL_GetAtomicU32(&table->slots[slot]) != ATOM_NONE)
+		{
+			slot = (slot + 1) & (size - 1);
+		}
+		SDL_SetAtomicU32(&table->slots[slot], atom);
+	}
+	// Published once it is filled, so that threads never look strings up in a partly filled table
+	SDL_SetAtomicPointer((void **)&atomTable, table);
+}
+
+Atom Intern(const char *string)
+{
+	if (string == NULL)
+	{
+		return ATOM_NONE;
+	}
+	return InternLength(string, strlen(string));
+}
+
+Atom InternLength(const char *string, const size_t length)
+{
+	const uint32_t hash = HashAtomString(string, length);
+	Atom atom = LookupAtom(string, length, hash);
+	if (atom != ATOM_NONE)
+	{
+		return atom;
+	}
+
+	SDL_LockSpinlock(&internLock);
+	// Kept at most half full, so that probes stay short and always end
+	if (atomTable == NULL || (atomCount + 1) * 2 > atomTable->size)
+	{
+		GrowAtomTable();
+	}
+	// Looked up again, since another thread may have interned the string before the lock was taken
+	const uint32_t slot = FindAtomSlot(atomTable, string, length, hash);
+	atom = SDL_GetAtomicU32(&atomTable->slots[slot]);
+	if (atom == ATOM_NONE)
+	{
+		if (atomCount + 1 >= MAX_ATOMS)
+		{
+			SDL_UnlockSpinlock(&internLock);
+			LogError("Atom table exhausted, failed to intern a string of %zu character(s)\n", length);
+			return ATOM_NONE;
+		}
+		atom = atomCount + 1;
+		if (atomChunks[atom / ATOM_CHUNK_SIZE] == NULL)
+		{
+			AtomEntry *chunk = MapArenaCalloc(&atomArena, ATOM_CHUNK_SIZE, sizeof(AtomEntry));
+			SDL_SetAtomicPointer((void **)&atomChunks[atom / ATOM_CHUNK_SIZE], chunk);
+		}
+		char *copy = MapArenaAlloc(&atomArena, length + 1);
+		memcpy(copy, string, length);
+		copy[length] = '\0';
+		*(AtomEntry *)GetAtomEntry(atom) = (AtomEntry){
+			.string = copy,
+			.hash = hash,
+			.length = (uint32_t)length,
+		};
+		atomCount = atom;
+		// Published last, so that threads looking the string up without the lock never see a partly written entry
+		SDL_SetAtomicU32(&atomTable->slots[slot], atom);
+	}
+	SDL_UnlockSpinlock(&internLock);
+	return atom;
+}
+
+Atom FindAtom(const char *string)
+{
+	if (string == NULL)
+	{
+		return ATOM_NONE;
+	}
+	const size_t length = strlen(string);
+	return LookupAtom(string, length, HashAtomString(string, length));
+}
+
+const char *AtomString(const Atom atom)
+{
+	return atom == ATOM_NONE ? NULL : GetAtomEntry(atom)->string;
+}
+
+uint32_t AtomHash(const Atom atom)
+{
+	return atom == ATOM_NONE ? 0 : GetAtomEntry(atom)->hash;
+}
+
+size_t GetAtomCount()
+{
+	return atomCount;
+}
+
+void DestroyAtoms()
+{
+	SDL_LockSpinlock(&internLock);
+	SDL_SetAtomicPointer((void **)&atomTable, NULL);
+	for (size_t i = 0; i < MAX_ATOMS / ATOM_CHUNK_SIZE; i++)
+	{
+		SDL_SetAtomicPointer((void **)&atomChunks[i], NULL);
+	}
+	atomCount = 0;
+	MapArenaDestroy(&atomArena);
+	SDL_UnlockSpinlock(&internLock);
+}
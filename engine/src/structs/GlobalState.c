@@ -3,10 +3,12 @@
 //
 
 #include <engine/assets/AssetReader.h>
+#include <engine/assets/AsyncAssetLoader.h>
 #include <engine/assets/MapLoader.h>
 #include <engine/graphics/RenderingHelpers.h>
 #include <engine/helpers/Arguments.h>
 #include <engine/physics/Physics.h>
+#include <engine/structs/Asset.h>
 #include <engine/structs/GameState.h>
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/Item.h>
@@ -224,21 +226,41 @@ void DestroyGlobalState()
 	PhysicsDestroyGlobal(&state);
 }
 
+/**
+ * Get the asset path of a map by name
+ * @param name The name of the map
+ * @param mapPath The buffer to write the path to, which must be @c MAX_MAP_PATH_LENGTH bytes
+ * @return Whether the name was short enough
+ */
+static bool GetMapAssetPath(const char *name, char *mapPath)
+{
+	// TODO make this dynamically sized
+	if (snprintf(mapPath, MAX_MAP_PATH_LENGTH, MAP("%s"), name) > MAX_MAP_PATH_LENGTH)
+	{
+		LogError("Failed to load map due to map name %s being too long\n", name);
+		return false;
+	}
+	return true;
+}
+
 bool ChangeMapByName(const char *name)
 {
 	LogInfo("Loading map \"%s\"\n", name);
 
-	// TODO make this dynamically sized
 	char mapPath[MAX_MAP_PATH_LENGTH];
-	if (snprintf(mapPath, MAX_MAP_PATH_LENGTH, MAP("%s"), name) > MAX_MAP_PATH_LENGTH)
+	if (!GetMapAssetPath(name, mapPath))
 	{
-		LogError("Failed to load map due to map name %s being too long\n", name);
 		return false;
 	}
+	return ChangeMapFromAsset(name, LoadAsset(mapPath, false, false));
+}
+
+bool ChangeMapFromAsset(const char *name, Asset *mapAsset)
+{
 	GetState()->saveData->blueCoins = 0;
 	Map *map = CreateMap();
 	ChangeMap(map);
-	if (!LoadMap(map, LoadAsset(mapPath, false, false)))
+	if (!LoadMap(map, mapAsset))
 	{
 		state.map =
 				NULL; // This will leak any previously loaded portions of the map, however it is likely that trying to free it will cause a crash.
@@ -249,3 +271,38 @@ bool ChangeMapByName(const char *name)
 	DiscordUpdateRPC();
 	return true;
 }
+
+bool ChangeMapFromPreload(const char *name, Map *map)
+{
+	if (map == NULL)
+	{
+		return false;
+	}
+	GetState()->saveData->blueCoins = 0;
+	// The map was created when its preload started, so the held item may have changed since
+	Item *item = GetItem();
+	if (item)
+	{
+		item->definition->SwitchTo(item, &map->viewmodel);
+	} else
+	{
+		map->viewmodel.enabled = false;
+	}
+	ChangeMap(map);
+	FinishDetachedMapLoad(map);
+	map->mapName = strdup(name);
+	DiscordUpdateRPC();
+	return true;
+}
+
+AssetLoadTicket LoadMapAssetAsync(const char *name, const AssetLoadCallback callback, void *userData)
+{
+	LogInfo("Loading map \"%s\" in the background\n", name);
+
+	char mapPath[MAX_MAP_PATH_LENGTH];
+	if (!GetMapAssetPath(name, mapPath))
+	{
+		return ASSET_LOAD_TICKET_INVALID;
+	}
+	return LoadAssetAsync(mapPath, ASSET_LOAD_NONE, callback, userData);
+}
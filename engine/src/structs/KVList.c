@@ -5,6 +5,7 @@
 #include <assert.h>
 #include <engine/assets/DataReader.h>
 #include <engine/assets/DataWriter.h>
+#include <engine/structs/Atom.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/KVList.h>
 #include <engine/subsystem/Error.h>
@@ -191,7 +192,7 @@ void FreeParam(Param *param)
 static void KvSet(KvList list, const char *key, const Param value)
 {
 	assert(list && key);
-	KvList_set_at(list, key, value);
+	KvList_set_at(list, Intern(key), value);
 }
 
 /**
@@ -203,8 +204,13 @@ static void KvSet(KvList list, const char *key, const Param value)
 static Param *KvGet(const KvList list, const char *key)
 {
 	assert(list && key);
-	Param *p = KvList_get(list, key);
-	return p;
+	// A key that has never been interned can't be in any list
+	const Atom atom = FindAtom(key);
+	if (atom == ATOM_NONE)
+	{
+		return NULL;
+	}
+	return KvList_get(list, atom);
 }
 
 /**
@@ -244,12 +250,15 @@ size_t ReadKvList(DataReader *reader, KvList out)
 	const size_t numParams = ReadSizeT(reader);
 	for (size_t _ = 0; _ < numParams; _++)
 	{
-		size_t keyLength = 0;
-		char *key = ReadStringSafe(reader, &keyLength);
+		// The key is interned by KvSetUnsafe, so it can be read straight out of the buffer
+		const char *key = ReadStringView(reader, NULL);
+		if (!key)
+		{
+			Error("DataReader Buffer Overrun");
+		}
 		Param param;
 		(void)ReadParam(reader, &param);
 		KvSetUnsafe(out, key, param);
-		free(key);
 		FreeParam(&param);
 	}
 	return DataReaderGetOffset(reader) - initialOffset;
@@ -264,7 +273,7 @@ void WriteKvList(const KvList list, DataWriter *writer)
 	for (KvList_it(iter, list); !KvList_end_p(iter); KvList_next(iter))
 	{
 		const KvList_pair *pair = KvList_cref(iter);
-		WriteString(writer, pair->key);
+		WriteString(writer, AtomString(pair->key));
 		WriteParam(&pair->value, writer);
 	}
 }
@@ -283,7 +292,11 @@ void KvListDestroy(KvList list)
 void KvDelete(KvList list, const char *key)
 {
 	assert(list && key);
-	KvList_erase(list, key);
+	const Atom atom = FindAtom(key);
+	if (atom != ATOM_NONE)
+	{
+		KvList_erase(list, atom);
+	}
 }
 
 bool KvHas(KvList list, const char *key, const ParamType expectedType)
@@ -2,11 +2,18 @@
 // Created by droc101 on 4/21/2024.
 //
 
+#include <assert.h>
 #include <engine/debug/JoltDebugRenderer.h>
 #include <engine/graphics/Drawing.h>
+#include <engine/helpers/MapChunkStreamer.h>
+#include <engine/helpers/Realloc.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
+#include <engine/structs/ActorDefinition.h>
+#include <engine/structs/ActorIoQueue.h>
+#include <engine/structs/ActorPool.h>
 #include <engine/structs/ActorWall.h>
+#include <engine/structs/Atom.h>
 #include <engine/structs/Camera.h>
 #include <engine/structs/Color.h>
 #include <engine/structs/GlobalState.h>
@@ -14,17 +21,20 @@
 #include <engine/structs/KVList.h>
 #include <engine/structs/List.h>
 #include <engine/structs/Map.h>
+#include <engine/structs/MapArena.h>
 #include <engine/structs/Player.h>
 #include <engine/subsystem/Error.h>
+#include <engine/subsystem/Logging.h>
 #include <joltc/joltc.h>
 #include <joltc/Physics/Body/BodyInterface.h>
 #include <limits.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_mutex.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 
 Map *CreateMap(void)
 {
@@ -48,9 +58,13 @@ Map *CreateMap(void)
 	map->exposure = 1.0f;
 	map->lightCount = 0;
 	map->pointLights = NULL;
-	ListInit(map->namedActorNames, LIST_POINTER);
-	ListInit(map->namedActorPointers, LIST_POINTER);
+	NamedActorIndex_init(map->namedActors);
+	map->namedActorsMutex = SDL_CreateMutex();
+	ListInit(map->removedActors, LIST_POINTER);
 	ListInit(map->joltBodies, LIST_UINT32);
+	ListInit(map->pendingActors, LIST_POINTER);
+	map->pendingMaterialNames = NULL;
+	ListInit(map->chunks, LIST_POINTER);
 
 	Item *item = GetItem();
 	if (item)
@@ -64,6 +78,17 @@ Map *CreateMap(void)
 	return map;
 }
 
+Map *CreateMapChunk(void)
+{
+	Map *chunk = calloc(1, sizeof(Map));
+	CheckAlloc(chunk);
+	ListInit(chunk->actors, LIST_UINT64);
+	ListInit(chunk->joltBodies, LIST_UINT32);
+	ListInit(chunk->pendingActors, LIST_POINTER);
+	ListInit(chunk->chunks, LIST_POINTER);
+	return chunk;
+}
+
 void FreeLoadTimeMapData(Map *map)
 {
 	for (size_t i = 0; i < map->modelCount; i++)
@@ -78,12 +103,29 @@ void FreeLoadTimeMapData(Map *map)
 	map->lightmapPixels = NULL;
 }
 
-void DestroyMap(Map *map)
+/**
+ * Free the parts of a map that a map and a chunk have in common
+ */
+static void FreeMapContents(Map *map)
 {
-	for (size_t i = 0; i < map->actors.length; i++)
+	for (size_t i = 0; i < map->pendingActors.length; i++)
 	{
-		FreeActor(ListGetPointer(map->actors, i));
+		MapPendingActor *pendingActor = ListGetPointer(map->pendingActors, i);
+		KvListDestroy(pendingActor->params);
+		for (size_t j = 0; j < pendingActor->ioConnections.length; j++)
+		{
+			DestroyActorConnection(ListGetPointer(pendingActor->ioConnections, j));
+		}
+		ListFree(pendingActor->ioConnections);
+	}
+	ListFree(map->pendingActors);
+
+	for (size_t i = 0; i < map->pendingCollisionCount; i++)
+	{
+		JPH_Shape_Destroy(map->pendingCollisionShapes[i]);
 	}
+	free(map->pendingCollisionShapes);
+	free(map->pendingCollisionPositions);
 
 	if (map->models)
 	{
@@ -93,9 +135,93 @@ void DestroyMap(Map *map)
 			free(model->vertices);
 			free(model->indices);
 		}
-		free(map->models);
 		map->models = NULL;
 	}
+	free(map->lightmapPixels);
+}
+
+/**
+ * Remove an actor from a map's actor list in constant time, by moving the last actor into its place
+ * @return Whether the actor was in the list
+ */
+static bool RemoveActorFromMapList(Actor *actor, Map *map)
+{
+	ListLock(map->actors);
+	const size_t index = actor->mapIndex;
+	if (index >= map->actors.length || ListGetPointer(map->actors, index) != actor)
+	{
+		ListUnlock(map->actors);
+		return false;
+	}
+	const size_t lastIndex = map->actors.length - 1;
+	if (index != lastIndex)
+	{
+		Actor *lastActor = ListGetPointer(map->actors, lastIndex);
+		ListSet(map->actors, index, lastActor);
+		lastActor->mapIndex = index;
+	}
+	ListRemoveAt(map->actors, lastIndex);
+	actor->mapIndex = SIZE_MAX;
+	ListUnlock(map->actors);
+	return true;
+}
+
+void DestroyMapChunk(Map *map, Map *chunk)
+{
+	// A chunk only has actors once it is attached
+	assert(map != NULL || chunk->actors.length == 0);
+	for (size_t i = 0; i < chunk->actors.length; i++)
+	{
+		// Actors that were removed during gameplay have been freed already, or will be once the dispatch finishes
+		Actor *actor = GetActorFromHandle(ListGetUint64(chunk->actors, i));
+		if (actor == NULL || actor->removed)
+		{
+			continue;
+		}
+		RemoveActorFromMapList(actor, map);
+		UnnameActor(actor, map);
+		if (map->player.targetedActor == actor)
+		{
+			map->player.targetedActor = NULL;
+			map->player.hasHeldActor = false;
+		}
+		if (map->ioProxy == actor)
+		{
+			map->ioProxy = NULL;
+		}
+		FreeActor(actor);
+	}
+	ListFree(chunk->actors);
+
+	if (map != NULL)
+	{
+		JPH_BodyInterface *bodyInterface = JPH_PhysicsSystem_GetBodyInterface(map->physicsSystem);
+		for (size_t i = 0; i < chunk->joltBodies.length; i++)
+		{
+			JPH_BodyInterface_RemoveAndDestroyBody(bodyInterface, ListGetUint32(chunk->joltBodies, i));
+		}
+	}
+	ListFree(chunk->joltBodies);
+	ListFree(chunk->chunks);
+
+	FreeMapContents(chunk);
+	MapArenaDestroy(&chunk->arena);
+	free(chunk);
+}
+
+void DestroyMap(Map *map)
+{
+	// Chunk actors are in this map's actor list as well, so the chunks have to go first
+	DestroyMapChunks(map);
+	ListFree(map->chunks);
+	FreeRemovedActors(map);
+	ListFree(map->removedActors);
+	DestroyActorIoQueue(&map->ioQueue);
+	for (size_t i = 0; i < map->actors.length; i++)
+	{
+		FreeActor(ListGetPointer(map->actors, i));
+	}
+	FreeMapContents(map);
 
 	free(map->mapName);
 	if (map->transition)
@@ -104,14 +230,6 @@ void DestroyMap(Map *map)
 		free(map->transition);
 	}
 
-	free(map->skyTexture);
-	free(map->discordRpcIcon);
-	free(map->discordRpcName);
-
-	free(map->lightmapPixels);
-
-	free(map->pointLights);
-
 	JPH_BodyInterface *bodyInterface = JPH_PhysicsSystem_GetBodyInterface(map->physicsSystem);
 
 	for (size_t i = 0; i < map->joltBodies.length; i++)
@@ -122,38 +240,49 @@ void DestroyMap(Map *map)
 
 	PhysicsDestroyMap(map);
 
-	ListAndContentsFree(map->namedActorNames);
-	ListFree(map->namedActorPointers);
+	NamedActorIndex_iterator iterator;
+	for (NamedActorIndex_it(iterator, map->namedActors); !NamedActorIndex_end_p(iterator); NamedActorIndex_next(iterator))
+	{
+		const NamedActorSet *set = &NamedActorIndex_cref(iterator)->value;
+		free(set->overflowActors);
+	}
+	NamedActorIndex_clear(map->namedActors);
+	SDL_DestroyMutex(map->namedActorsMutex);
 	ListFree(map->actors);
+	MapArenaDestroy(&map->arena);
 	free(map);
 }
 
 void AddActor(Actor *actor)
 {
-	ListAdd(GetState()->map->actors, actor);
+	AddActorToMap(actor, GetState()->map);
 }
 
-void RemoveActor(Actor *actor)
+void AddActorToMap(Actor *actor, Map *map)
 {
-	Map *map = GetState()->map;
-	ActorFireOutput(actor, ACTOR_OUTPUT_KILLED, PARAM_NONE);
+	ListLock(map->actors);
+	actor->mapIndex = map->actors.length;
+	ListAdd(map->actors, actor);
+	ListUnlock(map->actors);
+}
 
-	// Remove the actor from the named actor lists if it's there
-	const size_t nameIdx = ListFind(map->namedActorPointers, actor);
-	if (nameIdx != SIZE_MAX)
+void RemoveActor(Actor *actor)
+{
+	if (actor->removed)
 	{
-		free(ListGetPointer(map->namedActorNames, nameIdx));
-		ListRemoveAt(map->namedActorNames, nameIdx);
-		ListRemoveAt(map->namedActorPointers, nameIdx);
+		return;
 	}
+	Map *map = GetState()->map;
+	// Set first, so that inputs fired by the killed output are not sent back to the actor
+	actor->removed = true;
+	ActorFireOutputId(actor, ACTOR_OUTPUT_KILLED_ID, PARAM_NONE);
 
-	const size_t idx = ListFind(map->actors, actor);
-	if (idx == SIZE_MAX)
+	UnnameActor(actor, map);
+
+	if (!RemoveActorFromMapList(actor, map))
 	{
 		return;
 	}
-	ListRemoveAt(map->actors, idx);
-	FreeActor(actor);
 
 	Player *plr = &GetState()->map->player;
 	if (plr->targetedActor == actor)
@@ -161,43 +290,325 @@ void RemoveActor(Actor *actor)
 		plr->targetedActor = NULL;
 		plr->hasHeldActor = false;
 	}
+
+	// The input being dispatched may be sent by or to the actor, so it is kept until the dispatch finishes
+	if (SDL_GetAtomicInt(&map->ioDispatchDepth) > 0)
+	{
+		ListAdd(map->removedActors, actor);
+	} else
+	{
+		FreeActor(actor);
+	}
+}
+
+void FreeRemovedActors(Map *map)
+{
+	ListLock(map->removedActors);
+	for (size_t i = 0; i < map->removedActors.length; i++)
+	{
+		FreeActor(ListGetPointer(map->removedActors, i));
+	}
+	ListClear(map->removedActors);
+	ListUnlock(map->removedActors);
+}
+
+/**
+ * Get an actor from a named actor set
+ */
+static Actor *GetNamedActor(const NamedActorSet *set, const size_t index)
+{
+	if (index < NAMED_ACTOR_INLINE_CAPACITY)
+	{
+		return set->inlineActors[index];
+	}
+	return set->overflowActors[index - NAMED_ACTOR_INLINE_CAPACITY];
+}
+
+/**
+ * Replace an actor in a named actor set. The set must already have room for @c index.
+ */
+static void SetNamedActor(NamedActorSet *set, const size_t index, Actor *actor)
+{
+	if (index < NAMED_ACTOR_INLINE_CAPACITY)
+	{
+		set->inlineActors[index] = actor;
+	} else
+	{
+		set->overflowActors[index - NAMED_ACTOR_INLINE_CAPACITY] = actor;
+	}
 }
 
 void NameActor(Actor *actor, const char *name, Map *map)
 {
-	ListAdd(map->namedActorNames, strdup(name));
-	ListAdd(map->namedActorPointers, actor);
+	SDL_LockMutex(map->namedActorsMutex);
+	UnnameActor(actor, map);
+	const Atom nameAtom = Intern(name);
+	NamedActorSet *set = NamedActorIndex_get(map->namedActors, nameAtom);
+	if (set == NULL)
+	{
+		const NamedActorSet newSet = {
+			.name = nameAtom,
+		};
+		NamedActorIndex_set_at(map->namedActors, nameAtom, newSet);
+		set = NamedActorIndex_get(map->namedActors, nameAtom);
+	}
+	if (set->count >= NAMED_ACTOR_INLINE_CAPACITY &&
+		set->count - NAMED_ACTOR_INLINE_CAPACITY == set->overflowCapacity)
+	{
+		set->overflowCapacity = set->overflowCapacity ? set->overflowCapacity * 2 : NAMED_ACTOR_INLINE_CAPACITY;
+		set->overflowActors = GameReallocArray(set->overflowActors, set->overflowCapacity, sizeof(Actor *));
+		CheckAlloc(set->overflowActors);
+	}
+	SetNamedActor(set, set->count, actor);
+	set->count++;
+	actor->name = set->name;
+	SDL_AddAtomicInt(&map->ioLinkGeneration, 1);
+	SDL_UnlockMutex(map->namedActorsMutex);
 }
 
-Actor *GetActorByName(const char *name, const Map *map)
+void UnnameActor(Actor *actor, Map *map)
 {
-	ListLock(map->namedActorNames);
-	for (size_t i = 0; i < map->namedActorNames.length; i++)
+	if (actor->name == ATOM_NONE)
+	{
+		return;
+	}
+	SDL_LockMutex(map->namedActorsMutex);
+	NamedActorSet *set = NamedActorIndex_get(map->namedActors, actor->name);
+	if (set != NULL)
 	{
-		if (strcmp(ListGetPointer(map->namedActorNames, i), name) == 0)
+		for (size_t i = 0; i < set->count; i++)
 		{
-			Actor *actor = ListGetPointer(map->namedActorPointers, i);
-			ListUnlock(map->namedActorNames);
-			return actor;
+			if (GetNamedActor(set, i) != actor)
+			{
+				continue;
+			}
+			// Shifted down instead of swapped, so that the actors keep the order they were named in
+			for (size_t j = i + 1; j < set->count; j++)
+			{
+				SetNamedActor(set, j - 1, GetNamedActor(set, j));
+			}
+			set->count--;
+			break;
+		}
+		if (set->count == 0)
+		{
+			free(set->overflowActors);
+			NamedActorIndex_erase(map->namedActors, actor->name);
 		}
 	}
-	ListUnlock(map->namedActorNames);
-	return NULL;
+	actor->name = ATOM_NONE;
+	SDL_AddAtomicInt(&map->ioLinkGeneration, 1);
+	SDL_UnlockMutex(map->namedActorsMutex);
+}
+
+Actor *GetActorByName(const char *name, const Map *map)
+{
+	SDL_LockMutex(map->namedActorsMutex);
+	const NamedActorSet *set = NamedActorIndex_get(map->namedActors, FindAtom(name));
+	Actor *actor = set != NULL && set->count > 0 ? GetNamedActor(set, 0) : NULL;
+	SDL_UnlockMutex(map->namedActorsMutex);
+	return actor;
 }
 
 void GetActorsByName(const char *name, const Map *map, List *actors)
 {
 	ListInit(*actors, LIST_POINTER);
-	ListLock(map->namedActorNames);
-	for (size_t i = 0; i < map->namedActorNames.length; i++)
+	SDL_LockMutex(map->namedActorsMutex);
+	const NamedActorSet *set = NamedActorIndex_get(map->namedActors, FindAtom(name));
+	for (size_t i = 0; set != NULL && i < set->count; i++)
+	{
+		ListAdd(*actors, GetNamedActor(set, i));
+	}
+	SDL_UnlockMutex(map->namedActorsMutex);
+}
+
+void IterateActorsByName(const char *name, const Map *map, NamedActorIterator *iterator)
+{
+	iterator->map = map;
+	iterator->name = FindAtom(name);
+	iterator->next = 0;
+	iterator->previous = NULL;
+}
+
+Actor *NextActorByName(NamedActorIterator *iterator)
+{
+	const Map *map = iterator->map;
+	Actor *actor = NULL;
+	SDL_LockMutex(map->namedActorsMutex);
+	const NamedActorSet *set = NamedActorIndex_get(map->namedActors, iterator->name);
+	if (set != NULL)
 	{
-		const char *actorName = ListGetPointer(map->namedActorNames, i);
-		if (strcmp(actorName, name) == 0)
+		// If the previous actor is gone from where it was, it was removed and every actor after it moved down by one
+		if (iterator->previous != NULL &&
+			(iterator->next > set->count || GetNamedActor(set, iterator->next - 1) != iterator->previous))
 		{
-			ListAdd(*actors, ListGetPointer(map->namedActorPointers, i));
+			iterator->next--;
 		}
+		if (iterator->next < set->count)
+		{
+			actor = GetNamedActor(set, iterator->next);
+			iterator->next++;
+		}
+	}
+	iterator->previous = actor;
+	SDL_UnlockMutex(map->namedActorsMutex);
+	return actor;
+}
+
+void LinkActorOutputs(Actor *actor, Map *map)
+{
+	ListLock(actor->ioConnections);
+	SDL_LockMutex(map->namedActorsMutex);
+	// Read before linking, so that naming an actor while this runs makes the links stale instead of going unnoticed
+	actor->outputLinkGeneration = SDL_GetAtomicInt(&map->ioLinkGeneration);
+	SDL_AddAtomicInt(&map->ioRelinkCount, 1);
+
+	free(actor->outputLinks);
+	actor->outputLinks = NULL;
+	free(actor->outputLinkStarts);
+	actor->outputLinkStarts = NULL;
+	if (actor->ioConnections.length == 0)
+	{
+		SDL_UnlockMutex(map->namedActorsMutex);
+		ListUnlock(actor->ioConnections);
+		return;
+	}
+
+	// Connections with no target still get a link, so that their refires are counted
+	const size_t outputCount = actor->definition->outputCount;
+	actor->outputLinkStarts = calloc(outputCount + 1, sizeof(size_t));
+	CheckAlloc(actor->outputLinkStarts);
+	size_t linkCount = 0;
+	for (size_t i = 0; i < actor->ioConnections.length; i++)
+	{
+		ActorConnection *connection = ListGetPointer(actor->ioConnections, i);
+		connection->outputId = GetActorOutputId(actor->definition, connection->sourceActorOutput);
+		if (connection->outputId == ACTOR_OUTPUT_INVALID || connection->spent)
+		{
+			continue;
+		}
+		const NamedActorSet *set = NamedActorIndex_get(map->namedActors, connection->targetActorName);
+		const size_t targetCount = set != NULL && set->count > 0 ? set->count : 1;
+		actor->outputLinkStarts[connection->outputId + 1] += targetCount;
+		linkCount += targetCount;
+	}
+	for (size_t i = 0; i < outputCount; i++)
+	{
+		actor->outputLinkStarts[i + 1] += actor->outputLinkStarts[i];
+	}
+
+	actor->outputLinks = malloc(sizeof(ActorOutputLink) * (linkCount > 0 ? linkCount : 1));
+	CheckAlloc(actor->outputLinks);
+	// Filled in connection order, with each output's start moved along to where its next link goes
+	for (size_t i = 0; i < actor->ioConnections.length; i++)
+	{
+		ActorConnection *connection = ListGetPointer(actor->ioConnections, i);
+		if (connection->outputId == ACTOR_OUTPUT_INVALID || connection->spent)
+		{
+			continue;
+		}
+		const NamedActorSet *set = NamedActorIndex_get(map->namedActors, connection->targetActorName);
+		const size_t targetCount = set != NULL ? set->count : 0;
+		size_t *next = &actor->outputLinkStarts[connection->outputId];
+		for (size_t j = 0; j < targetCount; j++)
+		{
+			Actor *target = GetNamedActor(set, j);
+			actor->outputLinks[*next] = (ActorOutputLink){
+				.connection = connection,
+				.target = target,
+				.handler = GetActorInputHandler(target->definition, connection->targetActorInput),
+				.lastOfConnection = j == targetCount - 1,
+			};
+			(*next)++;
+		}
+		if (targetCount == 0)
+		{
+			actor->outputLinks[*next] = (ActorOutputLink){
+				.connection = connection,
+				.lastOfConnection = true,
+			};
+			(*next)++;
+		}
+	}
+	// Every start now holds the start of the output after it
+	for (size_t i = outputCount; i > 0; i--)
+	{
+		actor->outputLinkStarts[i] = actor->outputLinkStarts[i - 1];
+	}
+	actor->outputLinkStarts[0] = 0;
+
+	SDL_UnlockMutex(map->namedActorsMutex);
+	ListUnlock(actor->ioConnections);
+}
+
+#ifdef BUILDSTYLE_DEBUG
+/**
+ * Report the connections of an actor that will never reach an input
+ * @return The number of connections reported
+ */
+static size_t ValidateActorOutputLinks(const Actor *actor)
+{
+	const char *actorName = actor->name != ATOM_NONE ? AtomString(actor->name) : "(unnamed)";
+	size_t problemCount = 0;
+	for (size_t i = 0; i < actor->ioConnections.length; i++)
+	{
+		const ActorConnection *connection = ListGetPointer(actor->ioConnections, i);
+		if (connection->outputId == ACTOR_OUTPUT_INVALID)
+		{
+			LogWarning("%s %s has a connection from output \"%s\", which it does not have\n",
+					   actor->definition->className,
+					   actorName,
+					   AtomString(connection->sourceActorOutput));
+			problemCount++;
+		}
+	}
+	const size_t linkCount = actor->outputLinkStarts != NULL
+									 ? actor->outputLinkStarts[actor->definition->outputCount]
+									 : 0;
+	for (size_t i = 0; i < linkCount; i++)
+	{
+		const ActorOutputLink *link = &actor->outputLinks[i];
+		if (link->target == NULL)
+		{
+			LogWarning("%s %s has a connection to \"%s\", but no actor has that name\n",
+					   actor->definition->className,
+					   actorName,
+					   AtomString(link->connection->targetActorName));
+			problemCount++;
+		} else if (link->handler == NULL)
+		{
+			LogWarning("%s %s has a connection to input \"%s\" of %s %s, which it does not have\n",
+					   actor->definition->className,
+					   actorName,
+					   AtomString(link->connection->targetActorInput),
+					   link->target->definition->className,
+					   AtomString(link->connection->targetActorName));
+			problemCount++;
+		}
+	}
+	return problemCount;
+}
+#endif
+
+void LinkLoadedActorOutputs(Map *map, const size_t firstActor)
+{
+#ifdef BUILDSTYLE_DEBUG
+	size_t problemCount = 0;
+#endif
+	for (size_t i = firstActor; i < map->actors.length; i++)
+	{
+		Actor *actor = ListGetPointer(map->actors, i);
+		LinkActorOutputs(actor, map);
+#ifdef BUILDSTYLE_DEBUG
+		problemCount += ValidateActorOutputLinks(actor);
+#endif
+	}
+#ifdef BUILDSTYLE_DEBUG
+	if (problemCount > 0)
+	{
+		LogWarning("Found %zu broken I/O connection(s)\n", problemCount);
 	}
-	ListUnlock(map->namedActorNames);
+#endif
 }
 
 void RenderMap(Map *map, const Camera *camera)
@@ -0,0 +1,167 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <assert.h>
+#include <engine/structs/MapArena.h>
+#include <engine/subsystem/Error.h>
+#include <SDL3/SDL_atomic.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct MapArenaBlock
+{
+	MapArenaBlock *next;
+	/// The number of usable bytes in the block
+	size_t size;
+	/// The number of bytes that have been handed out
+	size_t used;
+	alignas(max_align_t) uint8_t data[];
+};
+
+/// Every allocation is aligned to this, so the arena can hold anything malloc can
+#define MAP_ARENA_ALIGNMENT alignof(max_align_t)
+
+/**
+ * Put in front of every allocation from @c MapArenaAllocFreeable, and padded so that the allocation stays aligned
+ */
+typedef union MapArenaAllocationHeader
+{
+	/// Whether the allocation came from an arena instead of the heap
+	bool fromArena;
+	max_align_t alignment;
+} MapArenaAllocationHeader;
+
+static MapArenaBlock *CreateMapArenaBlock(MapArena *arena, const size_t size)
+{
+	MapArenaBlock *block = malloc(sizeof(MapArenaBlock) + size);
+	CheckAlloc(block);
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+	arena->bytesReserved += sizeof(MapArenaBlock) + size;
+	arena->blockCount++;
+	return block;
+}
+
+void *MapArenaAlloc(MapArena *arena, size_t size)
+{
+	assert(!arena->sealed);
+	// Empty allocations still take up space, so that every pointer handed out is inside its block
+	size = size == 0 ? 1 : size;
+	size = (size + MAP_ARENA_ALIGNMENT - 1) & ~(MAP_ARENA_ALIGNMENT - 1);
+
+	SDL_LockSpinlock(&arena->lock);
+	arena->allocationCount++;
+	arena->bytesAllocated += size;
+
+	void *pointer = NULL;
+	if (size > MAP_ARENA_LARGE_ALLOCATION)
+	{
+		// Inserted behind the current block, so that the current block keeps being filled
+		MapArenaBlock *block = CreateMapArenaBlock(arena, size);
+		block->used = size;
+		if (arena->blocks == NULL)
+		{
+			arena->blocks = block;
+		} else
+		{
+			block->next = arena->blocks->next;
+			arena->blocks->next = block;
+		}
+		pointer = block->data;
+	} else
+	{
+		MapArenaBlock *block = arena->blocks;
+		if (block == NULL || block->size - block->used < size)
+		{
+			block = CreateMapArenaBlock(arena, MAP_ARENA_BLOCK_SIZE - sizeof(MapArenaBlock));
+			block->next = arena->blocks;
+			arena->blocks = block;
+		}
+		pointer = block->data + block->used;
+		block->used += size;
+	}
+	SDL_UnlockSpinlock(&arena->lock);
+	return pointer;
+}
+
+void *MapArenaCalloc(MapArena *arena, const size_t count, const size_t size)
+{
+	if (size != 0 && count > SIZE_MAX / size)
+	{
+		Error("Map arena allocation is too large!");
+	}
+	void *pointer = MapArenaAlloc(arena, count * size);
+	memset(pointer, 0, count * size);
+	return pointer;
+}
+
+char *MapArenaStrdup(MapArena *arena, const char *string)
+{
+	const size_t length = strlen(string) + 1;
+	char *copy = MapArenaAlloc(arena, length);
+	memcpy(copy, string, length);
+	return copy;
+}
+
+void *MapArenaAllocFreeable(MapArena *arena, const size_t size)
+{
+	if (size > SIZE_MAX - sizeof(MapArenaAllocationHeader))
+	{
+		Error("Map arena allocation is too large!");
+	}
+	MapArenaAllocationHeader *header = NULL;
+	if (arena != NULL && !arena->sealed)
+	{
+		header = MapArenaCalloc(arena, 1, sizeof(MapArenaAllocationHeader) + size);
+		header->fromArena = true;
+	} else
+	{
+		header = calloc(1, sizeof(MapArenaAllocationHeader) + size);
+		CheckAlloc(header);
+	}
+	return header + 1;
+}
+
+char *MapArenaStrdupFreeable(MapArena *arena, const char *string)
+{
+	const size_t length = strlen(string) + 1;
+	char *copy = MapArenaAllocFreeable(arena, length);
+	memcpy(copy, string, length);
+	return copy;
+}
+
+void MapArenaFree(void *pointer)
+{
+	if (pointer == NULL)
+	{
+		return;
+	}
+	MapArenaAllocationHeader *header = (MapArenaAllocationHeader *)pointer - 1;
+	if (!header->fromArena)
+	{
+		free(header);
+	}
+}
+
+void MapArenaSeal(MapArena *arena)
+{
+	arena->sealed = true;
+}
+
+void MapArenaDestroy(MapArena *arena)
+{
+	MapArenaBlock *block = arena->blocks;
+	while (block != NULL)
+	{
+		MapArenaBlock *next = block->next;
+		free(block);
+		block = next;
+	}
+	memset(arena, 0, sizeof(MapArena));
+}
@@ -31,6 +31,8 @@ struct SoundChannel
 {
 	/// The audio playing on this channel
 	MIX_Audio *audio;
+	/// The sound asset the audio is read from, which is pinned in the asset cache while the channel exists
+	const Asset *soundAsset;
 	/// The track this audio is playing on
 	MIX_Track *track;
 	/// The index of the channel this audio is playing on
@@ -98,6 +100,7 @@ static void ChannelFinished(void *userdata, MIX_Track * /*track*/)
 		free(effect->position);
 	}
 	MIX_DestroyAudio(effect->audio);
+	UnpinAsset(effect->soundAsset);
 	soundSys.channels[effect->channelIndex] = NULL;
 	free(effect);
 }
@@ -165,6 +168,7 @@ void DestroySoundSystem()
 				MIX_SetTrackStoppedCallback(channel->track, NULL, NULL);
 				MIX_StopTrack(channel->track, 0);
 				MIX_DestroyAudio(channel->audio);
+				UnpinAsset(channel->soundAsset);
 				free(channel);
 			}
 		}
@@ -293,7 +297,8 @@ SoundChannel *PlaySoundEx(const SoundRequest *request)
 		UnlockSoundSystem();
 		return NULL;
 	}
-	const Asset *wav = LoadAsset(request->soundAsset, true, false);
+	// Streamed sounds read from the asset for as long as they play, so keep it from being evicted until then
+	const Asset *wav = LoadAssetPinned(request->soundAsset, false);
 	if (wav == NULL)
 	{
 		LogError("Failed to load sound effect asset.\n");
@@ -303,6 +308,7 @@ SoundChannel *PlaySoundEx(const SoundRequest *request)
 	if (wav->type != ASSET_TYPE_WAV)
 	{
 		LogError("PlaySoundEx Error: Asset is not a sound effect file.\n");
+		UnpinAsset(wav);
 		UnlockSoundSystem();
 		return NULL;
 	}
@@ -310,6 +316,7 @@ SoundChannel *PlaySoundEx(const SoundRequest *request)
 	if (!stream)
 	{
 		LogError("SDL_IOFromConstMem Error: %s\n", SDL_GetError());
+		UnpinAsset(wav);
 		UnlockSoundSystem();
 		return NULL;
 	}
@@ -317,6 +324,7 @@ SoundChannel *PlaySoundEx(const SoundRequest *request)
 	if (audio == NULL)
 	{
 		LogError("MIX_LoadAudio_IO Error: %s\n", SDL_GetError());
+		UnpinAsset(wav);
 		UnlockSoundSystem();
 		return NULL;
 	}
@@ -326,6 +334,7 @@ SoundChannel *PlaySoundEx(const SoundRequest *request)
 	{
 		LogError("PlaySoundEffect Error: No available tracks.\n");
 		MIX_DestroyAudio(audio);
+		UnpinAsset(wav);
 		UnlockSoundSystem();
 		return NULL;
 	}
@@ -334,6 +343,7 @@ SoundChannel *PlaySoundEx(const SoundRequest *request)
 	CheckAlloc(effect);
 	soundSys.channels[index] = effect;
 	effect->audio = audio;
+	effect->soundAsset = wav;
 	effect->track = track;
 	effect->channelIndex = index;
 	effect->category = request->category;
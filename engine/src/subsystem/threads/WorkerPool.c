@@ -0,0 +1,182 @@
+//
+// Created by droc101 on 10/18/26.
+//
+
+#include <engine/structs/List.h>
+#include <engine/subsystem/Logging.h>
+#include <engine/subsystem/threads/WorkerPool.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_mutex.h>
+#include <SDL3/SDL_thread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct ParallelForBatch ParallelForBatch;
+
+struct ParallelForBatch
+{
+	ParallelForFunction function;
+	void *userData;
+	size_t count;
+	/// The next index to claim
+	SDL_AtomicInt nextIndex;
+	/// The number of worker threads currently looking at this batch, protected by poolMutex
+	size_t activeWorkers;
+};
+
+static SDL_Thread *workers[MAX_WORKER_POOL_THREADS];
+static size_t workerCount = 0;
+static bool shouldExit = false;
+
+/// Protects everything below
+static SDL_Mutex *poolMutex = NULL;
+/// Signalled when a batch is added or the workers should exit
+static SDL_Condition *workAvailableCondition = NULL;
+/// Signalled when a worker stops working on a batch
+static SDL_Condition *workerDoneCondition = NULL;
+/// Batches that still have unclaimed indices
+static List batches;
+
+/**
+ * Run indices of a batch until there are none left to claim
+ */
+static void RunParallelForBatch(ParallelForBatch *batch)
+{
+	while (true)
+	{
+		const size_t index = (size_t)SDL_AddAtomicInt(&batch->nextIndex, 1);
+		if (index >= batch->count)
+		{
+			return;
+		}
+		batch->function(index, batch->userData);
+	}
+}
+
+static int WorkerPoolThreadMain(void * /*data*/)
+{
+	SDL_LockMutex(poolMutex);
+	while (true)
+	{
+		while (!shouldExit && batches.length == 0)
+		{
+			SDL_WaitCondition(workAvailableCondition, poolMutex);
+		}
+		if (shouldExit)
+		{
+			break;
+		}
+
+		ParallelForBatch *batch = ListGetPointer(batches, 0);
+		batch->activeWorkers++;
+		SDL_UnlockMutex(poolMutex);
+
+		RunParallelForBatch(batch);
+
+		SDL_LockMutex(poolMutex);
+		// The batch is exhausted, so make sure no other worker picks it up again
+		const size_t index = ListFind(batches, batch);
+		if (index != (size_t)-1)
+		{
+			ListRemoveAt(batches, index);
+		}
+		batch->activeWorkers--;
+		SDL_BroadcastCondition(workerDoneCondition);
+	}
+	SDL_UnlockMutex(poolMutex);
+	return 0;
+}
+
+void WorkerPoolInit()
+{
+	poolMutex = SDL_CreateMutex();
+	workAvailableCondition = SDL_CreateCondition();
+	workerDoneCondition = SDL_CreateCondition();
+	ListInit(batches, LIST_POINTER);
+	shouldExit = false;
+
+	const int cpuCount = SDL_GetNumLogicalCPUCores();
+	const size_t threadCount = cpuCount > 1 ? (size_t)cpuCount - 1 : 0;
+	workerCount = 0;
+	for (size_t i = 0; i < threadCount && i < MAX_WORKER_POOL_THREADS; i++)
+	{
+		workers[workerCount] = SDL_CreateThread(WorkerPoolThreadMain, "GameWorker", NULL);
+		if (workers[workerCount] == NULL)
+		{
+			LogWarning("Failed to start a worker pool thread\n");
+			break;
+		}
+		workerCount++;
+	}
+	LogDebug("Started %zu worker pool thread(s)\n", workerCount);
+}
+
+void WorkerPoolDestroy()
+{
+	if (poolMutex == NULL)
+	{
+		return;
+	}
+	LogDebug("Terminating worker pool threads...\n");
+	SDL_LockMutex(poolMutex);
+	shouldExit = true;
+	SDL_BroadcastCondition(workAvailableCondition);
+	SDL_UnlockMutex(poolMutex);
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		SDL_WaitThread(workers[i], NULL);
+	}
+	workerCount = 0;
+
+	ListFree(batches);
+	SDL_DestroyCondition(workAvailableCondition);
+	SDL_DestroyCondition(workerDoneCondition);
+	SDL_DestroyMutex(poolMutex);
+	poolMutex = NULL;
+}
+
+void ParallelFor(const size_t count, const ParallelForFunction function, void *userData)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	ParallelForBatch batch = {
+		.function = function,
+		.userData = userData,
+		.count = count,
+		.activeWorkers = 0,
+	};
+	SDL_SetAtomicInt(&batch.nextIndex, 0);
+	if (workerCount == 0 || count == 1)
+	{
+		RunParallelForBatch(&batch);
+		return;
+	}
+
+	SDL_LockMutex(poolMutex);
+	ListAdd(batches, &batch);
+	SDL_BroadcastCondition(workAvailableCondition);
+	SDL_UnlockMutex(poolMutex);
+
+	RunParallelForBatch(&batch);
+
+	// Every index has been claimed, wait for the workers still running one to finish before the batch goes away
+	SDL_LockMutex(poolMutex);
+	const size_t index = ListFind(batches, &batch);
+	if (index != (size_t)-1)
+	{
+		ListRemoveAt(batches, index);
+	}
+	while (batch.activeWorkers > 0)
+	{
+		SDL_WaitCondition(workerDoneCondition, poolMutex);
+	}
+	SDL_UnlockMutex(poolMutex);
+}
+
+size_t GetWorkerPoolThreadCount()
+{
+	return workerCount + 1;
+}
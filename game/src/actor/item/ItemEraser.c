@@ -5,20 +5,19 @@
 #include "actor/item/ItemEraser.h"
 #include <engine/assets/AssetReader.h>
 #include <engine/assets/ModelLoader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Map.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/enums.h>
 #include <joltc/Math/Transform.h>
 #include <joltc/Physics/Body/BodyCreationSettings.h>
 #include <joltc/Physics/Body/BodyID.h>
 #include <joltc/Physics/Body/BodyInterface.h>
 #include <stdbool.h>
-#include <stdlib.h>
 #include "item/EraserItem.h"
 
 typedef struct ItemEraserData ItemEraserData;
@@ -36,9 +35,7 @@ static inline void CreateItemEraserCollider(Actor *this, const Transform *transf
 																		  JPH_MotionType_Dynamic,
 																		  OBJECT_LAYER_DYNAMIC,
 																		  this);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
 
@@ -47,10 +44,8 @@ static void ItemEraserInit(Actor *this, const KvList params, Transform *transfor
 	this->hasModel = true;
 	this->model = LoadModel(MODEL("eraser_w"));
 	this->flags = ACTOR_FLAG_INTERACTABLE;
-	ItemEraserData *data = malloc(sizeof(ItemEraserData));
-	CheckAlloc(data);
+	ItemEraserData *data = ActorAllocExtraData(this, sizeof(ItemEraserData));
 	data->alwaysGive = KvGetBool(params, "always_give", false);
-	this->extraData = data;
 
 	CreateItemEraserCollider(this, transform);
 }
@@ -5,6 +5,7 @@
 #include "actor/npc/NpcJohn.h"
 #include <cglm/types.h>
 #include <engine/assets/AssetReader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -12,7 +13,6 @@
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Vector2.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/enums.h>
 #include <joltc/joltc.h>
 #include <joltc/Math/Transform.h>
@@ -21,8 +21,6 @@
 #include <joltc/Physics/Body/MassProperties.h>
 #include <joltc/Physics/Collision/Shape/Shape.h>
 #include <stdbool.h>
-#include <stdlib.h>
-#include <string.h>
 
 static inline void CreateNpcJohnCollider(Actor *this, const Transform *transform)
 {
@@ -44,9 +42,7 @@ static inline void CreateNpcJohnCollider(Actor *this, const Transform *transform
 													JPH_AllowedDOFs_TranslationY |
 													JPH_AllowedDOFs_TranslationZ |
 													JPH_AllowedDOFs_RotationY);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 	JPH_Shape_Destroy(shape);
 }
@@ -58,13 +54,11 @@ static void JohnUpdate(Actor *this, double /*delta*/)
 
 static void JohnInit(Actor *this, const KvList /*params*/, Transform *transform)
 {
-	this->wall = malloc(sizeof(ActorWall));
-	CheckAlloc(this->wall);
+	this->wall = ActorAlloc(this, sizeof(ActorWall));
 	this->wall->centerOffset = v2s(0);
 	this->wall->orientation = ACTOR_WALL_ORIENTATION_X_AXIS;
 	this->wall->length = 16;
-	this->wall->texture = malloc(strlen(TEXTURE("actor/john")) + 1);
-	strcpy(this->wall->texture, TEXTURE("actor/john"));
+	this->wall->texture = ActorStrdup(this, TEXTURE("actor/john"));
 	this->wall->uvScale = v2s(1.0f);
 	this->wall->uvOffset = v2s(0.0f);
 	this->wall->height = 16.0f;
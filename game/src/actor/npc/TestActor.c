@@ -7,6 +7,7 @@
 #include <engine/assets/ModelLoader.h>
 #include <engine/graphics/Font.h>
 #include <engine/graphics/RenderingHelpers.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -40,9 +41,7 @@ static inline void CreateTestActorCollider(Actor *this, const Transform *transfo
 													JPH_AllowedDOFs_TranslationY |
 													JPH_AllowedDOFs_TranslationZ |
 													JPH_AllowedDOFs_RotationY);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
 
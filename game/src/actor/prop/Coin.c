@@ -5,6 +5,7 @@
 #include "actor/prop/Coin.h"
 #include <cglm/types.h>
 #include <engine/assets/AssetReader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -13,7 +14,6 @@
 #include <engine/structs/KVList.h>
 #include <engine/structs/Map.h>
 #include <engine/structs/Vector2.h>
-#include <engine/subsystem/Error.h>
 #include <engine/subsystem/SoundSystem.h>
 #include <joltc/constants.h>
 #include <joltc/enums.h>
@@ -27,8 +27,8 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <stdlib.h>
-#include <string.h>
+
+static ActorOutputId collectedOutput;
 
 static const float SIZE = 4.0f;
 
@@ -47,9 +47,7 @@ static inline void CreateCoinSensor(Actor *this, const Transform *transform)
 																						   OBJECT_LAYER_SENSOR,
 																						   this);
 	JPH_BodyCreationSettings_SetIsSensor(bodyCreationSettings, true);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_Shape_Destroy(shape);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
@@ -81,14 +79,13 @@ static void CoinOnPlayerContactAdded(Actor *this, JPH_BodyID /*bodyId*/)
 		GetState()->saveData->coins += 5;
 	}
 	(void)PlaySound(SOUND("sfx/coincling"), SOUND_CATEGORY_SFX);
-	ActorFireOutput(this, COIN_OUTPUT_COLLECTED, PARAM_NONE);
+	ActorFireOutputId(this, collectedOutput, PARAM_NONE);
 	RemoveActor(this);
 }
 
 static void CoinInit(Actor *this, const KvList params, Transform *transform)
 {
-	this->extraData = calloc(1, sizeof(CoinData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(CoinData));
 	CoinData *data = this->extraData;
 	data->isBlue = KvGetBool(params, "is_blue", false);
 
@@ -100,13 +97,11 @@ static void CoinInit(Actor *this, const KvList params, Transform *transform)
 	};
 	CreateCoinSensor(this, &adjustedTransform);
 
-	this->wall = malloc(sizeof(ActorWall));
-	CheckAlloc(this->wall);
+	this->wall = ActorAlloc(this, sizeof(ActorWall));
 	this->wall->centerOffset = v2s(0);
 	this->wall->orientation = ACTOR_WALL_ORIENTATION_X_AXIS;
 	this->wall->length = SIZE;
-	this->wall->texture = malloc(strlen(TEXTURE("actor/bluecoin")) + 1);
-	strcpy(this->wall->texture, data->isBlue ? TEXTURE("actor/bluecoin") : TEXTURE("actor/coin"));
+	this->wall->texture = ActorStrdup(this, data->isBlue ? TEXTURE("actor/bluecoin") : TEXTURE("actor/coin"));
 	this->wall->uvScale = v2(1.0f, 4.0f);
 	this->wall->uvOffset = v2s(0.0f);
 	this->wall->height = SIZE;
@@ -127,5 +122,6 @@ ActorDefinition coinActorDefinition = {
 void RegisterCoin()
 {
 	RegisterDefaultActorInputs(&coinActorDefinition);
+	collectedOutput = RegisterActorOutput(&coinActorDefinition, COIN_OUTPUT_COLLECTED);
 	RegisterActor(COIN_ACTOR_NAME, &coinActorDefinition);
 }
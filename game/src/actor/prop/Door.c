@@ -4,6 +4,7 @@
 
 #include "actor/prop/Door.h"
 #include <engine/assets/AssetReader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -11,7 +12,6 @@
 #include <engine/structs/Color.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Vector2.h>
-#include <engine/subsystem/Error.h>
 #include <engine/subsystem/Logging.h>
 #include <joltc/constants.h>
 #include <joltc/enums.h>
@@ -26,8 +26,11 @@
 #include <joltc/Physics/Collision/Shape/Shape.h>
 #include <stdbool.h>
 #include <stddef.h>
-#include <stdlib.h>
-#include <string.h>
+
+static ActorOutputId openingOutput;
+static ActorOutputId closingOutput;
+static ActorOutputId fullyOpenedOutput;
+static ActorOutputId fullyClosedOutput;
 
 typedef enum
 {
@@ -84,11 +87,11 @@ static inline void DoorSetState(Actor *this, const DoorState state, const double
 										  this->bodyId,
 										  &data->closedPosition,
 										  JPH_Activation_DontActivate);
-			ActorFireOutput(this, DOOR_OUTPUT_FULLY_CLOSED, PARAM_NONE);
+			ActorFireOutputId(this, fullyClosedOutput, PARAM_NONE);
 			break;
 		case DOOR_OPENING:
 			DoorSetOpenVector(this);
-			ActorFireOutput(this, DOOR_OUTPUT_OPENING, PARAM_NONE);
+			ActorFireOutputId(this, openingOutput, PARAM_NONE);
 			break;
 		case DOOR_OPEN:
 			JPH_BodyInterface_SetLinearVelocity(this->bodyInterface, this->bodyId, &Vector3_Zero);
@@ -96,11 +99,11 @@ static inline void DoorSetState(Actor *this, const DoorState state, const double
 										  this->bodyId,
 										  &data->openPosition,
 										  JPH_Activation_DontActivate);
-			ActorFireOutput(this, DOOR_OUTPUT_FULLY_OPENED, PARAM_NONE);
+			ActorFireOutputId(this, fullyOpenedOutput, PARAM_NONE);
 			break;
 		case DOOR_CLOSING:
 			DoorSetCloseVector(this);
-			ActorFireOutput(this, DOOR_OUTPUT_CLOSING, PARAM_NONE);
+			ActorFireOutputId(this, closingOutput, PARAM_NONE);
 			break;
 	}
 }
@@ -119,9 +122,7 @@ static inline void CreateDoorCollider(Actor *this, const Transform *transform)
 	JPH_BodyCreationSettings_SetMassPropertiesOverride(bodyCreationSettings, &massProperties);
 	JPH_BodyCreationSettings_SetOverrideMassProperties(bodyCreationSettings,
 													   JPH_OverrideMassProperties_CalculateInertia);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_Shape_Destroy(shape);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
@@ -139,9 +140,7 @@ static inline void CreateDoorSensor(Actor *this, const Transform *transform)
 																						   OBJECT_LAYER_SENSOR,
 																						   this);
 	JPH_BodyCreationSettings_SetIsSensor(bodyCreationSettings, true);
-	data->sensorBodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-															bodyCreationSettings,
-															JPH_Activation_Activate);
+	data->sensorBodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_Shape_Destroy(shape);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
@@ -321,21 +320,19 @@ static void DoorInit(Actor *this, const KvList params, Transform *transform)
 
 	const Vector2 size = KvGetVec2(params, "size", v2s(16.0f));
 
-	this->extraData = calloc(1, sizeof(DoorData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(DoorData));
 	DoorData *data = this->extraData;
 	data->stayOpen = KvGetBool(params, "stay_open", false);
 	data->width = size.x;
 	data->stayOpenTime = KvGetFloat(params, "delay_until_close", 1.0f);
 
-	this->wall = malloc(sizeof(ActorWall));
-	CheckAlloc(this->wall);
+	this->wall = ActorAlloc(this, sizeof(ActorWall));
 	const float width = data->width;
 	this->wall->orientation = ACTOR_WALL_ORIENTATION_Z_AXIS;
 	this->wall->centerOffset = v2s(0);
 	this->wall->length = width;
 	this->wall->height = size.y;
-	this->wall->texture = strdup(KvGetString(params, "texture", TEXTURE("actor/door")));
+	this->wall->texture = ActorStrdup(this, KvGetString(params, "texture", TEXTURE("actor/door")));
 	this->wall->uvScale = KvGetVec2(params, "uv_scale", v2s(1.0f));
 	this->wall->uvOffset = KvGetVec2(params, "uv_offset", v2s(0.0f));
 	this->wall->unshaded = KvGetBool(params, "unshaded", false);
@@ -358,6 +355,10 @@ ActorDefinition doorActorDefinition = {
 void RegisterDoor()
 {
 	RegisterDefaultActorInputs(&doorActorDefinition);
+	openingOutput = RegisterActorOutput(&doorActorDefinition, DOOR_OUTPUT_OPENING);
+	closingOutput = RegisterActorOutput(&doorActorDefinition, DOOR_OUTPUT_CLOSING);
+	fullyOpenedOutput = RegisterActorOutput(&doorActorDefinition, DOOR_OUTPUT_FULLY_OPENED);
+	fullyClosedOutput = RegisterActorOutput(&doorActorDefinition, DOOR_OUTPUT_FULLY_CLOSED);
 	RegisterActorInput(&doorActorDefinition, DOOR_INPUT_OPEN, DoorOpenHandler);
 	RegisterActorInput(&doorActorDefinition, DOOR_INPUT_CLOSE, DoorCloseHandler);
 	RegisterActor(DOOR_ACTOR_NAME, &doorActorDefinition);
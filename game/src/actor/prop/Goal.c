@@ -5,6 +5,7 @@
 #include "actor/prop/Goal.h"
 #include <cglm/types.h>
 #include <engine/assets/AssetReader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -13,7 +14,6 @@
 #include <engine/structs/KVList.h>
 #include <engine/structs/Map.h>
 #include <engine/structs/Vector2.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/constants.h>
 #include <joltc/enums.h>
 #include <joltc/joltc.h>
@@ -24,8 +24,8 @@
 #include <joltc/Physics/Body/BodyInterface.h>
 #include <joltc/Physics/Collision/Shape/Shape.h>
 #include <stdbool.h>
-#include <stdlib.h>
-#include <string.h>
+
+static ActorOutputId collectedOutput;
 
 typedef struct GoalData
 {
@@ -41,9 +41,7 @@ static inline void CreateGoalSensor(Actor *this, const Transform *transform)
 																						   OBJECT_LAYER_SENSOR,
 																						   this);
 	JPH_BodyCreationSettings_SetIsSensor(bodyCreationSettings, true);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_Shape_Destroy(shape);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
@@ -71,25 +69,21 @@ static void GoalOnPlayerContactAdded(Actor *this, JPH_BodyID /*bodyId*/)
 	if (data->enabled)
 	{
 		GetState()->saveData->coins += 10;
-		ActorFireOutput(this, GOAL_OUTPUT_COLLECTED, PARAM_NONE);
+		ActorFireOutputId(this, collectedOutput, PARAM_NONE);
 		RemoveActor(this);
 	}
 }
 
 static void GoalInit(Actor *this, const KvList params, Transform *transform)
 {
-	GoalData *data = calloc(1, sizeof(GoalData));
-	CheckAlloc(data);
-	this->extraData = data;
+	GoalData *data = ActorAllocExtraData(this, sizeof(GoalData));
 	data->enabled = KvGetBool(params, "start_enabled", true);
 
-	this->wall = malloc(sizeof(ActorWall));
-	CheckAlloc(this->wall);
+	this->wall = ActorAlloc(this, sizeof(ActorWall));
 	this->wall->length = 16;
 	this->wall->centerOffset = v2s(0);
 	this->wall->orientation = ACTOR_WALL_ORIENTATION_X_AXIS;
-	this->wall->texture = malloc(strlen(TEXTURE("actor/goal0")) + 1);
-	strcpy(this->wall->texture, data->enabled ? TEXTURE("actor/goal0") : TEXTURE("actor/goal1"));
+	this->wall->texture = ActorStrdup(this, data->enabled ? TEXTURE("actor/goal0") : TEXTURE("actor/goal1"));
 	this->wall->uvScale = v2s(1.0f);
 	this->wall->uvOffset = v2s(0.0f);
 	this->wall->height = 16.0f;
@@ -116,6 +110,7 @@ ActorDefinition goalActorDefinition = {
 void RegisterGoal()
 {
 	RegisterDefaultActorInputs(&goalActorDefinition);
+	collectedOutput = RegisterActorOutput(&goalActorDefinition, GOAL_OUTPUT_COLLECTED);
 	RegisterActorInput(&goalActorDefinition, GOAL_INPUT_ENABLE, GoalEnableHandler);
 	RegisterActorInput(&goalActorDefinition, GOAL_INPUT_DISABLE, GoalDisableHandler);
 	RegisterActor(GOAL_ACTOR_NAME, &goalActorDefinition);
@@ -4,6 +4,7 @@
 
 #include "actor/prop/Laser.h"
 #include <engine/assets/AssetReader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -11,7 +12,6 @@
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Vector2.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/enums.h>
 #include <joltc/joltc.h>
 #include <joltc/Math/Transform.h>
@@ -28,8 +28,6 @@
 #include <joltc/Physics/Collision/Shape/Shape.h>
 #include <math.h>
 #include <stdbool.h>
-#include <stdlib.h>
-#include <string.h>
 
 typedef struct LaserData
 {
@@ -117,9 +115,7 @@ static inline void LaserCreateBody(Actor *this, const Transform *transform)
 																						  JPH_MotionType_Static,
 																						  OBJECT_LAYER_STATIC,
 																						  this);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_DontActivate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_DontActivate);
 	JPH_ShapeSettings_Destroy(shapeSettings);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
@@ -173,20 +169,16 @@ static void LaserTurnOffHandler(Actor *this, const Actor * /*sender*/, const Par
 
 static void LaserInit(Actor *this, const KvList params, Transform *transform)
 {
-	LaserData *data = calloc(1, sizeof(LaserData));
-	CheckAlloc(data);
-	this->extraData = data;
+	LaserData *data = ActorAllocExtraData(this, sizeof(LaserData));
 	data->height = KvGetByte(params, "height", LASER_HEIGHT_MIDDLE);
 	data->on = KvGetBool(params, "start_on", true);
 
-	this->wall = malloc(sizeof(ActorWall));
-	CheckAlloc(this->wall);
+	this->wall = ActorAlloc(this, sizeof(ActorWall));
 	this->wall->length = 0;
 	this->wall->centerOffset = v2s(0);
 	this->wall->orientation = ACTOR_WALL_ORIENTATION_Z_AXIS;
-	this->wall->texture = malloc(strlen(TEXTURE("actor/triplelaser")) + 1);
-	strcpy(this->wall->texture,
-		   data->height == LASER_HEIGHT_TRIPLE ? TEXTURE("actor/triplelaser") : TEXTURE("actor/laser"));
+	const char *texture = data->height == LASER_HEIGHT_TRIPLE ? TEXTURE("actor/triplelaser") : TEXTURE("actor/laser");
+	this->wall->texture = ActorStrdup(this, texture);
 	this->wall->uvScale = v2s(1.0f);
 	this->wall->uvOffset = v2s(0.0f);
 	this->wall->height = 16.0f;
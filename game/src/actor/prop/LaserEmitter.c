@@ -5,13 +5,14 @@
 #include "actor/prop/LaserEmitter.h"
 #include <engine/assets/AssetReader.h>
 #include <engine/assets/ModelLoader.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/Physics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
+#include <engine/structs/ActorPool.h>
 #include <engine/structs/GlobalState.h>
 #include <engine/structs/KVList.h>
 #include <engine/structs/Map.h>
-#include <engine/subsystem/Error.h>
 #include <joltc/enums.h>
 #include <joltc/joltc.h>
 #include <joltc/Math/Quat.h>
@@ -21,7 +22,6 @@
 #include <joltc/Physics/Body/BodyInterface.h>
 #include <stdbool.h>
 #include <stddef.h>
-#include <stdlib.h>
 #include "actor/prop/Laser.h"
 
 enum LaserEmitterSkin
@@ -36,7 +36,8 @@ enum LaserEmitterSkin
 typedef struct LaserEmitterData
 {
 	LaserHeight height;
-	Actor *laserActor;
+	/// The laser this emitter spawned, or @c ACTOR_HANDLE_NONE before its first tick
+	ActorHandle laserActor;
 	bool startOn;
 	bool hasTicked;
 	Transform transform;
@@ -50,9 +51,7 @@ static inline void CreateLaserEmitterCollider(Actor *this, const Transform *tran
 																		  JPH_MotionType_Static,
 																		  OBJECT_LAYER_STATIC,
 																		  this);
-	this->bodyId = JPH_BodyInterface_CreateAndAddBody(this->bodyInterface,
-													  bodyCreationSettings,
-													  JPH_Activation_Activate);
+	this->bodyId = CreateAndAddBody(this->bodyInterface, bodyCreationSettings, JPH_Activation_Activate);
 	JPH_BodyCreationSettings_Destroy(bodyCreationSettings);
 }
 
@@ -65,11 +64,12 @@ static void LaserEmitterUpdate(Actor *this, const double /*delta*/)
 		KvListCreate(laserParams);
 		KvSetByte(laserParams, "height", data->height);
 		KvSetBool(laserParams, "start_on", data->startOn);
-		data->laserActor = CreateActor(&data->transform,
-									   LASER_ACTOR_NAME,
-									   laserParams,
-									   JPH_PhysicsSystem_GetBodyInterface(GetState()->map->physicsSystem));
-		AddActor(data->laserActor);
+		Actor *laserActor = CreateActor(&data->transform,
+										LASER_ACTOR_NAME,
+										laserParams,
+										JPH_PhysicsSystem_GetBodyInterface(GetState()->map->physicsSystem));
+		AddActor(laserActor);
+		data->laserActor = laserActor->handle;
 		data->hasTicked = true;
 	}
 }
@@ -77,14 +77,22 @@ static void LaserEmitterUpdate(Actor *this, const double /*delta*/)
 static void LaserEmitterTurnOnHandler(Actor *this, const Actor * /*sender*/, const Param * /*param*/)
 {
 	const LaserEmitterData *data = this->extraData;
-	ActorTriggerInput(this, data->laserActor, LASER_INPUT_TURN_ON, NULL);
+	Actor *laserActor = GetActorFromHandle(data->laserActor);
+	if (laserActor != NULL)
+	{
+		ActorTriggerInput(this, laserActor, LASER_INPUT_TURN_ON, NULL);
+	}
 	this->currentSkinIndex = data->height + 1;
 }
 
 static void LaserEmitterTurnOffHandler(Actor *this, const Actor * /*sender*/, const Param * /*param*/)
 {
 	const LaserEmitterData *data = this->extraData;
-	ActorTriggerInput(this, data->laserActor, LASER_INPUT_TURN_OFF, NULL);
+	Actor *laserActor = GetActorFromHandle(data->laserActor);
+	if (laserActor != NULL)
+	{
+		ActorTriggerInput(this, laserActor, LASER_INPUT_TURN_OFF, NULL);
+	}
 	this->currentSkinIndex = EMITTER_SKIN_OFF;
 }
 
@@ -92,8 +100,7 @@ static void LaserEmitterInit(Actor *this, const KvList params, Transform *transf
 {
 	this->flags = ACTOR_FLAG_CAN_BLOCK_LASERS;
 
-	this->extraData = calloc(1, sizeof(LaserEmitterData));
-	CheckAlloc(this->extraData);
+	ActorAllocExtraData(this, sizeof(LaserEmitterData));
 	LaserEmitterData *data = this->extraData;
 	data->height = (LaserHeight)KvGetByte(params, "height", LASER_HEIGHT_MIDDLE);
 	data->hasTicked = false;
@@ -8,6 +8,7 @@
 #include <engine/assets/AssetReader.h>
 #include <engine/graphics/Drawing.h>
 #include <engine/graphics/RenderingHelpers.h>
+#include <engine/physics/BodyBatch.h>
 #include <engine/physics/MapPhysics.h>
 #include <engine/structs/Actor.h>
 #include <engine/structs/ActorDefinition.h>
@@ -66,6 +67,8 @@ static void MainStateFixedUpdate(GlobalState *state, const double delta)
 		spawnActorOnce = PHYSBOX_ACTOR_NAME;
 	}
 
+	// Spawned bodies are added together, so that they only take the broadphase lock once
+	BeginBodyBatch(JPH_PhysicsSystem_GetBodyInterface(state->map->physicsSystem));
 	if (spawnActorOnce)
 	{
 		Actor *actor = CreateActor(&state->map->player.transform,
@@ -83,6 +86,7 @@ static void MainStateFixedUpdate(GlobalState *state, const double delta)
 								   JPH_PhysicsSystem_GetBodyInterface(state->map->physicsSystem));
 		AddActor(actor);
 	}
+	EndBodyBatch();
 
 	MapFixedUpdate(state, delta);
 